@@ -0,0 +1,85 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_AIO_QUEUE_HPP
+#define GEKKOFS_AIO_QUEUE_HPP
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace gkfs {
+namespace aio {
+
+// pair<error code, transferred size>
+using io_result = std::pair<int, ssize_t>;
+
+/**
+ * Process-wide table of in-flight asynchronous I/O requests.
+ * The RPCs of a request are already posted when it is submitted. Worker threads collect the responses so that
+ * completion can be polled without blocking the application. A worker waits for one request at a time and a new
+ * worker is started while requests are pending and all workers wait, up to gkfs::config::io::aio_workers. A request
+ * is thus completed as soon as its responses arrived, unless as many earlier requests are still outstanding.
+ * A request is released only by waiting for it. Once gkfs::config::io::aio_max_requests requests are not waited for,
+ * submissions fail until the application waits for some of them.
+ */
+class AioQueue {
+private:
+    struct Request {
+        std::shared_future<io_result> result;
+        bool done;
+        // a thread waits for the request, it is removed once completed
+        bool waited;
+        io_result ret;
+    };
+
+    std::map<int, Request> requests_;
+    // requests whose responses are not waited for yet, in submission order
+    std::deque<int> pending_;
+    int next_id_{0};
+    bool running_{false};
+    std::vector<std::thread> workers_;
+    // workers waiting for a pending request
+    size_t idle_{0};
+    std::mutex mutex_;
+    std::condition_variable submitted_;
+    std::condition_variable completed_;
+
+    void complete_requests_();
+
+public:
+    AioQueue() = default;
+
+    ~AioQueue();
+
+    int submit(const std::function<std::shared_future<io_result>()>& post);
+
+    int poll(int id);
+
+    int wait(int id, io_result& ret);
+
+    void shutdown();
+};
+
+} // namespace aio
+} // namespace gkfs
+
+#endif //GEKKOFS_AIO_QUEUE_HPP
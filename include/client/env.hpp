@@ -33,6 +33,10 @@ static constexpr auto LOG_OUTPUT          = ADD_PREFIX("LOG_OUTPUT");
 static constexpr auto LOG_OUTPUT_TRUNC    = ADD_PREFIX("LOG_OUTPUT_TRUNC");
 static constexpr auto CWD                 = ADD_PREFIX("CWD");
 static constexpr auto HOSTS_FILE          = ADD_PREFIX("HOSTS_FILE");
+static constexpr auto STRIPE_COUNT        = ADD_PREFIX("STRIPE_COUNT");
+static constexpr auto STRIPE_SIZE         = ADD_PREFIX("STRIPE_SIZE");
+static constexpr auto ASYNC_CREATE        = ADD_PREFIX("ASYNC_CREATE");
+static constexpr auto JOB_ID              = ADD_PREFIX("JOB_ID");
 #ifdef GKFS_ENABLE_FORWARDING
 static constexpr auto FORWARDING_MAP_FILE = ADD_PREFIX("FORWARDING_MAP_FILE");
 #endif
@@ -17,6 +17,10 @@
 #include <client/open_file_map.hpp>
 #include <global/metadata.hpp>
 
+#include <string>
+#include <vector>
+#include <functional>
+
 struct statfs;
 struct statvfs;
 struct linux_dirent;
@@ -31,6 +35,12 @@ int gkfs_create(const std::string& path, mode_t mode);
 
 int gkfs_remove(const std::string& path);
 
+int gkfs_create_batch(const std::vector<std::string>& paths, mode_t mode);
+
+int gkfs_stat_batch(const std::vector<std::string>& paths, std::vector<struct stat>& bufs, std::vector<int>& errs);
+
+int gkfs_remove_batch(const std::vector<std::string>& paths);
+
 // Implementation of access,
 // Follow links is true by default 
 int gkfs_access(const std::string& path, int mask, bool follow_links = true);
@@ -58,7 +68,9 @@ off64_t gkfs_lseek(std::shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off64_t off
 
 int gkfs_truncate(const std::string& path, off_t offset);
 
-int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size);
+int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size, const gkfs::rpc::StripeLayout& layout);
+
+int gkfs_close(unsigned int fd);
 
 int gkfs_dup(int oldfd);
 
@@ -93,6 +105,27 @@ ssize_t gkfs_readv(int fd, const struct iovec* iov, int iovcnt);
 
 ssize_t gkfs_preadv(int fd, const struct iovec* iov, int iovcnt, off_t offset);
 
+// Asynchronous I/O: start requests and collect their results later
+int gkfs_aio_pwrite(int fd, const void* buf, size_t count, off64_t offset);
+
+int gkfs_aio_pread(int fd, void* buf, size_t count, off64_t offset);
+
+int gkfs_aio_poll(int req);
+
+ssize_t gkfs_aio_wait(int req);
+
+ssize_t gkfs_write_from(int fd, off64_t offset, size_t len, const std::function<ssize_t(char*, size_t)>& source);
+
+ssize_t gkfs_read_to(int fd, off64_t offset, size_t len, const std::function<ssize_t(const char*, size_t)>& sink);
+
+ssize_t gkfs_copy_file_range(int fd_in, off64_t off_in, int fd_out, off64_t off_out, size_t len);
+
+void* gkfs_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+
+int gkfs_munmap(void* addr, size_t length);
+
+int gkfs_msync(void* addr, size_t length, int flags);
+
 int gkfs_opendir(const std::string& path);
 
 int gkfs_getdents(unsigned int fd, struct linux_dirent* dirp, unsigned int count);
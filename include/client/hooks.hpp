@@ -15,6 +15,7 @@
 #define GEKKOFS_HOOKS_HPP
 
 #include <sys/types.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
 
 struct statfs;
@@ -107,6 +108,20 @@ int hook_fstatfs(unsigned int fd, struct statfs* buf);
 
 int hook_fsync(unsigned int fd);
 
+#ifdef SYS_copy_file_range
+
+long hook_copy_file_range(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len, unsigned int flags);
+
+#endif
+
+long hook_sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+
+long hook_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+
+int hook_munmap(void* addr, size_t length);
+
+int hook_msync(void* addr, size_t length, int flags);
+
 } // namespace hook
 } // namespace gkfs
 
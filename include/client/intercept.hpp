@@ -29,6 +29,8 @@ hook_guard_wrapper(long syscall_number,
                    long arg3, long arg4, long arg5,
                    long* syscall_return_value);
 
+void enter_internal_thread();
+
 void start_self_interception();
 
 void start_interception();
@@ -0,0 +1,128 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_MAPPED_REGIONS_HPP
+#define GEKKOFS_MAPPED_REGIONS_HPP
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include <sys/types.h>
+
+namespace gkfs {
+
+namespace filemap {
+class OpenFile;
+}
+
+namespace mapping {
+
+enum class PageState : uint8_t {
+    missing, // not fetched from GekkoFS yet
+    present,
+    dirty, // present and written since the last write-back
+    unmapped
+};
+
+struct MappedRegion {
+    char* addr;
+    size_t length;
+    int prot;
+    int flags;
+    std::shared_ptr<gkfs::filemap::OpenFile> file;
+    off64_t offset;
+    // file size when the region was mapped. Data beyond is neither fetched nor written back
+    off64_t file_size;
+    std::vector<PageState> pages;
+    // distinguishes a region from one mapped later at the same address
+    uint64_t id;
+    // written pages are tracked by write-protecting present pages. Otherwise, all present pages are written back
+    bool track_dirty;
+};
+
+/**
+ * Memory mappings of GekkoFS files.
+ * A mapping is backed by private anonymous memory. If userfaultfd is available, pages are fetched on their first
+ * access, a chunk-sized window at a time, by a handler thread. Otherwise, the whole range is read when it is mapped.
+ * Pages of shared writable mappings that were written are written back on msync() and munmap(). Written pages are
+ * tracked with userfaultfd write-protect faults (Linux 5.7), without them all fetched pages are written back.
+ */
+class MappedRegions {
+private:
+    // regions by start address
+    std::map<uintptr_t, MappedRegion> regions_;
+    std::atomic<size_t> region_count_{0};
+    std::mutex mutex_;
+    size_t page_size_;
+    // userfaultfd and eventfd to stop the handler thread, -1 if not (yet) set up
+    int uffd_{-1};
+    int wakeup_fd_{-1};
+    bool uffd_checked_{false};
+    // write-protect faults are supported
+    bool uffd_wp_{false};
+    uint64_t next_region_id_{0};
+    std::thread handler_;
+
+    bool setup_uffd_();
+
+    void handle_faults_();
+
+    void handle_fault_(uintptr_t fault_addr, std::vector<char>& buf);
+
+    void handle_wp_fault_(uintptr_t fault_addr);
+
+    void wake_(uintptr_t page_addr);
+
+    bool register_(uintptr_t addr, size_t length, bool missing, bool wp);
+
+    bool write_protect_(uintptr_t addr, size_t length, bool protect);
+
+    std::map<uintptr_t, MappedRegion>::iterator find_(uintptr_t addr);
+
+    int fetch_(const std::shared_ptr<gkfs::filemap::OpenFile>& file, off64_t file_size, off64_t offset, size_t len,
+               char* buf);
+
+    int write_back_(MappedRegion& region, size_t first_page, size_t last_page);
+
+    int for_each_overlap_(uintptr_t addr, size_t length, bool unmap);
+
+public:
+    MappedRegions();
+
+    ~MappedRegions();
+
+    int map(void* addr, size_t length, int prot, int flags, std::shared_ptr<gkfs::filemap::OpenFile> file,
+            off64_t offset, off64_t file_size, void*& mapped);
+
+    int unmap(void* addr, size_t length);
+
+    void release(void* addr, size_t length);
+
+    int sync(void* addr, size_t length);
+
+    bool empty() const;
+
+    bool overlaps(void* addr, size_t length);
+
+    void shutdown();
+};
+
+} // namespace mapping
+} // namespace gkfs
+
+#endif //GEKKOFS_MAPPED_REGIONS_HPP
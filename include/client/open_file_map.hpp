@@ -15,10 +15,14 @@
 #ifndef GEKKOFS_OPEN_FILE_MAP_HPP
 #define GEKKOFS_OPEN_FILE_MAP_HPP
 
+#include <global/rpc/distributor.hpp>
+
 #include <map>
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <future>
+#include <vector>
 
 namespace gkfs {
 namespace filemap {
@@ -47,17 +51,22 @@ class OpenFile {
 protected:
     FileType type_;
     std::string path_;
-    std::array<bool, static_cast<int>(OpenFile_flags::flag_count)> flags_ = {{false}};
-    unsigned long pos_;
-    std::mutex pos_mutex_;
-    std::mutex flag_mutex_;
+    // one bit per OpenFile_flags value
+    std::atomic<unsigned int> flags_{0};
+    static_assert(static_cast<int>(OpenFile_flags::flag_count) <= 32, "OpenFile flags do not fit into flags_");
+    std::atomic<unsigned long> pos_{0};
+    gkfs::rpc::StripeLayout layout_;
+    // outstanding asynchronous create of this file. Its error code is reported by the next operation on the fd
+    std::shared_future<int> pending_create_;
+    std::mutex create_mutex_;
 
 public:
-    // multiple threads may want to update the file position if fd has been duplicated by dup()
+    // multiple threads may update the file position and flags if the fd is shared or duplicated by dup().
+    // Both are atomics so that no lock is taken on the read/write path.
 
     OpenFile(const std::string& path, int flags, FileType type = FileType::regular);
 
-    ~OpenFile() = default;
+    ~OpenFile();
 
     // getter/setter
     std::string path() const;
@@ -68,10 +77,22 @@ public:
 
     void pos(unsigned long pos_);
 
+    unsigned long advance_pos(unsigned long count);
+
+    bool compare_exchange_pos(unsigned long expected, unsigned long desired);
+
     bool get_flag(OpenFile_flags flag);
 
     void set_flag(OpenFile_flags flag, bool value);
 
+    const gkfs::rpc::StripeLayout& layout() const;
+
+    void layout(const gkfs::rpc::StripeLayout& layout);
+
+    void pending_create(std::shared_future<int> pending_create);
+
+    int wait_for_create();
+
     FileType type() const;
 };
 
@@ -79,9 +100,33 @@ public:
 class OpenFileMap {
 
 private:
+    /*
+     * Flat table for the fds [fd_table_base, fd_table_base + fd_table_size). Lookups in the table are lock-free and
+     * protect the slot they read with a per-thread hazard pointer. Removed slots are retired and freed once no
+     * hazard pointer refers to them anymore, see retire_slot_().
+     * fds outside of the table, e.g., set by dup2() or when the table is full, are stored in files_.
+     */
+    static constexpr int fd_table_base = 10000;
+    static constexpr int fd_table_size = 16384;
+
+    struct Slot {
+        std::shared_ptr<OpenFile> file;
+    };
+
+    std::unique_ptr<std::atomic<Slot*>[]> fd_table_;
+    std::atomic<unsigned int> next_slot_;
+    std::vector<Slot*> retired_slots_;
+    std::mutex retired_slots_mutex_;
+
     std::map<int, std::shared_ptr<OpenFile>> files_;
     std::recursive_mutex files_mutex_;
 
+    static bool in_fd_table_(int fd);
+
+    void retire_slot_(Slot* slot);
+
+    int add_to_fd_table_(const std::shared_ptr<OpenFile>& open_file);
+
     int safe_generate_fd_idx_();
 
     /*
@@ -99,6 +144,8 @@ private:
 public:
     OpenFileMap();
 
+    ~OpenFileMap();
+
     std::shared_ptr<OpenFile> get(int fd);
 
     std::shared_ptr<OpenDir> get_dir(int dirfd);
@@ -25,9 +25,13 @@ void init_ld_env_if_needed();
 } // namespace preload
 } // namespace gkfs
 
+#ifndef BYPASS_SYSCALL
+
 void init_preload() __attribute__((constructor));
 
 void destroy_preload() __attribute__((destructor));
 
+#endif
+
 
 #endif //IOINTERCEPT_PRELOAD_HPP
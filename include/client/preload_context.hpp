@@ -22,14 +22,24 @@
 #include <string>
 
 #include <bitset>
+#include <mutex>
+#include <atomic>
 
 /* Forward declarations */
 namespace gkfs {
 namespace filemap {
 class OpenFileMap;
 }
+namespace aio {
+class AioQueue;
+}
+namespace mapping {
+class MappedRegions;
+}
 namespace rpc {
 class Distributor;
+
+class ForwarderPins;
 }
 namespace log {
 struct logger;
@@ -54,6 +64,14 @@ struct FsConfig {
 
 };
 
+/*
+ * Cached lstat result of a path component outside of GekkoFS
+ */
+struct ResolveCacheEntry {
+    mode_t mode; // file type bits, i.e., S_IFDIR or S_IFLNK
+    std::string link_target; // canonical target if mode is S_IFLNK
+};
+
 enum class RelativizeStatus {
     internal,
     external,
@@ -73,6 +91,8 @@ private:
     PreloadContext();
 
     std::shared_ptr<gkfs::filemap::OpenFileMap> ofm_;
+    std::shared_ptr<gkfs::aio::AioQueue> aio_queue_;
+    std::shared_ptr<gkfs::mapping::MappedRegions> mapped_regions_;
     std::shared_ptr<gkfs::rpc::Distributor> distributor_;
     std::shared_ptr<FsConfig> fs_conf_;
 
@@ -82,9 +102,20 @@ private:
 
     std::vector<hermes::endpoint> hosts_;
     uint64_t local_host_id_;
-    uint64_t fwd_host_id_;
+    // may be changed by the forwarding mapper thread at any time
+    std::atomic<uint64_t> fwd_host_id_{0};
+    // forwarders this node may use, the first one is the default. Only accessed by the thread loading the
+    // forwarding map, i.e., the forwarding mapper thread after initialization
+    std::vector<uint64_t> fwd_candidates_;
+    // forwarders of the open files
+    std::shared_ptr<gkfs::rpc::ForwarderPins> fwd_pins_;
     std::string rpc_protocol_;
     bool auto_sm_{false};
+    unsigned int stripe_count_{0};
+    size_t stripe_size_{0};
+    bool async_create_{false};
+    // job the data requests are accounted to by the daemons' QoS, empty for the default class
+    std::string job_id_;
 
     bool interception_enabled_;
 
@@ -93,6 +124,9 @@ private:
     bool internal_fds_must_relocate_;
     std::bitset<MAX_USER_FDS> protected_fds_;
 
+    std::map<std::string, ResolveCacheEntry> resolve_cache_;
+    mutable std::mutex resolve_cache_mutex_;
+
 public:
     static PreloadContext* getInstance() {
         static PreloadContext instance;
@@ -129,6 +163,12 @@ public:
 
     void fwd_host_id(uint64_t id);
 
+    const std::vector<uint64_t>& fwd_candidates() const;
+
+    void fwd_candidates(const std::vector<uint64_t>& candidates);
+
+    const std::shared_ptr<gkfs::rpc::ForwarderPins>& fwd_pins() const;
+
     const std::string& rpc_protocol() const;
 
     void rpc_protocol(const std::string& rpc_protocol);
@@ -137,6 +177,22 @@ public:
 
     void auto_sm(bool auto_sm);
 
+    unsigned int stripe_count() const;
+
+    void stripe_count(unsigned int stripe_count);
+
+    size_t stripe_size() const;
+
+    void stripe_size(size_t stripe_size);
+
+    bool async_create() const;
+
+    void async_create(bool async_create);
+
+    const std::string& job_id() const;
+
+    void job_id(const std::string& job_id);
+
     RelativizeStatus relativize_fd_path(int dirfd,
                                         const char* raw_path,
                                         std::string& relative_path,
@@ -144,8 +200,20 @@ public:
 
     bool relativize_path(const char* raw_path, std::string& relative_path, bool resolve_last_link = true) const;
 
+    bool resolve_cache_get(const std::string& path, ResolveCacheEntry& entry) const;
+
+    void resolve_cache_put(const std::string& path, const ResolveCacheEntry& entry);
+
+    void resolve_cache_erase(const std::string& path);
+
+    void resolve_cache_clear();
+
     const std::shared_ptr<gkfs::filemap::OpenFileMap>& file_map() const;
 
+    const std::shared_ptr<gkfs::aio::AioQueue>& aio_queue() const;
+
+    const std::shared_ptr<gkfs::mapping::MappedRegions>& mapped_regions() const;
+
     void distributor(std::shared_ptr<gkfs::rpc::Distributor> distributor);
 
     std::shared_ptr<gkfs::rpc::Distributor> distributor() const;
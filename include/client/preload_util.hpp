@@ -17,6 +17,7 @@
 
 #include <client/preload.hpp>
 #include <global/metadata.hpp>
+#include <global/rpc/distributor.hpp>
 
 #include <string>
 #include <iostream>
@@ -59,9 +60,15 @@ std::shared_ptr<gkfs::metadata::Metadata> get_metadata(const std::string& path,
 
 int metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md, struct stat& attr);
 
+gkfs::rpc::StripeLayout metadata_to_layout(const gkfs::metadata::Metadata& md);
+
+void load_stripe_layout();
+
 void load_hosts();
 
-void load_forwarding_map();
+bool set_forwarder(uint64_t forwarder);
+
+bool load_forwarding_map(bool wait_for_entries = true);
 
 std::vector<std::pair<std::string, std::string>> read_hosts_file();
 
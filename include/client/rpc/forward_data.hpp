@@ -15,6 +15,8 @@
 #ifndef GEKKOFS_CLIENT_FORWARD_DATA_HPP
 #define GEKKOFS_CLIENT_FORWARD_DATA_HPP
 
+#include <future>
+
 namespace gkfs {
 namespace rpc {
 
@@ -26,12 +28,29 @@ struct ChunkStat {
 
 // TODO once we have LEAF, remove all the error code returns and throw them as an exception.
 
+struct StripeLayout;
+
+std::shared_future<std::pair<int, ssize_t>>
+forward_write_async(const std::string& path, const void* buf, bool append_flag, off64_t in_offset, size_t write_size,
+                    int64_t updated_metadentry_size, const StripeLayout& layout);
+
 std::pair<int, ssize_t> forward_write(const std::string& path, const void* buf, bool append_flag, off64_t in_offset,
-                                      size_t write_size, int64_t updated_metadentry_size);
+                                      size_t write_size, int64_t updated_metadentry_size,
+                                      const StripeLayout& layout);
+
+std::shared_future<std::pair<int, ssize_t>>
+forward_read_async(const std::string& path, void* buf, off64_t offset, size_t read_size, const StripeLayout& layout);
+
+std::pair<int, ssize_t> forward_read(const std::string& path, void* buf, off64_t offset, size_t read_size,
+                                     const StripeLayout& layout);
+
+std::pair<int, ssize_t>
+forward_copy_chunks(const std::string& src_path, const StripeLayout& src_layout, off64_t src_offset,
+                    const std::string& dst_path, const StripeLayout& dst_layout, off64_t dst_offset, size_t count);
 
-std::pair<int, ssize_t> forward_read(const std::string& path, void* buf, off64_t offset, size_t read_size);
+int forward_truncate(const std::string& path, size_t current_size, size_t new_size, const StripeLayout& layout);
 
-int forward_truncate(const std::string& path, size_t current_size, size_t new_size);
+std::pair<int, ChunkStat> forward_get_chunk_stat_tree();
 
 std::pair<int, ChunkStat> forward_get_chunk_stat();
 
@@ -15,11 +15,34 @@
 #ifndef GEKKOFS_CLIENT_FORWARD_MNGMNT_HPP
 #define GEKKOFS_CLIENT_FORWARD_MNGMNT_HPP
 
+#include <cstdint>
+#include <utility>
+#include <string>
+#include <future>
+
 namespace gkfs {
 namespace rpc {
 
+// load of a daemon's data path
+struct DaemonLoad {
+    uint64_t queue_depth;
+    uint64_t bytes_per_sec;
+    uint64_t pending_tasks;
+    // RPCs waiting for a handler thread
+    uint64_t metadata_queue_depth;
+    uint64_t data_queue_depth;
+};
+
 bool forward_get_fs_config();
 
+std::shared_future<std::pair<int, DaemonLoad>> forward_get_load_async(uint64_t host_id);
+
+int forward_flush_data(uint64_t host_id, unsigned int timeout_ms);
+
+std::pair<int, std::string> forward_get_qos_stats(uint64_t host_id);
+
+bool join_rpc_waiters(unsigned int timeout_ms);
+
 } // namespace rpc
 } // namespace gkfs
 
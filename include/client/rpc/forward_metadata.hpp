@@ -17,6 +17,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <future>
 
 /* Forward declaration */
 namespace gkfs {
@@ -33,11 +35,15 @@ class Metadata;
 
 namespace rpc {
 
-int forward_create(const std::string& path, mode_t mode);
+struct StripeLayout;
+
+int forward_create(const std::string& path, mode_t mode, const StripeLayout& layout);
+
+std::shared_future<int> forward_create_async(const std::string& path, mode_t mode, const StripeLayout& layout);
 
 int forward_stat(const std::string& path, std::string& attr);
 
-int forward_remove(const std::string& path, bool remove_metadentry_only, ssize_t size);
+int forward_remove(const std::string& path, bool remove_metadentry_only, ssize_t size, const StripeLayout& layout);
 
 int forward_decr_size(const std::string& path, size_t length);
 
@@ -51,6 +57,13 @@ std::pair<int, off64_t> forward_get_metadentry_size(const std::string& path);
 
 std::pair<int, std::shared_ptr<gkfs::filemap::OpenDir>> forward_get_dirents(const std::string& path);
 
+int forward_create_batch(const std::vector<std::string>& paths, mode_t mode);
+
+int forward_stat_batch(const std::vector<std::string>& paths, std::vector<std::string>& attrs,
+                       std::vector<int>& errs);
+
+int forward_remove_batch(const std::vector<std::string>& paths);
+
 #ifdef HAS_SYMLINKS
 
 int forward_mk_symlink(const std::string& path, const std::string& target_path);
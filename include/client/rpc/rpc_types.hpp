@@ -242,8 +242,8 @@ struct fs_config {
 
 
 //==============================================================================
-// definitions for create
-struct create {
+// definitions for get_load
+struct get_load {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -251,34 +251,34 @@ struct create {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = create;
+    using self_type = get_load;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_mk_node_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_input_type = hermes::detail::hg_void_t;
+    using mercury_output_type = rpc_load_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 796590080;
+    constexpr static const uint64_t public_id = 1520238592;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::create;
+    constexpr static const auto name = gkfs::rpc::tag::get_load;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_mk_node_in_t);
+            hermes::detail::hg_proc_void_t;
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_load_out_t);
 
     class input {
 
@@ -286,10 +286,7 @@ struct create {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              uint32_t mode) :
-                m_path(path),
-                m_mode(mode) {}
+        input() {}
 
         input(input&& rhs) = default;
 
@@ -299,29 +296,13 @@ struct create {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
-        }
-
-        uint32_t
-        mode() const {
-            return m_mode;
-        }
-
         explicit
-        input(const rpc_mk_node_in_t& other) :
-                m_path(other.path),
-                m_mode(other.mode) {}
+        input(const hermes::detail::hg_void_t& other) {}
 
         explicit
-        operator rpc_mk_node_in_t() {
-            return {m_path.c_str(), m_mode};
+        operator hermes::detail::hg_void_t() {
+            return {};
         }
-
-    private:
-        std::string m_path;
-        uint32_t m_mode;
     };
 
     class output {
@@ -331,10 +312,21 @@ struct create {
 
     public:
         output() :
-                m_err() {}
-
-        output(int32_t err) :
-                m_err(err) {}
+                m_err(),
+                m_queue_depth(),
+                m_bytes_per_sec(),
+                m_pending_tasks(),
+                m_metadata_queue_depth(),
+                m_data_queue_depth() {}
+
+        output(int32_t err, uint64_t queue_depth, uint64_t bytes_per_sec, uint64_t pending_tasks,
+               uint64_t metadata_queue_depth, uint64_t data_queue_depth) :
+                m_err(err),
+                m_queue_depth(queue_depth),
+                m_bytes_per_sec(bytes_per_sec),
+                m_pending_tasks(pending_tasks),
+                m_metadata_queue_depth(metadata_queue_depth),
+                m_data_queue_depth(data_queue_depth) {}
 
         output(output&& rhs) = default;
 
@@ -345,8 +337,13 @@ struct create {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_load_out_t& out) {
             m_err = out.err;
+            m_queue_depth = out.queue_depth;
+            m_bytes_per_sec = out.bytes_per_sec;
+            m_pending_tasks = out.pending_tasks;
+            m_metadata_queue_depth = out.metadata_queue_depth;
+            m_data_queue_depth = out.data_queue_depth;
         }
 
         int32_t
@@ -354,14 +351,44 @@ struct create {
             return m_err;
         }
 
+        uint64_t
+        queue_depth() const {
+            return m_queue_depth;
+        }
+
+        uint64_t
+        bytes_per_sec() const {
+            return m_bytes_per_sec;
+        }
+
+        uint64_t
+        pending_tasks() const {
+            return m_pending_tasks;
+        }
+
+        uint64_t
+        metadata_queue_depth() const {
+            return m_metadata_queue_depth;
+        }
+
+        uint64_t
+        data_queue_depth() const {
+            return m_data_queue_depth;
+        }
+
     private:
         int32_t m_err;
+        uint64_t m_queue_depth;
+        uint64_t m_bytes_per_sec;
+        uint64_t m_pending_tasks;
+        uint64_t m_metadata_queue_depth;
+        uint64_t m_data_queue_depth;
     };
 };
 
 //==============================================================================
-// definitions for stat
-struct stat {
+// definitions for flush_data
+struct flush_data {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -369,34 +396,34 @@ struct stat {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = stat;
+    using self_type = flush_data;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_path_only_in_t;
-    using mercury_output_type = rpc_stat_out_t;
+    using mercury_input_type = hermes::detail::hg_void_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 1396244480;
+    constexpr static const uint64_t public_id = 3057451008;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::stat;
+    constexpr static const auto name = gkfs::rpc::tag::flush_data;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+            hermes::detail::hg_proc_void_t;
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_stat_out_t);
+            HG_GEN_PROC_NAME(rpc_err_out_t);
 
     class input {
 
@@ -404,8 +431,7 @@ struct stat {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path) :
-                m_path(path) {}
+        input() {}
 
         input(input&& rhs) = default;
 
@@ -415,22 +441,13 @@ struct stat {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
-        }
-
         explicit
-        input(const rpc_path_only_in_t& other) :
-                m_path(other.path) {}
+        input(const hermes::detail::hg_void_t& other) {}
 
         explicit
-        operator rpc_path_only_in_t() {
-            return {m_path.c_str()};
+        operator hermes::detail::hg_void_t() {
+            return {};
         }
-
-    private:
-        std::string m_path;
     };
 
     class output {
@@ -440,12 +457,10 @@ struct stat {
 
     public:
         output() :
-                m_err(),
-                m_db_val() {}
+                m_err() {}
 
-        output(int32_t err, const std::string& db_val) :
-                m_err(err),
-                m_db_val(db_val) {}
+        output(int32_t err) :
+                m_err(err) {}
 
         output(output&& rhs) = default;
 
@@ -456,12 +471,8 @@ struct stat {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_stat_out_t& out) {
+        output(const rpc_err_out_t& out) {
             m_err = out.err;
-
-            if (out.db_val != nullptr) {
-                m_db_val = out.db_val;
-            }
         }
 
         int32_t
@@ -469,20 +480,14 @@ struct stat {
             return m_err;
         }
 
-        std::string
-        db_val() const {
-            return m_db_val;
-        }
-
     private:
         int32_t m_err;
-        std::string m_db_val;
     };
 };
 
 //==============================================================================
-// definitions for remove
-struct remove {
+// definitions for get_qos_stats
+struct get_qos_stats {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -490,34 +495,34 @@ struct remove {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = remove;
+    using self_type = get_qos_stats;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_rm_node_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_input_type = hermes::detail::hg_void_t;
+    using mercury_output_type = rpc_qos_stats_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 2549415936;
+    constexpr static const uint64_t public_id = 1494876160;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::remove;
+    constexpr static const auto name = gkfs::rpc::tag::get_qos_stats;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_rm_node_in_t);
+            hermes::detail::hg_proc_void_t;
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_qos_stats_out_t);
 
     class input {
 
@@ -525,8 +530,7 @@ struct remove {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path) :
-                m_path(path) {}
+        input() {}
 
         input(input&& rhs) = default;
 
@@ -536,22 +540,13 @@ struct remove {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
-        }
-
         explicit
-        input(const rpc_rm_node_in_t& other) :
-                m_path(other.path) {}
+        input(const hermes::detail::hg_void_t& other) {}
 
         explicit
-        operator rpc_rm_node_in_t() {
-            return {m_path.c_str()};
+        operator hermes::detail::hg_void_t() {
+            return {};
         }
-
-    private:
-        std::string m_path;
     };
 
     class output {
@@ -561,10 +556,12 @@ struct remove {
 
     public:
         output() :
-                m_err() {}
+                m_err(),
+                m_stats() {}
 
-        output(int32_t err) :
-                m_err(err) {}
+        output(int32_t err, const std::string& stats) :
+                m_err(err),
+                m_stats(stats) {}
 
         output(output&& rhs) = default;
 
@@ -575,8 +572,12 @@ struct remove {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_qos_stats_out_t& out) {
             m_err = out.err;
+
+            if (out.stats != nullptr) {
+                m_stats = out.stats;
+            }
         }
 
         int32_t
@@ -584,14 +585,20 @@ struct remove {
             return m_err;
         }
 
+        std::string
+        stats() const {
+            return m_stats;
+        }
+
     private:
         int32_t m_err;
+        std::string m_stats;
     };
 };
 
 //==============================================================================
-// definitions for decr_size
-struct decr_size {
+// definitions for create
+struct create {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -599,30 +606,30 @@ struct decr_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = decr_size;
+    using self_type = create;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_input_type = rpc_mk_node_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 1291649024;
+    constexpr static const uint64_t public_id = 796590080;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::decr_size;
+    constexpr static const auto name = gkfs::rpc::tag::create;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+            HG_GEN_PROC_NAME(rpc_mk_node_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -634,9 +641,16 @@ struct decr_size {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path, uint64_t length) :
+        input(const std::string& path,
+              uint32_t mode,
+              uint32_t stripe_count,
+              uint64_t stripe_size,
+              uint32_t stripe_start) :
                 m_path(path),
-                m_length(length) {}
+                m_mode(mode),
+                m_stripe_count(stripe_count),
+                m_stripe_size(stripe_size),
+                m_stripe_start(stripe_start) {}
 
         input(input&& rhs) = default;
 
@@ -651,24 +665,45 @@ struct decr_size {
             return m_path;
         }
 
+        uint32_t
+        mode() const {
+            return m_mode;
+        }
+
+        uint32_t
+        stripe_count() const {
+            return m_stripe_count;
+        }
+
         uint64_t
-        length() const {
-            return m_length;
+        stripe_size() const {
+            return m_stripe_size;
+        }
+
+        uint32_t
+        stripe_start() const {
+            return m_stripe_start;
         }
 
         explicit
-        input(const rpc_trunc_in_t& other) :
+        input(const rpc_mk_node_in_t& other) :
                 m_path(other.path),
-                m_length(other.length) {}
+                m_mode(other.mode),
+                m_stripe_count(other.stripe_count),
+                m_stripe_size(other.stripe_size),
+                m_stripe_start(other.stripe_start) {}
 
         explicit
-        operator rpc_trunc_in_t() {
-            return {m_path.c_str(), m_length};
+        operator rpc_mk_node_in_t() {
+            return {m_path.c_str(), m_mode, m_stripe_count, m_stripe_size, m_stripe_start};
         }
 
     private:
         std::string m_path;
-        uint64_t m_length;
+        uint32_t m_mode;
+        uint32_t m_stripe_count;
+        uint64_t m_stripe_size;
+        uint32_t m_stripe_start;
     };
 
     class output {
@@ -707,8 +742,8 @@ struct decr_size {
 };
 
 //==============================================================================
-// definitions for update_metadentry
-struct update_metadentry {
+// definitions for stat
+struct stat {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -716,34 +751,34 @@ struct update_metadentry {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = update_metadentry;
+    using self_type = stat;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_update_metadentry_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_input_type = rpc_path_only_in_t;
+    using mercury_output_type = rpc_stat_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 99483648;
+    constexpr static const uint64_t public_id = 1396244480;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::update_metadentry;
+    constexpr static const auto name = gkfs::rpc::tag::stat;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_in_t);
+            HG_GEN_PROC_NAME(rpc_path_only_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_stat_out_t);
 
     class input {
 
@@ -751,40 +786,8 @@ struct update_metadentry {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              uint64_t nlink,
-              uint32_t mode,
-              uint32_t uid,
-              uint32_t gid,
-              int64_t size,
-              int64_t blocks,
-              int64_t atime,
-              int64_t mtime,
-              int64_t ctime,
-              bool nlink_flag,
-              bool mode_flag,
-              bool size_flag,
-              bool block_flag,
-              bool atime_flag,
-              bool mtime_flag,
-              bool ctime_flag) :
-                m_path(path),
-                m_nlink(nlink),
-                m_mode(mode),
-                m_uid(uid),
-                m_gid(gid),
-                m_size(size),
-                m_blocks(blocks),
-                m_atime(atime),
-                m_mtime(mtime),
-                m_ctime(ctime),
-                m_nlink_flag(nlink_flag),
-                m_mode_flag(mode_flag),
-                m_size_flag(size_flag),
-                m_block_flag(block_flag),
-                m_atime_flag(atime_flag),
-                m_mtime_flag(mtime_flag),
-                m_ctime_flag(ctime_flag) {}
+        input(const std::string& path) :
+                m_path(path) {}
 
         input(input&& rhs) = default;
 
@@ -799,145 +802,1380 @@ struct update_metadentry {
             return m_path;
         }
 
-        uint64_t
-        nlink() const {
-            return m_nlink;
-        }
+        explicit
+        input(const rpc_path_only_in_t& other) :
+                m_path(other.path) {}
 
-        uint32_t
-        mode() const {
-            return m_mode;
+        explicit
+        operator rpc_path_only_in_t() {
+            return {m_path.c_str()};
         }
 
-        uint32_t
+    private:
+        std::string m_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_db_val() {}
+
+        output(int32_t err, const std::string& db_val) :
+                m_err(err),
+                m_db_val(db_val) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_stat_out_t& out) {
+            m_err = out.err;
+
+            if (out.db_val != nullptr) {
+                m_db_val = out.db_val;
+            }
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        std::string
+        db_val() const {
+            return m_db_val;
+        }
+
+    private:
+        int32_t m_err;
+        std::string m_db_val;
+    };
+};
+
+//==============================================================================
+// definitions for remove
+struct remove {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = remove;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_rm_node_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2549415936;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::remove;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_rm_node_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path) :
+                m_path(path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        explicit
+        input(const rpc_rm_node_in_t& other) :
+                m_path(other.path) {}
+
+        explicit
+        operator rpc_rm_node_in_t() {
+            return {m_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for decr_size
+struct decr_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = decr_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 1291649024;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::decr_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, uint64_t length) :
+                m_path(path),
+                m_length(length) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        length() const {
+            return m_length;
+        }
+
+        explicit
+        input(const rpc_trunc_in_t& other) :
+                m_path(other.path),
+                m_length(other.length) {}
+
+        explicit
+        operator rpc_trunc_in_t() {
+            return {m_path.c_str(), m_length};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_length;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for update_metadentry
+struct update_metadentry {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = update_metadentry;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_update_metadentry_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 99483648;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::update_metadentry;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_update_metadentry_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              uint64_t nlink,
+              uint32_t mode,
+              uint32_t uid,
+              uint32_t gid,
+              int64_t size,
+              int64_t blocks,
+              int64_t atime,
+              int64_t mtime,
+              int64_t ctime,
+              bool nlink_flag,
+              bool mode_flag,
+              bool size_flag,
+              bool block_flag,
+              bool atime_flag,
+              bool mtime_flag,
+              bool ctime_flag) :
+                m_path(path),
+                m_nlink(nlink),
+                m_mode(mode),
+                m_uid(uid),
+                m_gid(gid),
+                m_size(size),
+                m_blocks(blocks),
+                m_atime(atime),
+                m_mtime(mtime),
+                m_ctime(ctime),
+                m_nlink_flag(nlink_flag),
+                m_mode_flag(mode_flag),
+                m_size_flag(size_flag),
+                m_block_flag(block_flag),
+                m_atime_flag(atime_flag),
+                m_mtime_flag(mtime_flag),
+                m_ctime_flag(ctime_flag) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        nlink() const {
+            return m_nlink;
+        }
+
+        uint32_t
+        mode() const {
+            return m_mode;
+        }
+
+        uint32_t
         uid() const {
             return m_uid;
         }
 
         uint32_t
-        gid() const {
-            return m_gid;
+        gid() const {
+            return m_gid;
+        }
+
+        int64_t
+        size() const {
+            return m_size;
+        }
+
+        int64_t
+        blocks() const {
+            return m_blocks;
+        }
+
+        int64_t
+        atime() const {
+            return m_atime;
+        }
+
+        int64_t
+        mtime() const {
+            return m_mtime;
+        }
+
+        int64_t
+        ctime() const {
+            return m_ctime;
+        }
+
+        bool
+        nlink_flag() const {
+            return m_nlink_flag;
+        }
+
+        bool
+        mode_flag() const {
+            return m_mode_flag;
+        }
+
+        bool
+        size_flag() const {
+            return m_size_flag;
+        }
+
+        bool
+        block_flag() const {
+            return m_block_flag;
+        }
+
+        bool
+        atime_flag() const {
+            return m_atime_flag;
+        }
+
+        bool
+        mtime_flag() const {
+            return m_mtime_flag;
+        }
+
+        bool
+        ctime_flag() const {
+            return m_ctime_flag;
+        }
+
+        explicit
+        input(const rpc_update_metadentry_in_t& other) :
+                m_path(other.path),
+                m_nlink(other.nlink),
+                m_mode(other.mode),
+                m_uid(other.uid),
+                m_gid(other.gid),
+                m_size(other.size),
+                m_blocks(other.blocks),
+                m_atime(other.atime),
+                m_mtime(other.mtime),
+                m_ctime(other.ctime),
+                m_nlink_flag(other.nlink_flag),
+                m_mode_flag(other.mode_flag),
+                m_size_flag(other.size_flag),
+                m_block_flag(other.block_flag),
+                m_atime_flag(other.atime_flag),
+                m_mtime_flag(other.mtime_flag),
+                m_ctime_flag(other.ctime_flag) {}
+
+        explicit
+        operator rpc_update_metadentry_in_t() {
+            return {m_path.c_str(),
+                    m_nlink,
+                    m_mode,
+                    m_uid,
+                    m_gid,
+                    m_size,
+                    m_blocks,
+                    m_atime,
+                    m_mtime,
+                    m_ctime,
+                    m_nlink_flag,
+                    m_mode_flag,
+                    m_size_flag,
+                    m_block_flag,
+                    m_atime_flag,
+                    m_mtime_flag,
+                    m_ctime_flag};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_nlink;
+        uint32_t m_mode;
+        uint32_t m_uid;
+        uint32_t m_gid;
+        int64_t m_size;
+        int64_t m_blocks;
+        int64_t m_atime;
+        int64_t m_mtime;
+        int64_t m_ctime;
+        bool m_nlink_flag;
+        bool m_mode_flag;
+        bool m_size_flag;
+        bool m_block_flag;
+        bool m_atime_flag;
+        bool m_mtime_flag;
+        bool m_ctime_flag;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for get_metadentry_size
+struct get_metadentry_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = get_metadentry_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_path_only_in_t;
+    using mercury_output_type = rpc_get_metadentry_size_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3426484224;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::get_metadentry_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_get_metadentry_size_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path) :
+                m_path(path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        explicit
+        input(const rpc_path_only_in_t& other) :
+                m_path(other.path) {}
+
+        explicit
+        operator rpc_path_only_in_t() {
+            return {m_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_ret_size() {}
+
+        output(int32_t err, int64_t ret_size) :
+                m_err(err),
+                m_ret_size(ret_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_get_metadentry_size_out_t& out) {
+            m_err = out.err;
+            m_ret_size = out.ret_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        ret_size() const {
+            return m_ret_size;
+        }
+
+    private:
+        int32_t m_err;
+        int64_t m_ret_size;
+    };
+};
+
+//==============================================================================
+// definitions for update_metadentry_size
+struct update_metadentry_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = update_metadentry_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_update_metadentry_size_in_t;
+    using mercury_output_type = rpc_update_metadentry_size_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2760900608;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::update_metadentry_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_update_metadentry_size_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_update_metadentry_size_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              uint64_t size,
+              int64_t offset,
+              bool append) :
+                m_path(path),
+                m_size(size),
+                m_offset(offset),
+                m_append(append) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        size() const {
+            return m_size;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        bool
+        append() const {
+            return m_append;
+        }
+
+        explicit
+        input(const rpc_update_metadentry_size_in_t& other) :
+                m_path(other.path),
+                m_size(other.size),
+                m_offset(other.offset),
+                m_append(other.append) {}
+
+        explicit
+        operator rpc_update_metadentry_size_in_t() {
+            return {m_path.c_str(), m_size, m_offset, m_append};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_size;
+        int64_t m_offset;
+        bool m_append;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_ret_size() {}
+
+        output(int32_t err, int64_t ret_size) :
+                m_err(err),
+                m_ret_size(ret_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_update_metadentry_size_out_t& out) {
+            m_err = out.err;
+            m_ret_size = out.ret_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        ret_size() const {
+            return m_ret_size;
+        }
+
+    private:
+        int32_t m_err;
+        int64_t m_ret_size;
+    };
+};
+
+#ifdef HAS_SYMLINKS
+
+//==============================================================================
+// definitions for mk_symlink
+struct mk_symlink {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = mk_symlink;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_mk_symlink_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3207004160;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::mk_symlink;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_mk_symlink_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              const std::string& target_path) :
+                m_path(path),
+                m_target_path(target_path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        std::string
+        target_path() const {
+            return m_target_path;
+        }
+
+        explicit
+        input(const rpc_mk_symlink_in_t& other) :
+                m_path(other.path),
+                m_target_path(other.target_path) {}
+
+        explicit
+        operator rpc_mk_symlink_in_t() {
+            return {m_path.c_str(), m_target_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+        std::string m_target_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+#endif // HAS_SYMLINKS
+
+//==============================================================================
+// definitions for write_data
+struct write_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = write_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_write_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3716481024;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::write;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_write_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              uint32_t stripe_count,
+              uint64_t stripe_size,
+              uint32_t stripe_start,
+              const std::string& job_id,
+              const hermes::exposed_memory& buffers) :
+                m_path(path),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_stripe_count(stripe_count),
+                m_stripe_size(stripe_size),
+                m_stripe_start(stripe_start),
+                m_job_id(job_id),
+                m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
+        }
+
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
+        }
+
+        uint32_t
+        stripe_count() const {
+            return m_stripe_count;
         }
 
-        int64_t
-        size() const {
-            return m_size;
+        uint64_t
+        stripe_size() const {
+            return m_stripe_size;
         }
 
-        int64_t
-        blocks() const {
-            return m_blocks;
+        uint32_t
+        stripe_start() const {
+            return m_stripe_start;
         }
 
-        int64_t
-        atime() const {
-            return m_atime;
+        std::string
+        job_id() const {
+            return m_job_id;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit
+        input(const rpc_write_data_in_t& other) :
+                m_path(other.path),
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_stripe_count(other.stripe_count),
+                m_stripe_size(other.stripe_size),
+                m_stripe_start(other.stripe_start),
+                m_job_id(other.job_id),
+                m_buffers(other.bulk_handle) {}
+
+        explicit
+        operator rpc_write_data_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    m_stripe_count,
+                    m_stripe_size,
+                    m_stripe_start,
+                    m_job_id.c_str(),
+                    hg_bulk_t(m_buffers)
+            };
+        }
+
+    private:
+        std::string m_path;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        uint32_t m_stripe_count;
+        uint64_t m_stripe_size;
+        uint32_t m_stripe_start;
+        std::string m_job_id;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_io_size() {}
+
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
         }
 
         int64_t
-        mtime() const {
-            return m_mtime;
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for read_data
+struct read_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = read_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_read_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 892207104;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::read;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_read_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              uint32_t stripe_count,
+              uint64_t stripe_size,
+              uint32_t stripe_start,
+              const std::string& job_id,
+              const hermes::exposed_memory& buffers) :
+                m_path(path),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_stripe_count(stripe_count),
+                m_stripe_size(stripe_size),
+                m_stripe_start(stripe_start),
+                m_job_id(job_id),
+                m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
         }
 
         int64_t
-        ctime() const {
-            return m_ctime;
+        offset() const {
+            return m_offset;
         }
 
-        bool
-        nlink_flag() const {
-            return m_nlink_flag;
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
         }
 
-        bool
-        mode_flag() const {
-            return m_mode_flag;
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
         }
 
-        bool
-        size_flag() const {
-            return m_size_flag;
+        uint32_t
+        stripe_count() const {
+            return m_stripe_count;
         }
 
-        bool
-        block_flag() const {
-            return m_block_flag;
+        uint64_t
+        stripe_size() const {
+            return m_stripe_size;
         }
 
-        bool
-        atime_flag() const {
-            return m_atime_flag;
+        uint32_t
+        stripe_start() const {
+            return m_stripe_start;
         }
 
-        bool
-        mtime_flag() const {
-            return m_mtime_flag;
+        std::string
+        job_id() const {
+            return m_job_id;
         }
 
-        bool
-        ctime_flag() const {
-            return m_ctime_flag;
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
         }
 
         explicit
-        input(const rpc_update_metadentry_in_t& other) :
+        input(const rpc_read_data_in_t& other) :
                 m_path(other.path),
-                m_nlink(other.nlink),
-                m_mode(other.mode),
-                m_uid(other.uid),
-                m_gid(other.gid),
-                m_size(other.size),
-                m_blocks(other.blocks),
-                m_atime(other.atime),
-                m_mtime(other.mtime),
-                m_ctime(other.ctime),
-                m_nlink_flag(other.nlink_flag),
-                m_mode_flag(other.mode_flag),
-                m_size_flag(other.size_flag),
-                m_block_flag(other.block_flag),
-                m_atime_flag(other.atime_flag),
-                m_mtime_flag(other.mtime_flag),
-                m_ctime_flag(other.ctime_flag) {}
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_stripe_count(other.stripe_count),
+                m_stripe_size(other.stripe_size),
+                m_stripe_start(other.stripe_start),
+                m_job_id(other.job_id),
+                m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_update_metadentry_in_t() {
-            return {m_path.c_str(),
-                    m_nlink,
-                    m_mode,
-                    m_uid,
-                    m_gid,
-                    m_size,
-                    m_blocks,
-                    m_atime,
-                    m_mtime,
-                    m_ctime,
-                    m_nlink_flag,
-                    m_mode_flag,
-                    m_size_flag,
-                    m_block_flag,
-                    m_atime_flag,
-                    m_mtime_flag,
-                    m_ctime_flag};
+        operator rpc_read_data_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    m_stripe_count,
+                    m_stripe_size,
+                    m_stripe_start,
+                    m_job_id.c_str(),
+                    hg_bulk_t(m_buffers)
+            };
         }
 
     private:
         std::string m_path;
-        uint64_t m_nlink;
-        uint32_t m_mode;
-        uint32_t m_uid;
-        uint32_t m_gid;
-        int64_t m_size;
-        int64_t m_blocks;
-        int64_t m_atime;
-        int64_t m_mtime;
-        int64_t m_ctime;
-        bool m_nlink_flag;
-        bool m_mode_flag;
-        bool m_size_flag;
-        bool m_block_flag;
-        bool m_atime_flag;
-        bool m_mtime_flag;
-        bool m_ctime_flag;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        uint32_t m_stripe_count;
+        uint64_t m_stripe_size;
+        uint32_t m_stripe_start;
+        std::string m_job_id;
+        hermes::exposed_memory m_buffers;
     };
 
     class output {
@@ -947,10 +2185,12 @@ struct update_metadentry {
 
     public:
         output() :
-                m_err() {}
+                m_err(),
+                m_io_size() {}
 
-        output(int32_t err) :
-                m_err(err) {}
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
 
         output(output&& rhs) = default;
 
@@ -961,8 +2201,9 @@ struct update_metadentry {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_data_out_t& out) {
             m_err = out.err;
+            m_io_size = out.io_size;
         }
 
         int32_t
@@ -970,14 +2211,20 @@ struct update_metadentry {
             return m_err;
         }
 
+        int64_t
+        io_size() const {
+            return m_io_size;
+        }
+
     private:
         int32_t m_err;
+        size_t m_io_size;
     };
 };
 
 //==============================================================================
-// definitions for get_metadentry_size
-struct get_metadentry_size {
+// definitions for trunc_data
+struct trunc_data {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -985,34 +2232,34 @@ struct get_metadentry_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = get_metadentry_size;
+    using self_type = trunc_data;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_path_only_in_t;
-    using mercury_output_type = rpc_get_metadentry_size_out_t;
+    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3426484224;
+    constexpr static const uint64_t public_id = 1850933248;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_metadentry_size;
+    constexpr static const auto name = gkfs::rpc::tag::truncate;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+            HG_GEN_PROC_NAME(rpc_trunc_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_get_metadentry_size_out_t);
+            HG_GEN_PROC_NAME(rpc_err_out_t);
 
     class input {
 
@@ -1020,8 +2267,10 @@ struct get_metadentry_size {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path) :
-                m_path(path) {}
+        input(const std::string& path,
+              uint64_t length) :
+                m_path(path),
+                m_length(length) {}
 
         input(input&& rhs) = default;
 
@@ -1036,17 +2285,27 @@ struct get_metadentry_size {
             return m_path;
         }
 
+        uint64_t
+        length() const {
+            return m_length;
+        }
+
         explicit
-        input(const rpc_path_only_in_t& other) :
-                m_path(other.path) {}
+        input(const rpc_trunc_in_t& other) :
+                m_path(other.path),
+                m_length(other.length) {}
 
         explicit
-        operator rpc_path_only_in_t() {
-            return {m_path.c_str()};
+        operator rpc_trunc_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_length,
+            };
         }
 
     private:
         std::string m_path;
+        uint64_t m_length;
     };
 
     class output {
@@ -1056,12 +2315,10 @@ struct get_metadentry_size {
 
     public:
         output() :
-                m_err(),
-                m_ret_size() {}
+                m_err() {}
 
-        output(int32_t err, int64_t ret_size) :
-                m_err(err),
-                m_ret_size(ret_size) {}
+        output(int32_t err) :
+                m_err(err) {}
 
         output(output&& rhs) = default;
 
@@ -1072,9 +2329,8 @@ struct get_metadentry_size {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_get_metadentry_size_out_t& out) {
+        output(const rpc_err_out_t& out) {
             m_err = out.err;
-            m_ret_size = out.ret_size;
         }
 
         int32_t
@@ -1082,20 +2338,14 @@ struct get_metadentry_size {
             return m_err;
         }
 
-        int64_t
-        ret_size() const {
-            return m_ret_size;
-        }
-
     private:
         int32_t m_err;
-        int64_t m_ret_size;
     };
 };
 
 //==============================================================================
-// definitions for update_metadentry_size
-struct update_metadentry_size {
+// definitions for get_dirents
+struct get_dirents {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1103,34 +2353,34 @@ struct update_metadentry_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = update_metadentry_size;
+    using self_type = get_dirents;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_update_metadentry_size_in_t;
-    using mercury_output_type = rpc_update_metadentry_size_out_t;
+    using mercury_input_type = rpc_get_dirents_in_t;
+    using mercury_output_type = rpc_get_dirents_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 2760900608;
+    constexpr static const uint64_t public_id = 4121034752;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::update_metadentry_size;
+    constexpr static const auto name = gkfs::rpc::tag::get_dirents;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_size_in_t);
+            HG_GEN_PROC_NAME(rpc_get_dirents_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_size_out_t);
+            HG_GEN_PROC_NAME(rpc_get_dirents_out_t);
 
     class input {
 
@@ -1139,13 +2389,9 @@ struct update_metadentry_size {
 
     public:
         input(const std::string& path,
-              uint64_t size,
-              int64_t offset,
-              bool append) :
+              const hermes::exposed_memory& buffers) :
                 m_path(path),
-                m_size(size),
-                m_offset(offset),
-                m_append(append) {}
+                m_buffers(buffers) {}
 
         input(input&& rhs) = default;
 
@@ -1160,38 +2406,27 @@ struct update_metadentry_size {
             return m_path;
         }
 
-        uint64_t
-        size() const {
-            return m_size;
-        }
-
-        int64_t
-        offset() const {
-            return m_offset;
-        }
-
-        bool
-        append() const {
-            return m_append;
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
         }
 
         explicit
-        input(const rpc_update_metadentry_size_in_t& other) :
+        input(const rpc_get_dirents_in_t& other) :
                 m_path(other.path),
-                m_size(other.size),
-                m_offset(other.offset),
-                m_append(other.append) {}
+                m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_update_metadentry_size_in_t() {
-            return {m_path.c_str(), m_size, m_offset, m_append};
+        operator rpc_get_dirents_in_t() {
+            return {
+                    m_path.c_str(),
+                    hg_bulk_t(m_buffers)
+            };
         }
 
     private:
         std::string m_path;
-        uint64_t m_size;
-        int64_t m_offset;
-        bool m_append;
+        hermes::exposed_memory m_buffers;
     };
 
     class output {
@@ -1202,11 +2437,11 @@ struct update_metadentry_size {
     public:
         output() :
                 m_err(),
-                m_ret_size() {}
+                m_dirents_size() {}
 
-        output(int32_t err, int64_t ret_size) :
+        output(int32_t err, size_t dirents_size) :
                 m_err(err),
-                m_ret_size(ret_size) {}
+                m_dirents_size(dirents_size) {}
 
         output(output&& rhs) = default;
 
@@ -1217,9 +2452,9 @@ struct update_metadentry_size {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_update_metadentry_size_out_t& out) {
+        output(const rpc_get_dirents_out_t& out) {
             m_err = out.err;
-            m_ret_size = out.ret_size;
+            m_dirents_size = out.dirents_size;
         }
 
         int32_t
@@ -1227,22 +2462,20 @@ struct update_metadentry_size {
             return m_err;
         }
 
-        int64_t
-        ret_size() const {
-            return m_ret_size;
+        size_t
+        dirents_size() const {
+            return m_dirents_size;
         }
 
     private:
         int32_t m_err;
-        int64_t m_ret_size;
+        size_t m_dirents_size;
     };
 };
 
-#ifdef HAS_SYMLINKS
-
 //==============================================================================
-// definitions for mk_symlink
-struct mk_symlink {
+// definitions for chunk_stat
+struct chunk_stat {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1250,34 +2483,34 @@ struct mk_symlink {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = mk_symlink;
+    using self_type = chunk_stat;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_mk_symlink_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_input_type = rpc_chunk_stat_in_t;
+    using mercury_output_type = rpc_chunk_stat_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3207004160;
+    constexpr static const uint64_t public_id = 532742144;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::mk_symlink;
+    constexpr static const auto name = gkfs::rpc::tag::get_chunk_stat;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_mk_symlink_in_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_out_t);
 
     class input {
 
@@ -1285,10 +2518,8 @@ struct mk_symlink {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              const std::string& target_path) :
-                m_path(path),
-                m_target_path(target_path) {}
+        input(int32_t dummy) :
+                m_dummy(dummy) {}
 
         input(input&& rhs) = default;
 
@@ -1298,29 +2529,22 @@ struct mk_symlink {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
-        }
-
-        std::string
-        target_path() const {
-            return m_target_path;
+        int32_t
+        dummy() const {
+            return m_dummy;
         }
 
         explicit
-        input(const rpc_mk_symlink_in_t& other) :
-                m_path(other.path),
-                m_target_path(other.target_path) {}
+        input(const rpc_chunk_stat_in_t& other) :
+                m_dummy(other.dummy) {}
 
         explicit
-        operator rpc_mk_symlink_in_t() {
-            return {m_path.c_str(), m_target_path.c_str()};
+        operator rpc_chunk_stat_in_t() {
+            return {m_dummy};
         }
 
     private:
-        std::string m_path;
-        std::string m_target_path;
+        int32_t m_dummy;
     };
 
     class output {
@@ -1330,10 +2554,16 @@ struct mk_symlink {
 
     public:
         output() :
-                m_err() {}
+                m_err(),
+                m_chunk_size(),
+                m_chunk_total(),
+                m_chunk_free() {}
 
-        output(int32_t err) :
-                m_err(err) {}
+        output(int32_t err, uint64_t chunk_size, uint64_t chunk_total, uint64_t chunk_free) :
+                m_err(err),
+                m_chunk_size(chunk_size),
+                m_chunk_total(chunk_total),
+                m_chunk_free(chunk_free) {}
 
         output(output&& rhs) = default;
 
@@ -1344,8 +2574,11 @@ struct mk_symlink {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_chunk_stat_out_t& out) {
             m_err = out.err;
+            m_chunk_size = out.chunk_size;
+            m_chunk_total = out.chunk_total;
+            m_chunk_free = out.chunk_free;
         }
 
         int32_t
@@ -1353,16 +2586,32 @@ struct mk_symlink {
             return m_err;
         }
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        uint64_t
+        chunk_total() const {
+            return m_chunk_total;
+        }
+
+        uint64_t
+        chunk_free() const {
+            return m_chunk_free;
+        }
+
     private:
         int32_t m_err;
+        uint64_t m_chunk_size;
+        uint64_t m_chunk_total;
+        uint64_t m_chunk_free;
     };
 };
 
-#endif // HAS_SYMLINKS
-
 //==============================================================================
-// definitions for write_data
-struct write_data {
+// definitions for create_batch
+struct create_batch {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1370,34 +2619,34 @@ struct write_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = write_data;
+    using self_type = create_batch;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_write_data_in_t;
-    using mercury_output_type = rpc_data_out_t;
+    using mercury_input_type = rpc_mk_node_batch_in_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3716481024;
+    constexpr static const uint64_t public_id = 1310457856;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::write;
+    constexpr static const auto name = gkfs::rpc::tag::create_batch;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_write_data_in_t);
+            HG_GEN_PROC_NAME(rpc_mk_node_batch_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_data_out_t);
+            HG_GEN_PROC_NAME(rpc_err_out_t);
 
     class input {
 
@@ -1405,23 +2654,19 @@ struct write_data {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              int64_t offset,
-              uint64_t host_id,
-              uint64_t host_size,
-              uint64_t chunk_n,
-              uint64_t chunk_start,
-              uint64_t chunk_end,
-              uint64_t total_chunk_size,
+        input(uint64_t count,
+              uint64_t paths_size,
+              uint32_t mode,
+              uint32_t stripe_count,
+              uint64_t stripe_size,
+              uint32_t stripe_start,
               const hermes::exposed_memory& buffers) :
-                m_path(path),
-                m_offset(offset),
-                m_host_id(host_id),
-                m_host_size(host_size),
-                m_chunk_n(chunk_n),
-                m_chunk_start(chunk_start),
-                m_chunk_end(chunk_end),
-                m_total_chunk_size(total_chunk_size),
+                m_count(count),
+                m_paths_size(paths_size),
+                m_mode(mode),
+                m_stripe_count(stripe_count),
+                m_stripe_size(stripe_size),
+                m_stripe_start(stripe_start),
                 m_buffers(buffers) {}
 
         input(input&& rhs) = default;
@@ -1432,44 +2677,34 @@ struct write_data {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
-        }
-
-        int64_t
-        offset() const {
-            return m_offset;
-        }
-
         uint64_t
-        host_id() const {
-            return m_host_id;
+        count() const {
+            return m_count;
         }
 
         uint64_t
-        host_size() const {
-            return m_host_size;
+        paths_size() const {
+            return m_paths_size;
         }
 
-        uint64_t
-        chunk_n() const {
-            return m_chunk_n;
+        uint32_t
+        mode() const {
+            return m_mode;
         }
 
-        uint64_t
-        chunk_start() const {
-            return m_chunk_start;
+        uint32_t
+        stripe_count() const {
+            return m_stripe_count;
         }
 
         uint64_t
-        chunk_end() const {
-            return m_chunk_end;
+        stripe_size() const {
+            return m_stripe_size;
         }
 
-        uint64_t
-        total_chunk_size() const {
-            return m_total_chunk_size;
+        uint32_t
+        stripe_start() const {
+            return m_stripe_start;
         }
 
         hermes::exposed_memory
@@ -1478,41 +2713,35 @@ struct write_data {
         }
 
         explicit
-        input(const rpc_write_data_in_t& other) :
-                m_path(other.path),
-                m_offset(other.offset),
-                m_host_id(other.host_id),
-                m_host_size(other.host_size),
-                m_chunk_n(other.chunk_n),
-                m_chunk_start(other.chunk_start),
-                m_chunk_end(other.chunk_end),
-                m_total_chunk_size(other.total_chunk_size),
+        input(const rpc_mk_node_batch_in_t& other) :
+                m_count(other.count),
+                m_paths_size(other.paths_size),
+                m_mode(other.mode),
+                m_stripe_count(other.stripe_count),
+                m_stripe_size(other.stripe_size),
+                m_stripe_start(other.stripe_start),
                 m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_write_data_in_t() {
+        operator rpc_mk_node_batch_in_t() {
             return {
-                    m_path.c_str(),
-                    m_offset,
-                    m_host_id,
-                    m_host_size,
-                    m_chunk_n,
-                    m_chunk_start,
-                    m_chunk_end,
-                    m_total_chunk_size,
+                    m_count,
+                    m_paths_size,
+                    m_mode,
+                    m_stripe_count,
+                    m_stripe_size,
+                    m_stripe_start,
                     hg_bulk_t(m_buffers)
             };
         }
 
     private:
-        std::string m_path;
-        int64_t m_offset;
-        uint64_t m_host_id;
-        uint64_t m_host_size;
-        uint64_t m_chunk_n;
-        uint64_t m_chunk_start;
-        uint64_t m_chunk_end;
-        uint64_t m_total_chunk_size;
+        uint64_t m_count;
+        uint64_t m_paths_size;
+        uint32_t m_mode;
+        uint32_t m_stripe_count;
+        uint64_t m_stripe_size;
+        uint32_t m_stripe_start;
         hermes::exposed_memory m_buffers;
     };
 
@@ -1523,12 +2752,10 @@ struct write_data {
 
     public:
         output() :
-                m_err(),
-                m_io_size() {}
+                m_err() {}
 
-        output(int32_t err, size_t io_size) :
-                m_err(err),
-                m_io_size(io_size) {}
+        output(int32_t err) :
+                m_err(err) {}
 
         output(output&& rhs) = default;
 
@@ -1539,9 +2766,8 @@ struct write_data {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_data_out_t& out) {
+        output(const rpc_err_out_t& out) {
             m_err = out.err;
-            m_io_size = out.io_size;
         }
 
         int32_t
@@ -1549,20 +2775,14 @@ struct write_data {
             return m_err;
         }
 
-        int64_t
-        io_size() const {
-            return m_io_size;
-        }
-
     private:
         int32_t m_err;
-        size_t m_io_size;
     };
 };
 
 //==============================================================================
-// definitions for read_data
-struct read_data {
+// definitions for stat_batch
+struct stat_batch {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1570,34 +2790,34 @@ struct read_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = read_data;
+    using self_type = stat_batch;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_read_data_in_t;
-    using mercury_output_type = rpc_data_out_t;
+    using mercury_input_type = rpc_batch_in_t;
+    using mercury_output_type = rpc_batch_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 892207104;
+    constexpr static const uint64_t public_id = 3439722496;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::read;
+    constexpr static const auto name = gkfs::rpc::tag::stat_batch;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_read_data_in_t);
+            HG_GEN_PROC_NAME(rpc_batch_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_data_out_t);
+            HG_GEN_PROC_NAME(rpc_batch_out_t);
 
     class input {
 
@@ -1605,23 +2825,11 @@ struct read_data {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              int64_t offset,
-              uint64_t host_id,
-              uint64_t host_size,
-              uint64_t chunk_n,
-              uint64_t chunk_start,
-              uint64_t chunk_end,
-              uint64_t total_chunk_size,
+        input(uint64_t count,
+              uint64_t paths_size,
               const hermes::exposed_memory& buffers) :
-                m_path(path),
-                m_offset(offset),
-                m_host_id(host_id),
-                m_host_size(host_size),
-                m_chunk_n(chunk_n),
-                m_chunk_start(chunk_start),
-                m_chunk_end(chunk_end),
-                m_total_chunk_size(total_chunk_size),
+                m_count(count),
+                m_paths_size(paths_size),
                 m_buffers(buffers) {}
 
         input(input&& rhs) = default;
@@ -1630,46 +2838,16 @@ struct read_data {
 
         input& operator=(input&& rhs) = default;
 
-        input& operator=(const input& other) = default;
-
-        std::string
-        path() const {
-            return m_path;
-        }
-
-        int64_t
-        offset() const {
-            return m_offset;
-        }
-
-        uint64_t
-        host_id() const {
-            return m_host_id;
-        }
-
-        uint64_t
-        host_size() const {
-            return m_host_size;
-        }
-
-        uint64_t
-        chunk_n() const {
-            return m_chunk_n;
-        }
-
-        uint64_t
-        chunk_start() const {
-            return m_chunk_start;
-        }
+        input& operator=(const input& other) = default;
 
         uint64_t
-        chunk_end() const {
-            return m_chunk_end;
+        count() const {
+            return m_count;
         }
 
         uint64_t
-        total_chunk_size() const {
-            return m_total_chunk_size;
+        paths_size() const {
+            return m_paths_size;
         }
 
         hermes::exposed_memory
@@ -1678,41 +2856,23 @@ struct read_data {
         }
 
         explicit
-        input(const rpc_read_data_in_t& other) :
-                m_path(other.path),
-                m_offset(other.offset),
-                m_host_id(other.host_id),
-                m_host_size(other.host_size),
-                m_chunk_n(other.chunk_n),
-                m_chunk_start(other.chunk_start),
-                m_chunk_end(other.chunk_end),
-                m_total_chunk_size(other.total_chunk_size),
+        input(const rpc_batch_in_t& other) :
+                m_count(other.count),
+                m_paths_size(other.paths_size),
                 m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_read_data_in_t() {
+        operator rpc_batch_in_t() {
             return {
-                    m_path.c_str(),
-                    m_offset,
-                    m_host_id,
-                    m_host_size,
-                    m_chunk_n,
-                    m_chunk_start,
-                    m_chunk_end,
-                    m_total_chunk_size,
+                    m_count,
+                    m_paths_size,
                     hg_bulk_t(m_buffers)
             };
         }
 
     private:
-        std::string m_path;
-        int64_t m_offset;
-        uint64_t m_host_id;
-        uint64_t m_host_size;
-        uint64_t m_chunk_n;
-        uint64_t m_chunk_start;
-        uint64_t m_chunk_end;
-        uint64_t m_total_chunk_size;
+        uint64_t m_count;
+        uint64_t m_paths_size;
         hermes::exposed_memory m_buffers;
     };
 
@@ -1724,11 +2884,11 @@ struct read_data {
     public:
         output() :
                 m_err(),
-                m_io_size() {}
+                m_out_size() {}
 
-        output(int32_t err, size_t io_size) :
+        output(int32_t err, size_t out_size) :
                 m_err(err),
-                m_io_size(io_size) {}
+                m_out_size(out_size) {}
 
         output(output&& rhs) = default;
 
@@ -1739,9 +2899,9 @@ struct read_data {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_data_out_t& out) {
+        output(const rpc_batch_out_t& out) {
             m_err = out.err;
-            m_io_size = out.io_size;
+            m_out_size = out.out_size;
         }
 
         int32_t
@@ -1749,20 +2909,20 @@ struct read_data {
             return m_err;
         }
 
-        int64_t
-        io_size() const {
-            return m_io_size;
+        size_t
+        out_size() const {
+            return m_out_size;
         }
 
     private:
         int32_t m_err;
-        size_t m_io_size;
+        size_t m_out_size;
     };
 };
 
 //==============================================================================
-// definitions for trunc_data
-struct trunc_data {
+// definitions for remove_batch
+struct remove_batch {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1770,30 +2930,30 @@ struct trunc_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = trunc_data;
+    using self_type = remove_batch;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_input_type = rpc_batch_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 1850933248;
+    constexpr static const uint64_t public_id = 4237950976;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::truncate;
+    constexpr static const auto name = gkfs::rpc::tag::remove_batch;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+            HG_GEN_PROC_NAME(rpc_batch_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -1805,10 +2965,12 @@ struct trunc_data {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              uint64_t length) :
-                m_path(path),
-                m_length(length) {}
+        input(uint64_t count,
+              uint64_t paths_size,
+              const hermes::exposed_memory& buffers) :
+                m_count(count),
+                m_paths_size(paths_size),
+                m_buffers(buffers) {}
 
         input(input&& rhs) = default;
 
@@ -1818,32 +2980,40 @@ struct trunc_data {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
+        uint64_t
+        count() const {
+            return m_count;
         }
 
         uint64_t
-        length() const {
-            return m_length;
+        paths_size() const {
+            return m_paths_size;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
         }
 
         explicit
-        input(const rpc_trunc_in_t& other) :
-                m_path(other.path),
-                m_length(other.length) {}
+        input(const rpc_batch_in_t& other) :
+                m_count(other.count),
+                m_paths_size(other.paths_size),
+                m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_trunc_in_t() {
+        operator rpc_batch_in_t() {
             return {
-                    m_path.c_str(),
-                    m_length,
+                    m_count,
+                    m_paths_size,
+                    hg_bulk_t(m_buffers)
             };
         }
 
     private:
-        std::string m_path;
-        uint64_t m_length;
+        uint64_t m_count;
+        uint64_t m_paths_size;
+        hermes::exposed_memory m_buffers;
     };
 
     class output {
@@ -1882,8 +3052,8 @@ struct trunc_data {
 };
 
 //==============================================================================
-// definitions for get_dirents
-struct get_dirents {
+// definitions for chunk_stat_tree
+struct chunk_stat_tree {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1891,34 +3061,34 @@ struct get_dirents {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = get_dirents;
+    using self_type = chunk_stat_tree;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_get_dirents_in_t;
-    using mercury_output_type = rpc_get_dirents_out_t;
+    using mercury_input_type = rpc_chunk_stat_tree_in_t;
+    using mercury_output_type = rpc_chunk_stat_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 4121034752;
+    constexpr static const uint64_t public_id = 559349760;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_dirents;
+    constexpr static const auto name = gkfs::rpc::tag::get_chunk_stat_tree;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_get_dirents_in_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_tree_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_get_dirents_out_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_out_t);
 
     class input {
 
@@ -1926,10 +3096,12 @@ struct get_dirents {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              const hermes::exposed_memory& buffers) :
-                m_path(path),
-                m_buffers(buffers) {}
+        input(uint64_t first_host,
+              uint64_t last_host,
+              uint32_t fanout) :
+                m_first_host(first_host),
+                m_last_host(last_host),
+                m_fanout(fanout) {}
 
         input(input&& rhs) = default;
 
@@ -1939,32 +3111,40 @@ struct get_dirents {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
+        uint64_t
+        first_host() const {
+            return m_first_host;
         }
 
-        hermes::exposed_memory
-        buffers() const {
-            return m_buffers;
+        uint64_t
+        last_host() const {
+            return m_last_host;
+        }
+
+        uint32_t
+        fanout() const {
+            return m_fanout;
         }
 
         explicit
-        input(const rpc_get_dirents_in_t& other) :
-                m_path(other.path),
-                m_buffers(other.bulk_handle) {}
+        input(const rpc_chunk_stat_tree_in_t& other) :
+                m_first_host(other.first_host),
+                m_last_host(other.last_host),
+                m_fanout(other.fanout) {}
 
         explicit
-        operator rpc_get_dirents_in_t() {
+        operator rpc_chunk_stat_tree_in_t() {
             return {
-                    m_path.c_str(),
-                    hg_bulk_t(m_buffers)
+                    m_first_host,
+                    m_last_host,
+                    m_fanout
             };
         }
 
     private:
-        std::string m_path;
-        hermes::exposed_memory m_buffers;
+        uint64_t m_first_host;
+        uint64_t m_last_host;
+        uint32_t m_fanout;
     };
 
     class output {
@@ -1975,11 +3155,15 @@ struct get_dirents {
     public:
         output() :
                 m_err(),
-                m_dirents_size() {}
+                m_chunk_size(),
+                m_chunk_total(),
+                m_chunk_free() {}
 
-        output(int32_t err, size_t dirents_size) :
+        output(int32_t err, uint64_t chunk_size, uint64_t chunk_total, uint64_t chunk_free) :
                 m_err(err),
-                m_dirents_size(dirents_size) {}
+                m_chunk_size(chunk_size),
+                m_chunk_total(chunk_total),
+                m_chunk_free(chunk_free) {}
 
         output(output&& rhs) = default;
 
@@ -1990,9 +3174,11 @@ struct get_dirents {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_get_dirents_out_t& out) {
+        output(const rpc_chunk_stat_out_t& out) {
             m_err = out.err;
-            m_dirents_size = out.dirents_size;
+            m_chunk_size = out.chunk_size;
+            m_chunk_total = out.chunk_total;
+            m_chunk_free = out.chunk_free;
         }
 
         int32_t
@@ -2000,20 +3186,32 @@ struct get_dirents {
             return m_err;
         }
 
-        size_t
-        dirents_size() const {
-            return m_dirents_size;
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        uint64_t
+        chunk_total() const {
+            return m_chunk_total;
+        }
+
+        uint64_t
+        chunk_free() const {
+            return m_chunk_free;
         }
 
     private:
         int32_t m_err;
-        size_t m_dirents_size;
+        uint64_t m_chunk_size;
+        uint64_t m_chunk_total;
+        uint64_t m_chunk_free;
     };
 };
 
 //==============================================================================
-// definitions for chunk_stat
-struct chunk_stat {
+// definitions for copy_chunks
+struct copy_chunks {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -2021,34 +3219,34 @@ struct chunk_stat {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = chunk_stat;
+    using self_type = copy_chunks;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_chunk_stat_in_t;
-    using mercury_output_type = rpc_chunk_stat_out_t;
+    using mercury_input_type = rpc_copy_chunks_in_t;
+    using mercury_output_type = rpc_data_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 532742144;
+    constexpr static const uint64_t public_id = 844955648;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_chunk_stat;
+    constexpr static const auto name = gkfs::rpc::tag::copy_chunks;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_chunk_stat_in_t);
+            HG_GEN_PROC_NAME(rpc_copy_chunks_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_chunk_stat_out_t);
+            HG_GEN_PROC_NAME(rpc_data_out_t);
 
     class input {
 
@@ -2056,8 +3254,32 @@ struct chunk_stat {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(int32_t dummy) :
-                m_dummy(dummy) {}
+        input(const std::string& src_path,
+              const std::string& dst_path,
+              int64_t src_offset,
+              int64_t dst_offset,
+              uint64_t count,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint32_t src_stripe_count,
+              uint64_t src_stripe_size,
+              uint32_t src_stripe_start,
+              uint32_t dst_stripe_count,
+              uint64_t dst_stripe_size,
+              uint32_t dst_stripe_start) :
+                m_src_path(src_path),
+                m_dst_path(dst_path),
+                m_src_offset(src_offset),
+                m_dst_offset(dst_offset),
+                m_count(count),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_src_stripe_count(src_stripe_count),
+                m_src_stripe_size(src_stripe_size),
+                m_src_stripe_start(src_stripe_start),
+                m_dst_stripe_count(dst_stripe_count),
+                m_dst_stripe_size(dst_stripe_size),
+                m_dst_stripe_start(dst_stripe_start) {}
 
         input(input&& rhs) = default;
 
@@ -2067,22 +3289,120 @@ struct chunk_stat {
 
         input& operator=(const input& other) = default;
 
-        int32_t
-        dummy() const {
-            return m_dummy;
+        std::string
+        src_path() const {
+            return m_src_path;
+        }
+
+        std::string
+        dst_path() const {
+            return m_dst_path;
+        }
+
+        int64_t
+        src_offset() const {
+            return m_src_offset;
+        }
+
+        int64_t
+        dst_offset() const {
+            return m_dst_offset;
+        }
+
+        uint64_t
+        count() const {
+            return m_count;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint32_t
+        src_stripe_count() const {
+            return m_src_stripe_count;
+        }
+
+        uint64_t
+        src_stripe_size() const {
+            return m_src_stripe_size;
+        }
+
+        uint32_t
+        src_stripe_start() const {
+            return m_src_stripe_start;
+        }
+
+        uint32_t
+        dst_stripe_count() const {
+            return m_dst_stripe_count;
+        }
+
+        uint64_t
+        dst_stripe_size() const {
+            return m_dst_stripe_size;
+        }
+
+        uint32_t
+        dst_stripe_start() const {
+            return m_dst_stripe_start;
         }
 
         explicit
-        input(const rpc_chunk_stat_in_t& other) :
-                m_dummy(other.dummy) {}
+        input(const rpc_copy_chunks_in_t& other) :
+                m_src_path(other.src_path),
+                m_dst_path(other.dst_path),
+                m_src_offset(other.src_offset),
+                m_dst_offset(other.dst_offset),
+                m_count(other.count),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_src_stripe_count(other.src_stripe_count),
+                m_src_stripe_size(other.src_stripe_size),
+                m_src_stripe_start(other.src_stripe_start),
+                m_dst_stripe_count(other.dst_stripe_count),
+                m_dst_stripe_size(other.dst_stripe_size),
+                m_dst_stripe_start(other.dst_stripe_start) {}
 
         explicit
-        operator rpc_chunk_stat_in_t() {
-            return {m_dummy};
+        operator rpc_copy_chunks_in_t() {
+            return {
+                    m_src_path.c_str(),
+                    m_dst_path.c_str(),
+                    m_src_offset,
+                    m_dst_offset,
+                    m_count,
+                    m_host_id,
+                    m_host_size,
+                    m_src_stripe_count,
+                    m_src_stripe_size,
+                    m_src_stripe_start,
+                    m_dst_stripe_count,
+                    m_dst_stripe_size,
+                    m_dst_stripe_start
+            };
         }
 
     private:
-        int32_t m_dummy;
+        std::string m_src_path;
+        std::string m_dst_path;
+        int64_t m_src_offset;
+        int64_t m_dst_offset;
+        uint64_t m_count;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint32_t m_src_stripe_count;
+        uint64_t m_src_stripe_size;
+        uint32_t m_src_stripe_start;
+        uint32_t m_dst_stripe_count;
+        uint64_t m_dst_stripe_size;
+        uint32_t m_dst_stripe_start;
     };
 
     class output {
@@ -2093,15 +3413,11 @@ struct chunk_stat {
     public:
         output() :
                 m_err(),
-                m_chunk_size(),
-                m_chunk_total(),
-                m_chunk_free() {}
+                m_io_size() {}
 
-        output(int32_t err, uint64_t chunk_size, uint64_t chunk_total, uint64_t chunk_free) :
+        output(int32_t err, size_t io_size) :
                 m_err(err),
-                m_chunk_size(chunk_size),
-                m_chunk_total(chunk_total),
-                m_chunk_free(chunk_free) {}
+                m_io_size(io_size) {}
 
         output(output&& rhs) = default;
 
@@ -2112,11 +3428,9 @@ struct chunk_stat {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_chunk_stat_out_t& out) {
+        output(const rpc_data_out_t& out) {
             m_err = out.err;
-            m_chunk_size = out.chunk_size;
-            m_chunk_total = out.chunk_total;
-            m_chunk_free = out.chunk_free;
+            m_io_size = out.io_size;
         }
 
         int32_t
@@ -2124,26 +3438,14 @@ struct chunk_stat {
             return m_err;
         }
 
-        uint64_t
-        chunk_size() const {
-            return m_chunk_size;
-        }
-
-        uint64_t
-        chunk_total() const {
-            return m_chunk_total;
-        }
-
-        uint64_t
-        chunk_free() const {
-            return m_chunk_free;
+        size_t
+        io_size() const {
+            return m_io_size;
         }
 
     private:
         int32_t m_err;
-        uint64_t m_chunk_size;
-        uint64_t m_chunk_total;
-        uint64_t m_chunk_free;
+        size_t m_io_size;
     };
 };
 
@@ -0,0 +1,36 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_USER_FUNCTIONS_HPP
+#define GEKKOFS_USER_FUNCTIONS_HPP
+
+/*
+ * API of the GekkoFS user library (gkfs_user_lib). Applications and I/O libraries link against it and call the
+ * gkfs::syscall::gkfs_*() functions directly instead of preloading the interception library.
+ * Paths are given relative to the GekkoFS root, e.g., "/dir/file", and file descriptors returned by the library
+ * are only valid for gkfs_*() functions. gkfs_init() must be called before any other function.
+ */
+
+#include <client/gkfs_functions.hpp>
+
+namespace gkfs {
+namespace syscall {
+
+int gkfs_init();
+
+int gkfs_end();
+
+} // namespace syscall
+} // namespace gkfs
+
+#endif //GEKKOFS_USER_FUNCTIONS_HPP
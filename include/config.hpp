@@ -25,6 +25,28 @@ namespace config {
 
 constexpr auto hostfile_path = "./gkfs_hosts.txt";
 constexpr auto forwarding_file_path = "./gkfs_forwarding.map";
+// seconds between checks of the forwarding map for changes that were not notified by inotify, e.g., on NFS
+constexpr auto forwarding_map_check_interval = 10;
+// seconds between load queries to the candidate forwarders of a client if the forwarding map lists more than one
+constexpr auto forwarding_balance_interval = 2;
+// the interval varies by up to this percentage per client and round, so that clients do not query and move in lockstep
+constexpr auto forwarding_balance_jitter = 50;
+// milliseconds a client waits for the load of a candidate forwarder. Candidates that do not respond in time are skipped
+constexpr auto forwarding_balance_timeout = 500;
+/*
+ * A client moves to another candidate forwarder only if its load (queued requests and pending tasks) is lower by at
+ * least this amount, so that clients do not move back and forth between similarly loaded forwarders. Each round adds a
+ * random amount of up to the margin again, so that clients seeing the same loads do not all move at once
+ */
+constexpr auto forwarding_balance_margin = 4;
+// milliseconds a client waits for its previous forwarder to drain its staged chunks after moving
+constexpr auto forwarding_flush_timeout = 10000;
+/*
+ * Milliseconds a client waits on shutdown for load and flush requests whose responses are still outstanding. If a
+ * daemon does not respond in time, the RPC subsystem is left running instead of being destroyed under the threads
+ * waiting for it
+ */
+constexpr auto rpc_waiter_shutdown_timeout = 1000;
 
 namespace io {
 /*
@@ -32,8 +54,65 @@ namespace io {
  * If buffer is not zeroed, sparse regions contain invalid data.
  */
 constexpr auto zero_buffer_before_read = false;
+/*
+ * Time in milliseconds a statfs result is reused. Daemons cache the statistics of their chunk directory and
+ * clients cache the statistics aggregated over all daemons. 0 disables caching.
+ */
+constexpr auto statfs_cache_ttl = 1000;
+// Maximum number of client threads collecting the responses of asynchronous reads and writes
+constexpr auto aio_workers = 8u;
+// Maximum number of asynchronous requests that were submitted but not waited for. Further submissions fail
+constexpr auto aio_max_requests = 4096u;
+/*
+ * Time in milliseconds the daemon collects writes smaller than a chunk to the same chunk before writing them with
+ * as few pwrite calls as possible. Replies to these writes are delayed accordingly. 0 disables aggregation.
+ * Only the forwarding daemon aggregates by default as it receives the writes of many clients.
+ */
+#ifdef GKFS_ENABLE_FORWARDING
+constexpr auto write_aggregation_window = 2;
+#else
+constexpr auto write_aggregation_window = 0;
+#endif
+// Maximum memory in bytes of the chunk buffers collecting writes. Further chunks are written without aggregation
+constexpr auto write_aggregation_max_size = 256ul * 1024 * 1024;
+/*
+ * Write-back staging of chunks on a node-local tier, enabled with the daemon's --staging-dir option.
+ * Maximum size of staged chunks in bytes before writes to further chunks block.
+ */
+constexpr auto staging_max_size = 1024ul * 1024 * 1024;
+// Time in milliseconds a chunk stays staged before it is drained, so that subsequent writes to it are absorbed
+constexpr auto staging_drain_delay = 100;
+// Number of Argobots execution streams that drain staged chunks to the storage backend
+constexpr auto staging_drain_xstreams = 2;
+/*
+ * Adaptive number of active I/O xstreams, enabled with the daemon's --io-autotune option. The number of waiting
+ * chunk operations and their mean latency are sampled every autotune_interval milliseconds. Between
+ * autotune_min_xstreams and all I/O xstreams are active.
+ */
+constexpr auto autotune_interval = 500;
+constexpr auto autotune_min_xstreams = 2;
+// a mean latency above this factor of the lowest observed latency is treated as saturation of the device
+constexpr auto autotune_saturation = 2.0;
+// factor by which the lowest observed latency may grow per sample, so that it follows changed workloads
+constexpr auto autotune_decay = 1.05;
+/*
+ * An idle I/O xstream sleeps on its own pool and polls the other pools for tasks to steal after steal_poll_min
+ * microseconds. The interval doubles while all pools stay empty, up to steal_poll_max microseconds.
+ */
+constexpr auto steal_poll_min = 10;
+constexpr auto steal_poll_max = 200;
+// number of samples without waiting operations after which a stream is deactivated
+constexpr auto autotune_idle_rounds = 4u;
 } // namespace io
 
+namespace path {
+/*
+ * Maximum number of path components outside of GekkoFS (directories and symlinks) that a client caches to avoid
+ * lstat calls during path resolution. The cache is cleared when it is full. 0 disables the cache.
+ */
+constexpr auto resolve_cache_size = 4096;
+} // namespace path
+
 namespace log {
 constexpr auto client_log_path = "/tmp/gkfs_client.log";
 constexpr auto daemon_log_path = "/tmp/gkfs_daemon.log";
@@ -49,21 +128,67 @@ constexpr auto use_ctime = false;
 constexpr auto use_mtime = false;
 constexpr auto use_link_cnt = false;
 constexpr auto use_blocks = false;
+// store the per-file stripe layout (stripe count, stripe size, start host) in the metadentry
+constexpr auto use_stripe_layout = true;
 } // namespace metadata
 
 namespace rpc {
 constexpr auto chunksize = 524288; // in bytes (e.g., 524288 == 512KB)
 //size of preallocated buffer to hold directory entries in rpc call
 constexpr auto dirents_buff_size = (8 * 1024 * 1024); // 8 mega
+// expected size of a serialized metadentry per path to preallocate buffers for batched stat rpcs
+constexpr auto stat_batch_entry_size = 256; // in bytes
+/*
+ * Number of children per daemon for collective RPCs that are reduced along a tree of daemons (e.g., statfs).
+ * 0 disables the tree and the client contacts all daemons itself
+ */
+constexpr auto broadcast_fanout = 8;
 /*
  * Indicates the number of concurrent progress to drive I/O operations of chunk files to and from local file systems
- * The value is directly mapped to created Argobots xstreams, controlled in a single pool with ABT_snoozer scheduler
+ * The value is directly mapped to created Argobots xstreams, controlled in a single pool with ABT_snoozer scheduler.
+ * This and the handler xstreams below are defaults that can be changed with daemon options or environment variables
  */
 constexpr auto daemon_io_xstreams = 8;
-// Number of threads used for RPC handlers at the daemon
-constexpr auto daemon_handler_xstreams = 8;
+/*
+ * Number of threads used for RPC handlers at the daemon. Metadata and data RPCs run in their own pools below, so
+ * that long data RPCs, blocked on bulk transfers and chunk operations, do not delay metadata RPCs. The threads here
+ * serve the remaining RPCs, e.g., fs_config and chunk stat, and the pools that are configured with 0 threads.
+ */
+constexpr auto daemon_handler_xstreams = 2;
+// Number of threads used for metadata RPC handlers, e.g., create, stat, and get_dirents
+constexpr auto daemon_metadata_xstreams = 4;
+// Number of threads used for data RPC handlers, i.e., read, write, truncate, and copy_chunks
+constexpr auto daemon_data_xstreams = 8;
+// Number of chunks a daemon reads at a time and then writes to their destination in a server-side copy
+constexpr auto copy_chunks_batch = 8;
 } // namespace rpc
 
+namespace scheduler {
+/*
+ * Default policy of the daemon's I/O request scheduler: none, fifo, aggregation, or deadline.
+ * The forwarding daemon aggregates requests of its clients by default, unless AGIOS is used.
+ */
+#if defined(GKFS_ENABLE_FORWARDING) && !defined(GKFS_ENABLE_AGIOS)
+constexpr auto default_policy = "aggregation";
+#else
+constexpr auto default_policy = "none";
+#endif
+// Time in milliseconds after which a queued request is released first by the deadline policy
+constexpr auto deadline = 50;
+// Minimum time in milliseconds over which the bytes/s of the daemon's load are averaged
+constexpr auto load_window = 1000;
+/*
+ * Per-job quality of service, enabled with the daemon's --qos option. Read and write requests of each job pass a
+ * token bucket for bandwidth and one for requests/s. The buckets hold tokens for qos_burst milliseconds at most.
+ * At most qos_inflight_per_xstream requests per I/O xstream are released at the same time, the others wait and are
+ * released in weighted fair order.
+ */
+constexpr auto qos_burst = 100;
+constexpr auto qos_inflight_per_xstream = 2u;
+// Time in seconds after which a job without requests and with full buckets is forgotten, including its statistics
+constexpr auto qos_job_timeout = 60;
+} // namespace scheduler
+
 namespace rocksdb {
 // Write-ahead logging of rocksdb
 constexpr auto use_write_ahead_log = false;
@@ -0,0 +1,62 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_AFFINITY_HPP
+#define GEKKOFS_DAEMON_AFFINITY_HPP
+
+#include <daemon/cpu_set.hpp>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs {
+namespace affinity {
+
+int interface_numa_node(const std::string& iface);
+
+CpuSet thread_cpus();
+
+void pin_thread(const CpuSet& cpus);
+
+void prefer_numa_node(int node);
+
+void pin_pools(const std::vector<ABT_pool>& pools, unsigned int xstreams, const CpuSet& cpus, int numa_node = -1);
+
+void pin_pool(ABT_pool pool, unsigned int xstreams, const CpuSet& cpus, int numa_node = -1);
+
+/**
+ * Pins the calling thread to a CPU set for its lifetime and restores the previous affinity afterwards. Threads
+ * started meanwhile, e.g., execution streams or RocksDB background threads, inherit the CPU set
+ */
+class ScopedPin {
+private:
+    CpuSet previous_;
+
+public:
+    explicit ScopedPin(const CpuSet& cpus);
+
+    ~ScopedPin();
+
+    ScopedPin(const ScopedPin&) = delete;
+
+    ScopedPin& operator=(const ScopedPin&) = delete;
+};
+
+} // namespace affinity
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_AFFINITY_HPP
@@ -20,6 +20,8 @@
 #include <string>
 #include <memory>
 #include <system_error>
+#include <mutex>
+#include <chrono>
 
 /* Forward declarations */
 namespace spdlog {
@@ -49,6 +51,12 @@ private:
     std::string root_path_;
     size_t chunksize_;
 
+    // last result of chunk_stat() which is reused for gkfs::config::io::statfs_cache_ttl
+    mutable std::mutex chunk_stat_mutex_;
+    mutable ChunkStat chunk_stat_cache_{};
+    mutable std::chrono::steady_clock::time_point chunk_stat_time_{};
+    mutable bool chunk_stat_valid_{false};
+
     inline std::string absolute(const std::string& internal_path) const;
 
     static inline std::string get_chunks_dir(const std::string& file_path);
@@ -57,6 +65,8 @@ private:
 
     void init_chunk_space(const std::string& file_path) const;
 
+    ChunkStat stat_chunk_dir() const;
+
 public:
     ChunkStorage(std::string& path, size_t chunksize);
 
@@ -73,6 +83,8 @@ public:
 
     void truncate_chunk_file(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id, off_t length);
 
+    void remove_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id) const;
+
     ChunkStat chunk_stat() const;
 };
 
@@ -41,8 +41,14 @@ public:
 
     void put(const std::string& key, const std::string& val);
 
+    void put_batch(const std::vector<std::pair<std::string, std::string>>& entries);
+
+    std::vector<std::string> get_batch(const std::vector<std::string>& keys) const;
+
     void remove(const std::string& key);
 
+    void remove_batch(const std::vector<std::string>& keys);
+
     bool exists(const std::string& key);
 
     void update(const std::string& old_key, const std::string& new_key, const std::string& val);
@@ -16,6 +16,7 @@
 #define LFS_FS_DATA_H
 
 #include <daemon/daemon.hpp>
+#include <daemon/affinity.hpp>
 
 #include <unordered_map>
 #include <map>
@@ -29,6 +30,8 @@ class MetadataDB;
 
 namespace data {
 class ChunkStorage;
+
+class StagingCache;
 }
 
 namespace daemon {
@@ -45,17 +48,38 @@ private:
     std::string rootdir_;
     std::string mountdir_;
     std::string metadir_;
+    // node-local staging tier, empty if writes are not staged
+    std::string staging_dir_;
 
     // RPC management
     std::string rpc_protocol_;
     std::string bind_addr_;
     std::string hosts_file_;
     bool use_auto_sm_;
+    std::string io_scheduler_;
+    // per-job QoS classes, empty if QoS is disabled
+    std::string qos_;
+    // execution streams of the I/O pool and of the RPC handler pools
+    unsigned int io_xstreams_;
+    unsigned int handler_xstreams_;
+    unsigned int metadata_xstreams_;
+    unsigned int data_xstreams_;
+    // adapt the number of active I/O streams to the load
+    bool io_autotune_;
+    // CPU sets the execution streams and RocksDB's background threads are pinned to, empty if not pinned
+    gkfs::affinity::CpuSet io_cpus_;
+    gkfs::affinity::CpuSet handler_cpus_;
+    gkfs::affinity::CpuSet progress_cpus_;
+    gkfs::affinity::CpuSet rocksdb_cpus_;
+    // NUMA node RPC buffers are allocated on, -1 if not set
+    int buffer_numa_node_;
 
     // Database
     std::shared_ptr<gkfs::metadata::MetadataDB> mdb_;
     // Storage backend
     std::shared_ptr<gkfs::data::ChunkStorage> storage_;
+    // write-back cache in front of the storage backend, nullptr if disabled
+    std::shared_ptr<gkfs::data::StagingCache> staging_;
 
     // configurable metadata
     bool atime_state_;
@@ -102,10 +126,66 @@ public:
 
     void storage(const std::shared_ptr<gkfs::data::ChunkStorage>& storage);
 
+    const std::shared_ptr<gkfs::data::StagingCache>& staging() const;
+
+    void staging(const std::shared_ptr<gkfs::data::StagingCache>& staging);
+
+    const std::string& staging_dir() const;
+
+    void staging_dir(const std::string& staging_dir);
+
     const std::string& rpc_protocol() const;
 
     void rpc_protocol(const std::string& rpc_protocol);
 
+    const std::string& io_scheduler() const;
+
+    void io_scheduler(const std::string& io_scheduler);
+
+    const std::string& qos() const;
+
+    void qos(const std::string& qos);
+
+    unsigned int io_xstreams() const;
+
+    void io_xstreams(unsigned int io_xstreams);
+
+    unsigned int handler_xstreams() const;
+
+    void handler_xstreams(unsigned int handler_xstreams);
+
+    unsigned int metadata_xstreams() const;
+
+    void metadata_xstreams(unsigned int metadata_xstreams);
+
+    unsigned int data_xstreams() const;
+
+    void data_xstreams(unsigned int data_xstreams);
+
+    bool io_autotune() const;
+
+    void io_autotune(bool io_autotune);
+
+    const gkfs::affinity::CpuSet& io_cpus() const;
+
+    void io_cpus(const gkfs::affinity::CpuSet& io_cpus);
+
+    const gkfs::affinity::CpuSet& handler_cpus() const;
+
+    void handler_cpus(const gkfs::affinity::CpuSet& handler_cpus);
+
+    const gkfs::affinity::CpuSet& progress_cpus() const;
+
+    void progress_cpus(const gkfs::affinity::CpuSet& progress_cpus);
+
+    const gkfs::affinity::CpuSet& rocksdb_cpus() const;
+
+    void rocksdb_cpus(const gkfs::affinity::CpuSet& rocksdb_cpus);
+
+    int buffer_numa_node() const;
+
+    void buffer_numa_node(int buffer_numa_node);
+
     const std::string& bind_addr() const;
 
     void bind_addr(const std::string& addr);
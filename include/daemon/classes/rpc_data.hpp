@@ -16,8 +16,27 @@
 #define LFS_RPC_DATA_HPP
 
 #include <daemon/daemon.hpp>
+#include <global/global_defs.hpp>
+
+#include <map>
+#include <mutex>
+#include <memory>
 
 namespace gkfs {
+namespace scheduler {
+class RequestScheduler;
+
+class LoadStats;
+
+class IoTuner;
+
+class QosScheduler;
+}
+
+namespace data {
+class WriteAggregator;
+}
+
 namespace daemon {
 
 class RPCData {
@@ -28,11 +47,31 @@ private:
     // Margo IDs. They can also be used to retrieve the Mercury classes and contexts that were created at init time
     margo_instance_id server_rpc_mid_;
 
-    // Argobots I/O pools and execution streams
-    ABT_pool io_pool_;
+    // Argobots I/O pools and execution streams. Each stream has its own pool and steals from the others
+    std::vector<ABT_pool> io_pools_;
     std::vector<ABT_xstream> io_streams_;
+    // adapts the number of active I/O streams, nullptr if disabled
+    std::shared_ptr<gkfs::scheduler::IoTuner> io_tuner_;
+    // Argobots pools and execution streams of metadata and data RPC handlers. ABT_POOL_NULL uses Margo's handler pool
+    ABT_pool metadata_pool_{ABT_POOL_NULL};
+    std::vector<ABT_xstream> metadata_streams_;
+    ABT_pool data_pool_{ABT_POOL_NULL};
+    std::vector<ABT_xstream> data_streams_;
     std::string self_addr_str_;
 
+    // addresses of other daemons by their host id, looked up on first use for daemon-to-daemon RPCs
+    std::map<uint64_t, hg_addr_t> peer_addrs_;
+    std::mutex peer_addrs_mutex_;
+
+    // orders read and write requests, nullptr if no scheduling policy is used
+    std::shared_ptr<gkfs::scheduler::RequestScheduler> scheduler_;
+    // load of the data path published to clients
+    std::shared_ptr<gkfs::scheduler::LoadStats> load_stats_;
+    // per-job shares and limits of read and write requests, nullptr if disabled
+    std::shared_ptr<gkfs::scheduler::QosScheduler> qos_;
+    // merges small writes to the same chunk, nullptr if disabled
+    std::shared_ptr<gkfs::data::WriteAggregator> write_aggregator_;
+
 public:
 
     static RPCData* getInstance() {
@@ -50,18 +89,62 @@ public:
 
     void server_rpc_mid(margo_instance* server_rpc_mid);
 
-    ABT_pool io_pool() const;
+    const std::vector<ABT_pool>& io_pools() const;
 
-    void io_pool(ABT_pool io_pool);
+    void io_pools(const std::vector<ABT_pool>& io_pools);
+
+    ABT_pool io_pool(const std::string& path, gkfs::rpc::chnk_id_t chnk_id) const;
 
     std::vector<ABT_xstream>& io_streams();
 
     void io_streams(const std::vector<ABT_xstream>& io_streams);
 
+    const std::shared_ptr<gkfs::scheduler::IoTuner>& io_tuner() const;
+
+    void io_tuner(const std::shared_ptr<gkfs::scheduler::IoTuner>& io_tuner);
+
+    ABT_pool metadata_pool() const;
+
+    void metadata_pool(ABT_pool metadata_pool);
+
+    std::vector<ABT_xstream>& metadata_streams();
+
+    void metadata_streams(const std::vector<ABT_xstream>& metadata_streams);
+
+    ABT_pool data_pool() const;
+
+    void data_pool(ABT_pool data_pool);
+
+    std::vector<ABT_xstream>& data_streams();
+
+    void data_streams(const std::vector<ABT_xstream>& data_streams);
+
     const std::string& self_addr_str() const;
 
     void self_addr_str(const std::string& addr_str);
 
+    hg_addr_t peer_addr(uint64_t host_id);
+
+    void peer_addr(uint64_t host_id, hg_addr_t addr);
+
+    void free_peer_addrs();
+
+    const std::shared_ptr<gkfs::scheduler::RequestScheduler>& scheduler() const;
+
+    void scheduler(const std::shared_ptr<gkfs::scheduler::RequestScheduler>& scheduler);
+
+    const std::shared_ptr<gkfs::scheduler::LoadStats>& load_stats() const;
+
+    void load_stats(const std::shared_ptr<gkfs::scheduler::LoadStats>& load_stats);
+
+    const std::shared_ptr<gkfs::scheduler::QosScheduler>& qos() const;
+
+    void qos(const std::shared_ptr<gkfs::scheduler::QosScheduler>& qos);
+
+    const std::shared_ptr<gkfs::data::WriteAggregator>& write_aggregator() const;
+
+    void write_aggregator(const std::shared_ptr<gkfs::data::WriteAggregator>& write_aggregator);
+
 };
 
 } // namespace daemon
@@ -0,0 +1,33 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_CPU_SET_HPP
+#define GEKKOFS_DAEMON_CPU_SET_HPP
+
+#include <string>
+#include <vector>
+
+namespace gkfs {
+namespace affinity {
+
+// sorted CPU ids. Empty if threads are not pinned
+using CpuSet = std::vector<int>;
+
+CpuSet parse_cpu_set(const std::string& spec);
+
+std::string to_string(const CpuSet& cpus);
+
+} // namespace affinity
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_CPU_SET_HPP
@@ -23,6 +23,17 @@ namespace gkfs {
 namespace env {
 
 static constexpr auto HOSTS_FILE = ADD_PREFIX("HOSTS_FILE");
+static constexpr auto IO_XSTREAMS = ADD_PREFIX("IO_XSTREAMS");
+static constexpr auto HANDLER_XSTREAMS = ADD_PREFIX("HANDLER_XSTREAMS");
+static constexpr auto METADATA_XSTREAMS = ADD_PREFIX("METADATA_XSTREAMS");
+static constexpr auto DATA_XSTREAMS = ADD_PREFIX("DATA_XSTREAMS");
+static constexpr auto IO_AUTOTUNE = ADD_PREFIX("IO_AUTOTUNE");
+static constexpr auto PIN_IO = ADD_PREFIX("PIN_IO");
+static constexpr auto PIN_HANDLER = ADD_PREFIX("PIN_HANDLER");
+static constexpr auto PIN_PROGRESS = ADD_PREFIX("PIN_PROGRESS");
+static constexpr auto PIN_ROCKSDB = ADD_PREFIX("PIN_ROCKSDB");
+static constexpr auto BUFFER_NUMA_NODE = ADD_PREFIX("BUFFER_NUMA_NODE");
+static constexpr auto QOS = ADD_PREFIX("QOS");
 
 } // namespace env
 } // namespace gkfs
@@ -23,6 +23,10 @@ extern "C" {
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_fs_config)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_load)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_qos_stats)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_create)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_stat)
@@ -39,6 +43,12 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry_size)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_dirents)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_create_batch)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_stat_batch)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_remove_batch)
+
 #ifdef HAS_SYMLINKS
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
@@ -55,4 +65,10 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat_tree)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_copy_chunks)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_flush_data)
+
 #endif //GKFS_DAEMON_RPC_DEFS_HPP
@@ -15,6 +15,7 @@
 #define GEKKOFS_DAEMON_DATA_HPP
 
 #include <daemon/daemon.hpp>
+#include <daemon/scheduler/io_pools.hpp>
 #include <global/global_defs.hpp>
 
 #include <string>
@@ -53,6 +54,8 @@ public:
  * All operations on chunk files must go through the Argobots' task queues.
  * Otherwise operations may overtake operations in the queues.
  * This applies to write, read, and truncate which may modify the middle of a chunk, essentially a write operation.
+ * The operations on a chunk are queued in the same I/O pool, see RPCData::io_pool(). A truncate removes chunks of
+ * all pools and is therefore ordered after the operations queued in any of the pools, see PoolBarrier.
  *
  * Note: This class is not thread-safe.
  *
@@ -120,6 +123,9 @@ private:
 
     struct chunk_truncate_args task_arg_{};
 
+    // runs the truncate after the operations queued in any I/O pool
+    gkfs::scheduler::PoolBarrier barrier_;
+
     static void truncate_abt(void* _arg);
 
     void clear_task_args();
@@ -150,6 +156,8 @@ private:
     };
 
     std::vector<struct chunk_write_args> task_args_;
+    // writes handed to the write aggregator instead of a tasklet
+    std::vector<bool> aggregated_;
 
     static void write_file_abt(void* _arg);
 
@@ -159,7 +167,7 @@ public:
 
     ChunkWriteOperation(const std::string& path, size_t n);
 
-    ~ChunkWriteOperation() = default;
+    ~ChunkWriteOperation();
 
     void write_nonblock(size_t idx, uint64_t chunk_id, const char* bulk_buf_ptr, size_t size, off64_t offset);
 
@@ -209,6 +217,8 @@ public:
     std::pair<int, size_t>
     wait_for_tasks_and_push_back(const bulk_args& args);
 
+    std::pair<int, size_t> wait_for_tasks();
+
 };
 
 } // namespace data
@@ -31,12 +31,18 @@ std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir);
 
 void create(const std::string& path, Metadata& md);
 
+void create_batch(const std::vector<std::string>& paths, Metadata& md);
+
+std::vector<std::string> get_str_batch(const std::vector<std::string>& paths);
+
 void update(const std::string& path, Metadata& md);
 
 void update_size(const std::string& path, size_t io_size, off_t offset, bool append);
 
 void remove(const std::string& path);
 
+void remove_batch(const std::vector<std::string>& paths);
+
 } // namespace metadata
 } // namespace gkfs
 
@@ -0,0 +1,117 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_STAGING_CACHE_HPP
+#define GEKKOFS_DAEMON_STAGING_CACHE_HPP
+
+#include <global/global_defs.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs {
+namespace data {
+
+class ChunkStorage;
+
+/**
+ * Write-back cache of chunks on a node-local staging tier, e.g., a tmpfs for DRAM or an NVMe mount, in front of the
+ * (slower, shared) chunk storage. Writes complete once they are staged. Drain threads on their own Argobots execution
+ * streams write staged chunks to the chunk storage after a short delay, which lets further writes to a chunk be
+ * absorbed, and remove them from the staging tier.
+ * A chunk is staged completely: its first partial write reads the stored chunk into the staging tier, so that reads
+ * of staged chunks are served from the staging tier alone. The number of staged chunks is bounded. Writes to
+ * further chunks block until chunks were drained.
+ *
+ * Staging operations are called from tasklets and may block the execution stream, like the chunk storage does.
+ */
+class StagingCache {
+private:
+    struct Entry {
+        std::string path;
+        gkfs::rpc::chnk_id_t chnk_id;
+        std::chrono::steady_clock::time_point staged;
+        // serializes staging, draining, and reading of the chunk
+        std::mutex mutex;
+        bool filled{false};
+        // set when the chunk left the cache. Callers holding the entry fall back to the chunk storage
+        bool removed{false};
+    };
+
+    using key_type = std::pair<std::string, gkfs::rpc::chnk_id_t>;
+
+    std::shared_ptr<ChunkStorage> staging_;
+    std::shared_ptr<ChunkStorage> storage_;
+    size_t chunksize_;
+    size_t max_entries_;
+    std::chrono::milliseconds drain_delay_;
+
+    // staged chunks, each is queued for draining exactly once
+    std::mutex mutex_;
+    std::condition_variable drain_cv_;
+    std::condition_variable space_cv_;
+    std::map<key_type, std::shared_ptr<Entry>> entries_;
+    std::deque<key_type> drain_queue_;
+    bool stop_{false};
+
+    ABT_pool drain_pool_{ABT_POOL_NULL};
+    std::vector<ABT_xstream> drain_streams_;
+    std::vector<ABT_thread> drain_threads_;
+
+    static void drain_ult(void* _arg);
+
+    bool drain_(const std::shared_ptr<Entry>& entry);
+
+    void drop_(const std::shared_ptr<Entry>& entry);
+
+    std::vector<std::shared_ptr<Entry>> entries_of_(const std::string& path, gkfs::rpc::chnk_id_t chunk_start);
+
+public:
+    StagingCache(std::shared_ptr<ChunkStorage> staging, std::shared_ptr<ChunkStorage> storage, size_t chunksize,
+                 size_t max_size, unsigned int drain_delay_ms, unsigned int drain_xstreams);
+
+    ~StagingCache();
+
+    StagingCache(const StagingCache&) = delete;
+
+    StagingCache& operator=(const StagingCache&) = delete;
+
+    ssize_t write_chunk(const std::string& path, gkfs::rpc::chnk_id_t chunk_id, const char* buf, size_t size,
+                        off64_t offset);
+
+    ssize_t read_chunk(const std::string& path, gkfs::rpc::chnk_id_t chunk_id, char* buf, size_t size,
+                       off64_t offset);
+
+    void truncate(const std::string& path, gkfs::rpc::chnk_id_t chunk_start, off_t left_pad);
+
+    void remove(const std::string& path);
+
+    bool flush();
+
+    void shutdown();
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_STAGING_CACHE_HPP
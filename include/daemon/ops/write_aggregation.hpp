@@ -0,0 +1,92 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_WRITE_AGGREGATION_HPP
+#define GEKKOFS_DAEMON_WRITE_AGGREGATION_HPP
+
+#include <global/global_defs.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+extern "C" {
+#include <abt.h>
+#include <margo.h>
+}
+
+namespace gkfs {
+namespace data {
+
+/**
+ * Merges small writes to the same chunk that arrive within a short window, e.g., from strided writes of many clients
+ * of a forwarding daemon. The first write to a chunk opens a slot and starts a ULT in the chunk's I/O pool that sleeps
+ * for the window. Writes arriving in the meantime are copied into the slot's chunk buffer, later ones overwriting
+ * earlier ones. The ULT then writes each contiguous range of the buffer with a single pwrite and signals all writers.
+ * Slots are not opened while their buffers would exceed max_size, writes to further chunks are not aggregated.
+ */
+class WriteAggregator {
+private:
+    struct Writer {
+        ABT_eventual eventual;
+        size_t size;
+    };
+
+    struct Slot {
+        std::string path;
+        gkfs::rpc::chnk_id_t chnk_id;
+        std::vector<char> buf;
+        // written ranges [begin, end) of buf in arrival order
+        std::vector<std::pair<size_t, size_t>> extents;
+        std::vector<Writer> writers;
+    };
+
+    struct FlushArgs {
+        WriteAggregator* aggregator;
+        std::shared_ptr<Slot> slot;
+    };
+
+    margo_instance_id mid_;
+    double window_;
+    size_t chunksize_;
+    size_t max_size_;
+
+    ABT_mutex mutex_;
+    std::map<std::pair<std::string, gkfs::rpc::chnk_id_t>, std::shared_ptr<Slot>> slots_;
+    // size of the buffers of open and flushing slots
+    size_t size_{0};
+
+    static void flush_ult(void* _arg);
+
+    void flush_(Slot& slot);
+
+public:
+    WriteAggregator(margo_instance_id mid, unsigned int window_ms, size_t chunksize, size_t max_size);
+
+    ~WriteAggregator();
+
+    WriteAggregator(const WriteAggregator&) = delete;
+
+    WriteAggregator& operator=(const WriteAggregator&) = delete;
+
+    bool aggregates(size_t size) const;
+
+    bool write(const std::string& path, gkfs::rpc::chnk_id_t chnk_id, const char* buf, size_t size, off64_t offset,
+               ABT_eventual eventual);
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_WRITE_AGGREGATION_HPP
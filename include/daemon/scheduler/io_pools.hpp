@@ -0,0 +1,60 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_IO_POOLS_HPP
+#define GEKKOFS_DAEMON_IO_POOLS_HPP
+
+#include <atomic>
+#include <vector>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs {
+namespace scheduler {
+
+void create_stealing_pools(unsigned int xstreams_num, std::vector<ABT_pool>& pools,
+                           std::vector<ABT_xstream>& xstreams);
+
+/**
+ * Orders a tasklet after all units queued before it in a set of FIFO pools, e.g., a truncate after the chunk
+ * operations of the file that hash to other I/O pools. A barrier tasklet is queued in each pool, the last one to run
+ * calls the function. The function therefore starts after every unit queued before the barrier in any of the pools
+ * has started, which is the order a single FIFO pool provides.
+ *
+ * The barrier must stay alive until the function was called.
+ */
+class PoolBarrier {
+private:
+    // barrier tasklets that have not run yet
+    std::atomic<size_t> pending_{0};
+    void (* fn_)(void*);
+    void* arg_;
+
+    static void arrive_abt(void* _arg);
+
+public:
+    PoolBarrier(void (* fn)(void*), void* arg);
+
+    PoolBarrier(const PoolBarrier&) = delete;
+
+    PoolBarrier& operator=(const PoolBarrier&) = delete;
+
+    int post(const std::vector<ABT_pool>& pools, std::vector<ABT_task>& tasks);
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_IO_POOLS_HPP
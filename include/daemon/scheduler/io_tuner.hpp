@@ -0,0 +1,95 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_IO_TUNER_HPP
+#define GEKKOFS_DAEMON_IO_TUNER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs {
+namespace scheduler {
+
+/**
+ * Adapts the number of active execution streams of the I/O pools to the load.
+ * A thread samples the number of chunk operations waiting in the pools and the mean latency of the chunk operations
+ * that finished since the last sample. Streams are activated while operations wait and the latency stays close to
+ * the lowest latency observed. Streams are deactivated if the latency grows, i.e., the device is saturated and
+ * further concurrency only adds queueing in the device, or if the pool was idle for a while.
+ *
+ * All streams are created up front. A stream is deactivated by pushing a ULT into its pool that blocks the stream
+ * until it is activated again, so deactivation takes effect once the operations queued before it were started. The
+ * operations of a deactivated stream's pool are stolen by the active streams.
+ */
+class IoTuner {
+private:
+    // one pool per stream, the stream with index i runs pools_[i] first
+    std::vector<ABT_pool> pools_;
+    unsigned int min_xstreams_;
+    unsigned int max_xstreams_;
+    std::chrono::milliseconds interval_;
+
+    // latency of the chunk operations finished since the last sample
+    std::atomic<uint64_t> latency_sum_us_{0};
+    std::atomic<uint64_t> latency_count_{0};
+    double baseline_us_{0};
+    unsigned int idle_rounds_{0};
+
+    std::mutex mutex_;
+    std::condition_variable park_cv_;
+    std::condition_variable stop_cv_;
+    unsigned int active_;
+    // number of streams that should be deactivated and number of streams that are blocked by a parking ULT
+    unsigned int park_target_{0};
+    unsigned int parked_{0};
+    bool stop_{false};
+    std::thread thread_;
+
+    static void park_ult(void* _arg);
+
+    void run_();
+
+    void tune_();
+
+    bool deactivate_();
+
+    void activate_();
+
+public:
+    IoTuner(std::vector<ABT_pool> pools, unsigned int min_xstreams, unsigned int interval_ms);
+
+    ~IoTuner();
+
+    IoTuner(const IoTuner&) = delete;
+
+    IoTuner& operator=(const IoTuner&) = delete;
+
+    void record(std::chrono::steady_clock::duration latency);
+
+    unsigned int active();
+
+    void shutdown();
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_IO_TUNER_HPP
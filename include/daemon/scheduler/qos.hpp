@@ -0,0 +1,93 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_QOS_HPP
+#define GEKKOFS_DAEMON_QOS_HPP
+
+#include <daemon/scheduler/qos_policy.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+extern "C" {
+#include <abt.h>
+#include <margo.h>
+}
+
+namespace gkfs {
+namespace scheduler {
+
+/**
+ * Per-job quality of service for the daemon's read and write requests. Jobs are identified by the job id clients
+ * send with each request. Writes between daemons are not scheduled, see gkfs::rpc::internal_job_id. The QosPolicy
+ * decides which requests are processed.
+ *
+ * Like the RequestScheduler, waiting blocks the calling ULT on an Argobots eventual. A ULT in Margo's handler pool
+ * releases throttled requests once their job's buckets are refilled.
+ */
+class QosScheduler : public std::enable_shared_from_this<QosScheduler> {
+private:
+    margo_instance_id mid_;
+    ABT_pool pacer_pool_;
+
+    ABT_mutex mutex_;
+    QosPolicy policy_;
+    // eventuals of the queued requests by their id
+    std::unordered_map<uint64_t, ABT_eventual> waiters_;
+    bool pacer_active_{false};
+
+    static void pacer_ult(void* _arg);
+
+    void dispatch_();
+
+public:
+    QosScheduler(std::vector<QosClass> classes, unsigned int max_inflight, margo_instance_id mid);
+
+    ~QosScheduler();
+
+    QosScheduler(const QosScheduler&) = delete;
+
+    QosScheduler& operator=(const QosScheduler&) = delete;
+
+    void enter(const std::string& job, uint64_t size);
+
+    void leave(const std::string& job);
+
+    std::string stats();
+};
+
+/**
+ * Enters the QoS scheduler on construction and leaves it on destruction, i.e., when the RPC handler returns
+ */
+class QosRequest {
+private:
+    std::shared_ptr<QosScheduler> qos_;
+    std::string job_;
+
+public:
+    QosRequest(std::shared_ptr<QosScheduler> qos, std::string job, uint64_t size);
+
+    ~QosRequest();
+
+    QosRequest(const QosRequest&) = delete;
+
+    QosRequest& operator=(const QosRequest&) = delete;
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_QOS_HPP
@@ -0,0 +1,128 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_QOS_POLICY_HPP
+#define GEKKOFS_DAEMON_QOS_POLICY_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <chrono>
+#include <cstdint>
+
+namespace gkfs {
+namespace scheduler {
+
+/**
+ * Share and limits of a job. The job "*" configures jobs that are not listed
+ */
+struct QosClass {
+    std::string job;
+    double weight{1};
+    // bytes/s, 0 if unlimited
+    uint64_t bandwidth{0};
+    // requests/s, 0 if unlimited
+    uint64_t iops{0};
+};
+
+/**
+ * Decides which requests of the QosScheduler are processed. Each job has a token bucket for bytes and one for
+ * requests. A job whose bucket is empty is throttled until it is refilled. At most max_inflight requests are
+ * processed at the same time. Further requests wait in a queue per job and are released by start-time fair
+ * queueing, i.e., each job receives a share of the processed bytes proportional to its weight while it has requests
+ * waiting. Jobs that are idle for gkfs::config::scheduler::qos_job_timeout are forgotten.
+ *
+ * The policy is not thread-safe and takes the current time as an argument. The QosScheduler serializes the calls
+ * and blocks the waiting requests.
+ */
+class QosPolicy {
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct Request {
+        uint64_t id;
+        uint64_t size;
+        double start_tag;
+        clock::time_point arrival;
+    };
+
+    struct Job {
+        QosClass config;
+        // virtual finish time of the job's last request
+        double last_finish{0};
+        double byte_tokens{0};
+        double request_tokens{0};
+        clock::time_point refilled;
+        // arrival of the job's last request
+        clock::time_point active;
+        std::deque<Request> queue;
+        unsigned int inflight{0};
+        // statistics
+        uint64_t requests{0};
+        uint64_t bytes{0};
+        uint64_t throttled{0};
+        clock::duration waited{0};
+    };
+
+    unsigned int max_inflight_;
+    std::vector<QosClass> classes_;
+    QosClass default_class_;
+
+    std::map<std::string, Job> jobs_;
+    // jobs with queued requests
+    std::vector<Job*> backlogged_;
+    size_t queued_{0};
+    unsigned int inflight_{0};
+    // start tag of the last released request
+    double virtual_time_{0};
+    uint64_t last_id_{0};
+    clock::time_point pruned_;
+
+    Job& job_(const std::string& job, clock::time_point now);
+
+    bool eligible_(Job& job, clock::time_point now);
+
+    void release_(Job& job, uint64_t size, double start_tag);
+
+    void dequeue_(Job& job, std::deque<Request>::iterator request, clock::time_point now);
+
+    void prune_(clock::time_point now);
+
+public:
+    QosPolicy(std::vector<QosClass> classes, unsigned int max_inflight);
+
+    uint64_t enter(const std::string& job, uint64_t size, clock::time_point now);
+
+    void leave(const std::string& job);
+
+    void release(const std::string& job, uint64_t id, clock::time_point now);
+
+    std::vector<uint64_t> dispatch(clock::time_point now, double& wait);
+
+    size_t queued() const;
+
+    unsigned int inflight() const;
+
+    size_t jobs() const;
+
+    std::string stats() const;
+
+    static std::vector<QosClass> parse_classes(const std::string& spec);
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_QOS_POLICY_HPP
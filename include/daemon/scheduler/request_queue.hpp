@@ -0,0 +1,90 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_REQUEST_QUEUE_HPP
+#define GEKKOFS_DAEMON_REQUEST_QUEUE_HPP
+
+#include <string>
+#include <list>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace gkfs {
+namespace scheduler {
+
+enum class Policy {
+    none, // requests are not queued
+    fifo, // requests are released in arrival order
+    aggregation, // the oldest request is released with all queued requests that are contiguous to it in the same file
+    deadline // requests are released in offset order per file unless one waited longer than the deadline
+};
+
+enum class RequestType {
+    read,
+    write
+};
+
+struct Request {
+    std::string path;
+    RequestType type;
+    uint64_t offset;
+    uint64_t size;
+    std::chrono::steady_clock::time_point arrival;
+};
+
+/**
+ * Decides the order in which the RequestScheduler releases queued requests. At most max_inflight requests are
+ * processed at the same time, the policy selects the next requests among the queued ones.
+ *
+ * The queue is not thread-safe and takes the current time as an argument. The RequestScheduler serializes the
+ * calls and blocks the waiting requests. Queued requests are owned by the caller.
+ */
+class RequestQueue {
+private:
+    Policy policy_;
+    unsigned int max_inflight_;
+    std::chrono::milliseconds deadline_;
+
+    std::list<Request*> queue_;
+    unsigned int inflight_{0};
+    // end of the last released request, used to continue in offset order by the deadline policy
+    std::string last_path_;
+    uint64_t last_end_{0};
+
+    std::vector<std::list<Request*>::iterator> pick_(std::chrono::steady_clock::time_point now);
+
+    void release_(const Request& request);
+
+public:
+    RequestQueue(Policy policy, unsigned int max_inflight, unsigned int deadline_ms);
+
+    Policy policy() const;
+
+    bool enter(Request* request);
+
+    void leave();
+
+    void release(Request* request);
+
+    std::vector<Request*> dispatch(std::chrono::steady_clock::time_point now);
+
+    size_t queued() const;
+
+    unsigned int inflight() const;
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_REQUEST_QUEUE_HPP
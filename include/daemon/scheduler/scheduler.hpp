@@ -0,0 +1,121 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_SCHEDULER_HPP
+#define GEKKOFS_DAEMON_SCHEDULER_HPP
+
+#include <daemon/scheduler/request_queue.hpp>
+
+#include <string>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs {
+namespace scheduler {
+
+/**
+ * Native I/O request scheduler of the daemon.
+ * Read and write handlers enter the scheduler before their data is transferred and leave it after the chunk
+ * operations finished. At most max_inflight requests are processed at the same time. Further requests wait in a
+ * queue and the policy decides the order in which they are released, see RequestQueue. Contiguous requests to the
+ * same file are released together so that their chunk operations reach the I/O pool back to back.
+ *
+ * Waiting blocks the calling ULT on an Argobots eventual, so the handler xstreams keep serving other RPCs.
+ */
+class RequestScheduler {
+private:
+    struct Waiter : Request {
+        ABT_eventual eventual;
+    };
+
+    ABT_mutex mutex_;
+    RequestQueue queue_;
+
+    void dispatch_();
+
+public:
+    RequestScheduler(Policy policy, unsigned int max_inflight, unsigned int deadline_ms);
+
+    ~RequestScheduler();
+
+    RequestScheduler(const RequestScheduler&) = delete;
+
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    Policy policy() const;
+
+    void enter(const std::string& path, RequestType type, uint64_t offset, uint64_t size);
+
+    void leave();
+
+    static Policy parse_policy(const std::string& name);
+
+    static std::string policy_name(Policy policy);
+};
+
+/**
+ * Load of the daemon's data path as published to clients choosing a forwarder. Counts read and write requests
+ * that are queued or processed and the bytes they requested.
+ */
+class LoadStats {
+private:
+    std::atomic<uint64_t> active_requests_{0};
+    std::atomic<uint64_t> bytes_{0};
+
+    // bytes/s are computed over windows of at least gkfs::config::scheduler::load_window
+    std::mutex rate_mutex_;
+    std::chrono::steady_clock::time_point window_start_{std::chrono::steady_clock::now()};
+    uint64_t window_bytes_{0};
+    uint64_t bytes_per_sec_{0};
+
+public:
+    void begin(uint64_t size);
+
+    void end();
+
+    uint64_t queue_depth() const;
+
+    uint64_t bytes_per_sec();
+};
+
+/**
+ * Enters the scheduler on construction and leaves it on destruction, i.e., when the RPC handler returns.
+ * The request is accounted in the daemon's load meanwhile.
+ */
+class ScheduledRequest {
+private:
+    std::shared_ptr<RequestScheduler> scheduler_;
+    std::shared_ptr<LoadStats> load_;
+
+public:
+    ScheduledRequest(std::shared_ptr<RequestScheduler> scheduler, std::shared_ptr<LoadStats> load,
+                     const std::string& path, RequestType type, uint64_t offset, uint64_t size);
+
+    ~ScheduledRequest();
+
+    ScheduledRequest(const ScheduledRequest&) = delete;
+
+    ScheduledRequest& operator=(const ScheduledRequest&) = delete;
+};
+
+} // namespace scheduler
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_SCHEDULER_HPP
@@ -14,11 +14,15 @@
 #ifndef GEKKOFS_DAEMON_UTIL_HPP
 #define GEKKOFS_DAEMON_UTIL_HPP
 
+#include <daemon/daemon.hpp>
+
 namespace gkfs {
 namespace util {
 void populate_hosts_file();
 
 void destroy_hosts_file();
+
+hg_addr_t lookup_peer_addr(uint64_t host_id);
 }
 }
 
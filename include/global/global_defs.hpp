@@ -21,9 +21,16 @@ namespace rpc {
 
 using chnk_id_t = unsigned long;
 
+// job id of writes between daemons, e.g., of a server-side copy. These writes are not scheduled by the QoS of the
+// receiving daemon. QoS classes cannot name it as ':' separates the fields of a class
+constexpr auto internal_job_id = "gkfs:internal";
+
 namespace tag {
 
 constexpr auto fs_config = "rpc_srv_fs_config";
+constexpr auto get_load = "rpc_srv_get_load";
+constexpr auto get_qos_stats = "rpc_srv_get_qos_stats";
+constexpr auto flush_data = "rpc_srv_flush_data";
 constexpr auto create = "rpc_srv_mk_node";
 constexpr auto stat = "rpc_srv_stat";
 constexpr auto remove = "rpc_srv_rm_node";
@@ -32,6 +39,9 @@ constexpr auto update_metadentry = "rpc_srv_update_metadentry";
 constexpr auto get_metadentry_size = "rpc_srv_get_metadentry_size";
 constexpr auto update_metadentry_size = "rpc_srv_update_metadentry_size";
 constexpr auto get_dirents = "rpc_srv_get_dirents";
+constexpr auto create_batch = "rpc_srv_mk_node_batch";
+constexpr auto stat_batch = "rpc_srv_stat_batch";
+constexpr auto remove_batch = "rpc_srv_rm_node_batch";
 #ifdef HAS_SYMLINKS
 constexpr auto mk_symlink = "rpc_srv_mk_symlink";
 #endif
@@ -39,6 +49,8 @@ constexpr auto write = "rpc_srv_write_data";
 constexpr auto read = "rpc_srv_read_data";
 constexpr auto truncate = "rpc_srv_trunc_data";
 constexpr auto get_chunk_stat = "rpc_srv_chunk_stat";
+constexpr auto get_chunk_stat_tree = "rpc_srv_chunk_stat_tree";
+constexpr auto copy_chunks = "rpc_srv_copy_chunks";
 } // namespace tag
 
 namespace protocol {
@@ -35,6 +35,9 @@ private:
     nlink_t link_count_;   // number of names for this inode (hardlinks)
     size_t size_;          // size_ in bytes, might be computed instead of stored
     blkcnt_t blocks_;      // allocated file system blocks_
+    unsigned int stripe_count_; // number of hosts the file's data is striped over. 0 means all hosts (default)
+    size_t stripe_size_;   // size of a stripe unit in bytes. Multiple of the chunksize
+    unsigned int stripe_start_; // host id holding the first stripe unit
 #ifdef HAS_SYMLINKS
     std::string target_path_;  // For links this is the path of the target file
 #endif
@@ -89,6 +92,18 @@ public:
 
     void blocks(blkcnt_t blocks_);
 
+    unsigned int stripe_count() const;
+
+    void stripe_count(unsigned int stripe_count);
+
+    size_t stripe_size() const;
+
+    void stripe_size(size_t stripe_size);
+
+    unsigned int stripe_start() const;
+
+    void stripe_start(unsigned int stripe_start);
+
 #ifdef HAS_SYMLINKS
 
     std::string target_path() const;
@@ -17,6 +17,10 @@
 #include <vector>
 #include <string>
 #include <numeric>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 namespace gkfs {
 namespace rpc {
@@ -24,12 +28,31 @@ namespace rpc {
 using chunkid_t = unsigned int;
 using host_t = unsigned int;
 
+/**
+ * Per-file data layout as stored in the metadentry.
+ * A stripe_count of 0 selects the default placement where every chunk is hashed over all hosts.
+ * Otherwise, stripe units of stripe_size bytes (a multiple of the chunksize) are placed round-robin
+ * on stripe_count consecutive hosts beginning with start_host.
+ */
+struct StripeLayout {
+    unsigned int stripe_count{0};
+    size_t stripe_size{0};
+    host_t start_host{0};
+
+    bool is_default() const {
+        return stripe_count == 0;
+    }
+};
+
 class Distributor {
 public:
     virtual host_t localhost() const = 0;
 
     virtual host_t locate_data(const std::string& path, const chunkid_t& chnk_id) const = 0;
 
+    virtual host_t
+    locate_data(const std::string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const = 0;
+
     virtual host_t locate_file_metadata(const std::string& path) const = 0;
 
     virtual std::vector<host_t> locate_directory_metadata(const std::string& path) const = 0;
@@ -49,6 +72,8 @@ public:
 
     host_t locate_data(const std::string& path, const chunkid_t& chnk_id) const override;
 
+    host_t locate_data(const std::string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const override;
+
     host_t locate_file_metadata(const std::string& path) const override;
 
     std::vector<host_t> locate_directory_metadata(const std::string& path) const override;
@@ -64,24 +89,49 @@ public:
 
     host_t locate_data(const std::string& path, const chunkid_t& chnk_id) const override;
 
+    host_t locate_data(const std::string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const override;
+
     host_t locate_file_metadata(const std::string& path) const override;
 
     std::vector<host_t> locate_directory_metadata(const std::string& path) const override;
 };
 
+/**
+ * Forwarders that data of open files is sent to. A file keeps the forwarder it was opened with until its last
+ * open file description is closed, even if the client moves to another forwarder meanwhile.
+ */
+class ForwarderPins {
+private:
+    // path -> (forwarder, open count)
+    std::unordered_map<std::string, std::pair<host_t, unsigned int>> pins_;
+    mutable std::mutex mutex_;
+    // skips the lookup while no file is pinned
+    std::atomic<size_t> size_{0};
+public:
+    void pin(const std::string& path, host_t host);
+
+    void unpin(const std::string& path);
+
+    bool lookup(const std::string& path, host_t& host) const;
+};
+
 class ForwarderDistributor : public Distributor {
 private:
     host_t fwd_host_;
     unsigned int hosts_size_;
     std::vector<host_t> all_hosts_;
     std::hash<std::string> str_hash;
+    std::shared_ptr<ForwarderPins> pins_;
 public:
-    ForwarderDistributor(host_t fwhost, unsigned int hosts_size);
+    ForwarderDistributor(host_t fwhost, unsigned int hosts_size, std::shared_ptr<ForwarderPins> pins = nullptr);
 
     host_t localhost() const override final;
 
     host_t locate_data(const std::string& path, const chunkid_t& chnk_id) const override final;
 
+    host_t
+    locate_data(const std::string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const override final;
+
     host_t locate_file_metadata(const std::string& path) const override;
 
     std::vector<host_t> locate_directory_metadata(const std::string& path) const override;
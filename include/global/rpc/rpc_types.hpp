@@ -29,7 +29,10 @@ MERCURY_GEN_PROC(rpc_err_out_t,
 // Metadentry
 MERCURY_GEN_PROC(rpc_mk_node_in_t,
                  ((hg_const_string_t) (path))
-                         ((uint32_t) (mode)))
+                         ((uint32_t) (mode))
+                         ((hg_uint32_t) (stripe_count))
+                         ((hg_uint64_t) (stripe_size))
+                         ((hg_uint32_t) (stripe_start)))
 
 MERCURY_GEN_PROC(rpc_path_only_in_t,
                  ((hg_const_string_t) (path)))
@@ -78,6 +81,25 @@ MERCURY_GEN_PROC(rpc_get_metadentry_size_out_t,
                  ((hg_int32_t) (err))
                          ((hg_int64_t) (ret_size)))
 
+// batched metadentry operations. Paths are transferred as consecutive null-terminated strings via bulk
+MERCURY_GEN_PROC(rpc_mk_node_batch_in_t,
+                 ((hg_uint64_t) (count))
+                         ((hg_uint64_t) (paths_size))
+                         ((uint32_t) (mode))
+                         ((hg_uint32_t) (stripe_count))
+                         ((hg_uint64_t) (stripe_size))
+                         ((hg_uint32_t) (stripe_start))
+                         ((hg_bulk_t) (bulk_handle)))
+
+MERCURY_GEN_PROC(rpc_batch_in_t,
+                 ((hg_uint64_t) (count))
+                         ((hg_uint64_t) (paths_size))
+                         ((hg_bulk_t) (bulk_handle)))
+
+MERCURY_GEN_PROC(rpc_batch_out_t,
+                 ((hg_int32_t) (err))
+                         ((hg_size_t) (out_size)))
+
 #ifdef HAS_SYMLINKS
 MERCURY_GEN_PROC(rpc_mk_symlink_in_t,
                  ((hg_const_string_t) (path))
@@ -96,6 +118,10 @@ MERCURY_GEN_PROC(rpc_read_data_in_t,
                          ((hg_uint64_t) (chunk_start))
                          ((hg_uint64_t) (chunk_end))
                          ((hg_uint64_t) (total_chunk_size))
+                         ((hg_uint32_t) (stripe_count))
+                         ((hg_uint64_t) (stripe_size))
+                         ((hg_uint32_t) (stripe_start))
+                         ((hg_const_string_t) (job_id))
                          ((hg_bulk_t) (bulk_handle)))
 
 MERCURY_GEN_PROC(rpc_data_out_t,
@@ -111,6 +137,10 @@ MERCURY_GEN_PROC(rpc_write_data_in_t,
                          ((hg_uint64_t) (chunk_start))
                          ((hg_uint64_t) (chunk_end))
                          ((hg_uint64_t) (total_chunk_size))
+                         ((hg_uint32_t) (stripe_count))
+                         ((hg_uint64_t) (stripe_size))
+                         ((hg_uint32_t) (stripe_start))
+                         ((hg_const_string_t) (job_id))
                          ((hg_bulk_t) (bulk_handle)))
 
 MERCURY_GEN_PROC(rpc_get_dirents_in_t,
@@ -137,10 +167,51 @@ MERCURY_GEN_PROC(rpc_config_out_t,
 )
 
 
+// load of a daemon's data path, used by clients to choose among candidate forwarders
+MERCURY_GEN_PROC(rpc_load_out_t,
+                 ((hg_int32_t) (err))
+                         ((hg_uint64_t) (queue_depth))
+                         ((hg_uint64_t) (bytes_per_sec))
+                         ((hg_uint64_t) (pending_tasks))
+                         ((hg_uint64_t) (metadata_queue_depth))
+                         ((hg_uint64_t) (data_queue_depth))
+)
+
+// per-job QoS statistics of a daemon as text, a line per job
+MERCURY_GEN_PROC(rpc_qos_stats_out_t,
+                 ((hg_int32_t) (err))
+                         ((hg_const_string_t) (stats))
+)
+
 MERCURY_GEN_PROC(rpc_chunk_stat_in_t,
                  ((hg_int32_t) (dummy))
 )
 
+// server-side copy of [src_offset, src_offset + count) of src_path to dst_offset of dst_path.
+// The receiving daemon (host_id) copies the source chunks it stores
+MERCURY_GEN_PROC(rpc_copy_chunks_in_t,
+                 ((hg_const_string_t) (src_path))
+                         ((hg_const_string_t) (dst_path))
+                         ((int64_t) (src_offset))
+                         ((int64_t) (dst_offset))
+                         ((hg_uint64_t) (count))
+                         ((hg_uint64_t) (host_id))
+                         ((hg_uint64_t) (host_size))
+                         ((hg_uint32_t) (src_stripe_count))
+                         ((hg_uint64_t) (src_stripe_size))
+                         ((hg_uint32_t) (src_stripe_start))
+                         ((hg_uint32_t) (dst_stripe_count))
+                         ((hg_uint64_t) (dst_stripe_size))
+                         ((hg_uint32_t) (dst_stripe_start))
+)
+
+// collective chunk stat over the hosts [first_host, last_host). The receiving daemon is first_host
+MERCURY_GEN_PROC(rpc_chunk_stat_tree_in_t,
+                 ((hg_uint64_t) (first_host))
+                         ((hg_uint64_t) (last_host))
+                         ((hg_uint32_t) (fanout))
+)
+
 MERCURY_GEN_PROC(rpc_chunk_stat_out_t,
                  ((hg_int32_t) (err))
                          ((hg_uint64_t) (chunk_size))
@@ -0,0 +1,161 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <client/aio_queue.hpp>
+#include <config.hpp>
+#ifndef BYPASS_SYSCALL
+#include <client/intercept.hpp>
+#endif
+
+#include <cerrno>
+#include <limits>
+
+using namespace std;
+
+namespace gkfs {
+namespace aio {
+
+AioQueue::~AioQueue() {
+    shutdown();
+}
+
+/**
+ * Worker thread: takes the oldest pending request, waits for its responses, and marks it as done.
+ * Returns once the queue is shut down and all pending requests are completed.
+ */
+void AioQueue::complete_requests_() {
+#ifndef BYPASS_SYSCALL
+    // syscalls made while collecting RPC responses must not be intercepted as the application's
+    gkfs::preload::enter_internal_thread();
+#endif
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        idle_++;
+        submitted_.wait(lock, [this] { return !pending_.empty() || !running_; });
+        idle_--;
+        if (pending_.empty())
+            return;
+        auto id = pending_.front();
+        pending_.pop_front();
+        auto result = requests_.at(id).result;
+        lock.unlock();
+        // blocks until all RPC responses of this request have arrived
+        auto ret = result.get();
+        lock.lock();
+        // wait() only removes completed requests, so the request is still there
+        auto& req = requests_.at(id);
+        req.ret = ret;
+        req.done = true;
+        completed_.notify_all();
+    }
+}
+
+/**
+ * Posts a request and adds it to the queue. A worker thread is started if no worker is free to wait for it.
+ * errno may be set
+ * @param post sends the RPCs of the request and returns the future holding its result or an invalid future on error.
+ * It is not called if gkfs::config::io::aio_max_requests requests are not waited for yet
+ * @return request id or -1 on error
+ */
+int AioQueue::submit(const function<shared_future<io_result>()>& post) {
+    int id;
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (requests_.size() >= gkfs::config::io::aio_max_requests) {
+            errno = EAGAIN;
+            return -1;
+        }
+        // ids wrap around, skipping those of requests that are still not waited for
+        do {
+            id = next_id_;
+            next_id_ = next_id_ == numeric_limits<int>::max() ? 0 : next_id_ + 1;
+        } while (requests_.count(id) != 0);
+        // reserves the id. No worker takes the request before it is pending
+        requests_.emplace(id, Request{{}, false, false, io_result{0, 0}});
+    }
+    auto result = post();
+    lock_guard<mutex> lock(mutex_);
+    if (!result.valid()) {
+        requests_.erase(id);
+        completed_.notify_all();
+        return -1;
+    }
+    running_ = true;
+    requests_.at(id).result = move(result);
+    pending_.push_back(id);
+    if (pending_.size() > idle_ && workers_.size() < gkfs::config::io::aio_workers)
+        workers_.emplace_back(&AioQueue::complete_requests_, this);
+    submitted_.notify_one();
+    return id;
+}
+
+/**
+ * Checks whether a request is completed without blocking
+ * @param id
+ * @return 1 if completed, 0 if still in flight, -1 if the request does not exist
+ */
+int AioQueue::poll(const int id) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = requests_.find(id);
+    if (it == requests_.end())
+        return -1;
+    return it->second.done ? 1 : 0;
+}
+
+/**
+ * Waits until a request is completed and removes it. Only one thread may wait for a request
+ * @param id
+ * @param ret (return val) result of the request
+ * @return 0 on success, EINVAL if the request does not exist, or EBUSY if another thread waits for it
+ */
+int AioQueue::wait(const int id, io_result& ret) {
+    unique_lock<mutex> lock(mutex_);
+    auto it = requests_.find(id);
+    if (it == requests_.end())
+        return EINVAL;
+    if (it->second.waited)
+        return EBUSY;
+    it->second.waited = true;
+    // a request whose posting failed is removed by submit()
+    completed_.wait(lock, [this, id] {
+        auto req = requests_.find(id);
+        return req == requests_.end() || req->second.done;
+    });
+    it = requests_.find(id);
+    if (it == requests_.end())
+        return EINVAL;
+    ret = it->second.ret;
+    requests_.erase(it);
+    return 0;
+}
+
+/**
+ * Completes all pending requests and stops the worker threads. Must be called before the RPC subsystem shuts down.
+ * A later submit() starts new worker threads.
+ */
+void AioQueue::shutdown() {
+    vector<thread> workers;
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (!running_)
+            return;
+        running_ = false;
+        workers.swap(workers_);
+        submitted_.notify_all();
+    }
+    for (auto& worker : workers)
+        worker.join();
+}
+
+} // namespace aio
+} // namespace gkfs
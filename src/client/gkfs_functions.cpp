@@ -20,16 +20,25 @@
 #include <client/rpc/forward_metadata.hpp>
 #include <client/rpc/forward_data.hpp>
 #include <client/open_dir.hpp>
+#include <client/aio_queue.hpp>
+#include <client/mapped_regions.hpp>
 
 #include <global/path_util.hpp>
+#include <global/chunk_calc_util.hpp>
 
 extern "C" {
 #include <dirent.h> // used for file types in the getdents{,64}() functions
 #include <linux/kernel.h> // used for definition of alignment macros
 #include <sys/statfs.h>
 #include <sys/statvfs.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 }
 
+#include <set>
+#include <mutex>
+#include <chrono>
+
 using namespace std;
 
 /*
@@ -63,11 +72,13 @@ namespace {
 
 /**
  * Checks if metadata for parent directory exists (can be disabled with CREATE_CHECK_PARENTS).
+ * If the parent directory has a stripe layout, its stripe count and size are passed on to layout.
  * errno may be set
  * @param path
+ * @param layout
  * @return 0 on success, -1 on failure
  */
-int check_parent_dir(const std::string& path) {
+int check_parent_dir(const std::string& path, gkfs::rpc::StripeLayout& layout) {
 #if CREATE_CHECK_PARENTS
     auto p_comp = gkfs::path::dirname(path);
     auto md = gkfs::util::get_metadata(p_comp);
@@ -84,9 +95,219 @@ int check_parent_dir(const std::string& path) {
         errno = ENOTDIR;
         return -1;
     }
+    if (md->stripe_count() > 0) {
+        layout.stripe_count = md->stripe_count();
+        layout.stripe_size = md->stripe_size();
+    }
+#endif // CREATE_CHECK_PARENTS
+    return 0;
+}
+
+/**
+ * Looks up a path and, with CREATE_CHECK_PARENTS, its parent directory with a single round trip for a relaxed create.
+ * If the path does not exist, its parent is checked like check_parent_dir() does and the parent's stripe layout is
+ * passed on to layout.
+ * errno may be set
+ * @param path
+ * @param md (return val) metadata of the path or nullptr with errno set, e.g., to ENOENT
+ * @param layout
+ * @return 0 on success, -1 if the parent check failed
+ */
+int lookup_with_parent(const std::string& path, std::shared_ptr<gkfs::metadata::Metadata>& md,
+                       gkfs::rpc::StripeLayout& layout) {
+    std::vector<std::string> paths{path};
+#if CREATE_CHECK_PARENTS
+    paths.push_back(gkfs::path::dirname(path));
+#endif
+    std::vector<std::string> attrs{};
+    std::vector<int> errs{};
+    auto err = gkfs::rpc::forward_stat_batch(paths, attrs, errs);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    if (errs[0] == 0) {
+        md = std::make_shared<gkfs::metadata::Metadata>(attrs[0]);
+        return 0;
+    }
+    md = nullptr;
+    errno = errs[0];
+#if CREATE_CHECK_PARENTS
+    if (errs[0] != ENOENT)
+        return 0;
+    if (errs[1] != 0) {
+        LOG(DEBUG, "Parent component '{}' could not be retrieved: {}", paths[1], strerror(errs[1]));
+        errno = errs[1];
+        return -1;
+    }
+    gkfs::metadata::Metadata parent{attrs[1]};
+    if (!S_ISDIR(parent.mode())) {
+        LOG(DEBUG, "Parent component is not a directory: '{}'", paths[1]);
+        errno = ENOTDIR;
+        return -1;
+    }
+    if (parent.stripe_count() > 0) {
+        layout.stripe_count = parent.stripe_count();
+        layout.stripe_size = parent.stripe_size();
+    }
+    errno = ENOENT;
 #endif // CREATE_CHECK_PARENTS
     return 0;
 }
+
+/**
+ * Returns the chunk statistic aggregated over all daemons. The result is reused for
+ * gkfs::config::io::statfs_cache_ttl milliseconds, so that repeated statfs calls are served locally.
+ * @return pair<error code, ChunkStat>
+ */
+pair<int, gkfs::rpc::ChunkStat> get_chunk_stat() {
+    using namespace std::chrono;
+    static std::mutex cache_mutex;
+    static gkfs::rpc::ChunkStat cached_stat{};
+    static steady_clock::time_point cached_time{};
+    static bool cache_valid = false;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (cache_valid && steady_clock::now() - cached_time < milliseconds(gkfs::config::io::statfs_cache_ttl))
+            return make_pair(0, cached_stat);
+    }
+    auto ret = gkfs::rpc::forward_get_chunk_stat();
+    if (ret.first == 0) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cached_stat = ret.second;
+        cached_time = steady_clock::now();
+        cache_valid = true;
+    }
+    return ret;
+}
+
+/**
+ * Creates the metadentry for a new file or directory. Its stripe layout is taken from the parent directory
+ * or, if none is set, from the process default. The first stripe unit is placed on the host that also
+ * holds the metadentry.
+ * errno may be set
+ * @param path
+ * @param mode
+ * @param layout (return val)
+ * @return 0 on success, -1 on failure
+ */
+int create_node(const std::string& path, mode_t mode, gkfs::rpc::StripeLayout& layout) {
+    layout.stripe_count = CTX->stripe_count();
+    layout.stripe_size = CTX->stripe_size();
+    if (check_parent_dir(path, layout)) {
+        return -1;
+    }
+    if (!layout.is_default()) {
+        layout.start_host = CTX->distributor()->locate_file_metadata(path);
+    }
+    auto err = gkfs::rpc::forward_create(path, mode, layout);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Returns the total number of bytes described by an iovec array
+ * @param iov
+ * @param iovcnt
+ * @return byte count
+ */
+size_t iov_count(const struct iovec* iov, int iovcnt) {
+    size_t count = 0;
+    for (int i = 0; i < iovcnt; ++i)
+        count += iov[i].iov_len;
+    return count;
+}
+
+/**
+ * Gives back the part of a reserved file range [pos, pos + count) that was not transferred, i.e., the file
+ * position is moved back to pos + transferred. This is only done if no other operation on the same fd has
+ * advanced the position in the meantime. Otherwise, the position is left as is, since moving it back would
+ * make the other operation's range overlap with a later one.
+ * @param file
+ * @param pos
+ * @param count
+ * @param transferred bytes actually transferred (-1 on error)
+ */
+void release_pos(const std::shared_ptr<gkfs::filemap::OpenFile>& file, unsigned long pos, size_t count,
+                 ssize_t transferred) {
+    auto done = transferred > 0 ? static_cast<unsigned long>(transferred) : 0;
+    if (!file->compare_exchange_pos(pos + count, pos + done)) {
+        LOG(DEBUG, "File position of '{}' moved concurrently. Not releasing {} unused bytes", file->path(),
+            count - done);
+    }
+}
+
+/**
+ * Checks that a file can be written, updates its size, and sends the write RPCs without waiting for their responses.
+ * errno may be set
+ * @param file
+ * @param buf
+ * @param count
+ * @param offset
+ * @return future holding pair<error code, written size>, or an invalid future on error
+ */
+shared_future<pair<int, ssize_t>>
+post_pwrite(const std::shared_ptr<gkfs::filemap::OpenFile>& file, const char* buf, size_t count, off64_t offset) {
+    if (file->type() != gkfs::filemap::FileType::regular) {
+        assert(file->type() == gkfs::filemap::FileType::directory);
+        LOG(WARNING, "Cannot read from directory");
+        errno = EISDIR;
+        return {};
+    }
+    auto create_err = file->wait_for_create();
+    if (create_err) {
+        LOG(ERROR, "Deferred create of '{}' failed with err '{}'", file->path(), create_err);
+        errno = create_err;
+        return {};
+    }
+    auto path = make_shared<string>(file->path());
+    auto append_flag = file->get_flag(gkfs::filemap::OpenFile_flags::append);
+
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(*path, count, offset, append_flag);
+    auto err = ret_update_size.first;
+    if (err) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'", err);
+        errno = err;
+        return {};
+    }
+    auto updated_size = ret_update_size.second;
+
+    return gkfs::rpc::forward_write_async(*path, buf, append_flag, offset, count, updated_size, file->layout());
+}
+
+/**
+ * Checks that a file can be read and sends the read RPCs without waiting for their responses.
+ * errno may be set
+ * @param file
+ * @param buf
+ * @param count
+ * @param offset
+ * @return future holding pair<error code, read size>, or an invalid future on error
+ */
+shared_future<pair<int, ssize_t>>
+post_pread(const std::shared_ptr<gkfs::filemap::OpenFile>& file, char* buf, size_t count, off64_t offset) {
+    if (file->type() != gkfs::filemap::FileType::regular) {
+        assert(file->type() == gkfs::filemap::FileType::directory);
+        LOG(WARNING, "Cannot read from directory");
+        errno = EISDIR;
+        return {};
+    }
+    auto create_err = file->wait_for_create();
+    if (create_err) {
+        LOG(ERROR, "Deferred create of '{}' failed with err '{}'", file->path(), create_err);
+        errno = create_err;
+        return {};
+    }
+
+    // Zeroing buffer before read is only relevant for sparse files. Otherwise sparse regions contain invalid data.
+    if (gkfs::config::io::zero_buffer_before_read) {
+        memset(buf, 0, sizeof(char) * count);
+    }
+    return gkfs::rpc::forward_read_async(file->path(), buf, offset, count, file->layout());
+}
 } // namespace
 
 namespace gkfs {
@@ -115,7 +336,21 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
     }
 
     bool exists = true;
-    auto md = gkfs::util::get_metadata(path);
+    gkfs::rpc::StripeLayout layout{};
+    std::shared_ptr<gkfs::metadata::Metadata> md{};
+    // Relaxed create: without O_EXCL and O_TRUNC, the file and its parent are looked up with a single round trip and
+    // the create of a new file is not waited for. An existing file is opened as usual with its own layout.
+    // Errors of the create are reported by the next operation on the fd.
+    auto relaxed = CTX->async_create() && (flags & O_CREAT) && !(flags & (O_EXCL | O_TRUNC | O_DIRECTORY));
+    if (relaxed) {
+        layout.stripe_count = CTX->stripe_count();
+        layout.stripe_size = CTX->stripe_size();
+        if (lookup_with_parent(path, md, layout)) {
+            return -1;
+        }
+    } else {
+        md = gkfs::util::get_metadata(path);
+    }
     if (!md) {
         if (errno == ENOENT) {
             exists = false;
@@ -141,8 +376,18 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
             return -1;
         }
 
+        if (relaxed) {
+            if (!layout.is_default()) {
+                layout.start_host = CTX->distributor()->locate_file_metadata(path);
+            }
+            auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+            file->layout(layout);
+            file->pending_create(gkfs::rpc::forward_create_async(path, mode | S_IFREG, layout));
+            return CTX->file_map()->add(file);
+        }
+
         // no access check required here. If one is using our FS they have the permissions.
-        if (gkfs_create(path, mode | S_IFREG)) {
+        if (create_node(path, mode | S_IFREG, layout)) {
             LOG(ERROR, "Error creating non-existent file: '{}'", strerror(errno));
             return -1;
         }
@@ -167,22 +412,30 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
 #endif
 
         if (S_ISDIR(md->mode())) {
+            // as for open(2), a directory cannot be opened for creation
+            if (flags & O_CREAT) {
+                errno = EISDIR;
+                return -1;
+            }
             return gkfs_opendir(path);
         }
 
 
         /*** Regular file exists ***/
         assert(S_ISREG(md->mode()));
+        layout = gkfs::util::metadata_to_layout(*md);
 
         if ((flags & O_TRUNC) && ((flags & O_RDWR) || (flags & O_WRONLY))) {
-            if (gkfs_truncate(path, md->size(), 0)) {
+            if (gkfs_truncate(path, md->size(), 0, layout)) {
                 LOG(ERROR, "Error truncating file");
                 return -1;
             }
         }
     }
 
-    return CTX->file_map()->add(std::make_shared<gkfs::filemap::OpenFile>(path, flags));
+    auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+    file->layout(layout);
+    return CTX->file_map()->add(file);
 }
 
 /**
@@ -215,10 +468,23 @@ int gkfs_create(const std::string& path, mode_t mode) {
             return -1;
     }
 
-    if (check_parent_dir(path)) {
+    gkfs::rpc::StripeLayout layout{};
+    return create_node(path, mode, layout);
+}
+
+/**
+ * gkfs wrapper for unlink() system calls
+ * errno may be set
+ * @param path
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_remove(const std::string& path) {
+    auto md = gkfs::util::get_metadata(path);
+    if (!md) {
         return -1;
     }
-    auto err = gkfs::rpc::forward_create(path, mode);
+    bool has_data = S_ISREG(md->mode()) && (md->size() != 0);
+    auto err = gkfs::rpc::forward_remove(path, !has_data, md->size(), gkfs::util::metadata_to_layout(*md));
     if (err) {
         errno = err;
         return -1;
@@ -227,18 +493,99 @@ int gkfs_create(const std::string& path, mode_t mode) {
 }
 
 /**
- * gkfs wrapper for unlink() system calls
+ * Creates many files with a single RPC per responsible daemon.
+ * Unlike gkfs_create(), new files always use the process' default stripe layout.
  * errno may be set
- * @param path
+ * @param paths
+ * @param mode
  * @return 0 on success, -1 on failure
  */
-int gkfs_remove(const std::string& path) {
-    auto md = gkfs::util::get_metadata(path);
-    if (!md) {
+int gkfs_create_batch(const std::vector<std::string>& paths, mode_t mode) {
+    if ((mode & S_IFMT) == 0) {
+        mode |= S_IFREG;
+    }
+    if (!S_ISREG(mode) && !S_ISDIR(mode)) {
+        LOG(WARNING, "Unsupported node type for batched create");
+        errno = ENOTSUP;
         return -1;
     }
-    bool has_data = S_ISREG(md->mode()) && (md->size() != 0);
-    auto err = gkfs::rpc::forward_remove(path, !has_data, md->size());
+#if CREATE_CHECK_PARENTS
+    std::set<std::string> parents{};
+    for (const auto& path : paths) {
+        // check_parent_dir() only looks at the dirname, thus checking one child per parent is sufficient
+        if (!parents.insert(gkfs::path::dirname(path)).second)
+            continue;
+        gkfs::rpc::StripeLayout parent_layout{};
+        if (check_parent_dir(path, parent_layout)) {
+            return -1;
+        }
+    }
+#endif // CREATE_CHECK_PARENTS
+    auto err = gkfs::rpc::forward_create_batch(paths, mode);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Stats many paths with a single RPC per responsible daemon. Symlinks are not followed.
+ * errno may be set
+ * @param paths
+ * @param bufs (return val) one stat struct per path
+ * @param errs (return val) one error code per path, e.g., ENOENT if the path does not exist
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_stat_batch(const std::vector<std::string>& paths, std::vector<struct stat>& bufs, std::vector<int>& errs) {
+    std::vector<std::string> attrs{};
+    auto err = gkfs::rpc::forward_stat_batch(paths, attrs, errs);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    bufs.resize(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (errs[i] == 0)
+            gkfs::util::metadata_to_stat(paths[i], gkfs::metadata::Metadata{attrs[i]}, bufs[i]);
+    }
+    return 0;
+}
+
+/**
+ * Removes many files. Metadentries of files without data on other daemons are removed with a single RPC per
+ * responsible daemon. All other files are removed individually.
+ * errno may be set
+ * @param paths
+ * @return 0 on success, -1 on failure. errno is set to the last error encountered
+ */
+int gkfs_remove_batch(const std::vector<std::string>& paths) {
+    std::vector<std::string> attrs{};
+    std::vector<int> errs{};
+    auto err = gkfs::rpc::forward_stat_batch(paths, attrs, errs);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    std::vector<std::string> batch_paths{};
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (errs[i] != 0) {
+            err = errs[i];
+            continue;
+        }
+        gkfs::metadata::Metadata md{attrs[i]};
+        bool has_data = S_ISREG(md.mode()) && (md.size() != 0);
+        if (!has_data) {
+            batch_paths.emplace_back(paths[i]);
+            continue;
+        }
+        auto rm_err = gkfs::rpc::forward_remove(paths[i], false, md.size(), gkfs::util::metadata_to_layout(md));
+        if (rm_err)
+            err = rm_err;
+    }
+    auto batch_err = gkfs::rpc::forward_remove_batch(batch_paths);
+    if (batch_err)
+        err = batch_err;
     if (err) {
         errno = err;
         return -1;
@@ -339,7 +686,7 @@ int gkfs_statx(int dirfs, const std::string& path, int flags, unsigned int mask,
  */
 int gkfs_statfs(struct statfs* buf) {
 
-    auto ret = gkfs::rpc::forward_get_chunk_stat();
+    auto ret = get_chunk_stat();
     auto err = ret.first;
     if (err) {
         LOG(ERROR, "{}() Failure with error: '{}'", err);
@@ -372,7 +719,7 @@ int gkfs_statfs(struct statfs* buf) {
  * @return 0 on success, -1 on failure
  */
 int gkfs_statvfs(struct statvfs* buf) {
-    auto ret = gkfs::rpc::forward_get_chunk_stat();
+    auto ret = get_chunk_stat();
     auto err = ret.first;
     if (err) {
         LOG(ERROR, "{}() Failure with error: '{}'", err);
@@ -416,6 +763,11 @@ off_t gkfs_lseek(unsigned int fd, off_t offset, unsigned int whence) {
  * @return 0 on success, -1 on failure
  */
 off_t gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset, unsigned int whence) {
+    auto create_err = gkfs_fd->wait_for_create();
+    if (create_err) {
+        errno = create_err;
+        return -1;
+    }
     switch (whence) {
         case SEEK_SET:
             if (offset < 0) {
@@ -425,8 +777,8 @@ off_t gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset, unsi
             gkfs_fd->pos(offset);
             break;
         case SEEK_CUR:
-            gkfs_fd->pos(gkfs_fd->pos() + offset);
-            break;
+            // negative offsets wrap around in the unsigned addition as intended
+            return gkfs_fd->advance_pos(offset) + offset;
         case SEEK_END: {
             auto ret = gkfs::rpc::forward_get_metadentry_size(gkfs_fd->path());
             auto err = ret.first;
@@ -467,9 +819,10 @@ off_t gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset, unsi
  * @param path
  * @param old_size
  * @param new_size
+ * @param layout
  * @return 0 on success, -1 on failure
  */
-int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
+int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size, const gkfs::rpc::StripeLayout& layout) {
     assert(new_size >= 0);
     assert(new_size <= old_size);
 
@@ -483,7 +836,7 @@ int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
         return -1;
     }
 
-    err = gkfs::rpc::forward_truncate(path, old_size, new_size);
+    err = gkfs::rpc::forward_truncate(path, old_size, new_size, layout);
     if (err) {
         LOG(DEBUG, "Failed to truncate data");
         errno = err;
@@ -524,7 +877,29 @@ int gkfs_truncate(const std::string& path, off_t length) {
         errno = EINVAL;
         return -1;
     }
-    return gkfs_truncate(path, size, length);
+    return gkfs_truncate(path, size, length, gkfs::util::metadata_to_layout(*md));
+}
+
+/**
+ * gkfs wrapper for close() system calls. Reports the error of a deferred create of the file.
+ * errno may be set
+ * @param fd
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_close(unsigned int fd) {
+    auto file = CTX->file_map()->get(fd);
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    auto err = file->wait_for_create();
+    CTX->file_map()->remove(fd);
+    if (err) {
+        LOG(ERROR, "Deferred create of '{}' failed with err '{}'", file->path(), err);
+        errno = err;
+        return -1;
+    }
+    return 0;
 }
 
 /**
@@ -558,26 +933,12 @@ int gkfs_dup2(const int oldfd, const int newfd) {
  * @return written size or -1 on error
  */
 ssize_t gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file, const char* buf, size_t count, off64_t offset) {
-    if (file->type() != gkfs::filemap::FileType::regular) {
-        assert(file->type() == gkfs::filemap::FileType::directory);
-        LOG(WARNING, "Cannot read from directory");
-        errno = EISDIR;
+    auto result = post_pwrite(file, buf, count, offset);
+    if (!result.valid()) {
         return -1;
     }
-    auto path = make_shared<string>(file->path());
-    auto append_flag = file->get_flag(gkfs::filemap::OpenFile_flags::append);
-
-    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(*path, count, offset, append_flag);
-    auto err = ret_update_size.first;
-    if (err) {
-        LOG(ERROR, "update_metadentry_size() failed with err '{}'", err);
-        errno = err;
-        return -1;
-    }
-    auto updated_size = ret_update_size.second;
-
-    auto ret_write = gkfs::rpc::forward_write(*path, buf, append_flag, offset, count, updated_size);
-    err = ret_write.first;
+    auto ret_write = result.get();
+    auto err = ret_write.first;
     if (err) {
         LOG(WARNING, "gkfs::rpc::forward_write() failed with err '{}'", err);
         errno = err;
@@ -610,14 +971,18 @@ ssize_t gkfs_pwrite_ws(int fd, const void* buf, size_t count, off64_t offset) {
  */
 ssize_t gkfs_write(int fd, const void* buf, size_t count) {
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); //retrieve the current offset
-    if (gkfs_fd->get_flag(gkfs::filemap::OpenFile_flags::append))
-        gkfs_lseek(gkfs_fd, 0, SEEK_END);
-    auto ret = gkfs_pwrite(gkfs_fd, reinterpret_cast<const char*>(buf), count, pos);
-    // Update offset in file descriptor in the file map
-    if (ret > 0) {
-        gkfs_fd->pos(pos + count);
+    if (gkfs_fd->get_flag(gkfs::filemap::OpenFile_flags::append)) {
+        // the daemon chooses the write offset. Afterwards, the offset is the (new) end of the file
+        auto ret = gkfs_pwrite(gkfs_fd, reinterpret_cast<const char*>(buf), count, gkfs_fd->pos());
+        if (ret > 0 && gkfs_lseek(gkfs_fd, 0, SEEK_END) < 0)
+            return -1;
+        return ret;
     }
+    // reserve [pos, pos + count) so that concurrent writes on a shared fd never overlap
+    auto pos = gkfs_fd->advance_pos(count);
+    auto ret = gkfs_pwrite(gkfs_fd, reinterpret_cast<const char*>(buf), count, pos);
+    if (ret < static_cast<ssize_t>(count))
+        release_pos(gkfs_fd, pos, count, ret);
     return ret;
 }
 
@@ -671,13 +1036,15 @@ ssize_t gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset)
 ssize_t gkfs_writev(int fd, const struct iovec* iov, int iovcnt) {
 
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); // retrieve the current offset
+    auto count = iov_count(iov, iovcnt);
+    auto pos = gkfs_fd->advance_pos(count); // reserve [pos, pos + count)
     auto ret = gkfs_pwritev(fd, iov, iovcnt, pos);
     assert(ret != 0);
+    if (ret < static_cast<ssize_t>(count))
+        release_pos(gkfs_fd, pos, count, ret);
     if (ret < 0) {
         return -1;
     }
-    gkfs_fd->pos(pos + ret);
     return ret;
 }
 
@@ -690,18 +1057,11 @@ ssize_t gkfs_writev(int fd, const struct iovec* iov, int iovcnt) {
  * @return read size or -1 on error
  */
 ssize_t gkfs_pread(std::shared_ptr<gkfs::filemap::OpenFile> file, char* buf, size_t count, off64_t offset) {
-    if (file->type() != gkfs::filemap::FileType::regular) {
-        assert(file->type() == gkfs::filemap::FileType::directory);
-        LOG(WARNING, "Cannot read from directory");
-        errno = EISDIR;
+    auto result = post_pread(file, buf, count, offset);
+    if (!result.valid()) {
         return -1;
     }
-
-    // Zeroing buffer before read is only relevant for sparse files. Otherwise sparse regions contain invalid data.
-    if (gkfs::config::io::zero_buffer_before_read) {
-        memset(buf, 0, sizeof(char) * count);
-    }
-    auto ret = gkfs::rpc::forward_read(file->path(), buf, offset, count);
+    auto ret = result.get();
     auto err = ret.first;
     if (err) {
         LOG(WARNING, "gkfs::rpc::forward_read() failed with ret '{}'", err);
@@ -722,12 +1082,11 @@ ssize_t gkfs_pread(std::shared_ptr<gkfs::filemap::OpenFile> file, char* buf, siz
  */
 ssize_t gkfs_read(int fd, void* buf, size_t count) {
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); //retrieve the current offset
+    auto pos = gkfs_fd->advance_pos(count); // reserve [pos, pos + count)
     auto ret = gkfs_pread(gkfs_fd, reinterpret_cast<char*>(buf), count, pos);
-    // Update offset in file descriptor in the file map
-    if (ret > 0) {
-        gkfs_fd->pos(pos + ret);
-    }
+    // a short read (e.g., at the end of the file) only advances the offset by the bytes actually read
+    if (ret < static_cast<ssize_t>(count))
+        release_pos(gkfs_fd, pos, count, ret);
     return ret;
 }
 
@@ -781,16 +1140,312 @@ ssize_t gkfs_preadv(int fd, const struct iovec* iov, int iovcnt, off_t offset) {
 ssize_t gkfs_readv(int fd, const struct iovec* iov, int iovcnt) {
 
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); // retrieve the current offset
+    auto count = iov_count(iov, iovcnt);
+    auto pos = gkfs_fd->advance_pos(count); // reserve [pos, pos + count)
     auto ret = gkfs_preadv(fd, iov, iovcnt, pos);
     assert(ret != 0);
+    if (ret < static_cast<ssize_t>(count))
+        release_pos(gkfs_fd, pos, count, ret);
+    if (ret < 0) {
+        return -1;
+    }
+    return ret;
+}
+
+/**
+ * Starts an asynchronous write of count bytes from buf at offset. The file size is updated before this function
+ * returns, the data transfer is completed in the background. buf must not be modified until the request completed.
+ * errno may be set
+ * @param fd
+ * @param buf
+ * @param count
+ * @param offset
+ * @return request id for gkfs_aio_poll() and gkfs_aio_wait() or -1 on error, EAGAIN if too many requests are not
+ * waited for
+ */
+int gkfs_aio_pwrite(int fd, const void* buf, size_t count, off64_t offset) {
+    auto file = CTX->file_map()->get(fd);
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    return CTX->aio_queue()->submit([&]() {
+        if (count == 0) {
+            promise<pair<int, ssize_t>> nothing;
+            nothing.set_value(make_pair(0, static_cast<ssize_t>(0)));
+            return nothing.get_future().share();
+        }
+        return post_pwrite(file, reinterpret_cast<const char*>(buf), count, offset);
+    });
+}
+
+/**
+ * Starts an asynchronous read of count bytes at offset into buf. buf must not be accessed until the request completed.
+ * errno may be set
+ * @param fd
+ * @param buf
+ * @param count
+ * @param offset
+ * @return request id for gkfs_aio_poll() and gkfs_aio_wait() or -1 on error, EAGAIN if too many requests are not
+ * waited for
+ */
+int gkfs_aio_pread(int fd, void* buf, size_t count, off64_t offset) {
+    auto file = CTX->file_map()->get(fd);
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    return CTX->aio_queue()->submit([&]() {
+        if (count == 0) {
+            promise<pair<int, ssize_t>> nothing;
+            nothing.set_value(make_pair(0, static_cast<ssize_t>(0)));
+            return nothing.get_future().share();
+        }
+        return post_pread(file, reinterpret_cast<char*>(buf), count, offset);
+    });
+}
+
+/**
+ * Checks without blocking whether an asynchronous request has completed
+ * errno may be set
+ * @param req request id
+ * @return 1 if completed, 0 if still in flight, -1 on error
+ */
+int gkfs_aio_poll(int req) {
+    auto ret = CTX->aio_queue()->poll(req);
     if (ret < 0) {
+        errno = EINVAL;
         return -1;
     }
-    gkfs_fd->pos(pos + ret);
     return ret;
 }
 
+/**
+ * Waits for an asynchronous request to complete and releases it. The request id is invalid afterwards. Every request
+ * must be waited for exactly once, a second thread waiting for the same request fails with EBUSY.
+ * errno may be set
+ * @param req request id
+ * @return transferred size or -1 on error
+ */
+ssize_t gkfs_aio_wait(int req) {
+    gkfs::aio::io_result ret;
+    auto err = CTX->aio_queue()->wait(req, ret);
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    if (ret.first) {
+        LOG(WARNING, "Asynchronous request {} failed with err '{}'", req, ret.first);
+        errno = ret.first;
+        return -1;
+    }
+    return ret.second;
+}
+
+/**
+ * Writes up to len bytes pulled from source to a GekkoFS file at offset. The data is streamed in chunk-sized blocks
+ * through two buffers: while the write RPCs of one block are in flight, the next block is pulled from source.
+ * errno may be set
+ * @param fd
+ * @param offset
+ * @param len
+ * @param source fills a buffer and returns the number of bytes, 0 at the end of the data, or -1 with errno set
+ * @return written size or -1 on error
+ */
+ssize_t gkfs_write_from(int fd, off64_t offset, size_t len, const std::function<ssize_t(char*, size_t)>& source) {
+    auto file = CTX->file_map()->get(fd);
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    const auto block_size = std::min(len, static_cast<size_t>(gkfs::config::rpc::chunksize));
+    vector<char> bufs[2] = {vector<char>(block_size), vector<char>(block_size)};
+    // write of the previous block whose buffer must not be reused before it is completed
+    shared_future<pair<int, ssize_t>> pending{};
+    size_t pulled = 0;
+    ssize_t written = 0;
+    auto err = 0;
+    for (auto cur = 0; pulled < len; cur ^= 1) {
+        auto n = source(bufs[cur].data(), std::min(block_size, len - pulled));
+        if (n <= 0) {
+            err = n < 0 ? errno : 0;
+            break;
+        }
+        auto result = post_pwrite(file, bufs[cur].data(), n, offset + pulled);
+        if (!result.valid()) {
+            err = errno;
+            break;
+        }
+        pulled += n;
+        if (pending.valid()) {
+            auto ret = pending.get();
+            if (ret.first) {
+                err = ret.first;
+                pending = result;
+                break;
+            }
+            written += ret.second;
+        }
+        pending = result;
+    }
+    if (pending.valid()) {
+        auto ret = pending.get();
+        if (ret.first) {
+            err = err ? err : ret.first;
+        } else if (!err) {
+            written += ret.second;
+        }
+    }
+    if (err && written == 0) {
+        LOG(ERROR, "Streaming write to '{}' failed with err '{}'", file->path(), err);
+        errno = err;
+        return -1;
+    }
+    return written;
+}
+
+/**
+ * Reads up to len bytes of a GekkoFS file at offset and pushes them to sink. Reading stops at the end of the file.
+ * Like gkfs_write_from(), the next block is read while the previous one is passed to sink.
+ * errno may be set
+ * @param fd
+ * @param offset
+ * @param len
+ * @param sink consumes a whole buffer and returns its size or -1 with errno set
+ * @return transferred size or -1 on error
+ */
+ssize_t gkfs_read_to(int fd, off64_t offset, size_t len, const std::function<ssize_t(const char*, size_t)>& sink) {
+    auto file = CTX->file_map()->get(fd);
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    auto size_ret = gkfs::rpc::forward_get_metadentry_size(file->path());
+    if (size_ret.first) {
+        errno = size_ret.first;
+        return -1;
+    }
+    if (offset >= size_ret.second)
+        return 0;
+    len = std::min(len, static_cast<size_t>(size_ret.second - offset));
+    const auto block_size = std::min(len, static_cast<size_t>(gkfs::config::rpc::chunksize));
+    vector<char> bufs[2] = {vector<char>(block_size), vector<char>(block_size)};
+    size_t posted = std::min(block_size, len);
+    auto pending = post_pread(file, bufs[0].data(), posted, offset);
+    if (!pending.valid())
+        return -1;
+    ssize_t transferred = 0;
+    auto err = 0;
+    for (auto cur = 0; pending.valid(); cur ^= 1) {
+        auto ret = pending.get();
+        pending = {};
+        if (ret.first) {
+            err = ret.first;
+            break;
+        }
+        if (ret.second == 0)
+            break;
+        // read the next block while this one is passed on
+        if (posted < len) {
+            auto n = std::min(block_size, len - posted);
+            pending = post_pread(file, bufs[cur ^ 1].data(), n, offset + posted);
+            if (!pending.valid()) {
+                err = errno;
+            }
+            posted += n;
+        }
+        if (sink(bufs[cur].data(), ret.second) < 0) {
+            err = errno;
+            if (pending.valid())
+                pending.get();
+            break;
+        }
+        transferred += ret.second;
+        if (err)
+            break;
+    }
+    if (err && transferred == 0) {
+        LOG(ERROR, "Streaming read from '{}' failed with err '{}'", file->path(), err);
+        errno = err;
+        return -1;
+    }
+    return transferred;
+}
+
+/**
+ * Copies len bytes from one GekkoFS file to another, as copy_file_range() does. If source and destination offsets
+ * have the same position within a chunk, the daemons copy the chunks directly. Otherwise the data is streamed
+ * through the client.
+ * errno may be set
+ * @param fd_in
+ * @param off_in
+ * @param fd_out
+ * @param off_out
+ * @param len
+ * @return copied size or -1 on error
+ */
+ssize_t gkfs_copy_file_range(int fd_in, off64_t off_in, int fd_out, off64_t off_out, size_t len) {
+    auto src = CTX->file_map()->get(fd_in);
+    auto dst = CTX->file_map()->get(fd_out);
+    if (!src || !dst) {
+        errno = EBADF;
+        return -1;
+    }
+    if (src->type() != gkfs::filemap::FileType::regular || dst->type() != gkfs::filemap::FileType::regular) {
+        errno = EISDIR;
+        return -1;
+    }
+    for (const auto& file : {src, dst}) {
+        auto create_err = file->wait_for_create();
+        if (create_err) {
+            LOG(ERROR, "Deferred create of '{}' failed with err '{}'", file->path(), create_err);
+            errno = create_err;
+            return -1;
+        }
+    }
+    auto size_ret = gkfs::rpc::forward_get_metadentry_size(src->path());
+    if (size_ret.first) {
+        errno = size_ret.first;
+        return -1;
+    }
+    if (len == 0 || off_in >= size_ret.second)
+        return 0;
+    len = std::min(len, static_cast<size_t>(size_ret.second - off_in));
+    if (src->path() == dst->path() && off_in < static_cast<off64_t>(off_out + len) &&
+        off_out < static_cast<off64_t>(off_in + len)) {
+        // overlapping ranges within the same file
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (gkfs::util::chnk_lpad(off_in, gkfs::config::rpc::chunksize) !=
+        gkfs::util::chnk_lpad(off_out, gkfs::config::rpc::chunksize)) {
+        LOG(DEBUG, "Unaligned copy from '{}' to '{}'. Copying through the client", src->path(), dst->path());
+        auto pos = off_in;
+        return gkfs_write_from(fd_out, off_out, len, [&src, &pos](char* buf, size_t count) {
+            auto n = gkfs_pread(src, buf, count, pos);
+            if (n > 0)
+                pos += n;
+            return n;
+        });
+    }
+
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(dst->path(), len, off_out, false);
+    if (ret_update_size.first) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'", ret_update_size.first);
+        errno = ret_update_size.first;
+        return -1;
+    }
+    auto ret = gkfs::rpc::forward_copy_chunks(src->path(), src->layout(), off_in, dst->path(), dst->layout(), off_out,
+                                              len);
+    if (ret.first) {
+        LOG(WARNING, "gkfs::rpc::forward_copy_chunks() failed with err '{}'", ret.first);
+        errno = ret.first;
+        return -1;
+    }
+    return ret.second;
+}
+
 /**
  * gkfs wrapper for pread() system calls
  * errno may be set
@@ -805,6 +1460,77 @@ ssize_t gkfs_pread_ws(int fd, void* buf, size_t count, off64_t offset) {
     return gkfs_pread(gkfs_fd, reinterpret_cast<char*>(buf), count, offset);
 }
 
+/**
+ * gkfs wrapper for mmap() system calls. The mapping is backed by anonymous memory that is filled from GekkoFS,
+ * see gkfs::mapping::MappedRegions
+ * errno may be set
+ * @param addr
+ * @param length
+ * @param prot
+ * @param flags
+ * @param fd
+ * @param offset
+ * @return start of the mapping or MAP_FAILED on error
+ */
+void* gkfs_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+    auto gkfs_fd = CTX->file_map()->get(fd);
+    if (gkfs_fd == nullptr) {
+        errno = EBADF;
+        return MAP_FAILED;
+    }
+    if (gkfs_fd->type() != gkfs::filemap::FileType::regular) {
+        errno = ENODEV;
+        return MAP_FAILED;
+    }
+    struct stat st{};
+    if (gkfs_stat(gkfs_fd->path(), &st) != 0) {
+        return MAP_FAILED;
+    }
+    void* mapped = nullptr;
+    auto err = CTX->mapped_regions()->map(addr, length, prot, flags, gkfs_fd, offset, st.st_size, mapped);
+    if (err) {
+        errno = err;
+        return MAP_FAILED;
+    }
+    return mapped;
+}
+
+/**
+ * gkfs wrapper for munmap() system calls. Modified pages of shared mappings are written back first
+ * errno may be set
+ * @param addr
+ * @param length
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_munmap(void* addr, size_t length) {
+    auto err = CTX->mapped_regions()->unmap(addr, length);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * gkfs wrapper for msync() system calls. Written pages of shared writable mappings are written back
+ * errno may be set
+ * @param addr
+ * @param length
+ * @param flags
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_msync(void* addr, size_t length, int flags) {
+    // the kernel validates the arguments and the range
+    auto err = syscall_error_code(syscall_no_intercept(SYS_msync, addr, length, flags));
+    if (!err)
+        err = CTX->mapped_regions()->sync(addr, length);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * wrapper function for opening directories
  * errno may be set
@@ -864,7 +1590,7 @@ int gkfs_rmdir(const std::string& path) {
         errno = ENOTEMPTY;
         return -1;
     }
-    err = gkfs::rpc::forward_remove(path, true, 0);
+    err = gkfs::rpc::forward_remove(path, true, 0, gkfs::rpc::StripeLayout{});
     if (err) {
         errno = err;
         return -1;
@@ -18,6 +18,7 @@
 #include <client/gkfs_functions.hpp>
 #include <client/path.hpp>
 #include <client/open_dir.hpp>
+#include <client/mapped_regions.hpp>
 
 #include <global/path_util.hpp>
 
@@ -28,6 +29,7 @@ extern "C" {
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/mman.h>
 }
 
 namespace {
@@ -37,6 +39,72 @@ inline int with_errno(int ret) {
     return (ret < 0) ? -errno : ret;
 }
 
+/**
+ * Copies len bytes between two fds of which at least one belongs to GekkoFS.
+ * A null offset pointer selects the fd's file position, which is advanced by the copied size. Otherwise the copy
+ * starts at *off, which is advanced instead.
+ * @return copied size or -errno
+ */
+long copy_between(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len) {
+    auto in_file = CTX->file_map()->get(fd_in);
+    auto out_file = CTX->file_map()->get(fd_out);
+    // GekkoFS files using their file position reserve the whole range up front
+    const loff_t in_pos = off_in ? *off_in : (in_file ? static_cast<loff_t>(in_file->advance_pos(len)) : 0);
+    const loff_t out_pos = off_out ? *off_out : (out_file ? static_cast<loff_t>(out_file->advance_pos(len)) : 0);
+
+    ssize_t ret;
+    if (in_file && out_file) {
+        ret = gkfs::syscall::gkfs_copy_file_range(fd_in, in_pos, fd_out, out_pos, len);
+    } else if (out_file) {
+        // import into GekkoFS: stream from the kernel file
+        auto src_pos = in_pos;
+        ret = gkfs::syscall::gkfs_write_from(fd_out, out_pos, len, [&](char* buf, size_t count) -> ssize_t {
+            auto n = off_in ? syscall_no_intercept(SYS_pread64, fd_in, buf, count, src_pos)
+                            : syscall_no_intercept(SYS_read, fd_in, buf, count);
+            if (syscall_error_code(n)) {
+                errno = syscall_error_code(n);
+                return -1;
+            }
+            src_pos += n;
+            return n;
+        });
+    } else {
+        // export from GekkoFS: stream to the kernel file
+        auto dst_pos = out_pos;
+        ret = gkfs::syscall::gkfs_read_to(fd_in, in_pos, len, [&](const char* buf, size_t count) -> ssize_t {
+            size_t total = 0;
+            while (total < count) {
+                auto n = off_out ? syscall_no_intercept(SYS_pwrite64, fd_out, buf + total, count - total,
+                                                        dst_pos + total)
+                                 : syscall_no_intercept(SYS_write, fd_out, buf + total, count - total);
+                if (syscall_error_code(n)) {
+                    errno = syscall_error_code(n);
+                    return -1;
+                }
+                total += n;
+            }
+            dst_pos += total;
+            return total;
+        });
+    }
+
+    const auto done = static_cast<size_t>(ret > 0 ? ret : 0);
+    if (done < len) {
+        // give back the unused part of the reserved ranges if no other operation moved the file positions since
+        if (!off_in && in_file)
+            in_file->compare_exchange_pos(in_pos + len, in_pos + done);
+        if (!off_out && out_file)
+            out_file->compare_exchange_pos(out_pos + len, out_pos + done);
+    }
+    if (ret < 0)
+        return -errno;
+    if (off_in)
+        *off_in += done;
+    if (off_out)
+        *off_out += done;
+    return ret;
+}
+
 } // namespace
 
 namespace gkfs {
@@ -73,9 +141,8 @@ int hook_close(int fd) {
     LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
 
     if (CTX->file_map()->exist(fd)) {
-        // No call to the daemon is required
-        CTX->file_map()->remove(fd);
-        return 0;
+        // No call to the daemon is required unless a create of the file is still outstanding
+        return with_errno(gkfs::syscall::gkfs_close(fd));
     }
 
     if (CTX->is_internal_fd(fd)) {
@@ -150,8 +217,12 @@ int hook_fstat(unsigned int fd, struct stat* buf) {
         __func__, fd, fmt::ptr(buf));
 
     if (CTX->file_map()->exist(fd)) {
-        auto path = CTX->file_map()->get(fd)->path();
-        return with_errno(gkfs::syscall::gkfs_stat(path, buf));
+        auto file = CTX->file_map()->get(fd);
+        auto err = file->wait_for_create();
+        if (err) {
+            return -err;
+        }
+        return with_errno(gkfs::syscall::gkfs_stat(file->path(), buf));
     }
     return syscall_no_intercept(SYS_fstat, fd, buf);
 }
@@ -295,9 +366,11 @@ int hook_unlinkat(int dirfd, const char* cpath, int flags) {
     auto rstatus = CTX->relativize_fd_path(dirfd, cpath, resolved, false);
     switch (rstatus) {
         case gkfs::preload::RelativizeStatus::fd_unknown:
+            CTX->resolve_cache_clear();
             return syscall_no_intercept(SYS_unlinkat, dirfd, cpath, flags);
 
         case gkfs::preload::RelativizeStatus::external:
+            CTX->resolve_cache_erase(resolved);
             return syscall_no_intercept(SYS_unlinkat, dirfd, resolved.c_str(), flags);
 
         case gkfs::preload::RelativizeStatus::fd_not_a_dir:
@@ -331,9 +404,11 @@ int hook_symlinkat(const char* oldname, int newdfd, const char* newname) {
     auto rstatus = CTX->relativize_fd_path(newdfd, newname, newname_resolved, false);
     switch (rstatus) {
         case gkfs::preload::RelativizeStatus::fd_unknown:
+            CTX->resolve_cache_clear();
             return syscall_no_intercept(SYS_symlinkat, oldname, newdfd, newname);
 
         case gkfs::preload::RelativizeStatus::external:
+            CTX->resolve_cache_erase(newname_resolved);
             return syscall_no_intercept(SYS_symlinkat, oldname, newdfd, newname_resolved.c_str());
 
         case gkfs::preload::RelativizeStatus::fd_not_a_dir:
@@ -428,8 +503,12 @@ int hook_ftruncate(unsigned int fd, unsigned long length) {
         __func__, fd, length);
 
     if (CTX->file_map()->exist(fd)) {
-        auto path = CTX->file_map()->get(fd)->path();
-        return with_errno(gkfs::syscall::gkfs_truncate(path, length));
+        auto file = CTX->file_map()->get(fd);
+        auto err = file->wait_for_create();
+        if (err) {
+            return -err;
+        }
+        return with_errno(gkfs::syscall::gkfs_truncate(file->path(), length));
     }
     return syscall_no_intercept(SYS_ftruncate, fd, length);
 }
@@ -564,6 +643,7 @@ int hook_chdir(const char* path) {
     LOG(DEBUG, "{}() called with path: \"{}\"",
         __func__, path);
 
+    CTX->resolve_cache_clear();
     std::string rel_path;
     bool internal = CTX->relativize_path(path, rel_path);
     if (internal) {
@@ -598,6 +678,7 @@ int hook_fchdir(unsigned int fd) {
     LOG(DEBUG, "{}() called with fd: {}",
         __func__, fd);
 
+    CTX->resolve_cache_clear();
     if (CTX->file_map()->exist(fd)) {
         auto open_dir = CTX->file_map()->get_dir(fd);
         if (open_dir == nullptr) {
@@ -791,6 +872,8 @@ int hook_renameat(int olddfd, const char* oldname,
             return -EINVAL;
     }
 
+    // renamed directories and links invalidate cached path components of both names and everything below
+    CTX->resolve_cache_clear();
     return syscall_no_intercept(SYS_renameat2, olddfd, oldpath_pass, newdfd, newpath_pass, flags);
 }
 
@@ -831,5 +914,86 @@ int hook_fsync(unsigned int fd) {
     return syscall_no_intercept(SYS_fsync, fd);
 }
 
+#ifdef SYS_copy_file_range
+
+long hook_copy_file_range(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len, unsigned int flags) {
+
+    LOG(DEBUG, "{}() called with fd_in: {}, off_in: {}, fd_out: {}, off_out: {}, len: {}, flags: {}",
+        __func__, fd_in, fmt::ptr(off_in), fd_out, fmt::ptr(off_out), len, flags);
+
+    if (!CTX->file_map()->exist(fd_in) && !CTX->file_map()->exist(fd_out)) {
+        return syscall_no_intercept(SYS_copy_file_range, fd_in, off_in, fd_out, off_out, len, flags);
+    }
+    if (flags != 0) {
+        return -EINVAL;
+    }
+    return ::copy_between(fd_in, off_in, fd_out, off_out, len);
+}
+
+#endif
+
+long hook_sendfile(int out_fd, int in_fd, off_t* offset, size_t count) {
+
+    LOG(DEBUG, "{}() called with out_fd: {}, in_fd: {}, offset: {}, count: {}",
+        __func__, out_fd, in_fd, fmt::ptr(offset), count);
+
+    if (!CTX->file_map()->exist(in_fd) && !CTX->file_map()->exist(out_fd)) {
+        return syscall_no_intercept(SYS_sendfile, out_fd, in_fd, offset, count);
+    }
+    if (offset == nullptr) {
+        return ::copy_between(in_fd, nullptr, out_fd, nullptr, count);
+    }
+    // sendfile() reads from *offset and leaves the file position of in_fd untouched
+    loff_t in_off = *offset;
+    auto ret = ::copy_between(in_fd, &in_off, out_fd, nullptr, count);
+    *offset = in_off;
+    return ret;
+}
+
+long hook_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+
+    // anonymous mappings, e.g., by malloc(), are the common case and take the short path
+    if ((flags & MAP_ANONYMOUS) != 0 || !CTX->file_map()->exist(fd)) {
+        // a fixed mapping replacing GekkoFS mappings ends them like munmap() does
+        if ((flags & MAP_FIXED) != 0 && CTX->mapped_regions()->overlaps(addr, length)) {
+            LOG(DEBUG, "{}() fixed mapping at {} (length {}) replaces GekkoFS mappings", __func__, fmt::ptr(addr),
+                length);
+            CTX->mapped_regions()->release(addr, length);
+        }
+        return syscall_no_intercept(SYS_mmap, addr, length, prot, flags, fd, offset);
+    }
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}, prot: {}, flags: {}, fd: {}, offset: {}",
+        __func__, fmt::ptr(addr), length, prot, flags, fd, offset);
+
+    auto ret = gkfs::syscall::gkfs_mmap(addr, length, prot, flags, fd, offset);
+    if (ret == MAP_FAILED) {
+        return -errno;
+    }
+    return reinterpret_cast<long>(ret);
+}
+
+int hook_munmap(void* addr, size_t length) {
+
+    if (!CTX->mapped_regions()->overlaps(addr, length)) {
+        return syscall_no_intercept(SYS_munmap, addr, length);
+    }
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}", __func__, fmt::ptr(addr), length);
+
+    return with_errno(gkfs::syscall::gkfs_munmap(addr, length));
+}
+
+int hook_msync(void* addr, size_t length, int flags) {
+
+    if (!CTX->mapped_regions()->overlaps(addr, length)) {
+        return syscall_no_intercept(SYS_msync, addr, length, flags);
+    }
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}, flags: {}", __func__, fmt::ptr(addr), length, flags);
+
+    return with_errno(gkfs::syscall::gkfs_msync(addr, length, flags));
+}
+
 } // namespace hook
 } // namespace gkfs
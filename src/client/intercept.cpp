@@ -20,6 +20,7 @@
 #include <fmt/format.h>
 
 #include <cerrno>
+#include <cstdint>
 
 extern "C" {
 #include <syscall.h>
@@ -47,6 +48,80 @@ inline gkfs::syscall::info get_current_syscall_info() {
 }
 
 
+/*
+ * Syscalls handled by hook(). This list must match the cases of the switch in
+ * hook(): any syscall missing here is forwarded to the kernel without ever
+ * reaching hook().
+ */
+constexpr long hooked_syscalls[] = {
+        SYS_execve,
+#ifdef SYS_execveat
+        SYS_execveat,
+#endif
+        SYS_open, SYS_creat, SYS_openat, SYS_close,
+        SYS_stat,
+#ifdef STATX_TYPE
+        SYS_statx,
+#endif
+        SYS_lstat, SYS_fstat, SYS_newfstatat,
+        SYS_read, SYS_pread64, SYS_readv, SYS_preadv,
+        SYS_write, SYS_pwrite64, SYS_writev, SYS_pwritev,
+        SYS_unlink, SYS_unlinkat, SYS_rmdir,
+        SYS_symlink, SYS_symlinkat,
+        SYS_access, SYS_faccessat,
+        SYS_lseek, SYS_truncate, SYS_ftruncate,
+        SYS_dup, SYS_dup2, SYS_dup3,
+        SYS_getdents, SYS_getdents64,
+        SYS_mkdirat, SYS_mkdir,
+        SYS_chmod, SYS_fchmod, SYS_fchmodat,
+        SYS_chdir, SYS_fchdir, SYS_getcwd,
+        SYS_readlink, SYS_readlinkat,
+        SYS_fcntl,
+        SYS_rename, SYS_renameat, SYS_renameat2,
+        SYS_fstatfs, SYS_statfs,
+        SYS_fsync,
+#ifdef SYS_copy_file_range
+        SYS_copy_file_range,
+#endif
+        SYS_sendfile,
+        SYS_mmap, SYS_munmap, SYS_msync
+};
+
+// upper bound (exclusive) of syscall numbers covered by the bitmap
+constexpr long syscall_bitmap_bits = 512;
+
+struct syscall_bitmap {
+    uint64_t words[syscall_bitmap_bits / 64];
+};
+
+constexpr syscall_bitmap make_syscall_bitmap() {
+    syscall_bitmap bitmap{};
+    for (auto nr : hooked_syscalls) {
+        bitmap.words[nr / 64] |= uint64_t{1} << (nr % 64);
+    }
+    return bitmap;
+}
+
+constexpr bool syscalls_fit_bitmap() {
+    for (auto nr : hooked_syscalls) {
+        if (nr < 0 || nr >= syscall_bitmap_bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(syscalls_fit_bitmap(), "hooked syscall number exceeds syscall_bitmap_bits");
+
+// built at compile time, so the lookup is a single load and bit test
+constexpr syscall_bitmap hooked_syscall_bitmap = make_syscall_bitmap();
+
+inline bool is_hooked_syscall(long syscall_number) {
+    return static_cast<unsigned long>(syscall_number) < syscall_bitmap_bits &&
+           ((hooked_syscall_bitmap.words[syscall_number / 64] >> (syscall_number % 64)) & 1) != 0;
+}
+
+
 /*
  * hook_internal -- interception hook for internal syscalls
  *
@@ -377,8 +452,9 @@ hook_internal(long syscall_number,
             break;
 
         default:
-            // ignore any other syscalls, i.e.: pass them on to the kernel
-            // (syscalls forwarded to the kernel that return are logged in 
+            // not reached for syscalls filtered out by is_hooked_syscall() in
+            // hook_guard_wrapper(). Any other syscall is passed on to the kernel
+            // (syscalls forwarded to the kernel that return are logged in
             // hook_forwarded_syscall())
             ::save_current_syscall_info(
                     gkfs::syscall::from_internal_code |
@@ -730,6 +806,44 @@ int hook(long syscall_number,
             *result = gkfs::hook::hook_fsync(static_cast<unsigned int>(arg0));
             break;
 
+#ifdef SYS_copy_file_range
+        case SYS_copy_file_range:
+            *result = gkfs::hook::hook_copy_file_range(static_cast<int>(arg0),
+                                                       reinterpret_cast<loff_t*>(arg1),
+                                                       static_cast<int>(arg2),
+                                                       reinterpret_cast<loff_t*>(arg3),
+                                                       static_cast<size_t>(arg4),
+                                                       static_cast<unsigned int>(arg5));
+            break;
+#endif
+
+        case SYS_sendfile:
+            *result = gkfs::hook::hook_sendfile(static_cast<int>(arg0),
+                                                static_cast<int>(arg1),
+                                                reinterpret_cast<off_t*>(arg2),
+                                                static_cast<size_t>(arg3));
+            break;
+
+        case SYS_mmap:
+            *result = gkfs::hook::hook_mmap(reinterpret_cast<void*>(arg0),
+                                            static_cast<size_t>(arg1),
+                                            static_cast<int>(arg2),
+                                            static_cast<int>(arg3),
+                                            static_cast<int>(arg4),
+                                            static_cast<off_t>(arg5));
+            break;
+
+        case SYS_munmap:
+            *result = gkfs::hook::hook_munmap(reinterpret_cast<void*>(arg0),
+                                              static_cast<size_t>(arg1));
+            break;
+
+        case SYS_msync:
+            *result = gkfs::hook::hook_msync(reinterpret_cast<void*>(arg0),
+                                             static_cast<size_t>(arg1),
+                                             static_cast<int>(arg2));
+            break;
+
         default:
             // ignore any other syscalls, i.e.: pass them on to the kernel
             // (syscalls forwarded to the kernel that return are logged in 
@@ -895,6 +1009,16 @@ hook_guard_wrapper(long syscall_number,
         return was_hooked;
     }
 
+    // syscalls GekkoFS does not care about go straight back to the kernel
+    // (they are logged in hook_forwarded_syscall() once they return)
+    if (!::is_hooked_syscall(syscall_number)) {
+        ::save_current_syscall_info(
+                gkfs::syscall::from_external_code |
+                gkfs::syscall::to_kernel |
+                gkfs::syscall::not_executed);
+        return gkfs::syscall::forward_to_kernel;
+    }
+
     reentrance_guard_flag = true;
     int oerrno = errno;
     was_hooked = ::hook(syscall_number,
@@ -906,6 +1030,14 @@ hook_guard_wrapper(long syscall_number,
     return was_hooked;
 }
 
+/**
+ * Marks the calling thread as internal to GekkoFS: its syscalls are handled like those GekkoFS makes while handling
+ * an intercepted syscall. Must be called first by threads GekkoFS starts to call gkfs functions itself
+ */
+void enter_internal_thread() {
+    reentrance_guard_flag = true;
+}
+
 void start_self_interception() {
 
     LOG(DEBUG, "Enabling syscall interception for self");
@@ -0,0 +1,581 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <config.hpp>
+#include <client/mapped_regions.hpp>
+#include <client/preload.hpp>
+#include <client/logging.hpp>
+#include <client/gkfs_functions.hpp>
+#include <client/open_file_map.hpp>
+#ifndef BYPASS_SYSCALL
+#include <client/intercept.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <libsyscall_intercept_hook_point.h>
+#include <linux/userfaultfd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+}
+
+using namespace std;
+
+namespace gkfs {
+namespace mapping {
+
+MappedRegions::MappedRegions() : page_size_(static_cast<size_t>(sysconf(_SC_PAGESIZE))) {}
+
+MappedRegions::~MappedRegions() {
+    shutdown();
+}
+
+/**
+ * Creates the userfaultfd and starts the handler thread on first use. Must be called with mutex_ held
+ * @return true if pages can be fetched on demand
+ */
+bool MappedRegions::setup_uffd_() {
+    if (uffd_checked_)
+        return uffd_ >= 0;
+    uffd_checked_ = true;
+#ifdef SYS_userfaultfd
+    // UFFD_USER_MODE_ONLY is not used: faults of syscalls accessing mapped pages would fail with EFAULT
+    auto fd = syscall_no_intercept(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+    if (syscall_error_code(fd) != 0) {
+        LOG(INFO, "{}() userfaultfd not available: '{}'. Mapped GekkoFS files are read when they are mapped",
+            __func__, ::strerror(syscall_error_code(fd)));
+        return false;
+    }
+    struct uffdio_api api{};
+    api.api = UFFD_API;
+    long api_ret = -EINVAL;
+#ifdef UFFDIO_WRITEPROTECT_MODE_WP
+    // kernels without write-protect faults reject the feature
+    api.features = UFFD_FEATURE_PAGEFAULT_FLAG_WP;
+    api_ret = syscall_no_intercept(SYS_ioctl, fd, UFFDIO_API, &api);
+    uffd_wp_ = api_ret == 0;
+    if (api_ret != 0) {
+        api = {};
+        api.api = UFFD_API;
+    }
+#endif
+    if (api_ret != 0)
+        api_ret = syscall_no_intercept(SYS_ioctl, fd, UFFDIO_API, &api);
+    long wake_fd = -EINVAL;
+    if (api_ret == 0)
+        wake_fd = syscall_no_intercept(SYS_eventfd2, 0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (syscall_error_code(wake_fd) != 0) {
+        LOG(WARNING, "{}() Failed to set up userfaultfd: '{}'. Mapped GekkoFS files are read when they are mapped",
+            __func__, ::strerror(syscall_error_code(wake_fd)));
+        syscall_no_intercept(SYS_close, fd);
+        return false;
+    }
+#ifndef BYPASS_SYSCALL
+    // applications closing all their file descriptors must not close ours
+    try {
+        fd = CTX->register_internal_fd(static_cast<int>(fd));
+        wake_fd = CTX->register_internal_fd(static_cast<int>(wake_fd));
+    } catch (const std::exception& e) {
+        LOG(WARNING, "{}() Failed to register userfaultfd: '{}'", __func__, e.what());
+        syscall_no_intercept(SYS_close, fd);
+        syscall_no_intercept(SYS_close, wake_fd);
+        return false;
+    }
+#endif
+    uffd_ = static_cast<int>(fd);
+    wakeup_fd_ = static_cast<int>(wake_fd);
+    handler_ = thread(&MappedRegions::handle_faults_, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Handler thread: resolves page faults in registered regions until shutdown() signals the eventfd
+ */
+void MappedRegions::handle_faults_() {
+#ifndef BYPASS_SYSCALL
+    // syscalls of the RPCs fetching pages must not be intercepted as the application's
+    gkfs::preload::enter_internal_thread();
+#endif
+    vector<char> buf{};
+    struct pollfd fds[2]{};
+    fds[0].fd = uffd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeup_fd_;
+    fds[1].events = POLLIN;
+    while (true) {
+        auto ret = syscall_no_intercept(SYS_poll, fds, 2, -1);
+        if (syscall_error_code(ret) == EINTR)
+            continue;
+        if (syscall_error_code(ret) != 0) {
+            LOG(ERROR, "{}() Polling userfaultfd failed: '{}'", __func__, ::strerror(syscall_error_code(ret)));
+            return;
+        }
+        if (fds[1].revents != 0)
+            return;
+        if ((fds[0].revents & POLLIN) == 0)
+            continue;
+        struct uffd_msg msg{};
+        ret = syscall_no_intercept(SYS_read, uffd_, &msg, sizeof(msg));
+        // EAGAIN if the fault was already resolved
+        if (ret != sizeof(msg) || msg.event != UFFD_EVENT_PAGEFAULT)
+            continue;
+        auto addr = static_cast<uintptr_t>(msg.arg.pagefault.address);
+#ifdef UFFDIO_WRITEPROTECT_MODE_WP
+        if ((msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WP) != 0) {
+            handle_wp_fault_(addr);
+            continue;
+        }
+#endif
+        handle_fault_(addr, buf);
+    }
+}
+
+/**
+ * Fetches the missing pages around a faulting page, limited to the chunk containing the page. The pages are read
+ * without holding mutex_, so that other threads' mmap(), msync(), and munmap() do not wait for the RPCs
+ * @param fault_addr
+ * @param buf staging buffer reused across faults
+ */
+void MappedRegions::handle_fault_(uintptr_t fault_addr, vector<char>& buf) {
+    auto page_addr = fault_addr & ~(static_cast<uintptr_t>(page_size_) - 1);
+    shared_ptr<gkfs::filemap::OpenFile> file;
+    off64_t offset;
+    off64_t file_size;
+    uint64_t id;
+    uintptr_t first_addr;
+    size_t len;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = find_(page_addr);
+        auto page = it == regions_.end() ? 0 : (page_addr - it->first) / page_size_;
+        if (it == regions_.end() || it->second.pages[page] != PageState::missing) {
+            // unmapped or resolved in the meantime
+            wake_(page_addr);
+            return;
+        }
+        auto& region = it->second;
+        auto chunk_start = region.offset + page * page_size_;
+        chunk_start -= chunk_start % gkfs::config::rpc::chunksize;
+        auto chunk_end = chunk_start + gkfs::config::rpc::chunksize;
+        auto first = page;
+        auto last = page + 1;
+        while (first > 0 && region.pages[first - 1] == PageState::missing &&
+               region.offset + (first - 1) * page_size_ >= chunk_start)
+            --first;
+        while (last < region.pages.size() && region.pages[last] == PageState::missing &&
+               region.offset + last * page_size_ < chunk_end)
+            ++last;
+        file = region.file;
+        offset = region.offset + static_cast<off64_t>(first * page_size_);
+        file_size = region.file_size;
+        id = region.id;
+        first_addr = it->first + first * page_size_;
+        len = (last - first) * page_size_;
+    }
+
+    buf.resize(max(buf.size(), len));
+    auto err = fetch_(file, file_size, offset, len, buf.data());
+    if (err != 0) {
+        // the faulting thread cannot be failed, it would wait forever
+        LOG(ERROR, "{}() Failed to fetch pages of '{}': '{}'. Pages are zero-filled", __func__, file->path(),
+            ::strerror(err));
+        memset(buf.data(), 0, len);
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    // only this thread resolves missing pages, but the region may have been unmapped in the meantime
+    auto it = find_(first_addr);
+    if (it == regions_.end() || it->second.id != id || first_addr + len > it->first + it->second.length) {
+        wake_(page_addr);
+        return;
+    }
+    auto& region = it->second;
+    auto first = (first_addr - it->first) / page_size_;
+    auto last = first + len / page_size_;
+    if (any_of(region.pages.begin() + first, region.pages.begin() + last,
+               [](PageState s) { return s != PageState::missing; })) {
+        wake_(page_addr);
+        return;
+    }
+    struct uffdio_copy copy{};
+    copy.dst = first_addr;
+    copy.src = reinterpret_cast<uintptr_t>(buf.data());
+    copy.len = len;
+#ifdef UFFDIO_WRITEPROTECT_MODE_WP
+    // the first write to a fetched page marks it dirty
+    if (region.track_dirty)
+        copy.mode = UFFDIO_COPY_MODE_WP;
+#endif
+    auto ret = syscall_no_intercept(SYS_ioctl, uffd_, UFFDIO_COPY, &copy);
+    if (ret != 0) {
+        LOG(ERROR, "{}() UFFDIO_COPY failed: '{}'", __func__, ::strerror(syscall_error_code(ret)));
+        wake_(page_addr);
+        return;
+    }
+    fill(region.pages.begin() + first, region.pages.begin() + last, PageState::present);
+}
+
+/**
+ * Marks a write-protected page as dirty and lets the faulting thread write it
+ * @param fault_addr
+ */
+void MappedRegions::handle_wp_fault_(uintptr_t fault_addr) {
+    auto page_addr = fault_addr & ~(static_cast<uintptr_t>(page_size_) - 1);
+    lock_guard<mutex> lock(mutex_);
+    auto it = find_(page_addr);
+    if (it != regions_.end()) {
+        auto& state = it->second.pages[(page_addr - it->first) / page_size_];
+        if (state == PageState::present)
+            state = PageState::dirty;
+    }
+    // removing the protection wakes the faulting thread
+    if (!write_protect_(page_addr, page_size_, false))
+        wake_(page_addr);
+}
+
+/**
+ * Wakes the threads waiting for a fault on a page to retry their access
+ */
+void MappedRegions::wake_(uintptr_t page_addr) {
+    struct uffdio_range range{page_addr, page_size_};
+    syscall_no_intercept(SYS_ioctl, uffd_, UFFDIO_WAKE, &range);
+}
+
+/**
+ * Registers a range with the userfaultfd
+ * @param missing report faults on missing pages
+ * @param wp report write faults on write-protected pages
+ * @return true on success
+ */
+bool MappedRegions::register_(uintptr_t addr, size_t length, bool missing, bool wp) {
+    struct uffdio_register reg{};
+    reg.range.start = addr;
+    reg.range.len = length;
+    if (missing)
+        reg.mode |= UFFDIO_REGISTER_MODE_MISSING;
+    if (wp) {
+#ifdef UFFDIO_WRITEPROTECT_MODE_WP
+        reg.mode |= UFFDIO_REGISTER_MODE_WP;
+#else
+        return false;
+#endif
+    }
+    auto ret = syscall_no_intercept(SYS_ioctl, uffd_, UFFDIO_REGISTER, &reg);
+    if (ret != 0) {
+        LOG(WARNING, "{}() Failed to register mapping with userfaultfd (missing {}, write-protect {}): '{}'",
+            __func__, missing, wp, ::strerror(syscall_error_code(ret)));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Sets or removes the write protection of registered pages. Removing it wakes threads waiting for it
+ * @return true on success
+ */
+bool MappedRegions::write_protect_(uintptr_t addr, size_t length, bool protect) {
+#ifdef UFFDIO_WRITEPROTECT_MODE_WP
+    struct uffdio_writeprotect wp{};
+    wp.range.start = addr;
+    wp.range.len = length;
+    wp.mode = protect ? UFFDIO_WRITEPROTECT_MODE_WP : 0;
+    auto ret = syscall_no_intercept(SYS_ioctl, uffd_, UFFDIO_WRITEPROTECT, &wp);
+    if (ret != 0) {
+        LOG(ERROR, "{}() UFFDIO_WRITEPROTECT failed: '{}'", __func__, ::strerror(syscall_error_code(ret)));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @param addr
+ * @return region containing addr or end()
+ */
+map<uintptr_t, MappedRegion>::iterator MappedRegions::find_(uintptr_t addr) {
+    auto it = regions_.upper_bound(addr);
+    if (it == regions_.begin())
+        return regions_.end();
+    --it;
+    return addr < it->first + it->second.length ? it : regions_.end();
+}
+
+/**
+ * Reads mapped pages from GekkoFS. Data beyond the file size is zero-filled
+ * @param file_size file size when the region was mapped
+ * @return 0 on success or errno
+ */
+int MappedRegions::fetch_(const shared_ptr<gkfs::filemap::OpenFile>& file, off64_t file_size, off64_t offset,
+                          size_t len, char* buf) {
+    size_t avail = 0;
+    if (offset < file_size)
+        avail = min(len, static_cast<size_t>(file_size - offset));
+    ssize_t ret = 0;
+    if (avail > 0) {
+        ret = gkfs::syscall::gkfs_pread(file, buf, avail, offset);
+        if (ret < 0)
+            return errno;
+    }
+    memset(buf + ret, 0, len - ret);
+    return 0;
+}
+
+/**
+ * Writes the dirty pages in [first_page, last_page) of a shared writable region back to GekkoFS. Without dirty
+ * tracking, all present pages are written back.
+ * The file is never extended: data beyond its size at mapping time is dropped.
+ * @return 0 on success or errno
+ */
+int MappedRegions::write_back_(MappedRegion& region, size_t first_page, size_t last_page) {
+    if ((region.flags & MAP_SHARED) == 0 || (region.prot & PROT_WRITE) == 0)
+        return 0;
+    auto written = [&region](PageState s) {
+        return s == PageState::dirty || (!region.track_dirty && s == PageState::present);
+    };
+    auto page = first_page;
+    while (page < last_page) {
+        if (!written(region.pages[page])) {
+            ++page;
+            continue;
+        }
+        auto run_end = page + 1;
+        while (run_end < last_page && written(region.pages[run_end]))
+            ++run_end;
+        auto offset = region.offset + static_cast<off64_t>(page * page_size_);
+        if (offset >= region.file_size)
+            return 0;
+        auto len = min((run_end - page) * page_size_, static_cast<size_t>(region.file_size - offset));
+        auto run_addr = reinterpret_cast<uintptr_t>(region.addr) + page * page_size_;
+        // protected before they are written back, so that concurrent writes mark the pages dirty again
+        if (region.track_dirty && write_protect_(run_addr, (run_end - page) * page_size_, true))
+            fill(region.pages.begin() + page, region.pages.begin() + run_end, PageState::present);
+        auto ret = gkfs::syscall::gkfs_pwrite(region.file, region.addr + page * page_size_, len, offset);
+        if (ret < 0) {
+            auto err = errno;
+            // retried by the next write-back
+            if (region.track_dirty)
+                fill(region.pages.begin() + page, region.pages.begin() + run_end, PageState::dirty);
+            return err;
+        }
+        page = run_end;
+    }
+    return 0;
+}
+
+/**
+ * Writes back the pages of all regions overlapping [addr, addr + length) and optionally marks them as unmapped.
+ * Must be called with mutex_ held
+ * @return first write-back error or 0
+ */
+int MappedRegions::for_each_overlap_(uintptr_t addr, size_t length, bool unmap) {
+    int err = 0;
+    auto end = addr + length;
+    auto it = find_(addr);
+    if (it == regions_.end())
+        it = regions_.upper_bound(addr);
+    while (it != regions_.end() && it->first < end) {
+        auto& region = it->second;
+        auto first = addr > it->first ? (addr - it->first) / page_size_ : 0;
+        auto last = min(region.pages.size(), (end - it->first + page_size_ - 1) / page_size_);
+        auto ret = write_back_(region, first, last);
+        if (ret != 0 && err == 0)
+            err = ret;
+        if (!unmap) {
+            ++it;
+            continue;
+        }
+        fill(region.pages.begin() + first, region.pages.begin() + last, PageState::unmapped);
+        if (all_of(region.pages.begin(), region.pages.end(),
+                   [](PageState s) { return s == PageState::unmapped; })) {
+            it = regions_.erase(it);
+            --region_count_;
+        } else {
+            ++it;
+        }
+    }
+    return err;
+}
+
+/**
+ * Maps a GekkoFS file into memory
+ * @param addr address hint as for mmap()
+ * @param length
+ * @param prot
+ * @param flags either MAP_SHARED or MAP_PRIVATE. MAP_FIXED, MAP_NORESERVE, and MAP_POPULATE are honored
+ * @param file
+ * @param offset must be a multiple of the page size
+ * @param file_size current size of the file
+ * @param mapped (return val) start of the mapping
+ * @return 0 on success or errno
+ */
+int MappedRegions::map(void* addr, size_t length, int prot, int flags, shared_ptr<gkfs::filemap::OpenFile> file,
+                       off64_t offset, off64_t file_size, void*& mapped) {
+    auto map_type = flags & MAP_TYPE;
+#ifdef MAP_SHARED_VALIDATE
+    if (map_type == MAP_SHARED_VALIDATE)
+        map_type = MAP_SHARED;
+#endif
+    if (length == 0 || offset < 0 || offset % page_size_ != 0 || (map_type != MAP_SHARED && map_type != MAP_PRIVATE))
+        return EINVAL;
+    if (file->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+        (map_type == MAP_SHARED && (prot & PROT_WRITE) != 0 &&
+         !file->get_flag(gkfs::filemap::OpenFile_flags::rdwr)))
+        return EACCES;
+    auto page_count = (length + page_size_ - 1) / page_size_;
+    length = page_count * page_size_;
+    // GekkoFS mappings replaced by MAP_FIXED are written back first
+    if ((flags & MAP_FIXED) != 0 && overlaps(addr, length))
+        release(addr, length);
+
+    lock_guard<mutex> lock(mutex_);
+    auto uffd = setup_uffd_();
+    auto on_demand = (flags & MAP_POPULATE) == 0 && uffd;
+    auto track_dirty = uffd && uffd_wp_ && map_type == MAP_SHARED && (prot & PROT_WRITE) != 0;
+    auto ret = syscall_no_intercept(SYS_mmap, addr, length, prot,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | (flags & (MAP_FIXED | MAP_NORESERVE)), -1, 0);
+    if (syscall_error_code(ret) != 0)
+        return syscall_error_code(ret);
+    MappedRegion region{reinterpret_cast<char*>(ret), length, prot, flags, move(file), offset, file_size,
+                        vector<PageState>(page_count, PageState::missing), ++next_region_id_, false};
+    auto start = static_cast<uintptr_t>(ret);
+    if (on_demand) {
+        if (track_dirty && !register_(start, length, true, true))
+            track_dirty = false;
+        if (!track_dirty && !register_(start, length, true, false))
+            on_demand = false;
+    }
+    if (!on_demand) {
+        // the whole range is read now. The mapping must be writable while it is filled
+        auto err = syscall_error_code(syscall_no_intercept(SYS_mprotect, ret, length, PROT_READ | PROT_WRITE));
+        if (err == 0)
+            err = fetch_(region.file, file_size, offset, length, region.addr);
+        if (err == 0)
+            err = syscall_error_code(syscall_no_intercept(SYS_mprotect, ret, length, prot));
+        if (err != 0) {
+            syscall_no_intercept(SYS_munmap, ret, length);
+            return err;
+        }
+        fill(region.pages.begin(), region.pages.end(), PageState::present);
+        // the pages read now are protected right away
+        if (track_dirty)
+            track_dirty = register_(start, length, false, true) && write_protect_(start, length, true);
+    }
+    region.track_dirty = track_dirty;
+    LOG(DEBUG, "{}() Mapped '{}' at {} (offset {}, length {}, on demand {}, dirty tracking {})", __func__,
+        region.file->path(), static_cast<void*>(region.addr), offset, length, on_demand, track_dirty);
+    mapped = region.addr;
+    regions_.emplace(static_cast<uintptr_t>(ret), move(region));
+    ++region_count_;
+    return 0;
+}
+
+/**
+ * Writes back and unmaps [addr, addr + length). Write-back errors are logged but do not fail the unmap
+ * @return 0 on success or errno
+ */
+int MappedRegions::unmap(void* addr, size_t length) {
+    lock_guard<mutex> lock(mutex_);
+    auto err = for_each_overlap_(reinterpret_cast<uintptr_t>(addr), length, true);
+    if (err != 0) {
+        LOG(ERROR, "{}() Failed to write back mapped pages: '{}'", __func__, ::strerror(err));
+    }
+    return syscall_error_code(syscall_no_intercept(SYS_munmap, addr, length));
+}
+
+/**
+ * Writes back and forgets the mappings in [addr, addr + length) without unmapping the range, before a MAP_FIXED
+ * mapping replaces it. Write-back errors are logged, the replacing mapping cannot be failed by them
+ */
+void MappedRegions::release(void* addr, size_t length) {
+    lock_guard<mutex> lock(mutex_);
+    auto err = for_each_overlap_(reinterpret_cast<uintptr_t>(addr), length, true);
+    if (err != 0) {
+        LOG(ERROR, "{}() Failed to write back mapped pages: '{}'", __func__, ::strerror(err));
+    }
+}
+
+/**
+ * Writes back the pages of shared writable mappings in [addr, addr + length)
+ * @return 0 on success or errno
+ */
+int MappedRegions::sync(void* addr, size_t length) {
+    lock_guard<mutex> lock(mutex_);
+    return for_each_overlap_(reinterpret_cast<uintptr_t>(addr), length, false);
+}
+
+bool MappedRegions::empty() const {
+    return region_count_ == 0;
+}
+
+/**
+ * @return true if [addr, addr + length) overlaps a GekkoFS mapping
+ */
+bool MappedRegions::overlaps(void* addr, size_t length) {
+    if (empty())
+        return false;
+    lock_guard<mutex> lock(mutex_);
+    auto start = reinterpret_cast<uintptr_t>(addr);
+    auto it = find_(start);
+    if (it != regions_.end())
+        return true;
+    it = regions_.upper_bound(start);
+    return it != regions_.end() && it->first < start + length;
+}
+
+/**
+ * Writes back all mappings and stops the handler thread. Must be called before the RPC subsystem shuts down.
+ * Closing the userfaultfd unregisters the remaining mappings. Pages that were not fetched read as zeros afterwards.
+ */
+void MappedRegions::shutdown() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (auto& entry : regions_) {
+            auto err = write_back_(entry.second, 0, entry.second.pages.size());
+            if (err != 0) {
+                LOG(ERROR, "{}() Failed to write back mapped pages of '{}': '{}'", __func__,
+                    entry.second.file->path(), ::strerror(err));
+            }
+        }
+        regions_.clear();
+        region_count_ = 0;
+        if (uffd_ < 0)
+            return;
+        uint64_t val = 1;
+        syscall_no_intercept(SYS_write, wakeup_fd_, &val, sizeof(val));
+    }
+    handler_.join();
+#ifndef BYPASS_SYSCALL
+    CTX->unregister_internal_fd(uffd_);
+    CTX->unregister_internal_fd(wakeup_fd_);
+#endif
+    syscall_no_intercept(SYS_close, uffd_);
+    syscall_no_intercept(SYS_close, wakeup_fd_);
+    uffd_ = -1;
+    wakeup_fd_ = -1;
+    uffd_checked_ = false;
+}
+
+} // namespace mapping
+} // namespace gkfs
@@ -18,6 +18,8 @@
 #include <client/preload_util.hpp>
 #include <client/logging.hpp>
 
+#include <algorithm>
+
 extern "C" {
 #include <fcntl.h>
 }
@@ -27,29 +29,84 @@ using namespace std;
 namespace gkfs {
 namespace filemap {
 
+namespace {
+
+/*
+ * Hazard pointer of a thread, published while the thread reads a slot of an fd table. Records are shared by all
+ * OpenFileMaps, reused after their thread exited, and never freed. The padding keeps the records of different
+ * threads in different cache lines.
+ */
+struct Hazard {
+    atomic<const void*> slot{nullptr};
+    atomic<bool> used{true};
+    Hazard* next{nullptr};
+    char padding[64]{};
+};
+
+atomic<Hazard*> hazards{nullptr};
+
+Hazard* acquire_hazard() {
+    for (auto hazard = hazards.load(); hazard != nullptr; hazard = hazard->next) {
+        bool expected = false;
+        if (!hazard->used.load() && hazard->used.compare_exchange_strong(expected, true))
+            return hazard;
+    }
+    auto hazard = new Hazard{};
+    hazard->next = hazards.load();
+    while (!hazards.compare_exchange_weak(hazard->next, hazard)) {}
+    return hazard;
+}
+
+/*
+ * Owns the hazard record of a thread and returns it when the thread exits
+ */
+struct HazardOwner {
+    Hazard* hazard{acquire_hazard()};
+
+    ~HazardOwner() {
+        hazard->slot.store(nullptr);
+        hazard->used.store(false);
+    }
+};
+
+Hazard& this_thread_hazard() {
+    thread_local HazardOwner owner{};
+    return *owner.hazard;
+}
+
+} // namespace
+
 OpenFile::OpenFile(const string& path, const int flags, FileType type) :
         type_(type),
         path_(path) {
     // set flags to OpenFile
     if (flags & O_CREAT)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::creat)] = true;
+        set_flag(OpenFile_flags::creat, true);
     if (flags & O_APPEND)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::append)] = true;
+        set_flag(OpenFile_flags::append, true);
     if (flags & O_TRUNC)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::trunc)] = true;
+        set_flag(OpenFile_flags::trunc, true);
     if (flags & O_RDONLY)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::rdonly)] = true;
+        set_flag(OpenFile_flags::rdonly, true);
     if (flags & O_WRONLY)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::wronly)] = true;
+        set_flag(OpenFile_flags::wronly, true);
     if (flags & O_RDWR)
-        flags_[gkfs::util::to_underlying(OpenFile_flags::rdwr)] = true;
+        set_flag(OpenFile_flags::rdwr, true);
 
     pos_ = 0; // If O_APPEND flag is used, it will be used before each write.
+#ifdef GKFS_ENABLE_FORWARDING
+    // data of the file stays with the current forwarder while it is open
+    if (type_ == FileType::regular)
+        CTX->fwd_pins()->pin(path_, CTX->fwd_host_id());
+#endif
 }
 
-OpenFileMap::OpenFileMap() :
-        fd_idx(10000),
-        fd_validation_needed(false) {}
+OpenFile::~OpenFile() {
+#ifdef GKFS_ENABLE_FORWARDING
+    if (type_ == FileType::regular)
+        CTX->fwd_pins()->unpin(path_);
+#endif
+}
 
 string OpenFile::path() const {
     return path_;
@@ -60,23 +117,72 @@ void OpenFile::path(const string& path) {
 }
 
 unsigned long OpenFile::pos() {
-    lock_guard<mutex> lock(pos_mutex_);
-    return pos_;
+    return pos_.load();
 }
 
 void OpenFile::pos(unsigned long pos) {
-    lock_guard<mutex> lock(pos_mutex_);
-    OpenFile::pos_ = pos;
+    pos_.store(pos);
+}
+
+/**
+ * Atomically advances the file position by count (fetch-and-advance).
+ * Concurrent callers on the same fd therefore get disjoint ranges [pos, pos + count).
+ * @param count
+ * @return the file position before the advance
+ */
+unsigned long OpenFile::advance_pos(unsigned long count) {
+    return pos_.fetch_add(count);
+}
+
+/**
+ * Sets the file position to desired only if it still is expected, i.e., no other thread moved it meanwhile.
+ * @param expected
+ * @param desired
+ * @return true if the file position was updated
+ */
+bool OpenFile::compare_exchange_pos(unsigned long expected, unsigned long desired) {
+    return pos_.compare_exchange_strong(expected, desired);
 }
 
 bool OpenFile::get_flag(OpenFile_flags flag) {
-    lock_guard<mutex> lock(pos_mutex_);
-    return flags_[gkfs::util::to_underlying(flag)];
+    return (flags_.load() & (1u << gkfs::util::to_underlying(flag))) != 0;
 }
 
 void OpenFile::set_flag(OpenFile_flags flag, bool value) {
-    lock_guard<mutex> lock(flag_mutex_);
-    flags_[gkfs::util::to_underlying(flag)] = value;
+    auto mask = 1u << gkfs::util::to_underlying(flag);
+    if (value)
+        flags_.fetch_or(mask);
+    else
+        flags_.fetch_and(~mask);
+}
+
+const gkfs::rpc::StripeLayout& OpenFile::layout() const {
+    return layout_;
+}
+
+void OpenFile::layout(const gkfs::rpc::StripeLayout& layout) {
+    OpenFile::layout_ = layout;
+}
+
+void OpenFile::pending_create(std::shared_future<int> pending_create) {
+    lock_guard<mutex> lock(create_mutex_);
+    pending_create_ = std::move(pending_create);
+}
+
+/**
+ * Waits for an outstanding asynchronous create of this file.
+ * The result is kept so that every subsequent call reports the same error.
+ * @return error code of the create, 0 if there is none
+ */
+int OpenFile::wait_for_create() {
+    shared_future<int> pending_create;
+    {
+        lock_guard<mutex> lock(create_mutex_);
+        if (!pending_create_.valid())
+            return 0;
+        pending_create = pending_create_;
+    }
+    return pending_create.get();
 }
 
 FileType OpenFile::type() const {
@@ -85,7 +191,85 @@ FileType OpenFile::type() const {
 
 // OpenFileMap starts here
 
+OpenFileMap::OpenFileMap() :
+        fd_table_(new std::atomic<Slot*>[fd_table_size]),
+        next_slot_(0),
+        fd_idx(fd_table_base + fd_table_size),
+        fd_validation_needed(false) {
+    for (int i = 0; i < fd_table_size; ++i)
+        fd_table_[i].store(nullptr);
+}
+
+OpenFileMap::~OpenFileMap() {
+    for (int i = 0; i < fd_table_size; ++i)
+        delete fd_table_[i].load();
+    for (auto slot : retired_slots_)
+        delete slot;
+}
+
+bool OpenFileMap::in_fd_table_(const int fd) {
+    return fd >= fd_table_base && fd < fd_table_base + fd_table_size;
+}
+
+/**
+ * Frees a slot that was removed from the fd table. Lookups that started before the removal may still access the
+ * slot. Thus, all retired slots are freed unless a hazard pointer refers to them. Lookups starting afterwards cannot
+ * reach them anymore. At most one retired slot per thread remains until the next call.
+ * @param slot
+ */
+void OpenFileMap::retire_slot_(Slot* slot) {
+    lock_guard<mutex> lock(retired_slots_mutex_);
+    retired_slots_.push_back(slot);
+    vector<const void*> hazard_slots{};
+    for (auto hazard = hazards.load(); hazard != nullptr; hazard = hazard->next) {
+        auto hazard_slot = hazard->slot.load();
+        if (hazard_slot != nullptr)
+            hazard_slots.push_back(hazard_slot);
+    }
+    sort(hazard_slots.begin(), hazard_slots.end());
+    auto in_use = partition(retired_slots_.begin(), retired_slots_.end(), [&hazard_slots](Slot* s) {
+        return binary_search(hazard_slots.begin(), hazard_slots.end(), s);
+    });
+    for (auto it = in_use; it != retired_slots_.end(); ++it)
+        delete *it;
+    retired_slots_.erase(in_use, retired_slots_.end());
+}
+
+/**
+ * Places a file in a free slot of the fd table, starting the search after the most recently used slot so that
+ * closed fds are not reused right away
+ * @param open_file
+ * @return fd or -1 if the table is full
+ */
+int OpenFileMap::add_to_fd_table_(const std::shared_ptr<OpenFile>& open_file) {
+    auto slot = new Slot{open_file};
+    auto start = next_slot_.load();
+    for (int i = 0; i < fd_table_size; ++i) {
+        auto idx = (start + i) % fd_table_size;
+        Slot* expected = nullptr;
+        if (fd_table_[idx].load() == nullptr && fd_table_[idx].compare_exchange_strong(expected, slot)) {
+            next_slot_.store(idx + 1);
+            return fd_table_base + static_cast<int>(idx);
+        }
+    }
+    delete slot;
+    return -1;
+}
+
 shared_ptr<OpenFile> OpenFileMap::get(int fd) {
+    if (in_fd_table_(fd)) {
+        auto& entry = fd_table_[fd - fd_table_base];
+        auto& hazard = this_thread_hazard();
+        // the slot is protected once it is still in the table after publishing the hazard pointer
+        Slot* slot;
+        do {
+            slot = entry.load();
+            hazard.slot.store(slot);
+        } while (slot != entry.load());
+        auto open_file = slot == nullptr ? nullptr : slot->file;
+        hazard.slot.store(nullptr);
+        return open_file;
+    }
     lock_guard<recursive_mutex> lock(files_mutex_);
     auto f = files_.find(fd);
     if (f == files_.end()) {
@@ -104,6 +288,8 @@ shared_ptr<OpenDir> OpenFileMap::get_dir(int dirfd) {
 }
 
 bool OpenFileMap::exist(const int fd) {
+    if (in_fd_table_(fd))
+        return fd_table_[fd - fd_table_base].load() != nullptr;
     lock_guard<recursive_mutex> lock(files_mutex_);
     auto f = files_.find(fd);
     return !(f == files_.end());
@@ -129,13 +315,24 @@ int OpenFileMap::safe_generate_fd_idx_() {
 }
 
 int OpenFileMap::add(std::shared_ptr<OpenFile> open_file) {
-    auto fd = safe_generate_fd_idx_();
+    auto fd = add_to_fd_table_(open_file);
+    if (fd >= 0)
+        return fd;
+    // table is full
+    fd = safe_generate_fd_idx_();
     lock_guard<recursive_mutex> lock(files_mutex_);
     files_.insert(make_pair(fd, open_file));
     return fd;
 }
 
 bool OpenFileMap::remove(const int fd) {
+    if (in_fd_table_(fd)) {
+        auto slot = fd_table_[fd - fd_table_base].exchange(nullptr);
+        if (slot == nullptr)
+            return false;
+        retire_slot_(slot);
+        return true;
+    }
     lock_guard<recursive_mutex> lock(files_mutex_);
     auto f = files_.find(fd);
     if (f == files_.end()) {
@@ -150,19 +347,15 @@ bool OpenFileMap::remove(const int fd) {
 }
 
 int OpenFileMap::dup(const int oldfd) {
-    lock_guard<recursive_mutex> lock(files_mutex_);
     auto open_file = get(oldfd);
     if (open_file == nullptr) {
         errno = EBADF;
         return -1;
     }
-    auto newfd = safe_generate_fd_idx_();
-    files_.insert(make_pair(newfd, open_file));
-    return newfd;
+    return add(open_file);
 }
 
 int OpenFileMap::dup2(const int oldfd, const int newfd) {
-    lock_guard<recursive_mutex> lock(files_mutex_);
     auto open_file = get(oldfd);
     if (open_file == nullptr) {
         errno = EBADF;
@@ -170,6 +363,14 @@ int OpenFileMap::dup2(const int oldfd, const int newfd) {
     }
     if (oldfd == newfd)
         return newfd;
+    if (in_fd_table_(newfd)) {
+        // replace newfd silently if it exists
+        auto old_slot = fd_table_[newfd - fd_table_base].exchange(new Slot{open_file});
+        if (old_slot != nullptr)
+            retire_slot_(old_slot);
+        return newfd;
+    }
+    lock_guard<recursive_mutex> lock(files_mutex_);
     // remove newfd if exists in filemap silently
     if (exist(newfd)) {
         remove(newfd);
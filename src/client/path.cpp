@@ -168,36 +168,54 @@ bool resolve(const string& path, string& resolved, bool resolve_last_link) {
                 path.compare(start, comp_size, mnt_components.at(matched_components)) == 0) {
                 ++matched_components;
             }
-            if (lstat(resolved.c_str(), &st) < 0) {
+            if (end == path.size() && !resolve_last_link && matched_components < mnt_components.size()) {
+                // The last component is neither followed nor does it complete the mountdir.
+                // Whatever it is, the path is external
+                ++resolved_components;
+                continue;
+            }
+            gkfs::preload::ResolveCacheEntry cached{};
+            bool is_cached = CTX->resolve_cache_get(resolved, cached);
+            if (!is_cached) {
+                if (lstat(resolved.c_str(), &st) < 0) {
 
-                LOG(DEBUG, "path \"{}\" does not exist", resolved);
+                    LOG(DEBUG, "path \"{}\" does not exist", resolved);
 
-                resolved.append(path, end, string::npos);
-                return false;
+                    resolved.append(path, end, string::npos);
+                    return false;
+                }
+                cached.mode = st.st_mode & S_IFMT;
             }
-            if (S_ISLNK(st.st_mode)) {
+            if (S_ISLNK(cached.mode)) {
                 if (!resolve_last_link && end == path.size()) {
                     continue;
                 }
-                auto link_resolved = ::unique_ptr<char[]>(new char[PATH_MAX]);
-                if (realpath(resolved.c_str(), link_resolved.get()) == nullptr) {
-
-                    LOG(ERROR, "Failed to get realpath for link \"{}\". "
-                               "Error: {}", resolved, ::strerror(errno));
-
-                    resolved.append(path, end, string::npos);
-                    return false;
+                if (cached.link_target.empty()) {
+                    auto link_resolved = ::unique_ptr<char[]>(new char[PATH_MAX]);
+                    if (realpath(resolved.c_str(), link_resolved.get()) == nullptr) {
+
+                        LOG(ERROR, "Failed to get realpath for link \"{}\". "
+                                   "Error: {}", resolved, ::strerror(errno));
+
+                        resolved.append(path, end, string::npos);
+                        return false;
+                    }
+                    cached.link_target = link_resolved.get();
+                    CTX->resolve_cache_put(resolved, cached);
                 }
                 // substituute resolved with new link path
-                resolved = link_resolved.get();
+                resolved = cached.link_target;
                 matched_components = match_components(resolved, resolved_components, mnt_components);
                 // set matched counter to value coherent with the new path
                 last_slash_pos = resolved.find_last_of(path::separator);
                 continue;
-            } else if ((!S_ISDIR(st.st_mode)) && (end != path.size())) {
+            } else if ((!S_ISDIR(cached.mode)) && (end != path.size())) {
                 resolved.append(path, end, string::npos);
                 return false;
             }
+            if (!is_cached && S_ISDIR(cached.mode)) {
+                CTX->resolve_cache_put(resolved, cached);
+            }
         } else {
             // Inside GekkoFS
             ++matched_components;
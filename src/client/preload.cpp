@@ -17,16 +17,33 @@
 #include <client/rpc/forward_management.hpp>
 #include <client/preload_util.hpp>
 #include <client/intercept.hpp>
+#include <client/env.hpp>
+#include <client/user_functions.hpp>
+#include <client/aio_queue.hpp>
+#include <client/mapped_regions.hpp>
 
 #include <global/rpc/distributor.hpp>
 #include <global/global_defs.hpp>
+#include <global/env_util.hpp>
 
 #include <fstream>
+#include <mutex>
+#include <map>
+#include <random>
+#include <future>
+#include <chrono>
+#include <cstring>
 
 #include <hermes.hpp>
 
 extern "C" {
+#include <libsyscall_intercept_hook_point.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
 }
 
 using namespace std;
@@ -37,12 +54,19 @@ namespace {
 // make sure that things are only initialized once
 pthread_once_t init_env_thread = PTHREAD_ONCE_INIT;
 
+#ifdef BYPASS_SYSCALL
+std::mutex user_lib_mutex;
+bool user_lib_initialized = false;
+#endif
+
 #ifdef GKFS_ENABLE_FORWARDING
 pthread_t mapper;
-bool forwarding_running;
-
-pthread_mutex_t remap_mutex;
-pthread_cond_t remap_signal;
+// signaled by destroy_forwarding_mapper() to stop the mapper thread
+int mapper_wakeup_fd = -1;
+// watches the forwarding map, -1 if inotify is not available
+int mapper_inotify_fd = -1;
+// randomizes the balancing of the mapper thread, seeded differently on each client by init_forwarding_mapper()
+std::mt19937 mapper_rng{};
 #endif
 
 inline void exit_error_msg(int errcode, const string& msg) {
@@ -50,12 +74,18 @@ inline void exit_error_msg(int errcode, const string& msg) {
     LOG_ERROR("{}", msg);
     gkfs::log::logger::log_message(stderr, "{}\n", msg);
 
+#ifdef BYPASS_SYSCALL
+    // the user library must not terminate the application. gkfs_init() reports the error instead
+    (void) errcode;
+    throw std::runtime_error(msg);
+#else
     // if we don't disable interception before calling ::exit()
     // syscall hooks may find an inconsistent in shared state
     // (e.g. the logger) and thus, crash
     gkfs::preload::stop_interception();
     CTX->disable_interception();
     ::exit(errcode);
+#endif
 }
 
 /**
@@ -86,6 +116,22 @@ bool init_hermes_client() {
     return true;
 }
 
+/**
+ * Shuts down the Hermes client once the threads waiting for management RPC responses are joined. If a daemon does
+ * not respond in time, the client is left running, as its waiting threads would use it after destruction
+ */
+void shutdown_network_service() {
+    if (gkfs::rpc::join_rpc_waiters(gkfs::config::rpc_waiter_shutdown_timeout)) {
+        ld_network_service.reset();
+        LOG(DEBUG, "RPC subsystem shut down");
+    } else {
+        LOG(WARNING, "Responses of management RPCs are still outstanding after {} ms. RPC subsystem is left running",
+            gkfs::config::rpc_waiter_shutdown_timeout);
+        // intentionally leaked
+        ld_network_service.release();
+    }
+}
+
 /**
  * This function is only called in the preload constructor and initializes 
  * the file system client
@@ -116,21 +162,38 @@ void init_ld_environment_() {
     /* Setup distributor */
 #ifdef GKFS_ENABLE_FORWARDING
     try {
+        // also sets the forwarder distributor
         gkfs::util::load_forwarding_map();
 
         LOG(INFO, "{}() Forward to {}", __func__, CTX->fwd_host_id());
     } catch (std::exception& e){
         exit_error_msg(EXIT_FAILURE, fmt::format("Unable set the forwarding host '{}'", e.what()));
     }
-    
-    auto forwarder_dist = std::make_shared<gkfs::rpc::ForwarderDistributor>(CTX->fwd_host_id(), CTX->hosts().size());
-    CTX->distributor(forwarder_dist);
 #else
     auto simple_hash_dist = std::make_shared<gkfs::rpc::SimpleHashDistributor>(CTX->local_host_id(),
                                                                                CTX->hosts().size());
     CTX->distributor(simple_hash_dist);
 #endif
 
+    try {
+        gkfs::util::load_stripe_layout();
+    } catch (const std::exception& e) {
+        exit_error_msg(EXIT_FAILURE, "Failed to set default stripe layout: "s + e.what());
+    }
+
+    const auto async_create_val = gkfs::env::get_var(gkfs::env::ASYNC_CREATE, "0");
+    CTX->async_create(!async_create_val.empty() && async_create_val != "0");
+    LOG(INFO, "Asynchronous create: {}", CTX->async_create() ? "enabled" : "disabled");
+
+    // the batch system's job id unless set explicitly
+    CTX->job_id(gkfs::env::get_var(gkfs::env::JOB_ID, gkfs::env::get_var("SLURM_JOB_ID", "")));
+    // writes between daemons are tagged with it to bypass the QoS, a job must not evade its limits this way
+    if (CTX->job_id() == gkfs::rpc::internal_job_id) {
+        exit_error_msg(EXIT_FAILURE, fmt::format("Job id '{}' is reserved for daemon-internal writes",
+                                                 gkfs::rpc::internal_job_id));
+    }
+    LOG(INFO, "Job id: '{}'", CTX->job_id());
+
     LOG(INFO, "Retrieving file system configuration...");
 
     if (!gkfs::rpc::forward_get_fs_config()) {
@@ -141,50 +204,270 @@ void init_ld_environment_() {
 }
 
 #ifdef GKFS_ENABLE_FORWARDING
-void *forwarding_mapper(void* p) {
-    struct timespec timeout;
-    clock_gettime(CLOCK_REALTIME, &timeout);
-    timeout.tv_sec += 10; // 10 seconds
+/**
+ * Identifies a version of the forwarding map file. A rewritten or replaced file differs in at least one field
+ */
+struct MapFileVersion {
+    dev_t dev{0};
+    ino_t ino{0};
+    off_t size{-1};
+    struct timespec mtime{0, 0};
+
+    bool operator==(const MapFileVersion& other) const {
+        return dev == other.dev && ino == other.ino && size == other.size && mtime.tv_sec == other.mtime.tv_sec &&
+               mtime.tv_nsec == other.mtime.tv_nsec;
+    }
+};
+
+MapFileVersion map_file_version(const string& path) {
+    MapFileVersion version{};
+    struct stat st{};
+    if (syscall_no_intercept(SYS_stat, path.c_str(), &st) == 0) {
+        version.dev = st.st_dev;
+        version.ino = st.st_ino;
+        version.size = st.st_size;
+        version.mtime = st.st_mtim;
+    }
+    return version;
+}
 
-    int previous = -1;
+/**
+ * Watches the directory of the forwarding map, so that replacing the file by rename() is noticed as well
+ * @return inotify fd or -1 if inotify is not available
+ */
+int watch_map_file(const string& path) {
+    auto fd = syscall_no_intercept(SYS_inotify_init1, IN_NONBLOCK | IN_CLOEXEC);
+    if (syscall_error_code(fd) != 0) {
+        LOG(WARNING, "{}() inotify not available: '{}'. Forwarding map is checked every {} seconds", __func__,
+            ::strerror(syscall_error_code(fd)), gkfs::config::forwarding_map_check_interval);
+        return -1;
+    }
+    auto slash = path.find_last_of('/');
+    auto dir = slash == string::npos ? "."s : (slash == 0 ? "/"s : path.substr(0, slash));
+    auto wd = syscall_no_intercept(SYS_inotify_add_watch, fd, dir.c_str(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY);
+    if (syscall_error_code(wd) != 0) {
+        LOG(WARNING, "{}() Failed to watch '{}': '{}'. Forwarding map is checked every {} seconds", __func__, dir,
+            ::strerror(syscall_error_code(wd)), gkfs::config::forwarding_map_check_interval);
+        syscall_no_intercept(SYS_close, fd);
+        return -1;
+    }
+#ifndef BYPASS_SYSCALL
+    try {
+        fd = CTX->register_internal_fd(static_cast<int>(fd));
+    } catch (const std::exception& e) {
+        LOG(WARNING, "{}() Failed to register inotify fd: '{}'", __func__, e.what());
+        syscall_no_intercept(SYS_close, fd);
+        return -1;
+    }
+#endif
+    return static_cast<int>(fd);
+}
 
-    while (forwarding_running) {
-        try {
-            gkfs::util::load_forwarding_map();
+/**
+ * Drains pending inotify events
+ * @return true if an event concerns the file name
+ */
+bool map_file_touched(int inotify_fd, const string& name) {
+    alignas(struct inotify_event) char buf[4096];
+    auto touched = false;
+    long len;
+    while ((len = syscall_no_intercept(SYS_read, inotify_fd, buf, sizeof(buf))) > 0) {
+        for (long pos = 0; pos < len;) {
+            auto event = reinterpret_cast<struct inotify_event*>(buf + pos);
+            // on overflow, events were dropped
+            if ((event->mask & IN_Q_OVERFLOW) != 0 || (event->len > 0 && name == event->name))
+                touched = true;
+            pos += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return touched;
+}
 
-            if (previous != CTX->fwd_host_id()) {
-                LOG(INFO, "{}() Forward to {}", __func__, CTX->fwd_host_id());
+/**
+ * Moves this node to the least loaded of its candidate forwarders. The load of a forwarder is the number of its
+ * queued and processed data requests, including those waiting for a handler thread, plus the chunk operations
+ * waiting in its I/O pool. Ties are broken by bytes/s.
+ * Candidates that do not report their load within forwarding_balance_timeout are skipped. A query that timed out is
+ * not sent again before its response arrived, so that an unresponsive candidate holds at most one waiting thread.
+ * The node only moves if the load is lower by at least forwarding_balance_margin plus a random amount of up to the
+ * margin, or if the current forwarder does not respond. Open files keep their forwarder. After moving, the previous
+ * forwarder drains its staged chunks, so that they are visible through the new forwarder.
+ */
+void balance_forwarder() {
+    static std::map<uint64_t, std::shared_future<std::pair<int, gkfs::rpc::DaemonLoad>>> queries{};
+    const auto& candidates = CTX->fwd_candidates();
+    if (candidates.size() < 2)
+        return;
+    for (auto candidate : candidates) {
+        auto& query = queries[candidate];
+        if (!query.valid())
+            query = gkfs::rpc::forward_get_load_async(candidate);
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(gkfs::config::forwarding_balance_timeout);
+
+    auto current = CTX->fwd_host_id();
+    auto best = current;
+    auto current_reachable = false;
+    uint64_t current_load = 0;
+    uint64_t best_load = 0;
+    uint64_t best_bytes = 0;
+    auto best_found = false;
+    for (auto candidate : candidates) {
+        auto& query = queries[candidate];
+        if (query.wait_until(deadline) != std::future_status::ready) {
+            LOG(WARNING, "{}() Forwarder {} did not report its load within {} ms", __func__, candidate,
+                gkfs::config::forwarding_balance_timeout);
+            continue;
+        }
+        auto ret = query.get();
+        query = {};
+        if (ret.first != 0)
+            continue;
+        auto load = ret.second.queue_depth + ret.second.pending_tasks + ret.second.data_queue_depth;
+        LOG(DEBUG, "{}() Forwarder {} load {} bytes/s {}", __func__, candidate, load, ret.second.bytes_per_sec);
+        if (candidate == current) {
+            current_reachable = true;
+            current_load = load;
+        }
+        if (!best_found || load < best_load || (load == best_load && ret.second.bytes_per_sec < best_bytes)) {
+            best_found = true;
+            best = candidate;
+            best_load = load;
+            best_bytes = ret.second.bytes_per_sec;
+        }
+    }
+    if (!best_found || best == current)
+        return;
+    auto margin = gkfs::config::forwarding_balance_margin +
+                  std::uniform_int_distribution<uint64_t>{0, gkfs::config::forwarding_balance_margin}(mapper_rng);
+    if (current_reachable && best_load + margin > current_load)
+        return;
+    if (!gkfs::util::set_forwarder(best))
+        return;
+    LOG(INFO, "{}() Forward to {} (load {}) instead of {} (load {})", __func__, best, best_load, current,
+        current_reachable ? fmt::format("{}", current_load) : "unreachable"s);
+    if (!current_reachable) {
+        LOG(WARNING, "{}() Chunks staged on forwarder {} are not flushed", __func__, current);
+        return;
+    }
+    auto err = gkfs::rpc::forward_flush_data(current, gkfs::config::forwarding_flush_timeout);
+    if (err != 0) {
+        LOG(WARNING, "{}() Failed to flush chunks staged on forwarder {}: '{}'", __func__, current,
+            ::strerror(err));
+    }
+}
+
+/**
+ * @return time in milliseconds until the next balancing round, varied by forwarding_balance_jitter percent
+ */
+int balance_timeout() {
+    auto interval = gkfs::config::forwarding_balance_interval * 1000;
+    auto jitter = interval * gkfs::config::forwarding_balance_jitter / 100;
+    return interval - jitter + std::uniform_int_distribution<int>{0, 2 * jitter}(mapper_rng);
+}
 
-                previous = CTX->fwd_host_id();
+/**
+ * Reloads the forwarding map when it changes. Changes are noticed by inotify and, as a fallback for file systems
+ * without notifications, by a periodic check of the file's version. Unchanged files are not read again.
+ * If the map lists several candidate forwarders for this node, their load is checked in between.
+ */
+void* forwarding_mapper(void* p) {
+    auto map_file = gkfs::env::get_var(gkfs::env::FORWARDING_MAP_FILE, gkfs::config::forwarding_file_path);
+    auto map_name = map_file.substr(map_file.find_last_of('/') + 1);
+    auto inotify_fd = mapper_inotify_fd;
+    // the map was loaded during initialization
+    auto loaded_version = map_file_version(map_file);
+
+    struct pollfd fds[2]{};
+    fds[0].fd = mapper_wakeup_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = inotify_fd;
+    fds[1].events = POLLIN;
+    while (true) {
+        auto balancing = CTX->fwd_candidates().size() > 1;
+        auto timeout = balancing ? balance_timeout() : gkfs::config::forwarding_map_check_interval * 1000;
+        auto ret = syscall_no_intercept(SYS_poll, fds, inotify_fd < 0 ? 1 : 2, timeout);
+        if (syscall_error_code(ret) == EINTR)
+            continue;
+        if (syscall_error_code(ret) != 0) {
+            LOG(ERROR, "{}() poll() failed: '{}'", __func__, ::strerror(syscall_error_code(ret)));
+            break;
+        }
+        if (fds[0].revents != 0)
+            break;
+        if (ret == 0 && balancing)
+            balance_forwarder();
+        if (fds[1].revents != 0 && !map_file_touched(inotify_fd, map_name))
+            continue;
+
+        auto version = map_file_version(map_file);
+        if (version == loaded_version)
+            continue;
+        try {
+            if (gkfs::util::load_forwarding_map(false)) {
+                LOG(INFO, "{}() Forward to {}", __func__, CTX->fwd_host_id());
             }
-        } catch (std::exception& e) {
-            exit_error_msg(EXIT_FAILURE, fmt::format("Unable set the forwarding host '{}'", e.what()));
+            loaded_version = version;
+        } catch (const std::exception& e) {
+            // e.g., the file is being rewritten. The next change is picked up
+            LOG(WARNING, "{}() Keeping forwarder {}: {}", __func__, CTX->fwd_host_id(), e.what());
         }
-
-        pthread_mutex_lock(&remap_mutex);
-        pthread_cond_timedwait(&remap_signal, &remap_mutex, &timeout);
-        pthread_mutex_unlock(&remap_mutex);
     }
-
     return nullptr;
 }
+
+/**
+ * Closes the file descriptors of the forwarding mapper
+ */
+void close_mapper_fds() {
+    for (auto fd : {mapper_wakeup_fd, mapper_inotify_fd}) {
+        if (fd < 0)
+            continue;
+#ifndef BYPASS_SYSCALL
+        CTX->unregister_internal_fd(fd);
 #endif
+        syscall_no_intercept(SYS_close, fd);
+    }
+    mapper_wakeup_fd = -1;
+    mapper_inotify_fd = -1;
+}
 
-#ifdef GKFS_ENABLE_FORWARDING
 void init_forwarding_mapper() {
-    forwarding_running = true;
-
-    pthread_create(&mapper, NULL, forwarding_mapper, NULL);
-}
+    auto fd = syscall_no_intercept(SYS_eventfd2, 0, EFD_CLOEXEC);
+    if (syscall_error_code(fd) != 0) {
+        exit_error_msg(EXIT_FAILURE, "Failed to create eventfd for the forwarding mapper: "s +
+                                     ::strerror(syscall_error_code(fd)));
+    }
+#ifndef BYPASS_SYSCALL
+    try {
+        fd = CTX->register_internal_fd(static_cast<int>(fd));
+    } catch (const std::exception& e) {
+        syscall_no_intercept(SYS_close, fd);
+        exit_error_msg(EXIT_FAILURE, "Failed to register eventfd for the forwarding mapper: "s + e.what());
+    }
 #endif
+    mapper_wakeup_fd = static_cast<int>(fd);
+    mapper_rng.seed(static_cast<unsigned int>(chrono::steady_clock::now().time_since_epoch().count()) ^
+                    static_cast<unsigned int>(syscall_no_intercept(SYS_getpid)));
+    mapper_inotify_fd = watch_map_file(
+            gkfs::env::get_var(gkfs::env::FORWARDING_MAP_FILE, gkfs::config::forwarding_file_path));
+
+    auto err = pthread_create(&mapper, NULL, forwarding_mapper, NULL);
+    if (err != 0) {
+        close_mapper_fds();
+        exit_error_msg(EXIT_FAILURE, "Failed to start the forwarding mapper: "s + ::strerror(err));
+    }
+}
 
-#ifdef GKFS_ENABLE_FORWARDING
 void destroy_forwarding_mapper() {
-    forwarding_running = false;
-
-    pthread_cond_signal(&remap_signal);
+    uint64_t val = 1;
+    syscall_no_intercept(SYS_write, mapper_wakeup_fd, &val, sizeof(val));
 
     pthread_join(mapper, NULL);
+
+    close_mapper_fds();
 }
 #endif
 
@@ -216,6 +499,79 @@ void init_ld_env_if_needed() {
 } // namespace preload
 } // namespace gkfs
 
+#ifdef BYPASS_SYSCALL
+
+namespace gkfs {
+namespace syscall {
+
+/**
+ * Initializes the client of the user library: logging, RPC subsystem, and the connection to all daemons.
+ * No syscalls are intercepted. Subsequent calls return immediately.
+ * errno may be set
+ * @return 0 on success, -1 on failure
+ */
+int gkfs_init() {
+    std::lock_guard<std::mutex> lock(user_lib_mutex);
+    if (user_lib_initialized)
+        return 0;
+
+    CTX->init_logging();
+    LOG(DEBUG, "Logging subsystem initialized");
+
+    try {
+        log_prog_name();
+        init_ld_environment_();
+#ifdef GKFS_ENABLE_FORWARDING
+        // started last, it closes its own file descriptors on failure
+        init_forwarding_mapper();
+#endif
+    } catch (const std::exception&) {
+        // the error was already logged
+        ld_network_service.reset();
+        CTX->clear_hosts();
+        errno = EIO;
+        return -1;
+    }
+
+    user_lib_initialized = true;
+    LOG(INFO, "User library initialized");
+    return 0;
+}
+
+/**
+ * Shuts down the client of the user library. File descriptors opened through the library become invalid.
+ * @return 0 on success, -1 if the library was not initialized
+ */
+int gkfs_end() {
+    std::lock_guard<std::mutex> lock(user_lib_mutex);
+    if (!user_lib_initialized) {
+        errno = EINVAL;
+        return -1;
+    }
+
+#ifdef GKFS_ENABLE_FORWARDING
+    destroy_forwarding_mapper();
+#endif
+
+    // outstanding asynchronous I/O and dirty mapped pages still need the RPC subsystem
+    CTX->aio_queue()->shutdown();
+    CTX->mapped_regions()->shutdown();
+
+    CTX->clear_hosts();
+    LOG(DEBUG, "Peer information deleted");
+
+    shutdown_network_service();
+
+    user_lib_initialized = false;
+    LOG(INFO, "All subsystems shut down. User library shutdown complete.");
+    return 0;
+}
+
+} // namespace syscall
+} // namespace gkfs
+
+#else
+
 /**
  * Called initially ONCE when preload library is used with the LD_PRELOAD environment variable
  */
@@ -265,11 +621,14 @@ void destroy_preload() {
     destroy_forwarding_mapper();
 #endif
 
+    // outstanding asynchronous I/O and dirty mapped pages still need the RPC subsystem
+    CTX->aio_queue()->shutdown();
+    CTX->mapped_regions()->shutdown();
+
     CTX->clear_hosts();
     LOG(DEBUG, "Peer information deleted");
 
-    ld_network_service.reset();
-    LOG(DEBUG, "RPC subsystem shut down");
+    shutdown_network_service();
 
     gkfs::preload::stop_interception();
     CTX->disable_interception();
@@ -277,3 +636,5 @@ void destroy_preload() {
 
     LOG(INFO, "All subsystems shut down. Client shutdown complete.");
 }
+
+#endif // BYPASS_SYSCALL
@@ -14,6 +14,8 @@
 #include <client/env.hpp>
 #include <client/logging.hpp>
 #include <client/open_file_map.hpp>
+#include <client/aio_queue.hpp>
+#include <client/mapped_regions.hpp>
 #include <client/open_dir.hpp>
 #include <client/path.hpp>
 
@@ -28,6 +30,7 @@
 extern "C" {
 #include <libsyscall_intercept_hook_point.h>
 #include <syscall.h>
+#include <sys/stat.h>
 }
 
 namespace gkfs {
@@ -40,7 +43,10 @@ decltype(PreloadContext::MAX_USER_FDS) constexpr
 
 PreloadContext::PreloadContext() :
         ofm_(std::make_shared<gkfs::filemap::OpenFileMap>()),
-        fs_conf_(std::make_shared<FsConfig>()) {
+        aio_queue_(std::make_shared<gkfs::aio::AioQueue>()),
+        mapped_regions_(std::make_shared<gkfs::mapping::MappedRegions>()),
+        fs_conf_(std::make_shared<FsConfig>()),
+        fwd_pins_(std::make_shared<gkfs::rpc::ForwarderPins>()) {
 
     internal_fds_.set();
     internal_fds_must_relocate_ = true;
@@ -129,6 +135,18 @@ void PreloadContext::fwd_host_id(uint64_t id) {
     fwd_host_id_ = id;
 }
 
+const std::vector<uint64_t>& PreloadContext::fwd_candidates() const {
+    return fwd_candidates_;
+}
+
+void PreloadContext::fwd_candidates(const std::vector<uint64_t>& candidates) {
+    fwd_candidates_ = candidates;
+}
+
+const std::shared_ptr<gkfs::rpc::ForwarderPins>& PreloadContext::fwd_pins() const {
+    return fwd_pins_;
+}
+
 const std::string& PreloadContext::rpc_protocol() const {
     return rpc_protocol_;
 }
@@ -145,6 +163,38 @@ void PreloadContext::auto_sm(bool auto_sm) {
     PreloadContext::auto_sm_ = auto_sm;
 }
 
+unsigned int PreloadContext::stripe_count() const {
+    return stripe_count_;
+}
+
+void PreloadContext::stripe_count(unsigned int stripe_count) {
+    PreloadContext::stripe_count_ = stripe_count;
+}
+
+size_t PreloadContext::stripe_size() const {
+    return stripe_size_;
+}
+
+void PreloadContext::stripe_size(size_t stripe_size) {
+    PreloadContext::stripe_size_ = stripe_size;
+}
+
+bool PreloadContext::async_create() const {
+    return async_create_;
+}
+
+void PreloadContext::async_create(bool async_create) {
+    PreloadContext::async_create_ = async_create;
+}
+
+const std::string& PreloadContext::job_id() const {
+    return job_id_;
+}
+
+void PreloadContext::job_id(const std::string& job_id) {
+    PreloadContext::job_id_ = job_id;
+}
+
 RelativizeStatus PreloadContext::relativize_fd_path(int dirfd,
                                                     const char* raw_path,
                                                     std::string& relative_path,
@@ -211,16 +261,74 @@ bool PreloadContext::relativize_path(const char* raw_path, std::string& relative
     return gkfs::path::resolve(path, relative_path, resolve_last_link);
 }
 
+/**
+ * @param path resolved path of a component outside of GekkoFS
+ * @param entry (return val)
+ * @return true if the component is cached
+ */
+bool PreloadContext::resolve_cache_get(const std::string& path, ResolveCacheEntry& entry) const {
+    std::lock_guard<std::mutex> lock(resolve_cache_mutex_);
+    auto it = resolve_cache_.find(path);
+    if (it == resolve_cache_.end())
+        return false;
+    entry = it->second;
+    return true;
+}
+
+void PreloadContext::resolve_cache_put(const std::string& path, const ResolveCacheEntry& entry) {
+    if (gkfs::config::path::resolve_cache_size == 0)
+        return;
+    std::lock_guard<std::mutex> lock(resolve_cache_mutex_);
+    if (resolve_cache_.size() >= gkfs::config::path::resolve_cache_size)
+        resolve_cache_.clear();
+    resolve_cache_[path] = entry;
+}
+
+/**
+ * Removes a path, all cached components below it, and all links pointing to it or below it
+ * @param path resolved path
+ */
+void PreloadContext::resolve_cache_erase(const std::string& path) {
+    auto is_below = [&path](const std::string& p) {
+        return p.compare(0, path.size(), path) == 0 &&
+               (p.size() == path.size() || p[path.size()] == gkfs::path::separator);
+    };
+    std::lock_guard<std::mutex> lock(resolve_cache_mutex_);
+    for (auto it = resolve_cache_.begin(); it != resolve_cache_.end();) {
+        if (is_below(it->first) || (S_ISLNK(it->second.mode) && is_below(it->second.link_target)))
+            it = resolve_cache_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void PreloadContext::resolve_cache_clear() {
+    std::lock_guard<std::mutex> lock(resolve_cache_mutex_);
+    resolve_cache_.clear();
+}
+
 const std::shared_ptr<gkfs::filemap::OpenFileMap>& PreloadContext::file_map() const {
     return ofm_;
 }
 
+const std::shared_ptr<gkfs::aio::AioQueue>& PreloadContext::aio_queue() const {
+    return aio_queue_;
+}
+
+const std::shared_ptr<gkfs::mapping::MappedRegions>& PreloadContext::mapped_regions() const {
+    return mapped_regions_;
+}
+
+/*
+ * The distributor is replaced at runtime when the forwarder of this node changes, thus it is accessed atomically.
+ * Operations in flight keep their copy of the previous distributor.
+ */
 void PreloadContext::distributor(std::shared_ptr<gkfs::rpc::Distributor> d) {
-    distributor_ = d;
+    std::atomic_store(&distributor_, std::move(d));
 }
 
 std::shared_ptr<gkfs::rpc::Distributor> PreloadContext::distributor() const {
-    return distributor_;
+    return std::atomic_load(&distributor_);
 }
 
 const std::shared_ptr<FsConfig>& PreloadContext::fs_conf() const {
@@ -28,6 +28,9 @@
 #include <regex>
 #include <csignal>
 #include <random>
+#include <thread>
+#include <chrono>
+#include <algorithm>
 
 extern "C" {
 #include <sys/sysmacros.h>
@@ -211,6 +214,11 @@ int metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md
 
     attr.st_mode = md.mode();
 
+    // striped files report their stripe unit as preferred I/O size
+    if (md.stripe_count() > 0 && md.stripe_size() > 0) {
+        attr.st_blksize = md.stripe_size();
+    }
+
 #ifdef HAS_SYMLINKS
     if (md.is_link())
         attr.st_size = md.target_path().size() + CTX->mountdir().size();
@@ -236,8 +244,55 @@ int metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md
     return 0;
 }
 
+/**
+ * Converts the stripe layout fields of a metadentry to the layout used for data placement
+ * @param md
+ * @return
+ */
+gkfs::rpc::StripeLayout metadata_to_layout(const gkfs::metadata::Metadata& md) {
+    gkfs::rpc::StripeLayout layout{};
+    layout.stripe_count = md.stripe_count();
+    layout.stripe_size = md.stripe_size();
+    layout.start_host = md.stripe_start();
+    return layout;
+}
+
+/**
+ * Loads the default stripe layout for newly created files from the environment.
+ * A stripe count of 0 (default) keeps the hash-based placement over all hosts.
+ * @throws std::runtime_error if the given values are invalid
+ */
+void load_stripe_layout() {
+    unsigned long stripe_count;
+    unsigned long stripe_size;
+    try {
+        stripe_count = std::stoul(gkfs::env::get_var(gkfs::env::STRIPE_COUNT, "0"));
+        stripe_size = std::stoul(gkfs::env::get_var(gkfs::env::STRIPE_SIZE,
+                                                    std::to_string(gkfs::config::rpc::chunksize)));
+    } catch (const exception& e) {
+        throw runtime_error(fmt::format("Failed to parse stripe layout: {}", e.what()));
+    }
+    if (stripe_size == 0 || stripe_size % gkfs::config::rpc::chunksize != 0) {
+        throw runtime_error(fmt::format("Stripe size '{}' must be a multiple of the chunksize '{}'",
+                                        stripe_size, gkfs::config::rpc::chunksize));
+    }
+    if (stripe_count > CTX->hosts().size()) {
+        LOG(WARNING, "Stripe count '{}' exceeds number of hosts. Using '{}'", stripe_count, CTX->hosts().size());
+        stripe_count = CTX->hosts().size();
+    }
+    CTX->stripe_count(static_cast<unsigned int>(stripe_count));
+    CTX->stripe_size(stripe_size);
+    LOG(INFO, "Default stripe layout: count '{}' size '{}'", stripe_count, stripe_size);
+}
+
 #ifdef GKFS_ENABLE_FORWARDING
-map<string, uint64_t> load_forwarding_map_file(const std::string& lfpath) {
+/**
+ * Reads the forwarding map. Each line maps a host to its forwarder or to a comma-separated list of candidate
+ * forwarders, e.g., "node1 3" or "node1 3,4,5". The first candidate is the default forwarder
+ * @param lfpath
+ * @return map of host names to their candidate forwarders
+ */
+map<string, vector<uint64_t>> load_forwarding_map_file(const std::string& lfpath) {
 
     LOG(DEBUG, "Loading forwarding map file file: \"{}\"", lfpath);
 
@@ -246,12 +301,11 @@ map<string, uint64_t> load_forwarding_map_file(const std::string& lfpath) {
         throw runtime_error(fmt::format("Failed to open forwarding map file '{}': {}",
                             lfpath, strerror(errno)));
     }
-    map<string, uint64_t> forwarding_map;
-    const regex line_re("^(\\S+)\\s+(\\S+)$",
+    map<string, vector<uint64_t>> forwarding_map;
+    const regex line_re("^(\\S+)\\s+(\\d+(,\\d+)*)$",
                         regex::ECMAScript | regex::optimize);
     string line;
     string host;
-    uint64_t forwarder;
     std::smatch match;
     while (getline(lf, line)) {
         if (!regex_match(line, match, line_re)) {
@@ -263,20 +317,50 @@ map<string, uint64_t> load_forwarding_map_file(const std::string& lfpath) {
                     fmt::format("unrecognized line format: '{}'", line));
         }
         host = match[1];
-        forwarder = std::stoi(match[2].str());
-        forwarding_map[host] = forwarder;
+        vector<uint64_t> candidates;
+        stringstream ids(match[2].str());
+        string id;
+        while (getline(ids, id, ',')) {
+            auto forwarder = std::stoul(id);
+            if (forwarder >= CTX->hosts().size()) {
+                throw runtime_error(fmt::format("forwarder '{}' of host '{}' is not a daemon", forwarder, host));
+            }
+            candidates.push_back(forwarder);
+        }
+        forwarding_map[host] = candidates;
     }
     return forwarding_map;
 }
-#endif
 
-#ifdef GKFS_ENABLE_FORWARDING
-void load_forwarding_map() {
+/**
+ * Sets the forwarder of this node. If the forwarder changed, the distributor is replaced atomically. Operations in
+ * flight finish with the previous forwarder and open files keep theirs.
+ * @param forwarder
+ * @return true if the forwarder changed
+ */
+bool set_forwarder(uint64_t forwarder) {
+    if (CTX->distributor() != nullptr && CTX->fwd_host_id() == forwarder) {
+        return false;
+    }
+    CTX->fwd_host_id(forwarder);
+    CTX->distributor(std::make_shared<gkfs::rpc::ForwarderDistributor>(forwarder, CTX->hosts().size(),
+                                                                      CTX->fwd_pins()));
+    return true;
+}
+
+/**
+ * Reads the forwarding map and sets the candidate forwarders of this node. The node stays with its current
+ * forwarder as long as it is a candidate, otherwise it moves to the first candidate.
+ * @param wait_for_entries retry until the file has entries, e.g., while the job script still writes it.
+ * Otherwise an empty file is an error
+ * @return true if the forwarder changed
+ */
+bool load_forwarding_map(bool wait_for_entries) {
     string forwarding_map_file;
 
     forwarding_map_file = gkfs::env::get_var(gkfs::env::FORWARDING_MAP_FILE, gkfs::config::forwarding_file_path);
 
-    map<string, uint64_t> forwarding_map;
+    map<string, vector<uint64_t>> forwarding_map;
 
     while (forwarding_map.size() == 0) {
         try {
@@ -285,20 +369,29 @@ void load_forwarding_map() {
             auto emsg = fmt::format("Failed to load forwarding map file: {}", e.what());
             throw runtime_error(emsg);
         }
+        if (forwarding_map.empty()) {
+            if (!wait_for_entries) {
+                throw runtime_error(fmt::format("Forwarding map file is empty: '{}'", forwarding_map_file));
+            }
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
     }
 
-    //if (forwarding_map.size() == 0) {
-    //    throw runtime_error(fmt::format("Forwarding map file is empty: '{}'", forwarding_map_file));
-    //}
-
-    auto local_hostname = get_my_hostname(true);
+    auto local_hostname = gkfs::rpc::get_my_hostname(true);
 
     if (forwarding_map.find(local_hostname) == forwarding_map.end()) {
         throw runtime_error(fmt::format("Unable to determine the forwarder for host: '{}'", local_hostname));
     }
-    LOG(INFO, "Forwarding map loaded for '{}' as '{}'", local_hostname, forwarding_map[local_hostname]);
-
-    CTX->fwd_host_id(forwarding_map[local_hostname]);
+    const auto& candidates = forwarding_map[local_hostname];
+    LOG(INFO, "Forwarding map loaded for '{}' as '{}' with '{}' candidate forwarder(s)", local_hostname,
+        candidates.front(), candidates.size());
+    CTX->fwd_candidates(candidates);
+
+    if (CTX->distributor() != nullptr &&
+        find(candidates.begin(), candidates.end(), CTX->fwd_host_id()) != candidates.end()) {
+        return false;
+    }
+    return set_forwarder(candidates.front());
 }
 #endif
 
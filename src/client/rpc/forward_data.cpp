@@ -20,12 +20,28 @@
 #include <global/chunk_calc_util.hpp>
 
 #include <unordered_set>
+#include <future>
 
 using namespace std;
 
 namespace gkfs {
 namespace rpc {
 
+namespace {
+
+/**
+ * Returns an already completed I/O result for errors detected before any RPC was sent
+ * @param err
+ * @return future holding pair<error code, 0>
+ */
+shared_future<pair<int, ssize_t>> ready_io_result(int err) {
+    promise<pair<int, ssize_t>> result;
+    result.set_value(make_pair(err, static_cast<ssize_t>(0)));
+    return result.get_future().share();
+}
+
+} // namespace
+
 /*
  * This file includes all metadata RPC calls.
  * NOTE: No errno is defined here!
@@ -35,18 +51,21 @@ namespace rpc {
 // Code is mostly redundant
 
 /**
- * Send an RPC request to write from a buffer.
+ * Send RPC requests to write from a buffer without waiting for their responses.
+ * The responses are only waited for when the result of the returned future is requested.
+ * The buffer must stay valid until then.
  * @param path
  * @param buf
  * @param append_flag
  * @param in_offset
  * @param write_size
  * @param updated_metadentry_size
- * @return pair<error code, written size>
+ * @param layout stripe layout of the file
+ * @return future holding pair<error code, written size>
  */
-pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool append_flag,
-                                 const off64_t in_offset, const size_t write_size,
-                                 const int64_t updated_metadentry_size) {
+shared_future<pair<int, ssize_t>>
+forward_write_async(const string& path, const void* buf, const bool append_flag, const off64_t in_offset,
+                    const size_t write_size, const int64_t updated_metadentry_size, const StripeLayout& layout) {
 
     assert(write_size > 0);
 
@@ -69,7 +88,7 @@ pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool
     uint64_t chnk_end_target = 0;
 
     for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        auto target = CTX->distributor()->locate_data(path, chnk_id, layout);
 
         if (target_chnks.count(target) == 0) {
             target_chnks.insert(std::make_pair(target, std::vector<uint64_t>{chnk_id}));
@@ -102,7 +121,7 @@ pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool
 
     } catch (const std::exception& ex) {
         LOG(ERROR, "Failed to expose buffers for RMA");
-        return make_pair(EBUSY, 0);
+        return ready_io_result(EBUSY);
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::write_data>> handles;
@@ -148,6 +167,12 @@ pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool
                     chnk_end,
                     // total size to write
                     total_chunk_size,
+                    // stripe layout so that daemons find their chunks
+                    layout.stripe_count,
+                    layout.stripe_size,
+                    layout.start_host,
+                    // job accounted by the daemon's QoS
+                    CTX->job_id(),
                     local_buffers);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
@@ -163,57 +188,84 @@ pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool
         } catch (const std::exception& ex) {
             LOG(ERROR, "Unable to send non-blocking rpc for "
                        "path \"{}\" [peer: {}]", path, target);
-            return make_pair(EBUSY, 0);
+            return ready_io_result(EBUSY);
         }
     }
 
-    // Wait for RPC responses and then get response and add it to out_size
-    // which is the written size All potential outputs are served to free
-    // resources regardless of errors, although an errorcode is set.
-    auto err = 0;
-    ssize_t out_size = 0;
-    std::size_t idx = 0;
-
-    for (const auto& h : handles) {
-        try {
-            // XXX We might need a timeout here to not wait forever for an
-            // output that never comes?
-            auto out = h.get().at(0);
-
-            if (out.err() != 0) {
-                LOG(ERROR, "Daemon reported error: {}", out.err());
-                err = out.err();
+    // local_buffers must stay exposed until all responses have arrived
+    return async(launch::deferred, [path, targets](vector<hermes::rpc_handle<gkfs::rpc::write_data>> handles,
+                                                   hermes::exposed_memory) {
+        // Wait for RPC responses and then get response and add it to out_size
+        // which is the written size All potential outputs are served to free
+        // resources regardless of errors, although an errorcode is set.
+        auto err = 0;
+        ssize_t out_size = 0;
+        std::size_t idx = 0;
+
+        for (const auto& h : handles) {
+            try {
+                // XXX We might need a timeout here to not wait forever for an
+                // output that never comes?
+                auto out = h.get().at(0);
+
+                if (out.err() != 0) {
+                    LOG(ERROR, "Daemon reported error: {}", out.err());
+                    err = out.err();
+                }
+
+                out_size += static_cast<size_t>(out.io_size());
+
+            } catch (const std::exception& ex) {
+                LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
+                    path, targets[idx]);
+                err = EIO;
             }
 
-            out_size += static_cast<size_t>(out.io_size());
-
-        } catch (const std::exception& ex) {
-            LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
-                path, targets[idx]);
-            err = EIO;
+            idx++;
         }
+        /*
+         * Typically file systems return the size even if only a part of it was written.
+         * In our case, we do not keep track which daemon fully wrote its workload. Thus, we always return size 0 on error.
+         */
+        if (err)
+            return make_pair(err, static_cast<ssize_t>(0));
+        else
+            return make_pair(0, out_size);
+    }, std::move(handles), std::move(local_buffers)).share();
+}
 
-        idx++;
-    }
-    /*
-     * Typically file systems return the size even if only a part of it was written.
-     * In our case, we do not keep track which daemon fully wrote its workload. Thus, we always return size 0 on error.
-     */
-    if (err)
-        return make_pair(err, 0);
-    else
-        return make_pair(0, out_size);
+/**
+ * Send an RPC request to write from a buffer.
+ * @param path
+ * @param buf
+ * @param append_flag
+ * @param in_offset
+ * @param write_size
+ * @param updated_metadentry_size
+ * @param layout stripe layout of the file
+ * @return pair<error code, written size>
+ */
+pair<int, ssize_t> forward_write(const string& path, const void* buf, const bool append_flag,
+                                 const off64_t in_offset, const size_t write_size,
+                                 const int64_t updated_metadentry_size, const StripeLayout& layout) {
+    return forward_write_async(path, buf, append_flag, in_offset, write_size, updated_metadentry_size,
+                               layout).get();
 }
 
 /**
- * Send an RPC request to read to a buffer.
+ * Send RPC requests to read to a buffer without waiting for their responses.
+ * The responses are only waited for when the result of the returned future is requested.
+ * The buffer must stay valid until then.
  * @param path
  * @param buf
  * @param offset
  * @param read_size
- * @return pair<error code, read size>
+ * @param layout stripe layout of the file
+ * @return future holding pair<error code, read size>
  */
-pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t offset, const size_t read_size) {
+shared_future<pair<int, ssize_t>>
+forward_read_async(const string& path, void* buf, const off64_t offset, const size_t read_size,
+                   const StripeLayout& layout) {
 
     // Calculate chunkid boundaries and numbers so that daemons know in which
     // interval to look for chunks
@@ -232,7 +284,7 @@ pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t off
     uint64_t chnk_end_target = 0;
 
     for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        auto target = CTX->distributor()->locate_data(path, chnk_id, layout);
 
         if (target_chnks.count(target) == 0) {
             target_chnks.insert(std::make_pair(target, std::vector<uint64_t>{chnk_id}));
@@ -265,7 +317,7 @@ pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t off
 
     } catch (const std::exception& ex) {
         LOG(ERROR, "Failed to expose buffers for RMA");
-        return make_pair(EBUSY, 0);
+        return ready_io_result(EBUSY);
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::read_data>> handles;
@@ -311,6 +363,12 @@ pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t off
                     chnk_end,
                     // total size to write
                     total_chunk_size,
+                    // stripe layout so that daemons find their chunks
+                    layout.stripe_count,
+                    layout.stripe_size,
+                    layout.start_host,
+                    // job accounted by the daemon's QoS
+                    CTX->job_id(),
                     local_buffers);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
@@ -327,43 +385,132 @@ pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t off
         } catch (const std::exception& ex) {
             LOG(ERROR, "Unable to send non-blocking rpc for path \"{}\" "
                        "[peer: {}]", path, target);
-            return make_pair(EBUSY, 0);
+            return ready_io_result(EBUSY);
+        }
+    }
+
+    // local_buffers must stay exposed until all responses have arrived
+    return async(launch::deferred, [path, targets](vector<hermes::rpc_handle<gkfs::rpc::read_data>> handles,
+                                                   hermes::exposed_memory) {
+        // Wait for RPC responses and then get response and add it to out_size
+        // which is the read size. All potential outputs are served to free
+        // resources regardless of errors, although an errorcode is set.
+        auto err = 0;
+        ssize_t out_size = 0;
+        std::size_t idx = 0;
+
+        for (const auto& h : handles) {
+            try {
+                // XXX We might need a timeout here to not wait forever for an
+                // output that never comes?
+                auto out = h.get().at(0);
+
+                if (out.err() != 0) {
+                    LOG(ERROR, "Daemon reported error: {}", out.err());
+                    err = out.err();
+                }
+
+                out_size += static_cast<size_t>(out.io_size());
+
+            } catch (const std::exception& ex) {
+                LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
+                    path, targets[idx]);
+                err = EIO;
+            }
+            idx++;
         }
+        /*
+         * Typically file systems return the size even if only a part of it was read.
+         * In our case, we do not keep track which daemon fully read its workload. Thus, we always return size 0 on error.
+         */
+        if (err)
+            return make_pair(err, static_cast<ssize_t>(0));
+        else
+            return make_pair(0, out_size);
+    }, std::move(handles), std::move(local_buffers)).share();
+}
+
+/**
+ * Send an RPC request to read to a buffer.
+ * @param path
+ * @param buf
+ * @param offset
+ * @param read_size
+ * @param layout stripe layout of the file
+ * @return pair<error code, read size>
+ */
+pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t offset, const size_t read_size,
+                                const StripeLayout& layout) {
+    return forward_read_async(path, buf, offset, read_size, layout).get();
+}
+
+/**
+ * Send RPC requests for a server-side copy of [src_offset, src_offset + count) of src_path to dst_offset of
+ * dst_path. Every daemon storing source chunks copies them to the destination chunks itself.
+ * src_offset and dst_offset must have the same position within a chunk.
+ * @param src_path
+ * @param src_layout stripe layout of the source file
+ * @param src_offset
+ * @param dst_path
+ * @param dst_layout stripe layout of the destination file
+ * @param dst_offset
+ * @param count
+ * @return pair<error code, copied size>
+ */
+pair<int, ssize_t> forward_copy_chunks(const string& src_path, const StripeLayout& src_layout, const off64_t src_offset,
+                                       const string& dst_path, const StripeLayout& dst_layout, const off64_t dst_offset,
+                                       const size_t count) {
+
+    assert(count > 0);
+    assert(gkfs::util::chnk_lpad(src_offset, gkfs::config::rpc::chunksize) ==
+           gkfs::util::chnk_lpad(dst_offset, gkfs::config::rpc::chunksize));
+
+    auto chnk_start = gkfs::util::chnk_id_for_offset(src_offset, gkfs::config::rpc::chunksize);
+    auto chnk_end = gkfs::util::chnk_id_for_offset(src_offset + count - 1, gkfs::config::rpc::chunksize);
+
+    // only daemons storing source chunks take part
+    std::vector<uint64_t> targets{};
+    std::unordered_set<uint64_t> seen{};
+    for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        auto target = CTX->distributor()->locate_data(src_path, chnk_id, src_layout);
+        if (seen.insert(target).second)
+            targets.push_back(target);
     }
 
-    // Wait for RPC responses and then get response and add it to out_size
-    // which is the read size. All potential outputs are served to free
-    // resources regardless of errors, although an errorcode is set.
+    std::vector<hermes::rpc_handle<gkfs::rpc::copy_chunks>> handles;
+
     auto err = 0;
-    ssize_t out_size = 0;
-    std::size_t idx = 0;
+    for (const auto& target : targets) {
+        try {
+            LOG(DEBUG, "Sending RPC ...");
+            gkfs::rpc::copy_chunks::input in(src_path, dst_path, src_offset, dst_offset, count, target,
+                                             CTX->hosts().size(), src_layout.stripe_count, src_layout.stripe_size,
+                                             src_layout.start_host, dst_layout.stripe_count,
+                                             dst_layout.stripe_size, dst_layout.start_host);
+            handles.emplace_back(ld_network_service->post<gkfs::rpc::copy_chunks>(CTX->hosts().at(target), in));
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Unable to send non-blocking rpc for path \"{}\" [peer: {}]", src_path, target);
+            err = EBUSY;
+            break; // We need to gather all responses so we can't return here
+        }
+    }
 
+    ssize_t out_size = 0;
     for (const auto& h : handles) {
         try {
-            // XXX We might need a timeout here to not wait forever for an
-            // output that never comes?
             auto out = h.get().at(0);
-
             if (out.err() != 0) {
                 LOG(ERROR, "Daemon reported error: {}", out.err());
                 err = out.err();
             }
-
             out_size += static_cast<size_t>(out.io_size());
-
         } catch (const std::exception& ex) {
-            LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
-                path, targets[idx]);
+            LOG(ERROR, "Failed to get rpc output for path \"{}\"", src_path);
             err = EIO;
         }
-        idx++;
     }
-    /*
-     * Typically file systems return the size even if only a part of it was read.
-     * In our case, we do not keep track which daemon fully read its workload. Thus, we always return size 0 on error.
-     */
     if (err)
-        return make_pair(err, 0);
+        return make_pair(err, static_cast<ssize_t>(0));
     else
         return make_pair(0, out_size);
 }
@@ -373,9 +520,10 @@ pair<int, ssize_t> forward_read(const string& path, void* buf, const off64_t off
  * @param path
  * @param current_size
  * @param new_size
+ * @param layout stripe layout of the file
  * @return error code
  */
-int forward_truncate(const std::string& path, size_t current_size, size_t new_size) {
+int forward_truncate(const std::string& path, size_t current_size, size_t new_size, const StripeLayout& layout) {
 
     assert(current_size > new_size);
 
@@ -387,7 +535,7 @@ int forward_truncate(const std::string& path, size_t current_size, size_t new_si
 
     std::unordered_set<unsigned int> hosts;
     for (unsigned int chunk_id = chunk_start; chunk_id <= chunk_end; ++chunk_id) {
-        hosts.insert(CTX->distributor()->locate_data(path, chunk_id));
+        hosts.insert(CTX->distributor()->locate_data(path, chunk_id, layout));
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::trunc_data>> handles;
@@ -440,11 +588,42 @@ int forward_truncate(const std::string& path, size_t current_size, size_t new_si
 }
 
 /**
- * Send an RPC request to chunk stat all hosts
+ * Send a single RPC request to chunk stat all hosts. Daemons forward the request along a k-ary tree
+ * (k = gkfs::config::rpc::broadcast_fanout) rooted at host 0 and add up the results of their subtrees.
+ * @return pair<error code, rpc::ChunkStat>
+ */
+pair<int, ChunkStat> forward_get_chunk_stat_tree() {
+    auto endp = CTX->hosts().at(0);
+    try {
+        LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
+        gkfs::rpc::chunk_stat_tree::input in(0, CTX->hosts().size(), gkfs::config::rpc::broadcast_fanout);
+        auto out = ld_network_service->post<gkfs::rpc::chunk_stat_tree>(endp, in).get().at(0);
+        if (out.err()) {
+            LOG(ERROR, "Tree chunk stat failed with err code '{}'", out.err());
+            return make_pair(out.err(), ChunkStat{});
+        }
+        return make_pair(0, ChunkStat{out.chunk_size(), out.chunk_total(), out.chunk_free()});
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to get RPC output from host: {}", endp.to_string());
+        return make_pair(EBUSY, ChunkStat{});
+    }
+}
+
+/**
+ * Send an RPC request to chunk stat all hosts. With more than one host and a configured broadcast fanout, a
+ * single RPC is reduced along a tree of daemons. If this fails, e.g., because the daemons were started without a
+ * shared hosts file, all hosts are contacted individually.
  * @return pair<error code, rpc::ChunkStat>
  */
 pair<int, ChunkStat> forward_get_chunk_stat() {
 
+    if (gkfs::config::rpc::broadcast_fanout > 0 && CTX->hosts().size() > 1) {
+        auto ret = forward_get_chunk_stat_tree();
+        if (ret.first == 0)
+            return ret;
+        LOG(WARNING, "Tree chunk stat failed. Falling back to contacting all hosts");
+    }
+
     std::vector<hermes::rpc_handle<gkfs::rpc::chunk_stat>> handles;
 
     auto err = 0;
@@ -18,6 +18,14 @@
 
 #include <boost/token_functions.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace gkfs {
 namespace rpc {
 
@@ -60,5 +68,171 @@ bool forward_get_fs_config() {
     return true;
 }
 
+namespace {
+
+// thread waiting for the response of a management RPC
+struct RpcWaiter {
+    std::thread thread;
+    // shared with the thread, so that a waiter left behind by join_rpc_waiters() can be forgotten
+    std::shared_ptr<bool> done;
+};
+
+std::mutex waiters_mutex;
+std::condition_variable waiters_done;
+// finished waiters are joined when the next waiter starts and by join_rpc_waiters()
+std::list<RpcWaiter> waiters;
+
+/**
+ * Joins the waiters whose response arrived. waiters_mutex must be held
+ */
+void join_done_waiters() {
+    for (auto it = waiters.begin(); it != waiters.end();) {
+        if (*it->done) {
+            it->thread.join();
+            it = waiters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * Waits for the response of a management RPC on its own thread, so that the caller can give up on a daemon that
+ * does not respond. The thread ends when the response arrives or the RPC fails and is joined by a later call or on
+ * shutdown, see join_rpc_waiters()
+ * @tparam RPC
+ * @tparam Result
+ * @param handle posted RPC
+ * @param get_result converts the RPC output to the result
+ * @param error result if the RPC fails
+ * @return future holding the result
+ */
+template<typename RPC, typename Result, typename GetResult>
+std::shared_future<Result> wait_detached(hermes::rpc_handle<RPC> handle, GetResult&& get_result, Result error) {
+    auto result = std::make_shared<std::promise<Result>>();
+    auto future = result->get_future().share();
+    auto done = std::make_shared<bool>(false);
+    std::lock_guard<std::mutex> lock(waiters_mutex);
+    join_done_waiters();
+    // the thread marks itself done under the lock, i.e., not before it is added
+    waiters.push_back(RpcWaiter{std::thread([result, error, done](hermes::rpc_handle<RPC> h,
+                                                                  std::decay_t<GetResult> get) {
+        try {
+            result->set_value(get(h.get().at(0)));
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to get rpc output: {}", ex.what());
+            result->set_value(error);
+        }
+        std::lock_guard<std::mutex> lock(waiters_mutex);
+        *done = true;
+        waiters_done.notify_all();
+    }, std::move(handle), std::forward<GetResult>(get_result)), done});
+    return future;
+}
+
+} // namespace
+
+/**
+ * Gets the load of a daemon, e.g., to choose among candidate forwarders. The response is waited for on a separate
+ * thread, so that the returned future can be waited for with a timeout
+ * @param host_id
+ * @return future holding pair<error code, DaemonLoad>
+ */
+std::shared_future<std::pair<int, DaemonLoad>> forward_get_load_async(uint64_t host_id) {
+
+    auto endp = CTX->hosts().at(host_id);
+    auto host = endp.to_string();
+    auto error = std::make_pair(EBUSY, DaemonLoad{});
+
+    try {
+        LOG(DEBUG, "Retrieving load from host: {}", host);
+        auto handle = ld_network_service->post<gkfs::rpc::get_load>(endp);
+        return wait_detached(std::move(handle), [host](const gkfs::rpc::get_load::output& out) {
+            if (out.err()) {
+                LOG(ERROR, "Host '{}' reported err code '{}' during load request", host, out.err());
+                return std::make_pair(static_cast<int>(out.err()), DaemonLoad{});
+            }
+            return std::make_pair(0, DaemonLoad{out.queue_depth(), out.bytes_per_sec(), out.pending_tasks(),
+                                                out.metadata_queue_depth(), out.data_queue_depth()});
+        }, error);
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to get load from host: {}", host);
+        std::promise<std::pair<int, DaemonLoad>> result;
+        result.set_value(error);
+        return result.get_future().share();
+    }
+}
+
+/**
+ * Makes a daemon drain the chunks it staged, e.g., before this client moves to another forwarder
+ * @param host_id
+ * @param timeout_ms
+ * @return error code, ETIMEDOUT if the daemon did not respond in time
+ */
+int forward_flush_data(uint64_t host_id, unsigned int timeout_ms) {
+
+    auto endp = CTX->hosts().at(host_id);
+
+    try {
+        LOG(DEBUG, "Flushing staged data of host: {}", endp.to_string());
+        auto handle = ld_network_service->post<gkfs::rpc::flush_data>(endp);
+        auto result = wait_detached(std::move(handle), [](const gkfs::rpc::flush_data::output& out) {
+            return static_cast<int>(out.err());
+        }, EBUSY);
+        if (result.wait_for(std::chrono::milliseconds(timeout_ms)) != std::future_status::ready) {
+            LOG(ERROR, "Host '{}' did not flush its staged data within {} ms", endp.to_string(), timeout_ms);
+            return ETIMEDOUT;
+        }
+        if (result.get()) {
+            LOG(ERROR, "Host '{}' reported err code '{}' during flush request", endp.to_string(), result.get());
+        }
+        return result.get();
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to flush staged data of host: {}", endp.to_string());
+        return EBUSY;
+    }
+}
+
+/**
+ * Gets the per-job QoS statistics of a daemon as text table
+ * @param host_id
+ * @return pair<error code, statistics>. ENOTSUP if the daemon runs without QoS
+ */
+std::pair<int, std::string> forward_get_qos_stats(uint64_t host_id) {
+
+    auto endp = CTX->hosts().at(host_id);
+
+    try {
+        LOG(DEBUG, "Retrieving QoS statistics from host: {}", endp.to_string());
+        auto out = ld_network_service->post<gkfs::rpc::get_qos_stats>(endp).get().at(0);
+        if (out.err()) {
+            LOG(ERROR, "Host '{}' reported err code '{}' during QoS statistics request", endp.to_string(),
+                out.err());
+            return std::make_pair(out.err(), std::string{});
+        }
+        return std::make_pair(0, out.stats());
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to get QoS statistics from host: {}", endp.to_string());
+        return std::make_pair(EBUSY, std::string{});
+    }
+}
+
+/**
+ * Joins the threads waiting for responses of management RPCs. Must be called before the RPC subsystem shuts down
+ * @param timeout_ms time to wait for outstanding responses
+ * @return false if responses are still outstanding. Their threads are detached and still use the RPC subsystem
+ */
+bool join_rpc_waiters(unsigned int timeout_ms) {
+    std::unique_lock<std::mutex> lock(waiters_mutex);
+    auto all_done = waiters_done.wait_for(lock, std::chrono::milliseconds(timeout_ms), [] {
+        return std::all_of(waiters.begin(), waiters.end(), [](const RpcWaiter& waiter) { return *waiter.done; });
+    });
+    join_done_waiters();
+    for (auto& waiter : waiters)
+        waiter.thread.detach();
+    waiters.clear();
+    return all_done;
+}
+
 } // namespace rpc
 } // namespace gkfs
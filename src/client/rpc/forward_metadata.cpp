@@ -22,6 +22,9 @@
 #include <global/rpc/distributor.hpp>
 #include <global/rpc/rpc_types.hpp>
 
+#include <algorithm>
+#include <map>
+
 using namespace std;
 
 namespace gkfs {
@@ -32,13 +35,137 @@ namespace rpc {
  * NOTE: No errno is defined here!
  */
 
+namespace {
+
+/**
+ * Paths of a batched request that belong to a single metadata host. The paths are stored as consecutive
+ * null-terminated strings at the beginning of the buffer which is exposed to the daemon.
+ */
+struct BatchTarget {
+    host_t host;
+    std::vector<std::size_t> indices; // positions of the paths in the caller's vector
+    std::size_t paths_size{0};
+    std::size_t buf_size{0};
+    std::unique_ptr<char[]> buf;
+};
+
+/**
+ * Groups paths by their responsible metadata host and serializes them into one buffer per host
+ * @param paths
+ * @param entry_size minimum buffer space per path, e.g., to receive results into the same buffer
+ * @return
+ */
+std::vector<BatchTarget> make_batch_targets(const std::vector<std::string>& paths, std::size_t entry_size) {
+    std::map<host_t, BatchTarget> targets{};
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        auto host = CTX->distributor()->locate_file_metadata(paths[i]);
+        auto& target = targets[host];
+        target.host = host;
+        target.indices.emplace_back(i);
+        // number of characters + \0 terminator
+        target.paths_size += paths[i].size() + 1;
+    }
+    std::vector<BatchTarget> ret{};
+    ret.reserve(targets.size());
+    for (auto& t : targets) {
+        auto& target = t.second;
+        target.buf_size = std::max(target.paths_size, target.indices.size() * entry_size);
+        target.buf = std::unique_ptr<char[]>(new char[target.buf_size]);
+        auto ptr = target.buf.get();
+        for (auto i : target.indices) {
+            ::memcpy(ptr, paths[i].c_str(), paths[i].size() + 1);
+            ptr += paths[i].size() + 1;
+        }
+        ret.emplace_back(std::move(target));
+    }
+    return ret;
+}
+
+/**
+ * Exposes the buffers of all batch targets for RMA
+ * @param targets
+ * @param mode
+ * @param exposed_buffers (return val)
+ * @return error code
+ */
+int expose_batch_targets(const std::vector<BatchTarget>& targets, hermes::access_mode mode,
+                         std::vector<hermes::exposed_memory>& exposed_buffers) {
+    exposed_buffers.reserve(targets.size());
+    for (const auto& target : targets) {
+        try {
+            exposed_buffers.emplace_back(ld_network_service->expose(
+                    std::vector<hermes::mutable_buffer>{
+                            hermes::mutable_buffer{target.buf.get(), target.buf_size}
+                    }, mode));
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "{}() Failed to expose buffers for RMA. err '{}'", __func__, ex.what());
+            return EBUSY;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sends a batched RPC to all targets and waits for all responses. RPC types must have an err() output.
+ * @tparam RPC batched RPC type
+ * @tparam MakeInput callable to build the RPC input for a target and its exposed buffer
+ * @param targets
+ * @param exposed_buffers
+ * @param make_input
+ * @param outputs (return val) outputs of the targets in the same order. Only valid if the target's error code is 0
+ * @param errs (return val) error code of each target, EBUSY if the RPC was not sent or its response not received
+ * @return error code
+ */
+template<typename RPC, typename MakeInput>
+int post_batch(const std::vector<BatchTarget>& targets, const std::vector<hermes::exposed_memory>& exposed_buffers,
+               MakeInput&& make_input, std::vector<typename RPC::output>& outputs, std::vector<int>& errs) {
+    auto err = 0;
+    std::vector<hermes::rpc_handle<RPC>> handles;
+    handles.reserve(targets.size());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        auto endp = CTX->hosts().at(targets[i].host);
+        try {
+            LOG(DEBUG, "{}() Sending RPC to host '{}' with '{}' paths", __func__, targets[i].host,
+                targets[i].indices.size());
+            handles.emplace_back(ld_network_service->post<RPC>(endp, make_input(targets[i], exposed_buffers[i])));
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "{}() Unable to send non-blocking rpc to host '{}' err '{}'", __func__, targets[i].host,
+                ex.what());
+            err = EBUSY;
+            break; // we need to gather responses from already sent RPCS
+        }
+    }
+    outputs.resize(targets.size());
+    errs.assign(targets.size(), EBUSY);
+    // wait for RPC responses
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        try {
+            outputs[i] = handles[i].get().at(0);
+            errs[i] = outputs[i].err();
+            if (errs[i] != 0) {
+                LOG(ERROR, "{}() Received error response from host '{}': '{}'", __func__, targets[i].host,
+                    strerror(errs[i]));
+                err = errs[i];
+            }
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "{}() Failed to get rpc output from host '{}' err '{}'", __func__, targets[i].host,
+                ex.what());
+            err = EBUSY;
+        }
+    }
+    return err;
+}
+
+} // namespace
+
 /**
  * Send an RPC for a create request
  * @param path
  * @param mode
+ * @param layout stripe layout stored in the new metadentry
  * @return error code
  */
-int forward_create(const std::string& path, const mode_t mode) {
+int forward_create(const std::string& path, const mode_t mode, const StripeLayout& layout) {
 
     auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
 
@@ -49,7 +176,8 @@ int forward_create(const std::string& path, const mode_t mode) {
         // TODO(amiranda): hermes will eventually provide a post(endpoint)
         // returning one result and a broadcast(endpoint_set) returning a
         // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service->post<gkfs::rpc::create>(endp, path, mode).get().at(0);
+        auto out = ld_network_service->post<gkfs::rpc::create>(endp, path, mode, layout.stripe_count,
+                                                                layout.stripe_size, layout.start_host).get().at(0);
         LOG(DEBUG, "Got response success: {}", out.err());
 
         return out.err() ? out.err() : 0;
@@ -59,6 +187,40 @@ int forward_create(const std::string& path, const mode_t mode) {
     }
 }
 
+/**
+ * Send an RPC for a create request without waiting for its response.
+ * The response is only waited for when the result of the returned future is requested.
+ * @param path
+ * @param mode
+ * @param layout stripe layout stored in the new metadentry
+ * @return future holding the error code
+ */
+std::shared_future<int> forward_create_async(const std::string& path, const mode_t mode, const StripeLayout& layout) {
+
+    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+
+    try {
+        LOG(DEBUG, "Sending async RPC ...");
+        auto handle = ld_network_service->post<gkfs::rpc::create>(endp, path, mode, layout.stripe_count,
+                                                                   layout.stripe_size, layout.start_host);
+        return std::async(std::launch::deferred, [path](hermes::rpc_handle<gkfs::rpc::create> h) {
+            try {
+                auto out = h.get().at(0);
+                LOG(DEBUG, "Got async create response for '{}' success: {}", path, out.err());
+                return out.err() ? out.err() : 0;
+            } catch (const std::exception& ex) {
+                LOG(ERROR, "while getting rpc output");
+                return EBUSY;
+            }
+        }, std::move(handle)).share();
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to send async create RPC for '{}': {}", path, ex.what());
+        std::promise<int> err;
+        err.set_value(EBUSY);
+        return err.get_future().share();
+    }
+}
+
 /**
  * Send an RPC for a stat request
  * @param path
@@ -97,9 +259,11 @@ int forward_stat(const std::string& path, string& attr) {
  * @param path
  * @param remove_metadentry_only
  * @param size
+ * @param layout stripe layout of the file
  * @return error code
  */
-int forward_remove(const std::string& path, const bool remove_metadentry_only, const ssize_t size) {
+int forward_remove(const std::string& path, const bool remove_metadentry_only, const ssize_t size,
+                   const StripeLayout& layout) {
 
     // if only the metadentry should be removed, send one rpc to the
     // metadentry's responsible node to remove the metadata
@@ -142,7 +306,7 @@ int forward_remove(const std::string& path, const bool remove_metadentry_only, c
             uint64_t chnk_end = size / gkfs::config::rpc::chunksize;
 
             for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-                const auto chnk_host_id = CTX->distributor()->locate_data(path, chnk_id);
+                const auto chnk_host_id = CTX->distributor()->locate_data(path, chnk_id, layout);
                 /*
                  * If the chnk host matches the metadata host the remove request as already been sent
                  * as part of the metadata remove request.
@@ -477,6 +641,128 @@ pair<int, shared_ptr<gkfs::filemap::OpenDir>> forward_get_dirents(const string&
     return make_pair(err, open_dir);
 }
 
+/**
+ * Send batched RPCs to create many files at once. One RPC is sent to each responsible metadata host,
+ * transferring all paths of that host in a single bulk transfer.
+ * The default stripe layout of the client is used and the first path of a host determines the start host.
+ * @param paths
+ * @param mode
+ * @return error code
+ */
+int forward_create_batch(const std::vector<std::string>& paths, const mode_t mode) {
+    if (paths.empty())
+        return 0;
+    auto targets = make_batch_targets(paths, 0);
+    std::vector<hermes::exposed_memory> exposed_buffers{};
+    auto err = expose_batch_targets(targets, hermes::access_mode::read_only, exposed_buffers);
+    if (err != 0)
+        return err;
+
+    auto stripe_count = CTX->stripe_count();
+    auto stripe_size = CTX->stripe_size();
+    std::vector<gkfs::rpc::create_batch::output> outputs{};
+    std::vector<int> errs{};
+    err = post_batch<gkfs::rpc::create_batch>(targets, exposed_buffers,
+                                              [&](const BatchTarget& target, const hermes::exposed_memory& buf) {
+                                                  return gkfs::rpc::create_batch::input(
+                                                          target.indices.size(), target.paths_size, mode,
+                                                          stripe_count, stripe_size,
+                                                          stripe_count == 0 ? 0 : target.host, buf);
+                                              }, outputs, errs);
+    LOG(DEBUG, "{}() Created '{}' files on '{}' hosts. err '{}'", __func__, paths.size(), targets.size(), err);
+    return err;
+}
+
+/**
+ * Send batched RPCs to stat many files at once. The daemons push the metadentries into the same buffer the
+ * paths were transferred with. If a daemon's results do not fit the buffer, the paths of this daemon are
+ * stat'ed individually instead. A failing daemon only fails the paths it is responsible for.
+ * @param paths
+ * @param attrs (return val) one metadentry string per path, empty if the path failed
+ * @param errs (return val) one error code per path, e.g., ENOENT if the entry does not exist
+ * @return error code if no RPC could be sent, otherwise 0
+ */
+int forward_stat_batch(const std::vector<std::string>& paths, std::vector<std::string>& attrs,
+                       std::vector<int>& errs) {
+    attrs.assign(paths.size(), {});
+    errs.assign(paths.size(), 0);
+    if (paths.empty())
+        return 0;
+    auto targets = make_batch_targets(paths, gkfs::config::rpc::stat_batch_entry_size);
+    std::vector<hermes::exposed_memory> exposed_buffers{};
+    auto err = expose_batch_targets(targets, hermes::access_mode::read_write, exposed_buffers);
+    if (err != 0)
+        return err;
+
+    std::vector<gkfs::rpc::stat_batch::output> outputs{};
+    std::vector<int> target_errs{};
+    post_batch<gkfs::rpc::stat_batch>(targets, exposed_buffers,
+                                      [](const BatchTarget& target, const hermes::exposed_memory& buf) {
+                                          return gkfs::rpc::stat_batch::input(
+                                                  target.indices.size(), target.paths_size, buf);
+                                      }, outputs, target_errs);
+
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        const auto& target = targets[i];
+        if (target_errs[i] == ENOBUFS) {
+            LOG(DEBUG, "{}() Results of host '{}' exceed buffer. Falling back to single stats", __func__,
+                target.host);
+            for (auto idx : target.indices)
+                errs[idx] = forward_stat(paths[idx], attrs[idx]);
+            continue;
+        }
+        if (target_errs[i] != 0) {
+            for (auto idx : target.indices)
+                errs[idx] = target_errs[i];
+            continue;
+        }
+        // the daemon may not have pushed more than the buffer holds
+        auto end = target.buf.get() + std::min(static_cast<std::size_t>(outputs[i].out_size()), target.buf_size);
+        auto ptr = target.buf.get();
+        for (auto idx : target.indices) {
+            auto terminator = ptr < end ? static_cast<const char*>(::memchr(ptr, '\0', end - ptr)) : nullptr;
+            if (terminator == nullptr) {
+                LOG(ERROR, "{}() Truncated results from host '{}' at path '{}'", __func__, target.host, paths[idx]);
+                errs[idx] = EIO;
+                continue;
+            }
+            attrs[idx] = std::string(ptr, terminator);
+            if (attrs[idx].empty())
+                errs[idx] = ENOENT;
+            // number of characters + \0 terminator
+            ptr = terminator + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Send batched RPCs to remove many metadentries at once. Chunks are only removed on the metadata hosts.
+ * Therefore, this function should only be used for files with no data on other daemons.
+ * @param paths
+ * @return error code
+ */
+int forward_remove_batch(const std::vector<std::string>& paths) {
+    if (paths.empty())
+        return 0;
+    auto targets = make_batch_targets(paths, 0);
+    std::vector<hermes::exposed_memory> exposed_buffers{};
+    auto err = expose_batch_targets(targets, hermes::access_mode::read_only, exposed_buffers);
+    if (err != 0)
+        return err;
+
+    std::vector<gkfs::rpc::remove_batch::output> outputs{};
+    std::vector<int> errs{};
+    err = post_batch<gkfs::rpc::remove_batch>(targets, exposed_buffers,
+                                              [](const BatchTarget& target, const hermes::exposed_memory& buf) {
+                                                  return gkfs::rpc::remove_batch::input(
+                                                          target.indices.size(), target.paths_size, buf);
+                                              }, outputs, errs);
+    LOG(DEBUG, "{}() Removed '{}' metadentries on '{}' hosts. err '{}'", __func__, paths.size(), targets.size(),
+        err);
+    return err;
+}
+
 #ifdef HAS_SYMLINKS
 
 /**
@@ -19,6 +19,9 @@
 //
 void hermes::detail::register_user_request_types() {
     (void) registered_requests().add<gkfs::rpc::fs_config>();
+    (void) registered_requests().add<gkfs::rpc::get_load>();
+    (void) registered_requests().add<gkfs::rpc::flush_data>();
+    (void) registered_requests().add<gkfs::rpc::get_qos_stats>();
     (void) registered_requests().add<gkfs::rpc::create>();
     (void) registered_requests().add<gkfs::rpc::stat>();
     (void) registered_requests().add<gkfs::rpc::remove>();
@@ -26,6 +29,10 @@ void hermes::detail::register_user_request_types() {
     (void) registered_requests().add<gkfs::rpc::update_metadentry>();
     (void) registered_requests().add<gkfs::rpc::get_metadentry_size>();
     (void) registered_requests().add<gkfs::rpc::update_metadentry_size>();
+    (void) registered_requests().add<gkfs::rpc::create_batch>();
+    (void) registered_requests().add<gkfs::rpc::stat_batch>();
+    (void) registered_requests().add<gkfs::rpc::remove_batch>();
+    (void) registered_requests().add<gkfs::rpc::chunk_stat_tree>();
 
 #ifdef HAS_SYMLINKS
     (void) registered_requests().add<gkfs::rpc::mk_symlink>();
@@ -34,6 +41,7 @@ void hermes::detail::register_user_request_types() {
     (void) registered_requests().add<gkfs::rpc::write_data>();
     (void) registered_requests().add<gkfs::rpc::read_data>();
     (void) registered_requests().add<gkfs::rpc::trunc_data>();
+    (void) registered_requests().add<gkfs::rpc::copy_chunks>();
     (void) registered_requests().add<gkfs::rpc::get_dirents>();
     (void) registered_requests().add<gkfs::rpc::chunk_stat>();
 
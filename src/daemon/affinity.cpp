@@ -0,0 +1,208 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/affinity.hpp>
+#include <daemon/daemon.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <system_error>
+
+extern "C" {
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+}
+
+using namespace std;
+
+namespace gkfs {
+namespace affinity {
+
+namespace {
+
+struct PinArgs {
+    CpuSet cpus;
+    int numa_node;
+    unsigned int xstreams;
+
+    mutex mtx;
+    condition_variable cv;
+    unsigned int arrived{0};
+    bool timed_out{false};
+    string error;
+};
+
+/**
+ * Pins the execution stream running it. Blocks the stream until a ULT runs on each stream of the pool, so that no
+ * stream runs two of them
+ */
+void pin_ult(void* _arg) {
+    auto args = static_cast<PinArgs*>(_arg);
+    {
+        unique_lock<mutex> lock(args->mtx);
+        ++args->arrived;
+        args->cv.notify_all();
+        if (!args->cv.wait_for(lock, chrono::seconds(1), [&]() { return args->arrived >= args->xstreams; }))
+            args->timed_out = true;
+    }
+    try {
+        if (!args->cpus.empty())
+            pin_thread(args->cpus);
+        if (args->numa_node >= 0)
+            prefer_numa_node(args->numa_node);
+    } catch (const std::exception& e) {
+        lock_guard<mutex> lock(args->mtx);
+        args->error = e.what();
+    }
+}
+
+} // namespace
+
+/**
+ * @param iface network interface, e.g., ib0
+ * @return NUMA node the interface's device is attached to or -1 if unknown
+ */
+int interface_numa_node(const string& iface) {
+    ifstream file(fmt::format("/sys/class/net/{}/device/numa_node", iface));
+    int node = -1;
+    if (!(file >> node))
+        return -1;
+    return node;
+}
+
+/**
+ * @return CPUs the calling thread may run on
+ * @throws system_error
+ */
+CpuSet thread_cpus() {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    auto err = pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (err != 0)
+        throw system_error(err, system_category(), "Failed to get thread affinity");
+    CpuSet cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &mask))
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/**
+ * Restricts the calling thread to a CPU set
+ * @param cpus
+ * @throws system_error, e.g., if none of the CPUs is available to the process
+ */
+void pin_thread(const CpuSet& cpus) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto cpu : cpus)
+        CPU_SET(cpu, &mask);
+    auto err = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (err != 0)
+        throw system_error(err, system_category(), fmt::format("Failed to pin thread to CPUs '{}'", to_string(cpus)));
+}
+
+/**
+ * Lets the calling thread allocate memory on a NUMA node while the node has free memory. Pages are placed when they
+ * are first touched, i.e., memory allocated by the thread but touched by others may still end up elsewhere
+ * @param node
+ * @throws system_error
+ */
+void prefer_numa_node(int node) {
+    unsigned long nodemask = 0;
+    if (node < 0 || node >= static_cast<int>(sizeof(nodemask) * 8))
+        throw system_error(EINVAL, system_category(), fmt::format("Unsupported NUMA node '{}'", node));
+    nodemask = 1UL << node;
+    // the kernel considers maxnode - 1 bits of the mask
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8 + 1) != 0)
+        throw system_error(errno, system_category(), fmt::format("Failed to prefer NUMA node '{}'", node));
+}
+
+/**
+ * Pins all execution streams of a set of pools to a CPU set and lets them prefer memory of a NUMA node. Runs a ULT on
+ * each stream, the streams must be idle
+ * @param pools ULTs are distributed round-robin over the pools
+ * @param xstreams number of execution streams running the pools
+ * @param cpus CPU set, not pinned if empty
+ * @param numa_node preferred NUMA node, memory policy is not changed if negative
+ * @throws runtime_error
+ */
+void pin_pools(const vector<ABT_pool>& pools, unsigned int xstreams, const CpuSet& cpus, int numa_node) {
+    if (pools.empty() || xstreams == 0 || (cpus.empty() && numa_node < 0))
+        return;
+    PinArgs args{};
+    args.cpus = cpus;
+    args.numa_node = numa_node;
+    args.xstreams = xstreams;
+    vector<ABT_thread> threads(xstreams, ABT_THREAD_NULL);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        auto& thread = threads[i];
+        if (ABT_thread_create(pools[i % pools.size()], pin_ult, &args, ABT_THREAD_ATTR_NULL, &thread) !=
+            ABT_SUCCESS) {
+            // the ULTs created so far are released by the timeout
+            lock_guard<mutex> lock(args.mtx);
+            args.error = "Failed to create ABT thread";
+            thread = ABT_THREAD_NULL;
+            break;
+        }
+    }
+    for (auto& thread : threads) {
+        if (thread == ABT_THREAD_NULL)
+            continue;
+        ABT_thread_join(thread);
+        ABT_thread_free(&thread);
+    }
+    if (!args.error.empty())
+        throw runtime_error(args.error);
+    if (args.timed_out) {
+        GKFS_DATA->spdlogger()->warn("{}() Not all of the {} execution streams of the pool ran a pinning ULT. Some "
+                                     "streams may not be pinned", __func__, xstreams);
+    }
+}
+
+/**
+ * Pins all execution streams of a pool. See pin_pools()
+ */
+void pin_pool(ABT_pool pool, unsigned int xstreams, const CpuSet& cpus, int numa_node) {
+    pin_pools({pool}, xstreams, cpus, numa_node);
+}
+
+/**
+ * @param cpus not pinned if empty
+ * @throws system_error
+ */
+ScopedPin::ScopedPin(const CpuSet& cpus) {
+    if (cpus.empty())
+        return;
+    previous_ = thread_cpus();
+    pin_thread(cpus);
+}
+
+ScopedPin::~ScopedPin() {
+    if (previous_.empty())
+        return;
+    try {
+        pin_thread(previous_);
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->warn("ScopedPin::{}() {}", __func__, e.what());
+    }
+}
+
+} // namespace affinity
+} // namespace gkfs
@@ -11,6 +11,7 @@
   SPDX-License-Identifier: MIT
 */
 
+#include <config.hpp>
 #include <daemon/backend/data/data_module.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/backend/data/file_handle.hpp>
@@ -283,12 +284,27 @@ void ChunkStorage::truncate_chunk_file(const string& file_path, gkfs::rpc::chnk_
     }
 }
 
+/**
+ * Removes a single chunk file. A missing chunk file is not an error
+ * @param file_path
+ * @param chunk_id
+ * @throws ChunkStorageException
+ */
+void ChunkStorage::remove_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id) const {
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    if (unlink(chunk_path.c_str()) == -1 && errno != ENOENT) {
+        auto err_str = fmt::format("Failed to remove chunk file. File: '{}', Error: '{}'", chunk_path,
+                                   ::strerror(errno));
+        throw ChunkStorageException(errno, err_str);
+    }
+}
+
 /**
  * Calls statfs on the chunk directory to get statistic on its used and free size left
  * @return ChunkStat
  * @throws ChunkStorageException
  */
-ChunkStat ChunkStorage::chunk_stat() const {
+ChunkStat ChunkStorage::stat_chunk_dir() const {
     struct statfs sfs{};
 
     if (statfs(root_path_.c_str(), &sfs) != 0) {
@@ -309,5 +325,28 @@ ChunkStat ChunkStorage::chunk_stat() const {
             bytes_free / chunksize_};
 }
 
+/**
+ * Returns the statistic of the chunk directory. The result of statfs is reused for
+ * gkfs::config::io::statfs_cache_ttl milliseconds, so that repeated statfs calls of clients do not reach the
+ * local file system.
+ * @return ChunkStat
+ * @throws ChunkStorageException
+ */
+ChunkStat ChunkStorage::chunk_stat() const {
+    using namespace std::chrono;
+    {
+        lock_guard<mutex> lock(chunk_stat_mutex_);
+        if (chunk_stat_valid_ &&
+            steady_clock::now() - chunk_stat_time_ < milliseconds(gkfs::config::io::statfs_cache_ttl))
+            return chunk_stat_cache_;
+    }
+    auto chk_stat = stat_chunk_dir();
+    lock_guard<mutex> lock(chunk_stat_mutex_);
+    chunk_stat_cache_ = chk_stat;
+    chunk_stat_time_ = steady_clock::now();
+    chunk_stat_valid_ = true;
+    return chk_stat;
+}
+
 } // namespace data
 } // namespace gkfs
\ No newline at end of file
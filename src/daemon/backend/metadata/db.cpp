@@ -73,6 +73,43 @@ void MetadataDB::put(const std::string& key, const std::string& val) {
     }
 }
 
+/**
+ * Creates multiple metadentries with a single write batch
+ * @param entries vector of pair <key, value>
+ */
+void MetadataDB::put_batch(const std::vector<std::pair<std::string, std::string>>& entries) {
+    rdb::WriteBatch batch;
+    for (const auto& e : entries) {
+        assert(gkfs::path::is_absolute(e.first));
+        assert(e.first == "/" || !gkfs::path::has_trailing_slash(e.first));
+        auto cop = CreateOperand(e.second);
+        batch.Merge(e.first, cop.serialize());
+    }
+    auto s = db->Write(write_opts, &batch);
+    if (!s.ok()) {
+        MetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+/**
+ * Gets multiple metadentries at once
+ * @param keys
+ * @return values in the order of keys. The value of a non-existing key is empty.
+ */
+std::vector<std::string> MetadataDB::get_batch(const std::vector<std::string>& keys) const {
+    std::vector<rdb::Slice> key_slices(keys.begin(), keys.end());
+    std::vector<std::string> vals;
+    auto statuses = db->MultiGet(rdb::ReadOptions(), key_slices, &vals);
+    for (std::size_t i = 0; i < statuses.size(); ++i) {
+        if (statuses[i].IsNotFound()) {
+            vals[i].clear();
+        } else if (!statuses[i].ok()) {
+            MetadataDB::throw_rdb_status_excpt(statuses[i]);
+        }
+    }
+    return vals;
+}
+
 void MetadataDB::remove(const std::string& key) {
     auto s = db->Delete(write_opts, key);
     if (!s.ok()) {
@@ -80,6 +117,21 @@ void MetadataDB::remove(const std::string& key) {
     }
 }
 
+/**
+ * Removes multiple metadentries with a single write batch. Non-existing keys are ignored.
+ * @param keys
+ */
+void MetadataDB::remove_batch(const std::vector<std::string>& keys) {
+    rdb::WriteBatch batch;
+    for (const auto& key : keys) {
+        batch.Delete(key);
+    }
+    auto s = db->Write(write_opts, &batch);
+    if (!s.ok()) {
+        MetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
 bool MetadataDB::exists(const std::string& key) {
     std::string val;
     auto s = db->Get(rdb::ReadOptions(), key, &val);
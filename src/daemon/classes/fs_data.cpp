@@ -48,6 +48,22 @@ void FsData::storage(const std::shared_ptr<gkfs::data::ChunkStorage>& storage) {
     storage_ = storage;
 }
 
+const std::shared_ptr<gkfs::data::StagingCache>& FsData::staging() const {
+    return staging_;
+}
+
+void FsData::staging(const std::shared_ptr<gkfs::data::StagingCache>& staging) {
+    staging_ = staging;
+}
+
+const std::string& FsData::staging_dir() const {
+    return staging_dir_;
+}
+
+void FsData::staging_dir(const std::string& staging_dir) {
+    staging_dir_ = staging_dir;
+}
+
 const std::string& FsData::rootdir() const {
     return rootdir_;
 }
@@ -80,6 +96,102 @@ void FsData::rpc_protocol(const std::string& rpc_protocol) {
     rpc_protocol_ = rpc_protocol;
 }
 
+const std::string& FsData::io_scheduler() const {
+    return io_scheduler_;
+}
+
+void FsData::io_scheduler(const std::string& io_scheduler) {
+    io_scheduler_ = io_scheduler;
+}
+
+const std::string& FsData::qos() const {
+    return qos_;
+}
+
+void FsData::qos(const std::string& qos) {
+    qos_ = qos;
+}
+
+unsigned int FsData::io_xstreams() const {
+    return io_xstreams_;
+}
+
+void FsData::io_xstreams(unsigned int io_xstreams) {
+    io_xstreams_ = io_xstreams;
+}
+
+unsigned int FsData::handler_xstreams() const {
+    return handler_xstreams_;
+}
+
+void FsData::handler_xstreams(unsigned int handler_xstreams) {
+    handler_xstreams_ = handler_xstreams;
+}
+
+unsigned int FsData::metadata_xstreams() const {
+    return metadata_xstreams_;
+}
+
+void FsData::metadata_xstreams(unsigned int metadata_xstreams) {
+    metadata_xstreams_ = metadata_xstreams;
+}
+
+unsigned int FsData::data_xstreams() const {
+    return data_xstreams_;
+}
+
+void FsData::data_xstreams(unsigned int data_xstreams) {
+    data_xstreams_ = data_xstreams;
+}
+
+bool FsData::io_autotune() const {
+    return io_autotune_;
+}
+
+void FsData::io_autotune(bool io_autotune) {
+    io_autotune_ = io_autotune;
+}
+
+const gkfs::affinity::CpuSet& FsData::io_cpus() const {
+    return io_cpus_;
+}
+
+void FsData::io_cpus(const gkfs::affinity::CpuSet& io_cpus) {
+    io_cpus_ = io_cpus;
+}
+
+const gkfs::affinity::CpuSet& FsData::handler_cpus() const {
+    return handler_cpus_;
+}
+
+void FsData::handler_cpus(const gkfs::affinity::CpuSet& handler_cpus) {
+    handler_cpus_ = handler_cpus;
+}
+
+const gkfs::affinity::CpuSet& FsData::progress_cpus() const {
+    return progress_cpus_;
+}
+
+void FsData::progress_cpus(const gkfs::affinity::CpuSet& progress_cpus) {
+    progress_cpus_ = progress_cpus;
+}
+
+const gkfs::affinity::CpuSet& FsData::rocksdb_cpus() const {
+    return rocksdb_cpus_;
+}
+
+void FsData::rocksdb_cpus(const gkfs::affinity::CpuSet& rocksdb_cpus) {
+    rocksdb_cpus_ = rocksdb_cpus;
+}
+
+int FsData::buffer_numa_node() const {
+    return buffer_numa_node_;
+}
+
+void FsData::buffer_numa_node(int buffer_numa_node) {
+    buffer_numa_node_ = buffer_numa_node;
+}
+
 const std::string& FsData::bind_addr() const {
     return bind_addr_;
 }
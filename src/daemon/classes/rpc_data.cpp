@@ -13,6 +13,13 @@
 
 
 #include <daemon/classes/rpc_data.hpp>
+#include <daemon/scheduler/scheduler.hpp>
+#include <daemon/scheduler/io_tuner.hpp>
+#include <daemon/scheduler/qos.hpp>
+#include <daemon/ops/write_aggregation.hpp>
+
+#include <functional>
+#include <cassert>
 
 using namespace std;
 
@@ -29,12 +36,32 @@ void RPCData::server_rpc_mid(margo_instance* server_rpc_mid) {
     RPCData::server_rpc_mid_ = server_rpc_mid;
 }
 
-ABT_pool RPCData::io_pool() const {
-    return io_pool_;
+const vector<ABT_pool>& RPCData::io_pools() const {
+    return io_pools_;
+}
+
+void RPCData::io_pools(const vector<ABT_pool>& io_pools) {
+    RPCData::io_pools_ = io_pools;
 }
 
-void RPCData::io_pool(ABT_pool io_pool) {
-    RPCData::io_pool_ = io_pool;
+/**
+ * Selects the I/O pool of a chunk. All operations on a chunk go to the same pool, which starts them in order
+ * @param path
+ * @param chnk_id
+ * @return I/O pool
+ */
+ABT_pool RPCData::io_pool(const string& path, gkfs::rpc::chnk_id_t chnk_id) const {
+    assert(!io_pools_.empty());
+    /*
+     * Clients place chunks on daemons by std::hash of path and chunk id modulo the number of daemons. The hash is
+     * computed differently here, otherwise all chunks of a daemon would end up in the same pool if the numbers of
+     * daemons and pools share a factor
+     */
+    uint64_t hash = std::hash<string>()(path) ^ (chnk_id * 0x9e3779b97f4a7c15ULL);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return io_pools_[hash % io_pools_.size()];
 }
 
 vector<ABT_xstream>& RPCData::io_streams() {
@@ -45,6 +72,46 @@ void RPCData::io_streams(const vector<ABT_xstream>& io_streams) {
     RPCData::io_streams_ = io_streams;
 }
 
+const std::shared_ptr<gkfs::scheduler::IoTuner>& RPCData::io_tuner() const {
+    return io_tuner_;
+}
+
+void RPCData::io_tuner(const std::shared_ptr<gkfs::scheduler::IoTuner>& io_tuner) {
+    io_tuner_ = io_tuner;
+}
+
+ABT_pool RPCData::metadata_pool() const {
+    return metadata_pool_;
+}
+
+void RPCData::metadata_pool(ABT_pool metadata_pool) {
+    RPCData::metadata_pool_ = metadata_pool;
+}
+
+vector<ABT_xstream>& RPCData::metadata_streams() {
+    return metadata_streams_;
+}
+
+void RPCData::metadata_streams(const vector<ABT_xstream>& metadata_streams) {
+    RPCData::metadata_streams_ = metadata_streams;
+}
+
+ABT_pool RPCData::data_pool() const {
+    return data_pool_;
+}
+
+void RPCData::data_pool(ABT_pool data_pool) {
+    RPCData::data_pool_ = data_pool;
+}
+
+vector<ABT_xstream>& RPCData::data_streams() {
+    return data_streams_;
+}
+
+void RPCData::data_streams(const vector<ABT_xstream>& data_streams) {
+    RPCData::data_streams_ = data_streams;
+}
+
 const std::string& RPCData::self_addr_str() const {
     return self_addr_str_;
 }
@@ -53,5 +120,65 @@ void RPCData::self_addr_str(const std::string& addr_str) {
     self_addr_str_ = addr_str;
 }
 
+/**
+ * @param host_id
+ * @return cached address of the daemon or HG_ADDR_NULL if it was not looked up yet
+ */
+hg_addr_t RPCData::peer_addr(uint64_t host_id) {
+    lock_guard<mutex> lock(peer_addrs_mutex_);
+    auto it = peer_addrs_.find(host_id);
+    return it == peer_addrs_.end() ? HG_ADDR_NULL : it->second;
+}
+
+/**
+ * Caches the address of a daemon. If another address was cached concurrently, the given one is freed.
+ * @param host_id
+ * @param addr
+ */
+void RPCData::peer_addr(uint64_t host_id, hg_addr_t addr) {
+    lock_guard<mutex> lock(peer_addrs_mutex_);
+    if (!peer_addrs_.emplace(host_id, addr).second)
+        margo_addr_free(server_rpc_mid_, addr);
+}
+
+void RPCData::free_peer_addrs() {
+    lock_guard<mutex> lock(peer_addrs_mutex_);
+    for (auto& peer : peer_addrs_)
+        margo_addr_free(server_rpc_mid_, peer.second);
+    peer_addrs_.clear();
+}
+
+const std::shared_ptr<gkfs::scheduler::RequestScheduler>& RPCData::scheduler() const {
+    return scheduler_;
+}
+
+void RPCData::scheduler(const std::shared_ptr<gkfs::scheduler::RequestScheduler>& scheduler) {
+    scheduler_ = scheduler;
+}
+
+const std::shared_ptr<gkfs::scheduler::LoadStats>& RPCData::load_stats() const {
+    return load_stats_;
+}
+
+void RPCData::load_stats(const std::shared_ptr<gkfs::scheduler::LoadStats>& load_stats) {
+    load_stats_ = load_stats;
+}
+
+const std::shared_ptr<gkfs::scheduler::QosScheduler>& RPCData::qos() const {
+    return qos_;
+}
+
+void RPCData::qos(const std::shared_ptr<gkfs::scheduler::QosScheduler>& qos) {
+    qos_ = qos;
+}
+
+const std::shared_ptr<gkfs::data::WriteAggregator>& RPCData::write_aggregator() const {
+    return write_aggregator_;
+}
+
+void RPCData::write_aggregator(const std::shared_ptr<gkfs::data::WriteAggregator>& write_aggregator) {
+    write_aggregator_ = write_aggregator;
+}
+
 } // namespace daemon
 } // namespace gkfs
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/cpu_set.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+extern "C" {
+#include <sched.h>
+}
+
+using namespace std;
+
+namespace gkfs {
+namespace affinity {
+
+namespace {
+
+/**
+ * @param value
+ * @return non-negative integer
+ * @throws runtime_error
+ */
+int parse_id(const string& value) {
+    size_t pos = 0;
+    int id = -1;
+    try {
+        id = stoi(value, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size() || id < 0)
+        throw runtime_error(fmt::format("Invalid CPU or NUMA node id '{}'", value));
+    return id;
+}
+
+/**
+ * Adds the CPUs of a list in the kernel's format, e.g., "0-3,8", to a set
+ * @throws runtime_error
+ */
+void add_cpu_list(const string& list, CpuSet& cpus) {
+    size_t begin = 0;
+    while (begin < list.size()) {
+        auto end = list.find(',', begin);
+        if (end == string::npos)
+            end = list.size();
+        auto range = list.substr(begin, end - begin);
+        begin = end + 1;
+        if (range.compare(0, 5, "node:") == 0) {
+            auto node = parse_id(range.substr(5));
+            auto path = fmt::format("/sys/devices/system/node/node{}/cpulist", node);
+            ifstream file(path);
+            string node_list;
+            if (!file || !getline(file, node_list))
+                throw runtime_error(fmt::format("Unknown NUMA node '{}'", node));
+            auto size = cpus.size();
+            add_cpu_list(node_list, cpus);
+            if (cpus.size() == size)
+                throw runtime_error(fmt::format("NUMA node '{}' has no CPUs", node));
+            continue;
+        }
+        auto dash = range.find('-');
+        auto first = parse_id(range.substr(0, dash));
+        auto last = dash == string::npos ? first : parse_id(range.substr(dash + 1));
+        if (first > last || last >= CPU_SETSIZE)
+            throw runtime_error(fmt::format("Invalid CPU range '{}'", range));
+        for (auto cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+}
+
+} // namespace
+
+/**
+ * Parses a CPU set given as comma-separated list of CPU ids, CPU ranges, and NUMA nodes, e.g., "0-3,8" or "node:1"
+ * @param spec
+ * @return CPU set, empty if spec is empty
+ * @throws runtime_error
+ */
+CpuSet parse_cpu_set(const string& spec) {
+    CpuSet cpus;
+    add_cpu_list(spec, cpus);
+    sort(cpus.begin(), cpus.end());
+    cpus.erase(unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+/**
+ * @param cpus
+ * @return CPU set in the kernel's list format
+ */
+string to_string(const CpuSet& cpus) {
+    string list;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        auto last = i;
+        while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1)
+            ++last;
+        if (!list.empty())
+            list += ',';
+        list += last == i ? fmt::format("{}", cpus[i]) : fmt::format("{}-{}", cpus[i], cpus[last]);
+        i = last;
+    }
+    return list;
+}
+
+} // namespace affinity
+} // namespace gkfs
@@ -24,6 +24,13 @@
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/util.hpp>
+#include <daemon/affinity.hpp>
+#include <daemon/scheduler/scheduler.hpp>
+#include <daemon/scheduler/io_tuner.hpp>
+#include <daemon/scheduler/io_pools.hpp>
+#include <daemon/scheduler/qos.hpp>
+#include <daemon/ops/write_aggregation.hpp>
+#include <daemon/ops/staging_cache.hpp>
 
 #ifdef GKFS_ENABLE_AGIOS
 #include <daemon/scheduler/agios.hpp>
@@ -37,6 +44,7 @@
 #include <fstream>
 #include <csignal>
 #include <condition_variable>
+#include <limits>
 
 extern "C" {
 #include <unistd.h>
@@ -50,29 +58,80 @@ namespace bfs = boost::filesystem;
 static condition_variable shutdown_please;
 static mutex mtx;
 
-void init_io_tasklet_pool() {
-    static_assert(gkfs::config::rpc::daemon_io_xstreams >= 0, "Daemon IO Execution streams must be higher than 0!");
-    unsigned int xstreams_num = gkfs::config::rpc::daemon_io_xstreams;
-
-    //retrieve the pool of the just created scheduler
+/**
+ * Creates a pool and execution streams that all tap into it
+ * @param xstreams_num
+ * @param xstreams filled with the created execution streams
+ * @return pool
+ * @throws runtime_error
+ */
+ABT_pool create_pool(unsigned int xstreams_num, vector<ABT_xstream>& xstreams) {
     ABT_pool pool;
     auto ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &pool);
     if (ret != ABT_SUCCESS) {
-        throw runtime_error("Failed to create I/O tasks pool");
+        throw runtime_error("Failed to create pool");
     }
 
     //create all subsequent xstream and the associated scheduler, all tapping into the same pool
-    vector<ABT_xstream> xstreams(xstreams_num);
+    xstreams.resize(xstreams_num);
     for (unsigned int i = 0; i < xstreams_num; ++i) {
         ret = ABT_xstream_create_basic(ABT_SCHED_BASIC_WAIT, 1, &pool,
                                        ABT_SCHED_CONFIG_NULL, &xstreams[i]);
         if (ret != ABT_SUCCESS) {
-            throw runtime_error("Failed to create task execution streams for I/O operations");
+            throw runtime_error("Failed to create execution streams");
         }
     }
+    return pool;
+}
+
+void init_io_tasklet_pool() {
+    unsigned int xstreams_num = GKFS_DATA->io_xstreams();
+
+    vector<ABT_xstream> xstreams;
+    vector<ABT_pool> pools;
+    try {
+        gkfs::scheduler::create_stealing_pools(xstreams_num, pools, xstreams);
+    } catch (const std::exception& e) {
+        throw runtime_error("Failed to create task execution streams for I/O operations: "s + e.what());
+    }
 
     RPC_DATA->io_streams(xstreams);
-    RPC_DATA->io_pool(pool);
+    RPC_DATA->io_pools(pools);
+    // before the tuner may block streams
+    gkfs::affinity::pin_pools(pools, xstreams_num, GKFS_DATA->io_cpus());
+
+    if (GKFS_DATA->io_autotune()) {
+        RPC_DATA->io_tuner(std::make_shared<gkfs::scheduler::IoTuner>(
+                pools, gkfs::config::io::autotune_min_xstreams, gkfs::config::io::autotune_interval));
+    }
+}
+
+/**
+ * Creates the pools of metadata and data RPC handlers. A pool without execution streams is not created, its RPCs
+ * are handled by Margo's handler pool. Data handlers allocate the RPC buffers and prefer the buffer NUMA node
+ */
+void init_handler_pools() {
+    vector<ABT_xstream> xstreams;
+    if (GKFS_DATA->metadata_xstreams() > 0) {
+        try {
+            RPC_DATA->metadata_pool(create_pool(GKFS_DATA->metadata_xstreams(), xstreams));
+        } catch (const std::exception& e) {
+            throw runtime_error("Failed to create metadata handler pool: "s + e.what());
+        }
+        RPC_DATA->metadata_streams(xstreams);
+        gkfs::affinity::pin_pool(RPC_DATA->metadata_pool(), GKFS_DATA->metadata_xstreams(),
+                                 GKFS_DATA->handler_cpus());
+    }
+    if (GKFS_DATA->data_xstreams() > 0) {
+        try {
+            RPC_DATA->data_pool(create_pool(GKFS_DATA->data_xstreams(), xstreams));
+        } catch (const std::exception& e) {
+            throw runtime_error("Failed to create data handler pool: "s + e.what());
+        }
+        RPC_DATA->data_streams(xstreams);
+        gkfs::affinity::pin_pool(RPC_DATA->data_pool(), GKFS_DATA->data_xstreams(), GKFS_DATA->handler_cpus(),
+                                 GKFS_DATA->buffer_numa_node());
+    }
 }
 
 /**
@@ -80,27 +139,53 @@ void init_io_tasklet_pool() {
  * @param hg_class
  */
 void register_server_rpcs(margo_instance_id mid) {
+    // metadata and data RPCs run in their own pools. The IDs equal those of MARGO_REGISTER with the default provider
+    auto md_pool = RPC_DATA->metadata_pool();
+    auto data_pool = RPC_DATA->data_pool();
     MARGO_REGISTER(mid, gkfs::rpc::tag::fs_config, void, rpc_config_out_t, rpc_srv_get_fs_config);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::create, rpc_mk_node_in_t, rpc_err_out_t, rpc_srv_create);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::stat, rpc_path_only_in_t, rpc_stat_out_t, rpc_srv_stat);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::decr_size, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_decr_size);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::remove, rpc_rm_node_in_t, rpc_err_out_t, rpc_srv_remove);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry, rpc_update_metadentry_in_t, rpc_err_out_t,
-                   rpc_srv_update_metadentry);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::get_metadentry_size, rpc_path_only_in_t, rpc_get_metadentry_size_out_t,
-                   rpc_srv_get_metadentry_size);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry_size, rpc_update_metadentry_size_in_t,
-                   rpc_update_metadentry_size_out_t, rpc_srv_update_metadentry_size);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::get_dirents, rpc_get_dirents_in_t, rpc_get_dirents_out_t,
-                   rpc_srv_get_dirents);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::get_load, void, rpc_load_out_t, rpc_srv_get_load);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::get_qos_stats, void, rpc_qos_stats_out_t, rpc_srv_get_qos_stats);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::flush_data, void, rpc_err_out_t, rpc_srv_flush_data);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::create, rpc_mk_node_in_t, rpc_err_out_t, rpc_srv_create,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::stat, rpc_path_only_in_t, rpc_stat_out_t, rpc_srv_stat,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::decr_size, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_decr_size,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::remove, rpc_rm_node_in_t, rpc_err_out_t, rpc_srv_remove,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::update_metadentry, rpc_update_metadentry_in_t, rpc_err_out_t,
+                            rpc_srv_update_metadentry, MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::get_metadentry_size, rpc_path_only_in_t,
+                            rpc_get_metadentry_size_out_t, rpc_srv_get_metadentry_size, MARGO_DEFAULT_PROVIDER_ID,
+                            md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::update_metadentry_size, rpc_update_metadentry_size_in_t,
+                            rpc_update_metadentry_size_out_t, rpc_srv_update_metadentry_size,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::get_dirents, rpc_get_dirents_in_t, rpc_get_dirents_out_t,
+                            rpc_srv_get_dirents, MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::create_batch, rpc_mk_node_batch_in_t, rpc_err_out_t,
+                            rpc_srv_create_batch, MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::stat_batch, rpc_batch_in_t, rpc_batch_out_t, rpc_srv_stat_batch,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::remove_batch, rpc_batch_in_t, rpc_err_out_t, rpc_srv_remove_batch,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
 #ifdef HAS_SYMLINKS
-    MARGO_REGISTER(mid, gkfs::rpc::tag::mk_symlink, rpc_mk_symlink_in_t, rpc_err_out_t, rpc_srv_mk_symlink);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::mk_symlink, rpc_mk_symlink_in_t, rpc_err_out_t, rpc_srv_mk_symlink,
+                            MARGO_DEFAULT_PROVIDER_ID, md_pool);
 #endif
-    MARGO_REGISTER(mid, gkfs::rpc::tag::write, rpc_write_data_in_t, rpc_data_out_t, rpc_srv_write);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::read, rpc_read_data_in_t, rpc_data_out_t, rpc_srv_read);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::truncate, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_truncate);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::write, rpc_write_data_in_t, rpc_data_out_t, rpc_srv_write,
+                            MARGO_DEFAULT_PROVIDER_ID, data_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::read, rpc_read_data_in_t, rpc_data_out_t, rpc_srv_read,
+                            MARGO_DEFAULT_PROVIDER_ID, data_pool);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::truncate, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_truncate,
+                            MARGO_DEFAULT_PROVIDER_ID, data_pool);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_chunk_stat, rpc_chunk_stat_in_t, rpc_chunk_stat_out_t,
                    rpc_srv_get_chunk_stat);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::get_chunk_stat_tree, rpc_chunk_stat_tree_in_t, rpc_chunk_stat_out_t,
+                   rpc_srv_get_chunk_stat_tree);
+    MARGO_REGISTER_PROVIDER(mid, gkfs::rpc::tag::copy_chunks, rpc_copy_chunks_in_t, rpc_data_out_t,
+                            rpc_srv_copy_chunks, MARGO_DEFAULT_PROVIDER_ID, data_pool);
 }
 
 void init_rpc_server() {
@@ -113,12 +198,17 @@ void init_rpc_server() {
     hg_options.na_class = nullptr;
     if (gkfs::rpc::protocol::ofi_psm2 == GKFS_DATA->rpc_protocol())
         hg_options.na_init_info.progress_mode = NA_NO_BLOCK;
-    // Start Margo (this will also initialize Argobots and Mercury internally)
+    // Argobots is initialized before Margo so that it outlives Margo. The daemon's streams are joined after Margo
+    // stopped accepting RPCs
+    if (ABT_init(0, nullptr) != ABT_SUCCESS) {
+        throw runtime_error("Failed to initialize Argobots");
+    }
+    // Start Margo (this will also initialize Mercury internally)
     auto mid = margo_init_opt(GKFS_DATA->bind_addr().c_str(),
                               MARGO_SERVER_MODE,
                               &hg_options,
                               HG_TRUE,
-                              gkfs::config::rpc::daemon_handler_xstreams);
+                              GKFS_DATA->handler_xstreams());
     if (mid == MARGO_INSTANCE_NULL) {
         throw runtime_error("Failed to initialize the Margo RPC server");
     }
@@ -145,6 +235,17 @@ void init_rpc_server() {
     // Put context and class into RPC_data object
     RPC_DATA->server_rpc_mid(mid);
 
+    // pin Margo's streams. Its handler pool handles data RPCs if they have no pool of their own
+    ABT_pool handler_pool, progress_pool;
+    margo_get_handler_pool(mid, &handler_pool);
+    margo_get_progress_pool(mid, &progress_pool);
+    gkfs::affinity::pin_pool(handler_pool, GKFS_DATA->handler_xstreams(), GKFS_DATA->handler_cpus(),
+                             GKFS_DATA->data_xstreams() == 0 ? GKFS_DATA->buffer_numa_node() : -1);
+    gkfs::affinity::pin_pool(progress_pool, 1, GKFS_DATA->progress_cpus(), GKFS_DATA->buffer_numa_node());
+
+    // handler pools must exist before the RPCs are assigned to them
+    init_handler_pools();
+
     // register RPCs
     register_server_rpcs(mid);
 }
@@ -154,6 +255,8 @@ void init_environment() {
     std::string metadata_path = GKFS_DATA->metadir() + "/rocksdb"s;
     GKFS_DATA->spdlogger()->debug("{}() Initializing metadata DB: '{}'", __func__, metadata_path);
     try {
+        // RocksDB starts its background threads when the DB is opened, they inherit the CPU set
+        gkfs::affinity::ScopedPin pin(GKFS_DATA->rocksdb_cpus());
         GKFS_DATA->mdb(std::make_shared<gkfs::metadata::MetadataDB>(metadata_path));
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to initialize metadata DB: {}", __func__, e.what());
@@ -195,6 +298,36 @@ void init_environment() {
         throw;
     }
 
+    RPC_DATA->load_stats(std::make_shared<gkfs::scheduler::LoadStats>());
+
+    // Init I/O request scheduler. Its waiting requests block on Argobots primitives, initialized with Margo
+    try {
+        auto policy = gkfs::scheduler::RequestScheduler::parse_policy(GKFS_DATA->io_scheduler());
+        if (policy != gkfs::scheduler::Policy::none) {
+            GKFS_DATA->spdlogger()->debug("{}() Initializing I/O request scheduler: '{}'", __func__,
+                                          GKFS_DATA->io_scheduler());
+            RPC_DATA->scheduler(std::make_shared<gkfs::scheduler::RequestScheduler>(
+                    policy, GKFS_DATA->io_xstreams(), gkfs::config::scheduler::deadline));
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to initialize I/O request scheduler: {}", __func__, e.what());
+        throw;
+    }
+
+    // Init per-job QoS in front of the I/O request scheduler
+    if (!GKFS_DATA->qos().empty()) {
+        try {
+            GKFS_DATA->spdlogger()->debug("{}() Initializing QoS: '{}'", __func__, GKFS_DATA->qos());
+            RPC_DATA->qos(std::make_shared<gkfs::scheduler::QosScheduler>(
+                    gkfs::scheduler::QosPolicy::parse_classes(GKFS_DATA->qos()),
+                    GKFS_DATA->io_xstreams() * gkfs::config::scheduler::qos_inflight_per_xstream,
+                    RPC_DATA->server_rpc_mid()));
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to initialize QoS: {}", __func__, e.what());
+            throw;
+        }
+    }
+
     // Init Argobots ESs to drive IO
     try {
         GKFS_DATA->spdlogger()->debug("{}() Initializing I/O pool", __func__);
@@ -204,6 +337,38 @@ void init_environment() {
         throw;
     }
 
+    // Init write-back staging. Its drain threads are Argobots execution streams
+    if (!GKFS_DATA->staging_dir().empty()) {
+        GKFS_DATA->spdlogger()->debug("{}() Initializing staging tier: '{}'", __func__, GKFS_DATA->staging_dir());
+        try {
+            auto staging_path = GKFS_DATA->staging_dir();
+            auto staging_storage = std::make_shared<gkfs::data::ChunkStorage>(staging_path,
+                                                                              gkfs::config::rpc::chunksize);
+            // the drain threads inherit the CPU set
+            gkfs::affinity::ScopedPin pin(GKFS_DATA->io_cpus());
+            GKFS_DATA->staging(std::make_shared<gkfs::data::StagingCache>(
+                    staging_storage, GKFS_DATA->storage(), gkfs::config::rpc::chunksize,
+                    gkfs::config::io::staging_max_size, gkfs::config::io::staging_drain_delay,
+                    gkfs::config::io::staging_drain_xstreams));
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to initialize staging tier: {}", __func__, e.what());
+            throw;
+        }
+    }
+
+    if (gkfs::config::io::write_aggregation_window > 0) {
+        GKFS_DATA->spdlogger()->debug("{}() Aggregating small writes per chunk within {} ms", __func__,
+                                      gkfs::config::io::write_aggregation_window);
+        try {
+            RPC_DATA->write_aggregator(std::make_shared<gkfs::data::WriteAggregator>(
+                    RPC_DATA->server_rpc_mid(), gkfs::config::io::write_aggregation_window,
+                    gkfs::config::rpc::chunksize, gkfs::config::io::write_aggregation_max_size));
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to initialize write aggregation: {}", __func__, e.what());
+            throw;
+        }
+    }
+
     // TODO set metadata configurations. these have to go into a user configurable file that is parsed here
     GKFS_DATA->atime_state(gkfs::config::metadata::use_atime);
     GKFS_DATA->mtime_state(gkfs::config::metadata::use_mtime);
@@ -248,11 +413,45 @@ void destroy_enviroment() {
     GKFS_DATA->spdlogger()->debug("{}() Removing mount directory", __func__);
     boost::system::error_code ecode;
     bfs::remove_all(GKFS_DATA->mountdir(), ecode);
+
+    // stop accepting RPCs before the streams running their handlers and operations are joined. Margo defers
+    // finalizing until the running handlers have returned
+    if (RPC_DATA->server_rpc_mid() != nullptr) {
+        RPC_DATA->free_peer_addrs();
+        GKFS_DATA->spdlogger()->debug("{}() Finalizing margo RPC server", __func__);
+        margo_finalize(RPC_DATA->server_rpc_mid());
+        RPC_DATA->server_rpc_mid(nullptr);
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Freeing handler executions streams", __func__);
+    for (auto streams : {&RPC_DATA->metadata_streams(), &RPC_DATA->data_streams()}) {
+        for (auto& xstream : *streams) {
+            ABT_xstream_join(xstream);
+            ABT_xstream_free(&xstream);
+        }
+        streams->clear();
+    }
+    if (RPC_DATA->io_tuner()) {
+        // reactivates all I/O streams so that they can be joined
+        RPC_DATA->io_tuner()->shutdown();
+    }
     GKFS_DATA->spdlogger()->debug("{}() Freeing I/O executions streams", __func__);
     for (unsigned int i = 0; i < RPC_DATA->io_streams().size(); i++) {
         ABT_xstream_join(RPC_DATA->io_streams().at(i));
         ABT_xstream_free(&RPC_DATA->io_streams().at(i));
     }
+    RPC_DATA->io_streams({});
+    RPC_DATA->io_pools({});
+    RPC_DATA->io_tuner(nullptr);
+
+    // no write can be staged anymore
+    if (GKFS_DATA->staging()) {
+        GKFS_DATA->spdlogger()->info("{}() Draining staging tier", __func__);
+        GKFS_DATA->staging()->shutdown();
+        GKFS_DATA->staging(nullptr);
+    }
+    if (!GKFS_DATA->staging_dir().empty())
+        bfs::remove_all(GKFS_DATA->staging_dir(), ecode);
 
     if (!GKFS_DATA->hosts_file().empty()) {
         GKFS_DATA->spdlogger()->debug("{}() Removing hosts file", __func__);
@@ -263,13 +462,15 @@ void destroy_enviroment() {
         }
     }
 
-    if (RPC_DATA->server_rpc_mid() != nullptr) {
-        GKFS_DATA->spdlogger()->debug("{}() Finalizing margo RPC server", __func__);
-        margo_finalize(RPC_DATA->server_rpc_mid());
-    }
+    RPC_DATA->write_aggregator(nullptr);
+    RPC_DATA->qos(nullptr);
+    RPC_DATA->scheduler(nullptr);
+    RPC_DATA->load_stats(nullptr);
 
     GKFS_DATA->spdlogger()->info("{}() Closing metadata DB", __func__);
     GKFS_DATA->close_mdb();
+
+    ABT_finalize();
 }
 
 void shutdown_handler(int dummy) {
@@ -305,6 +506,50 @@ void initialize_loggers() {
     gkfs::log::setup(logger_names, level, path);
 }
 
+/**
+ * Gets a number of execution streams from the option, the environment variable, or the default, in this order
+ * @throws runtime_error if the number is invalid or below the minimum
+ */
+unsigned int xstreams_option(const po::variables_map& vm, const string& option, const string& env_var,
+                             unsigned int default_value, unsigned int min) {
+    string value;
+    if (vm.count(option))
+        value = vm[option].as<string>();
+    else
+        value = gkfs::env::get_var(env_var, "");
+    if (value.empty())
+        return default_value;
+    unsigned long xstreams = 0;
+    size_t pos = 0;
+    try {
+        xstreams = stoul(value, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size() || xstreams < min || xstreams > numeric_limits<unsigned int>::max()) {
+        throw runtime_error(fmt::format("Invalid number of execution streams for '{}': '{}'", option, value));
+    }
+    return static_cast<unsigned int>(xstreams);
+}
+
+/**
+ * Gets a CPU set from the option or the environment variable, in this order
+ * @return CPU set, empty if neither is set
+ * @throws runtime_error if the CPU set is invalid
+ */
+gkfs::affinity::CpuSet cpu_set_option(const po::variables_map& vm, const string& option, const string& env_var) {
+    string value;
+    if (vm.count(option))
+        value = vm[option].as<string>();
+    else
+        value = gkfs::env::get_var(env_var, "");
+    try {
+        return gkfs::affinity::parse_cpu_set(value);
+    } catch (const std::exception& e) {
+        throw runtime_error(fmt::format("Invalid CPU set for '{}': {}", option, e.what()));
+    }
+}
+
 /**
  *
  * @param vm
@@ -347,8 +592,82 @@ void parse_input(const po::variables_map& vm) {
     }
 
     GKFS_DATA->rpc_protocol(rpc_protocol);
+
+    auto io_scheduler = string(gkfs::config::scheduler::default_policy);
+    if (vm.count("io-scheduler")) {
+        io_scheduler = vm["io-scheduler"].as<string>();
+    }
+    // throws on unknown policies
+    gkfs::scheduler::RequestScheduler::parse_policy(io_scheduler);
+    GKFS_DATA->io_scheduler(io_scheduler);
+    GKFS_DATA->spdlogger()->debug("{}() I/O request scheduling policy set to '{}'.", __func__, io_scheduler);
+
+    GKFS_DATA->io_xstreams(xstreams_option(vm, "io-xstreams", gkfs::env::IO_XSTREAMS,
+                                           gkfs::config::rpc::daemon_io_xstreams, 1));
+    GKFS_DATA->handler_xstreams(xstreams_option(vm, "handler-xstreams", gkfs::env::HANDLER_XSTREAMS,
+                                                gkfs::config::rpc::daemon_handler_xstreams, 1));
+    GKFS_DATA->metadata_xstreams(xstreams_option(vm, "metadata-xstreams", gkfs::env::METADATA_XSTREAMS,
+                                                 gkfs::config::rpc::daemon_metadata_xstreams, 0));
+    GKFS_DATA->data_xstreams(xstreams_option(vm, "data-xstreams", gkfs::env::DATA_XSTREAMS,
+                                             gkfs::config::rpc::daemon_data_xstreams, 0));
+    auto io_autotune = gkfs::env::get_var(gkfs::env::IO_AUTOTUNE, "0");
+    GKFS_DATA->io_autotune(vm.count("io-autotune") != 0 || (!io_autotune.empty() && io_autotune != "0"));
+    GKFS_DATA->spdlogger()->debug("{}() Execution streams: I/O '{}'{} handler '{}' metadata '{}' data '{}'.",
+                                  __func__, GKFS_DATA->io_xstreams(), GKFS_DATA->io_autotune() ? " (autotuned)" : "",
+                                  GKFS_DATA->handler_xstreams(), GKFS_DATA->metadata_xstreams(),
+                                  GKFS_DATA->data_xstreams());
+    GKFS_DATA->io_cpus(cpu_set_option(vm, "pin-io", gkfs::env::PIN_IO));
+    GKFS_DATA->handler_cpus(cpu_set_option(vm, "pin-handler", gkfs::env::PIN_HANDLER));
+    GKFS_DATA->progress_cpus(cpu_set_option(vm, "pin-progress", gkfs::env::PIN_PROGRESS));
+    GKFS_DATA->rocksdb_cpus(cpu_set_option(vm, "pin-rocksdb", gkfs::env::PIN_ROCKSDB));
+    GKFS_DATA->spdlogger()->debug("{}() CPU sets: I/O '{}' handler '{}' progress '{}' RocksDB '{}'.", __func__,
+                                  gkfs::affinity::to_string(GKFS_DATA->io_cpus()),
+                                  gkfs::affinity::to_string(GKFS_DATA->handler_cpus()),
+                                  gkfs::affinity::to_string(GKFS_DATA->progress_cpus()),
+                                  gkfs::affinity::to_string(GKFS_DATA->rocksdb_cpus()));
+    string buffer_node;
+    if (vm.count("buffer-numa-node"))
+        buffer_node = vm["buffer-numa-node"].as<string>();
+    else
+        buffer_node = gkfs::env::get_var(gkfs::env::BUFFER_NUMA_NODE, "");
+    GKFS_DATA->buffer_numa_node(-1);
+    if (buffer_node == "auto") {
+        // the NUMA node of the network interface, if the daemon listens on an interface
+        auto iface = vm.count("listen") ? vm["listen"].as<string>() : ""s;
+        GKFS_DATA->buffer_numa_node(iface.empty() ? -1 : gkfs::affinity::interface_numa_node(iface));
+        if (GKFS_DATA->buffer_numa_node() < 0) {
+            GKFS_DATA->spdlogger()->warn("{}() NUMA node of interface '{}' unknown. RPC buffers are not placed.",
+                                         __func__, iface);
+        }
+    } else if (!buffer_node.empty()) {
+        size_t pos = 0;
+        int node = -1;
+        try {
+            node = stoi(buffer_node, &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos == 0 || pos != buffer_node.size() || node < 0)
+            throw runtime_error(fmt::format("Invalid NUMA node for RPC buffers: '{}'", buffer_node));
+        GKFS_DATA->buffer_numa_node(node);
+    }
+    if (GKFS_DATA->buffer_numa_node() >= 0) {
+        GKFS_DATA->spdlogger()->debug("{}() RPC buffers prefer NUMA node '{}'.", __func__,
+                                      GKFS_DATA->buffer_numa_node());
+    }
     GKFS_DATA->bind_addr(fmt::format("{}://{}", rpc_protocol, addr));
 
+    string qos;
+    if (vm.count("qos"))
+        qos = vm["qos"].as<string>();
+    else
+        qos = gkfs::env::get_var(gkfs::env::QOS, "");
+    // throws on malformed classes
+    gkfs::scheduler::QosPolicy::parse_classes(qos);
+    GKFS_DATA->qos(qos);
+    if (!qos.empty())
+        GKFS_DATA->spdlogger()->debug("{}() QoS classes set to '{}'.", __func__, qos);
+
     string hosts_file;
     if (vm.count("hosts-file")) {
         hosts_file = vm["hosts-file"].as<string>();
@@ -378,6 +697,14 @@ void parse_input(const po::variables_map& vm) {
     bfs::create_directories(rootdir_path);
     GKFS_DATA->rootdir(rootdir_path.native());
 
+    if (vm.count("staging-dir")) {
+        // node-local, but several daemons may share the node
+        auto staging_path = bfs::path(vm["staging-dir"].as<string>()) / fmt::format_int(getpid()).str();
+        bfs::create_directories(staging_path);
+        GKFS_DATA->staging_dir(bfs::canonical(staging_path).native());
+        GKFS_DATA->spdlogger()->debug("{}() Staging directory: '{}'", __func__, GKFS_DATA->staging_dir());
+    }
+
     if (vm.count("metadir")) {
         auto metadir = vm["metadir"].as<string>();
 
@@ -432,6 +759,46 @@ int main(int argc, const char* argv[]) {
                                                     "Libfabric must have enabled support verbs or psm2.")
             ("auto-sm", "Enables intra-node communication (IPCs) via the `na+sm` (shared memory) protocol, "
                         "instead of using the RPC protocol. (Default off)")
+            ("staging-dir", po::value<string>(),
+             "Node-local directory, e.g., on tmpfs or NVMe, where writes are staged before they are written to "
+             "rootdir in the background. Writes complete once they are staged. If not set, writes are not staged.")
+            ("io-scheduler", po::value<string>(), "Policy to order concurrent read and write requests.\n"
+                                                  "Available: {none, fifo, aggregation, deadline}. aggregation "
+                                                  "releases contiguous requests to a file together, deadline "
+                                                  "releases them in offset order unless a request waits too long. "
+                                                  "(Default 'aggregation' for the forwarding daemon, 'none' otherwise)")
+            ("io-xstreams", po::value<string>(), "Number of execution streams for chunk I/O operations. "
+                                                 "(Default 8, or env GKFS_IO_XSTREAMS)")
+            ("io-autotune", "Adapts the number of active I/O execution streams to the number of waiting chunk "
+                            "operations and their latency, up to --io-xstreams. (Default off, or env "
+                            "GKFS_IO_AUTOTUNE)")
+            ("handler-xstreams", po::value<string>(), "Number of execution streams for RPC handlers other than "
+                                                      "metadata and data RPCs. (Default 2, or env "
+                                                      "GKFS_HANDLER_XSTREAMS)")
+            ("metadata-xstreams", po::value<string>(), "Number of execution streams for metadata RPC handlers. 0 "
+                                                       "uses the general handler streams. (Default 4, or env "
+                                                       "GKFS_METADATA_XSTREAMS)")
+            ("data-xstreams", po::value<string>(), "Number of execution streams for data RPC handlers. 0 uses the "
+                                                   "general handler streams. (Default 8, or env "
+                                                   "GKFS_DATA_XSTREAMS)")
+            ("pin-io", po::value<string>(), "CPUs the I/O and staging execution streams run on, as list of CPUs, "
+                                            "CPU ranges, and NUMA nodes, e.g., '4-7,12' or 'node:1'. (Default "
+                                            "not pinned, or env GKFS_PIN_IO)")
+            ("pin-handler", po::value<string>(), "CPUs the RPC handler execution streams run on. (Default not "
+                                                 "pinned, or env GKFS_PIN_HANDLER)")
+            ("pin-progress", po::value<string>(), "CPUs the network progress execution stream runs on. (Default "
+                                                  "not pinned, or env GKFS_PIN_PROGRESS)")
+            ("pin-rocksdb", po::value<string>(), "CPUs RocksDB's flush and compaction threads run on. (Default "
+                                                 "not pinned, or env GKFS_PIN_ROCKSDB)")
+            ("buffer-numa-node", po::value<string>(), "NUMA node RPC buffers are allocated on, preferably the node "
+                                                      "of the network interface. 'auto' uses the node of the "
+                                                      "--listen interface. (Default not set, or env "
+                                                      "GKFS_BUFFER_NUMA_NODE)")
+            ("qos", po::value<string>(), "Per-job shares and limits of read and write requests as comma-separated "
+                                         "list of JOB:WEIGHT[:BANDWIDTH[:IOPS]], e.g., '*:1,42:4:1G:5000'. Jobs "
+                                         "receive bandwidth proportional to their weight while the daemon is busy. "
+                                         "BANDWIDTH in bytes/s with optional K, M, or G suffix, 0 is unlimited. "
+                                         "'*' configures unlisted jobs. (Default off, or env GKFS_QOS)")
             ("version", "Print version and exit.");
     po::variables_map vm{};
     po::store(po::parse_command_line(argc, argv, desc), vm);
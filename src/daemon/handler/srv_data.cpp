@@ -17,11 +17,17 @@
 #include <daemon/handler/rpc_util.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/ops/data.hpp>
+#include <daemon/util.hpp>
+#include <daemon/scheduler/scheduler.hpp>
+#include <daemon/scheduler/qos.hpp>
+#include <daemon/ops/staging_cache.hpp>
 
 #include <global/rpc/rpc_types.hpp>
 #include <global/rpc/distributor.hpp>
 #include <global/chunk_calc_util.hpp>
 
+#include <cstring>
+
 #ifdef GKFS_ENABLE_AGIOS
 #include <daemon/scheduler/agios.hpp>
 
@@ -96,6 +102,16 @@ hg_return_t rpc_srv_write(hg_handle_t handle) {
     }
 #endif
 
+    // wait for the job's share before data is transferred, then for the scheduler. Both are left when the
+    // handler returns. Writes of other daemons bypass the QoS
+    string job = in.job_id != nullptr ? in.job_id : "";
+    gkfs::scheduler::QosRequest qos{job == gkfs::rpc::internal_job_id ? nullptr : RPC_DATA->qos(), job,
+                                    in.total_chunk_size};
+    gkfs::scheduler::ScheduledRequest scheduled{RPC_DATA->scheduler(), RPC_DATA->load_stats(), in.path,
+                                                gkfs::scheduler::RequestType::write,
+                                                in.chunk_start * gkfs::config::rpc::chunksize + in.offset,
+                                                in.total_chunk_size};
+
     /*
      * 2. Set up buffers for pull bulk transfers
      */
@@ -118,6 +134,10 @@ hg_return_t rpc_srv_write(hg_handle_t handle) {
     auto const host_id = in.host_id;
     auto const host_size = in.host_size;
     gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    gkfs::rpc::StripeLayout layout{};
+    layout.stripe_count = in.stripe_count;
+    layout.stripe_size = in.stripe_size;
+    layout.start_host = in.stripe_start;
 
     // chnk_ids used by this host
     vector<uint64_t> chnk_ids_host(in.chunk_n);
@@ -153,7 +173,7 @@ hg_return_t rpc_srv_write(hg_handle_t handle) {
          chnk_id_file <= in.chunk_end && chnk_id_curr < in.chunk_n; chnk_id_file++) {
         // Continue if chunk does not hash to this host
 #ifndef GKFS_ENABLE_FORWARDING
-        if (distributor.locate_data(in.path, chnk_id_file) != host_id) {
+        if (distributor.locate_data(in.path, chnk_id_file, layout) != host_id) {
             GKFS_DATA->spdlogger()->trace(
                     "{}() chunkid '{}' ignored as it does not match to this host with id '{}'. chnk_id_curr '{}'",
                     __func__, chnk_id_file, host_id, chnk_id_curr);
@@ -310,6 +330,14 @@ hg_return_t rpc_srv_read(hg_handle_t handle) {
     }
 #endif
 
+    // wait for the job's share before data is transferred, then for the scheduler. Both are left when the
+    // handler returns
+    gkfs::scheduler::QosRequest qos{RPC_DATA->qos(), in.job_id != nullptr ? in.job_id : "", in.total_chunk_size};
+    gkfs::scheduler::ScheduledRequest scheduled{RPC_DATA->scheduler(), RPC_DATA->load_stats(), in.path,
+                                                gkfs::scheduler::RequestType::read,
+                                                in.chunk_start * gkfs::config::rpc::chunksize + in.offset,
+                                                in.total_chunk_size};
+
     /*
      * 2. Set up buffers for pull bulk transfers
      */
@@ -333,6 +361,10 @@ hg_return_t rpc_srv_read(hg_handle_t handle) {
     auto const host_id = in.host_id;
     auto const host_size = in.host_size;
     gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    gkfs::rpc::StripeLayout layout{};
+    layout.stripe_count = in.stripe_count;
+    layout.stripe_size = in.stripe_size;
+    layout.start_host = in.stripe_start;
 #endif
 
     // chnk_ids used by this host
@@ -360,7 +392,7 @@ hg_return_t rpc_srv_read(hg_handle_t handle) {
          chnk_id_file <= in.chunk_end && chnk_id_curr < in.chunk_n; chnk_id_file++) {
         // Continue if chunk does not hash to this host
 #ifndef GKFS_ENABLE_FORWARDING
-        if (distributor.locate_data(in.path, chnk_id_file) != host_id) {
+        if (distributor.locate_data(in.path, chnk_id_file, layout) != host_id) {
             GKFS_DATA->spdlogger()->trace(
                     "{}() chunkid '{}' ignored as it does not match to this host with id '{}'. chnk_id_curr '{}'",
                     __func__, chnk_id_file, host_id, chnk_id_curr);
@@ -505,6 +537,355 @@ hg_return_t rpc_srv_get_chunk_stat(hg_handle_t handle) {
     return gkfs::rpc::cleanup_respond(&handle, &out);
 }
 
+/**
+ * Forwards a collective chunk stat to the children of this daemon and adds up their results.
+ * The hosts (first_host, last_host) below this daemon are split evenly into at most fanout contiguous subtrees,
+ * each rooted at its first host. All children are contacted before any response is waited for.
+ * @param in
+ * @param out
+ * @return error code
+ */
+int forward_chunk_stat_children(const rpc_chunk_stat_tree_in_t& in, rpc_chunk_stat_out_t& out) {
+    const uint64_t hosts = in.last_host - in.first_host - 1;
+    if (hosts == 0)
+        return 0;
+    const uint64_t children = std::min(static_cast<uint64_t>(std::max(in.fanout, 1u)), hosts);
+    auto mid = RPC_DATA->server_rpc_mid();
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    margo_registered_name(mid, gkfs::rpc::tag::get_chunk_stat_tree, &rpc_id, &registered);
+    assert(registered);
+
+    auto err = 0;
+    vector<hg_handle_t> handles(children, HG_HANDLE_NULL);
+    vector<margo_request> requests(children);
+    auto first_host = in.first_host + 1;
+    for (uint64_t i = 0; i < children; ++i) {
+        rpc_chunk_stat_tree_in_t child_in{};
+        child_in.first_host = first_host;
+        child_in.last_host = first_host + hosts / children + (i < hosts % children ? 1 : 0);
+        child_in.fanout = in.fanout;
+        first_host = child_in.last_host;
+        try {
+            auto addr = gkfs::util::lookup_peer_addr(child_in.first_host);
+            auto ret = margo_create(mid, addr, rpc_id, &handles[i]);
+            if (ret == HG_SUCCESS)
+                ret = margo_iforward(handles[i], &child_in, &requests[i]);
+            if (ret != HG_SUCCESS) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to forward to host '{}' with err '{}'", __func__,
+                                              child_in.first_host, ret);
+                if (handles[i] != HG_HANDLE_NULL)
+                    margo_destroy(handles[i]);
+                handles[i] = HG_HANDLE_NULL;
+                err = EBUSY;
+            }
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to contact host '{}': '{}'", __func__, child_in.first_host,
+                                          e.what());
+            err = EHOSTUNREACH;
+        }
+    }
+
+    // wait for RPC responses
+    for (uint64_t i = 0; i < children; ++i) {
+        if (handles[i] == HG_HANDLE_NULL)
+            continue;
+        rpc_chunk_stat_out_t child_out{};
+        auto ret = margo_wait(requests[i]);
+        if (ret == HG_SUCCESS)
+            ret = margo_get_output(handles[i], &child_out);
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to get rpc output with err '{}'", __func__, ret);
+            err = EBUSY;
+        } else {
+            if (child_out.err) {
+                err = child_out.err;
+            } else {
+                assert(child_out.chunk_size == out.chunk_size);
+                out.chunk_total += child_out.chunk_total;
+                out.chunk_free += child_out.chunk_free;
+            }
+            margo_free_output(handles[i], &child_out);
+        }
+        margo_destroy(handles[i]);
+    }
+    return err;
+}
+
+/**
+ * RPC handler for a chunk stat reduced along a tree of daemons. Each daemon adds its own chunk stat to the
+ * results of its subtrees.
+ * @param handle
+ * @return
+ */
+hg_return_t rpc_srv_get_chunk_stat_tree(hg_handle_t handle) {
+    rpc_chunk_stat_tree_in_t in{};
+    rpc_chunk_stat_out_t out{};
+    out.err = EIO;
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err '{}'", __func__, ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got RPC for hosts [{}, {}) with fanout '{}'", __func__, in.first_host,
+                                  in.last_host, in.fanout);
+    try {
+        auto chk_stat = GKFS_DATA->storage()->chunk_stat();
+        out.chunk_size = chk_stat.chunk_size;
+        out.chunk_total = chk_stat.chunk_total;
+        out.chunk_free = chk_stat.chunk_free;
+        out.err = 0;
+    } catch (const gkfs::data::ChunkStorageException& err) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
+        out.err = err.code().value();
+    } catch (const ::exception& err) {
+        GKFS_DATA->spdlogger()->error("{}() Unexpected error when chunk stat '{}'", __func__, err.what());
+        out.err = EAGAIN;
+    }
+    if (out.err == 0 && in.last_host > in.first_host)
+        out.err = forward_chunk_stat_children(in, out);
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}'", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
+/**
+ * Writes a buffer into a chunk stored by another daemon. The buffer is exposed via a bulk handle and sent with a
+ * regular write RPC for this single chunk, so the peer pulls it as it would from a client.
+ * @param mid
+ * @param host_id daemon storing the chunk
+ * @param host_size
+ * @param path
+ * @param layout stripe layout of the file
+ * @param chnk_id
+ * @param chnk_offset offset within the chunk
+ * @param buf
+ * @param size
+ * @return error code
+ */
+int write_peer_chunk(margo_instance_id mid, uint64_t host_id, uint64_t host_size, const string& path,
+                     const gkfs::rpc::StripeLayout& layout, gkfs::rpc::chnk_id_t chnk_id, off64_t chnk_offset,
+                     char* buf, size_t size) {
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    margo_registered_name(mid, gkfs::rpc::tag::write, &rpc_id, &registered);
+    assert(registered);
+
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    void* bulk_buf = buf;
+    hg_size_t bulk_size = size;
+    auto ret = margo_bulk_create(mid, 1, &bulk_buf, &bulk_size, HG_BULK_READ_ONLY, &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+        return EBUSY;
+    }
+    auto err = 0;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    try {
+        auto addr = gkfs::util::lookup_peer_addr(host_id);
+        rpc_write_data_in_t in{};
+        in.path = path.c_str();
+        in.offset = chnk_offset;
+        in.host_id = host_id;
+        in.host_size = host_size;
+        in.chunk_n = 1;
+        in.chunk_start = chnk_id;
+        in.chunk_end = chnk_id;
+        in.total_chunk_size = size;
+        in.stripe_count = layout.stripe_count;
+        in.stripe_size = layout.stripe_size;
+        in.stripe_start = layout.start_host;
+        // daemon-internal writes are not accounted to a job
+        in.job_id = gkfs::rpc::internal_job_id;
+        in.bulk_handle = bulk_handle;
+        ret = margo_create(mid, addr, rpc_id, &handle);
+        if (ret == HG_SUCCESS)
+            ret = margo_forward(handle, &in);
+        if (ret == HG_SUCCESS) {
+            rpc_data_out_t out{};
+            ret = margo_get_output(handle, &out);
+            if (ret == HG_SUCCESS) {
+                err = out.err;
+                margo_free_output(handle, &out);
+            }
+        }
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to write chunk '{}' of '{}' on host '{}' with err '{}'",
+                                          __func__, chnk_id, path, host_id, ret);
+            err = EBUSY;
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to contact host '{}': '{}'", __func__, host_id, e.what());
+        err = EHOSTUNREACH;
+    }
+    if (handle != HG_HANDLE_NULL)
+        margo_destroy(handle);
+    margo_bulk_free(bulk_handle);
+    return err;
+}
+
+/**
+ * RPC handler for a server-side copy. The daemon reads the source chunks it stores and writes each piece into the
+ * corresponding destination chunk, either locally or on the daemon storing it. The data never passes the client.
+ * Source and destination offsets must have the same position within a chunk so that every piece of a source chunk
+ * maps to exactly one destination chunk. A forwarding daemon stores all chunks of its clients and copies them all.
+ * Chunks are read and written by the I/O pools, copy_chunks_batch chunks at a time, and pass the scheduler.
+ * @param handle
+ * @return
+ */
+hg_return_t rpc_srv_copy_chunks(hg_handle_t handle) {
+    rpc_copy_chunks_in_t in{};
+    rpc_data_out_t out{};
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() src '{}' offset '{}' dst '{}' offset '{}' count '{}'", __func__,
+                                  in.src_path, in.src_offset, in.dst_path, in.dst_offset, in.count);
+    const auto chunksize = gkfs::config::rpc::chunksize;
+    if (in.count == 0 || gkfs::util::chnk_lpad(in.src_offset, chunksize) !=
+                         gkfs::util::chnk_lpad(in.dst_offset, chunksize)) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    auto mid = margo_hg_info_get_instance(margo_get_info(handle));
+#ifndef GKFS_ENABLE_FORWARDING
+    gkfs::rpc::SimpleHashDistributor distributor(in.host_id, in.host_size);
+    gkfs::rpc::StripeLayout src_layout{};
+    src_layout.stripe_count = in.src_stripe_count;
+    src_layout.stripe_size = in.src_stripe_size;
+    src_layout.start_host = in.src_stripe_start;
+#endif
+    gkfs::rpc::StripeLayout dst_layout{};
+    dst_layout.stripe_count = in.dst_stripe_count;
+    dst_layout.stripe_size = in.dst_stripe_size;
+    dst_layout.start_host = in.dst_stripe_start;
+    const string src_path = in.src_path;
+    const string dst_path = in.dst_path;
+    const uint64_t src_end = in.src_offset + in.count;
+
+    auto chnk_start = gkfs::util::chnk_id_for_offset(in.src_offset, chunksize);
+    auto chnk_end = gkfs::util::chnk_id_for_offset(src_end - 1, chunksize);
+    // source chunks stored on this daemon
+    vector<uint64_t> chnk_ids{};
+    for (auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+#ifndef GKFS_ENABLE_FORWARDING
+        if (distributor.locate_data(src_path, chnk_id, src_layout) != in.host_id)
+            continue;
+#endif
+        chnk_ids.push_back(chnk_id);
+    }
+
+    const size_t batch = gkfs::config::rpc::copy_chunks_batch;
+    vector<char> buf(min(batch, chnk_ids.size()) * chunksize);
+    auto err = 0;
+    for (size_t first = 0; first < chnk_ids.size() && !err; first += batch) {
+        auto n = min(batch, chnk_ids.size() - first);
+        // part of each chunk that is copied and the destination chunk with the same position within the chunk
+        vector<uint64_t> piece_starts(n);
+        vector<size_t> sizes(n);
+        vector<uint64_t> dst_chnk_ids(n);
+        vector<uint64_t> dst_hosts(n);
+        size_t batch_size = 0;
+        size_t local_n = 0;
+        for (size_t i = 0; i < n; i++) {
+            auto chnk_id = chnk_ids[first + i];
+            piece_starts[i] = std::max(static_cast<uint64_t>(in.src_offset), chnk_id * chunksize);
+            sizes[i] = static_cast<size_t>(std::min(src_end, (chnk_id + 1) * chunksize) - piece_starts[i]);
+            dst_chnk_ids[i] = (piece_starts[i] - in.src_offset + in.dst_offset) / chunksize;
+#ifdef GKFS_ENABLE_FORWARDING
+            dst_hosts[i] = in.host_id;
+#else
+            dst_hosts[i] = distributor.locate_data(dst_path, dst_chnk_ids[i], dst_layout);
+#endif
+            if (dst_hosts[i] == in.host_id)
+                local_n++;
+            batch_size += sizes[i];
+        }
+        // holes in the source are copied as zeros
+        memset(buf.data(), 0, n * chunksize);
+        {
+            gkfs::scheduler::ScheduledRequest scheduled{RPC_DATA->scheduler(), RPC_DATA->load_stats(), src_path,
+                                                        gkfs::scheduler::RequestType::read, piece_starts[0],
+                                                        batch_size};
+            gkfs::data::ChunkReadOperation read_op{src_path, n};
+            try {
+                for (size_t i = 0; i < n; i++) {
+                    read_op.read_nonblock(i, chnk_ids[first + i], buf.data() + i * chunksize, sizes[i],
+                                          gkfs::util::chnk_lpad(piece_starts[i], chunksize));
+                }
+                err = read_op.wait_for_tasks().first;
+            } catch (const gkfs::data::ChunkReadOpException& e) {
+                GKFS_DATA->spdlogger()->error("{}() while read_nonblock err '{}'", __func__, e.what());
+                err = EBUSY;
+            }
+        }
+        if (err)
+            break;
+        if (local_n > 0) {
+            gkfs::scheduler::ScheduledRequest scheduled{RPC_DATA->scheduler(), RPC_DATA->load_stats(), dst_path,
+                                                        gkfs::scheduler::RequestType::write,
+                                                        piece_starts[0] - in.src_offset + in.dst_offset,
+                                                        batch_size};
+            gkfs::data::ChunkWriteOperation write_op{dst_path, local_n};
+            try {
+                size_t idx = 0;
+                for (size_t i = 0; i < n; i++) {
+                    if (dst_hosts[i] != in.host_id)
+                        continue;
+                    write_op.write_nonblock(idx++, dst_chnk_ids[i], buf.data() + i * chunksize, sizes[i],
+                                            gkfs::util::chnk_lpad(piece_starts[i], chunksize));
+                }
+            } catch (const gkfs::data::ChunkWriteOpException& e) {
+                GKFS_DATA->spdlogger()->error("{}() while write_nonblock err '{}'", __func__, e.what());
+                err = EBUSY;
+                break;
+            }
+            err = write_op.wait_for_tasks().first;
+        }
+        // pieces of other daemons are sent after the scheduler was left. Their write RPCs pass the peers' schedulers,
+        // two daemons copying to each other must not wait for each other
+        for (size_t i = 0; i < n && !err; i++) {
+            if (dst_hosts[i] == in.host_id)
+                continue;
+            err = write_peer_chunk(mid, dst_hosts[i], in.host_size, dst_path, dst_layout, dst_chnk_ids[i],
+                                   gkfs::util::chnk_lpad(piece_starts[i], chunksize), buf.data() + i * chunksize,
+                                   sizes[i]);
+        }
+        if (!err)
+            out.io_size += batch_size;
+    }
+    out.err = err;
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}' io_size '{}'", __func__, out.err, out.io_size);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
+/**
+ * Drains the chunks staged on this daemon to the chunk storage, e.g., before a client moves to another forwarder.
+ * Responds EIO if a chunk could not be drained
+ */
+hg_return_t rpc_srv_flush_data(hg_handle_t handle) {
+    rpc_err_out_t out{};
+
+    GKFS_DATA->spdlogger()->debug("{}() Got flush RPC", __func__);
+
+    out.err = 0;
+    auto& staging = GKFS_DATA->staging();
+    if (staging && !staging->flush())
+        out.err = EIO;
+    auto hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to respond to flush request", __func__);
+    }
+
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
 }
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_write)
@@ -515,6 +896,12 @@ DEFINE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat_tree)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_copy_chunks)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_flush_data)
+
 #ifdef GKFS_ENABLE_AGIOS
 void *agios_eventual_callback(int64_t request_id, void* info) {
     GKFS_DATA->spdlogger()->debug("{}() custom callback request {} is ready", __func__, request_id);
@@ -14,6 +14,8 @@
 
 #include <daemon/daemon.hpp>
 #include <daemon/handler/rpc_defs.hpp>
+#include <daemon/scheduler/scheduler.hpp>
+#include <daemon/scheduler/qos.hpp>
 
 #include <global/rpc/rpc_types.hpp>
 
@@ -52,7 +54,82 @@ hg_return_t rpc_srv_get_fs_config(hg_handle_t handle) {
     return HG_SUCCESS;
 }
 
+/**
+ * @param pool
+ * @return number of units waiting in the pool, 0 for ABT_POOL_NULL
+ */
+uint64_t pool_queue_depth(ABT_pool pool) {
+    size_t size = 0;
+    if (pool != ABT_POOL_NULL && ABT_pool_get_size(pool, &size) != ABT_SUCCESS) {
+        GKFS_DATA->spdlogger()->warn("{}() Failed to get size of pool", __func__);
+    }
+    return size;
+}
+
+/**
+ * Reports the load of the data path: read and write requests that are queued or processed, requested bytes/s, and
+ * chunk operations waiting in the I/O pool. Also reports the RPCs waiting for a metadata or data handler thread
+ */
+hg_return_t rpc_srv_get_load(hg_handle_t handle) {
+    rpc_load_out_t out{};
+
+    GKFS_DATA->spdlogger()->trace("{}() Got load RPC", __func__);
+
+    auto& load = RPC_DATA->load_stats();
+    if (load) {
+        out.queue_depth = load->queue_depth();
+        out.bytes_per_sec = load->bytes_per_sec();
+    }
+    for (auto pool : RPC_DATA->io_pools()) {
+        size_t pending_tasks = 0;
+        if (ABT_pool_get_total_size(pool, &pending_tasks) != ABT_SUCCESS) {
+            GKFS_DATA->spdlogger()->warn("{}() Failed to get size of I/O pool", __func__);
+        }
+        out.pending_tasks += pending_tasks;
+    }
+    out.metadata_queue_depth = pool_queue_depth(RPC_DATA->metadata_pool());
+    out.data_queue_depth = pool_queue_depth(RPC_DATA->data_pool());
+    out.err = 0;
+    auto hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to respond to load request", __func__);
+    }
+
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
+/**
+ * Reports the per-job QoS statistics. Responds ENOTSUP if QoS is disabled
+ */
+hg_return_t rpc_srv_get_qos_stats(hg_handle_t handle) {
+    rpc_qos_stats_out_t out{};
+
+    GKFS_DATA->spdlogger()->trace("{}() Got QoS stats RPC", __func__);
+
+    string stats;
+    auto qos = RPC_DATA->qos();
+    if (qos) {
+        stats = qos->stats();
+        out.err = 0;
+    } else {
+        out.err = ENOTSUP;
+    }
+    out.stats = stats.c_str();
+    auto hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to respond to QoS stats request", __func__);
+    }
+
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
 }
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_fs_config)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_load)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_qos_stats)
+
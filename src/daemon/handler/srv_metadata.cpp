@@ -28,6 +28,52 @@ using namespace std;
 
 namespace {
 
+/**
+ * Pulls the paths of a batched metadentry request from the client. Paths are stored as consecutive
+ * null-terminated strings at the beginning of the client's buffer.
+ * @param handle
+ * @param client_bulk
+ * @param paths_size size of all paths in bytes including their terminators
+ * @param count number of paths
+ * @param paths (return val)
+ * @return error code
+ */
+int pull_batch_paths(hg_handle_t handle, hg_bulk_t client_bulk, hg_size_t paths_size, uint64_t count,
+                     vector<string>& paths) {
+    if (paths_size == 0 || paths_size > margo_bulk_get_size(client_bulk)) {
+        return EINVAL;
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    vector<char> paths_buf(paths_size);
+    void* buf_ptr = paths_buf.data();
+    hg_bulk_t bulk_handle = nullptr;
+    auto ret = margo_bulk_create(mid, 1, &buf_ptr, &paths_size, HG_BULK_WRITE_ONLY, &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+        return EBUSY;
+    }
+    ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr, client_bulk, 0, bulk_handle, 0, paths_size);
+    margo_bulk_free(bulk_handle);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to pull paths from client", __func__);
+        return EBUSY;
+    }
+    // the last path must be terminated, so that parsing cannot run past the buffer
+    if (paths_buf.back() != '\0') {
+        return EINVAL;
+    }
+    paths.reserve(count);
+    auto ptr = paths_buf.data();
+    auto end = paths_buf.data() + paths_size;
+    while (ptr < end && paths.size() < count) {
+        paths.emplace_back(ptr);
+        // number of characters + \0 terminator
+        ptr += paths.back().size() + 1;
+    }
+    return paths.size() == count ? 0 : EINVAL;
+}
+
 hg_return_t rpc_srv_create(hg_handle_t handle) {
     rpc_mk_node_in_t in;
     rpc_err_out_t out;
@@ -36,8 +82,12 @@ hg_return_t rpc_srv_create(hg_handle_t handle) {
     if (ret != HG_SUCCESS)
         GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
     assert(ret == HG_SUCCESS);
-    GKFS_DATA->spdlogger()->debug("{}() Got RPC with path '{}'", __func__, in.path);
+    GKFS_DATA->spdlogger()->debug("{}() Got RPC with path '{}' stripe_count '{}' stripe_size '{}' stripe_start '{}'",
+                                  __func__, in.path, in.stripe_count, in.stripe_size, in.stripe_start);
     gkfs::metadata::Metadata md(in.mode);
+    md.stripe_count(in.stripe_count);
+    md.stripe_size(in.stripe_size);
+    md.stripe_start(in.stripe_start);
     try {
         // create metadentry
         gkfs::metadata::create(in.path, md);
@@ -407,6 +457,172 @@ hg_return_t rpc_srv_get_dirents(hg_handle_t handle) {
 }
 
 
+/**
+ * RPC handler for batched creates. All metadentries are written with a single KV store write batch.
+ * @param handle
+ * @return
+ */
+hg_return_t rpc_srv_create_batch(hg_handle_t handle) {
+    rpc_mk_node_batch_in_t in{};
+    rpc_err_out_t out{};
+    out.err = EIO;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err '{}'", __func__, ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got RPC with '{}' paths, paths_size '{}'", __func__, in.count,
+                                  in.paths_size);
+
+    vector<string> paths{};
+    out.err = pull_batch_paths(handle, in.bulk_handle, in.paths_size, in.count, paths);
+    if (out.err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve paths: '{}'", __func__, strerror(out.err));
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    gkfs::metadata::Metadata md(in.mode);
+    md.stripe_count(in.stripe_count);
+    md.stripe_size(in.stripe_size);
+    md.stripe_start(in.stripe_start);
+    try {
+        gkfs::metadata::create_batch(paths, md);
+        out.err = 0;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create metadentries: '{}'", __func__, e.what());
+        out.err = EIO;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}'", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
+/**
+ * RPC handler for batched stats. The metadentry strings are pushed back to the client as consecutive
+ * null-terminated strings in the order of the requested paths. Non-existing entries are empty strings.
+ * @param handle
+ * @return
+ */
+hg_return_t rpc_srv_stat_batch(hg_handle_t handle) {
+    rpc_batch_in_t in{};
+    rpc_batch_out_t out{};
+    out.err = EIO;
+    out.out_size = 0;
+    hg_bulk_t bulk_handle = nullptr;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err '{}'", __func__, ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    auto bulk_size = margo_bulk_get_size(in.bulk_handle);
+    GKFS_DATA->spdlogger()->debug("{}() Got RPC with '{}' paths, paths_size '{}' bulk_size '{}'", __func__,
+                                  in.count, in.paths_size, bulk_size);
+
+    vector<string> paths{};
+    out.err = pull_batch_paths(handle, in.bulk_handle, in.paths_size, in.count, paths);
+    if (out.err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve paths: '{}'", __func__, strerror(out.err));
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    vector<string> vals{};
+    try {
+        vals = gkfs::metadata::get_str_batch(paths);
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to get metadentries from DB: '{}'", __func__, e.what());
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    size_t out_size = 0;
+    for (const auto& v : vals) {
+        // number of characters + \0 terminator
+        out_size += v.size() + 1;
+    }
+    if (bulk_size < out_size) {
+        GKFS_DATA->spdlogger()->debug("{}() Entries do not fit client buffer. bulk_size '{}' < out_size '{}'",
+                                      __func__, bulk_size, out_size);
+        out.err = ENOBUFS;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    void* bulk_buf;
+    ret = margo_bulk_create(mid, 1, nullptr, &out_size, HG_BULK_READ_ONLY, &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    uint32_t actual_count;
+    ret = margo_bulk_access(bulk_handle, 0, out_size, HG_BULK_READ_ONLY, 1, &bulk_buf, &out_size, &actual_count);
+    if (ret != HG_SUCCESS || actual_count != 1) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to access allocated buffer from bulk handle", __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    auto out_ptr = static_cast<char*>(bulk_buf);
+    for (const auto& v : vals) {
+        ::memcpy(out_ptr, v.c_str(), v.size() + 1);
+        out_ptr += v.size() + 1;
+    }
+    ret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr, in.bulk_handle, 0, bulk_handle, 0, out_size);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to push '{}' metadentries to client", __func__, vals.size());
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    out.err = 0;
+    out.out_size = out_size;
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}' out_size '{}'", __func__, out.err, out.out_size);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+}
+
+/**
+ * RPC handler for batched removes of metadentries. Chunks of the removed entries on this node are removed as well.
+ * @param handle
+ * @return
+ */
+hg_return_t rpc_srv_remove_batch(hg_handle_t handle) {
+    rpc_batch_in_t in{};
+    rpc_err_out_t out{};
+    out.err = EIO;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err '{}'", __func__, ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got RPC with '{}' paths, paths_size '{}'", __func__, in.count,
+                                  in.paths_size);
+
+    vector<string> paths{};
+    out.err = pull_batch_paths(handle, in.bulk_handle, in.paths_size, in.count, paths);
+    if (out.err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve paths: '{}'", __func__, strerror(out.err));
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    try {
+        gkfs::metadata::remove_batch(paths);
+        out.err = 0;
+    } catch (const gkfs::metadata::DBException& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to remove metadentries: '{}'", __func__, e.what());
+        out.err = EIO;
+    } catch (const gkfs::data::ChunkStorageException& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to remove chunks: '{}'", __func__, e.what());
+        out.err = e.code().value();
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Unexpected error: '{}'", __func__, e.what());
+        out.err = EBUSY;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}'", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
 #ifdef HAS_SYMLINKS
 
 hg_return_t rpc_srv_mk_symlink(hg_handle_t handle) {
@@ -460,6 +676,12 @@ DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_metadentry_size)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_dirents)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_create_batch)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_stat_batch)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove_batch)
+
 #ifdef HAS_SYMLINKS
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
@@ -12,6 +12,9 @@
 */
 
 #include <daemon/ops/data.hpp>
+#include <daemon/ops/write_aggregation.hpp>
+#include <daemon/ops/staging_cache.hpp>
+#include <daemon/scheduler/io_tuner.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <global/chunk_calc_util.hpp>
 #include <utility>
@@ -50,6 +53,9 @@ void ChunkTruncateOperation::truncate_abt(void* _arg) {
         auto chunk_id_start = gkfs::util::chnk_id_for_offset(size, gkfs::config::rpc::chunksize);
         // do not last delete chunk if it is in the middle of a chunk
         auto left_pad = gkfs::util::chnk_lpad(size, gkfs::config::rpc::chunksize);
+        // staged chunks must not be drained over the truncated chunks
+        if (GKFS_DATA->staging())
+            GKFS_DATA->staging()->truncate(path, chunk_id_start, left_pad);
         if (left_pad != 0) {
             GKFS_DATA->storage()->truncate_chunk_file(path, chunk_id_start, left_pad);
             chunk_id_start++;
@@ -70,11 +76,13 @@ void ChunkTruncateOperation::clear_task_args() {
     task_arg_ = {};
 }
 
-ChunkTruncateOperation::ChunkTruncateOperation(const string& path) : ChunkOperation{path, 1} {}
+ChunkTruncateOperation::ChunkTruncateOperation(const string& path) :
+        ChunkOperation{path, 1}, barrier_(truncate_abt, &task_arg_) {}
 
 /**
  * Starts a tasklet for requested truncate. In essence all chunk files after the given offset is removed
- * Only one truncate call is allowed at a time
+ * Only one truncate call is allowed at a time. The chunks to remove are spread over all I/O pools, the truncate
+ * starts once the operations queued before it in any pool have started
  */
 void ChunkTruncateOperation::truncate(size_t size) {
     assert(!task_eventuals_[0]);
@@ -93,7 +101,7 @@ void ChunkTruncateOperation::truncate(size_t size) {
     task_arg.size = size;
     task_arg.eventual = task_eventuals_[0];
 
-    abt_err = ABT_task_create(RPC_DATA->io_pool(), truncate_abt, &task_arg_, &abt_tasks_[0]);
+    abt_err = barrier_.post(RPC_DATA->io_pools(), abt_tasks_);
     if (abt_err != ABT_SUCCESS) {
         auto err_str = fmt::format("ChunkTruncateOperation::{}() Failed to create ABT task with abt_err '{}'", __func__,
                                    abt_err);
@@ -144,8 +152,13 @@ void ChunkWriteOperation::write_file_abt(void* _arg) {
     auto* arg = static_cast<struct chunk_write_args*>(_arg);
     const string& path = *(arg->path);
     ssize_t wrote{0};
+    auto start = chrono::steady_clock::now();
     try {
-        wrote = GKFS_DATA->storage()->write_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
+        auto& staging = GKFS_DATA->staging();
+        if (staging)
+            wrote = staging->write_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
+        else
+            wrote = GKFS_DATA->storage()->write_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
     } catch (const ChunkStorageException& err) {
         GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
         wrote = -(err.code().value());
@@ -154,15 +167,28 @@ void ChunkWriteOperation::write_file_abt(void* _arg) {
                                       path);
         wrote = -EIO;
     }
+    auto& tuner = RPC_DATA->io_tuner();
+    if (tuner)
+        tuner->record(chrono::steady_clock::now() - start);
     ABT_eventual_set(arg->eventual, &wrote, sizeof(wrote));
 }
 
 void ChunkWriteOperation::clear_task_args() {
     task_args_.clear();
+    aggregated_.clear();
 }
 
 ChunkWriteOperation::ChunkWriteOperation(const string& path, size_t n) : ChunkOperation{path, n} {
     task_args_.resize(n);
+    aggregated_.resize(n);
+}
+
+ChunkWriteOperation::~ChunkWriteOperation() {
+    // aggregated writes cannot be cancelled. Their eventuals must not be freed before they are set
+    for (size_t idx = 0; idx < aggregated_.size(); idx++) {
+        if (aggregated_[idx] && task_eventuals_[idx])
+            ABT_eventual_wait(task_eventuals_[idx], nullptr);
+    }
 }
 
 /**
@@ -190,6 +216,14 @@ ChunkWriteOperation::write_nonblock(size_t idx, const uint64_t chunk_id, const c
         throw ChunkWriteOpException(err_str);
     }
 
+    // small writes are merged with writes of other requests to the same chunk
+    auto& aggregator = RPC_DATA->write_aggregator();
+    if (aggregator && aggregator->aggregates(size) &&
+        aggregator->write(path_, chunk_id, bulk_buf_ptr, size, offset, task_eventuals_[idx])) {
+        aggregated_[idx] = true;
+        return;
+    }
+
     auto& task_arg = task_args_[idx];
     task_arg.path = &path_;
     task_arg.buf = bulk_buf_ptr;
@@ -198,7 +232,8 @@ ChunkWriteOperation::write_nonblock(size_t idx, const uint64_t chunk_id, const c
     task_arg.off = offset;
     task_arg.eventual = task_eventuals_[idx];
 
-    abt_err = ABT_task_create(RPC_DATA->io_pool(), write_file_abt, &task_args_[idx], &abt_tasks_[idx]);
+    abt_err = ABT_task_create(RPC_DATA->io_pool(path_, chunk_id), write_file_abt, &task_args_[idx],
+                              &abt_tasks_[idx]);
     if (abt_err != ABT_SUCCESS) {
         auto err_str = fmt::format("ChunkWriteOperation::{}() Failed to create ABT task with abt_err '{}'", __func__,
                                    abt_err);
@@ -267,9 +302,14 @@ void ChunkReadOperation::read_file_abt(void* _arg) {
     auto* arg = static_cast<struct chunk_read_args*>(_arg);
     const string& path = *(arg->path);
     ssize_t read = 0;
+    auto start = chrono::steady_clock::now();
     try {
         // Under expected circumstances (error or no error) read_chunk will signal the eventual
-        read = GKFS_DATA->storage()->read_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
+        auto& staging = GKFS_DATA->staging();
+        if (staging)
+            read = staging->read_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
+        else
+            read = GKFS_DATA->storage()->read_chunk(path, arg->chnk_id, arg->buf, arg->size, arg->off);
     } catch (const ChunkStorageException& err) {
         GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
         read = -(err.code().value());
@@ -278,6 +318,9 @@ void ChunkReadOperation::read_file_abt(void* _arg) {
                                       path);
         read = -EIO;
     }
+    auto& tuner = RPC_DATA->io_tuner();
+    if (tuner)
+        tuner->record(chrono::steady_clock::now() - start);
     ABT_eventual_set(arg->eventual, &read, sizeof(read));
 }
 
@@ -320,7 +363,8 @@ ChunkReadOperation::read_nonblock(size_t idx, const uint64_t chunk_id, char* bul
     task_arg.off = offset;
     task_arg.eventual = task_eventuals_[idx];
 
-    abt_err = ABT_task_create(RPC_DATA->io_pool(), read_file_abt, &task_args_[idx], &abt_tasks_[idx]);
+    abt_err = ABT_task_create(RPC_DATA->io_pool(path_, chunk_id), read_file_abt, &task_args_[idx],
+                              &abt_tasks_[idx]);
     if (abt_err != ABT_SUCCESS) {
         auto err_str = fmt::format("ChunkReadOperation::{}() Failed to create ABT task with abt_err '{}'", __func__,
                                    abt_err);
@@ -393,5 +437,35 @@ pair<int, size_t> ChunkReadOperation::wait_for_tasks_and_push_back(const bulk_ar
     return make_pair(io_err, total_read);
 }
 
+/**
+ * Waits for all Argobots tasklets to finish without transferring the data, e.g., when the daemon copies chunks
+ * itself. Missing chunks are sparse regions and read nothing.
+ * @return <int, size_t>
+ */
+pair<int, size_t> ChunkReadOperation::wait_for_tasks() {
+    GKFS_DATA->spdlogger()->trace("ChunkReadOperation::{}() enter: path '{}'", __func__, path_);
+    size_t total_read = 0;
+    int io_err = 0;
+    for (auto& e : task_eventuals_) {
+        ssize_t* task_size = nullptr;
+        auto abt_err = ABT_eventual_wait(e, (void**) &task_size);
+        if (abt_err != ABT_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("ChunkReadOperation::{}() Error when waiting on ABT eventual", __func__);
+            io_err = EIO;
+            ABT_eventual_free(&e);
+            continue;
+        }
+        assert(task_size != nullptr);
+        if (io_err == 0 && *task_size < 0 && -(*task_size) != ENOENT)
+            io_err = -(*task_size);
+        else if (*task_size > 0)
+            total_read += *task_size;
+        ABT_eventual_free(&e);
+    }
+    if (io_err != 0)
+        total_read = 0;
+    return make_pair(io_err, total_read);
+}
+
 } // namespace data
 } // namespace gkfs
@@ -15,6 +15,7 @@
 #include <daemon/ops/metadentry.hpp>
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/ops/staging_cache.hpp>
 
 using namespace std;
 
@@ -81,6 +82,40 @@ void create(const std::string& path, Metadata& md) {
     GKFS_DATA->mdb()->put(path, md.serialize());
 }
 
+/**
+ * Creates metadentries for all paths with the same metadata in a single KV store write
+ * @param paths
+ * @param md
+ */
+void create_batch(const std::vector<std::string>& paths, Metadata& md) {
+    if (GKFS_DATA->atime_state() || GKFS_DATA->mtime_state() || GKFS_DATA->ctime_state()) {
+        std::time_t time;
+        std::time(&time);
+        if (GKFS_DATA->atime_state())
+            md.atime(time);
+        if (GKFS_DATA->mtime_state())
+            md.mtime(time);
+        if (GKFS_DATA->ctime_state())
+            md.ctime(time);
+    }
+    auto val = md.serialize();
+    std::vector<std::pair<std::string, std::string>> entries{};
+    entries.reserve(paths.size());
+    for (const auto& path : paths) {
+        entries.emplace_back(path, val);
+    }
+    GKFS_DATA->mdb()->put_batch(entries);
+}
+
+/**
+ * Get metadentry strings for multiple paths. The string of a non-existing path is empty.
+ * @param paths
+ * @return
+ */
+std::vector<std::string> get_str_batch(const std::vector<std::string>& paths) {
+    return GKFS_DATA->mdb()->get_batch(paths);
+}
+
 /**
  * Update metadentry by given Metadata object and path
  * @param path
@@ -114,8 +149,24 @@ void remove(const string& path) {
     try {
         GKFS_DATA->mdb()->remove(path); // remove metadata from KV store
     } catch (const NotFoundException& e) {}
+    if (GKFS_DATA->staging())
+        GKFS_DATA->staging()->remove(path);
     GKFS_DATA->storage()->destroy_chunk_space(path); // destroys all chunks for the path on this node
 }
 
+/**
+ * Remove metadentries for all paths in a single KV store write and try to remove their chunks on this node
+ * @param paths
+ * @throws gkfs::metadata::DBException, gkfs::data::ChunkStorageException
+ */
+void remove_batch(const std::vector<std::string>& paths) {
+    GKFS_DATA->mdb()->remove_batch(paths);
+    for (const auto& path : paths) {
+        if (GKFS_DATA->staging())
+            GKFS_DATA->staging()->remove(path);
+        GKFS_DATA->storage()->destroy_chunk_space(path);
+    }
+}
+
 } // namespace metadata
 } // namespace gkfs
\ No newline at end of file
@@ -0,0 +1,330 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/ops/staging_cache.hpp>
+#include <daemon/daemon.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+
+#include <thread>
+
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+/**
+ * @param staging chunk storage on the staging tier
+ * @param storage chunk storage the staged chunks are drained to
+ * @param chunksize
+ * @param max_size maximum size of staged chunks in bytes
+ * @param drain_delay_ms time a chunk stays staged before it is drained unless the cache is half full
+ * @param drain_xstreams number of execution streams draining chunks
+ * @throws runtime_error if the execution streams cannot be created
+ */
+StagingCache::StagingCache(shared_ptr<ChunkStorage> staging, shared_ptr<ChunkStorage> storage, size_t chunksize,
+                           size_t max_size, unsigned int drain_delay_ms, unsigned int drain_xstreams) :
+        staging_(std::move(staging)), storage_(std::move(storage)), chunksize_(chunksize),
+        max_entries_(max(max_size / chunksize, static_cast<size_t>(1))), drain_delay_(drain_delay_ms) {
+    auto ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &drain_pool_);
+    if (ret != ABT_SUCCESS) {
+        throw runtime_error("Failed to create staging drain pool");
+    }
+    drain_streams_.resize(max(drain_xstreams, 1u));
+    drain_threads_.resize(drain_streams_.size());
+    for (size_t i = 0; i < drain_streams_.size(); ++i) {
+        ret = ABT_xstream_create_basic(ABT_SCHED_BASIC_WAIT, 1, &drain_pool_, ABT_SCHED_CONFIG_NULL,
+                                       &drain_streams_[i]);
+        if (ret != ABT_SUCCESS) {
+            throw runtime_error("Failed to create staging drain execution streams");
+        }
+        // the drain ULTs block their execution stream while waiting, so each stream runs one of them
+        ret = ABT_thread_create(drain_pool_, drain_ult, this, ABT_THREAD_ATTR_NULL, &drain_threads_[i]);
+        if (ret != ABT_SUCCESS) {
+            throw runtime_error("Failed to create staging drain threads");
+        }
+    }
+}
+
+StagingCache::~StagingCache() {
+    shutdown();
+}
+
+/**
+ * Drains staged chunks in the order they were staged until the cache is shut down
+ */
+void StagingCache::drain_ult(void* _arg) {
+    auto cache = static_cast<StagingCache*>(_arg);
+    unique_lock<mutex> lock(cache->mutex_);
+    while (!cache->stop_) {
+        if (cache->drain_queue_.empty()) {
+            cache->drain_cv_.wait(lock);
+            continue;
+        }
+        auto key = cache->drain_queue_.front();
+        auto it = cache->entries_.find(key);
+        if (it == cache->entries_.end()) {
+            // removed meanwhile
+            cache->drain_queue_.pop_front();
+            continue;
+        }
+        auto entry = it->second;
+        auto due = entry->staged + cache->drain_delay_;
+        if (cache->entries_.size() < cache->max_entries_ / 2 && chrono::steady_clock::now() < due) {
+            cache->drain_cv_.wait_until(lock, due);
+            continue;
+        }
+        cache->drain_queue_.pop_front();
+        lock.unlock();
+        auto drained = cache->drain_(entry);
+        lock.lock();
+        if (!drained) {
+            // retry later, e.g., if the chunk storage is temporarily unavailable
+            cache->drain_queue_.push_back(key);
+            lock.unlock();
+            this_thread::sleep_for(chrono::milliseconds(100));
+            lock.lock();
+        }
+    }
+}
+
+/**
+ * Writes a staged chunk to the chunk storage and removes it from the cache
+ * @param entry
+ * @return false if the chunk could not be drained
+ */
+bool StagingCache::drain_(const shared_ptr<Entry>& entry) {
+    lock_guard<mutex> entry_lock(entry->mutex);
+    if (entry->removed)
+        return true;
+    try {
+        vector<char> buf(chunksize_);
+        auto size = staging_->read_chunk(entry->path, entry->chnk_id, buf.data(), chunksize_, 0);
+        storage_->write_chunk(entry->path, entry->chnk_id, buf.data(), static_cast<size_t>(size), 0);
+    } catch (const ChunkStorageException& e) {
+        GKFS_DATA->spdlogger()->error("StagingCache::{}() Failed to drain chunk '{}' of file '{}': {}", __func__,
+                                      entry->chnk_id, entry->path, e.what());
+        return false;
+    }
+    drop_(entry);
+    return true;
+}
+
+/**
+ * Removes a chunk from the staging tier and the cache. Must be called with the entry's mutex held
+ * @param entry
+ */
+void StagingCache::drop_(const shared_ptr<Entry>& entry) {
+    try {
+        staging_->remove_chunk(entry->path, entry->chnk_id);
+    } catch (const ChunkStorageException& e) {
+        // the chunk is not reachable anymore
+        GKFS_DATA->spdlogger()->warn("StagingCache::{}() {}", __func__, e.what());
+    }
+    lock_guard<mutex> lock(mutex_);
+    auto it = entries_.find(make_pair(entry->path, entry->chnk_id));
+    if (it != entries_.end() && it->second == entry)
+        entries_.erase(it);
+    entry->removed = true;
+    space_cv_.notify_all();
+}
+
+/**
+ * @param path
+ * @param chunk_start
+ * @return staged chunks of the file starting with chunk_start
+ */
+vector<shared_ptr<StagingCache::Entry>>
+StagingCache::entries_of_(const string& path, gkfs::rpc::chnk_id_t chunk_start) {
+    vector<shared_ptr<Entry>> entries;
+    lock_guard<mutex> lock(mutex_);
+    for (auto it = entries_.lower_bound(make_pair(path, chunk_start));
+         it != entries_.end() && it->first.first == path; ++it) {
+        entries.push_back(it->second);
+    }
+    return entries;
+}
+
+/**
+ * Stages a write. Blocks while the maximum number of chunks is staged and the chunk is not staged yet
+ * @return written size
+ * @throws ChunkStorageException
+ */
+ssize_t StagingCache::write_chunk(const string& path, gkfs::rpc::chnk_id_t chunk_id, const char* buf, size_t size,
+                                  off64_t offset) {
+    auto key = make_pair(path, chunk_id);
+    while (true) {
+        shared_ptr<Entry> entry;
+        unique_lock<mutex> entry_lock;
+        {
+            unique_lock<mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it == entries_.end()) {
+                space_cv_.wait(lock, [&]() { return entries_.size() < max_entries_ || stop_; });
+                it = entries_.find(key);
+            }
+            if (it == entries_.end()) {
+                entry = make_shared<Entry>();
+                entry->path = path;
+                entry->chnk_id = chunk_id;
+                entry->staged = chrono::steady_clock::now();
+                // not contended as the entry is not visible yet. Held until the entry is filled
+                entry_lock = unique_lock<mutex>(entry->mutex);
+                entries_.emplace(key, entry);
+                drain_queue_.push_back(key);
+                drain_cv_.notify_one();
+            } else {
+                entry = it->second;
+            }
+        }
+        if (!entry_lock.owns_lock())
+            entry_lock = unique_lock<mutex>(entry->mutex);
+        if (entry->removed)
+            continue;
+        try {
+            if (!entry->filled && (offset != 0 || size != chunksize_)) {
+                // bring the rest of the chunk to the staging tier
+                vector<char> fill(chunksize_);
+                ssize_t fill_size = 0;
+                try {
+                    fill_size = storage_->read_chunk(path, chunk_id, fill.data(), chunksize_, 0);
+                } catch (const ChunkStorageException& e) {
+                    if (e.code().value() != ENOENT)
+                        throw;
+                }
+                if (fill_size > 0)
+                    staging_->write_chunk(path, chunk_id, fill.data(), static_cast<size_t>(fill_size), 0);
+            }
+            entry->filled = true;
+            return staging_->write_chunk(path, chunk_id, buf, size, offset);
+        } catch (const ChunkStorageException&) {
+            if (!entry->filled)
+                drop_(entry);
+            throw;
+        }
+    }
+}
+
+/**
+ * Reads a chunk from the staging tier if it is staged, from the chunk storage otherwise
+ * @return read size
+ * @throws ChunkStorageException
+ */
+ssize_t StagingCache::read_chunk(const string& path, gkfs::rpc::chnk_id_t chunk_id, char* buf, size_t size,
+                                 off64_t offset) {
+    shared_ptr<Entry> entry;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(make_pair(path, chunk_id));
+        if (it != entries_.end())
+            entry = it->second;
+    }
+    if (entry) {
+        lock_guard<mutex> entry_lock(entry->mutex);
+        if (!entry->removed)
+            return staging_->read_chunk(path, chunk_id, buf, size, offset);
+    }
+    return storage_->read_chunk(path, chunk_id, buf, size, offset);
+}
+
+/**
+ * Applies a truncate to the staged chunks of a file. Must be followed by the truncate of the chunk storage
+ * @param path
+ * @param chunk_start first chunk to cut off
+ * @param left_pad if not 0, chunk_start is truncated to this length instead of being removed
+ * @throws ChunkStorageException
+ */
+void StagingCache::truncate(const string& path, gkfs::rpc::chnk_id_t chunk_start, off_t left_pad) {
+    for (auto& entry : entries_of_(path, chunk_start)) {
+        lock_guard<mutex> entry_lock(entry->mutex);
+        if (entry->removed)
+            continue;
+        if (entry->chnk_id == chunk_start && left_pad != 0)
+            staging_->truncate_chunk_file(path, chunk_start, left_pad);
+        else
+            drop_(entry);
+    }
+}
+
+/**
+ * Discards the staged chunks of a removed file
+ * @param path
+ */
+void StagingCache::remove(const string& path) {
+    for (auto& entry : entries_of_(path, 0)) {
+        lock_guard<mutex> entry_lock(entry->mutex);
+        if (!entry->removed)
+            drop_(entry);
+    }
+}
+
+/**
+ * Drains all chunks staged so far without waiting for their drain delay, e.g., before clients move to another
+ * forwarder that does not see this staging tier. Chunks staged meanwhile are drained as usual
+ * @return false if a chunk could not be drained
+ */
+bool StagingCache::flush() {
+    vector<shared_ptr<Entry>> entries;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (auto& entry : entries_)
+            entries.push_back(entry.second);
+    }
+    auto flushed = true;
+    for (auto& entry : entries) {
+        // entries drained meanwhile are skipped by drain_(). The drain threads skip entries flushed here
+        if (!drain_(entry))
+            flushed = false;
+    }
+    return flushed;
+}
+
+/**
+ * Stops the drain threads and drains all remaining chunks
+ */
+void StagingCache::shutdown() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (stop_)
+            return;
+        stop_ = true;
+        drain_cv_.notify_all();
+        space_cv_.notify_all();
+    }
+    for (auto& thread : drain_threads_) {
+        ABT_thread_join(thread);
+        ABT_thread_free(&thread);
+    }
+    for (auto& xstream : drain_streams_) {
+        ABT_xstream_join(xstream);
+        ABT_xstream_free(&xstream);
+    }
+    drain_threads_.clear();
+    drain_streams_.clear();
+
+    vector<shared_ptr<Entry>> entries;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (auto& entry : entries_)
+            entries.push_back(entry.second);
+        drain_queue_.clear();
+    }
+    for (auto& entry : entries) {
+        if (!drain_(entry)) {
+            GKFS_DATA->spdlogger()->error("StagingCache::{}() Chunk '{}' of file '{}' is lost", __func__,
+                                          entry->chnk_id, entry->path);
+        }
+    }
+}
+
+} // namespace data
+} // namespace gkfs
@@ -0,0 +1,162 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/ops/write_aggregation.hpp>
+#include <daemon/ops/data.hpp>
+#include <daemon/daemon.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/ops/staging_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+WriteAggregator::WriteAggregator(margo_instance_id mid, unsigned int window_ms, size_t chunksize, size_t max_size) :
+        mid_(mid), window_(window_ms), chunksize_(chunksize), max_size_(max_size) {
+    if (ABT_mutex_create(&mutex_) != ABT_SUCCESS) {
+        throw runtime_error("Failed to create mutex for write aggregation");
+    }
+}
+
+WriteAggregator::~WriteAggregator() {
+    ABT_mutex_free(&mutex_);
+}
+
+/**
+ * @param size
+ * @return true if writes of this size are aggregated. Writes of whole chunks gain nothing from waiting
+ */
+bool WriteAggregator::aggregates(size_t size) const {
+    return size < chunksize_;
+}
+
+/**
+ * Adds a write to the chunk's slot. The eventual is set to the written size<ssize_t> or -errno when the slot was
+ * written. The buffer is copied and may be released when this function returns.
+ * @param path
+ * @param chnk_id
+ * @param buf
+ * @param size
+ * @param offset within the chunk
+ * @param eventual
+ * @return false if the write was not added because the chunk has no slot and the slots hold max_size bytes. The
+ * caller writes it directly
+ * @throws ChunkWriteOpException if the flush ULT cannot be created
+ */
+bool WriteAggregator::write(const string& path, gkfs::rpc::chnk_id_t chnk_id, const char* buf, size_t size,
+                            off64_t offset, ABT_eventual eventual) {
+    assert(offset + size <= chunksize_);
+    ABT_mutex_lock(mutex_);
+    auto& slot = slots_[make_pair(path, chnk_id)];
+    auto new_slot = !slot;
+    if (new_slot && size_ + chunksize_ > max_size_) {
+        slots_.erase(make_pair(path, chnk_id));
+        ABT_mutex_unlock(mutex_);
+        return false;
+    }
+    if (new_slot) {
+        size_ += chunksize_;
+        slot = make_shared<Slot>();
+        slot->path = path;
+        slot->chnk_id = chnk_id;
+        slot->buf.resize(chunksize_);
+    }
+    memcpy(slot->buf.data() + offset, buf, size);
+    slot->extents.emplace_back(offset, offset + size);
+    slot->writers.push_back(Writer{eventual, size});
+    if (new_slot) {
+        auto args = new FlushArgs{this, slot};
+        auto abt_err = ABT_thread_create(RPC_DATA->io_pool(path, chnk_id), flush_ult, args, ABT_THREAD_ATTR_NULL,
+                                         nullptr);
+        if (abt_err != ABT_SUCCESS) {
+            slots_.erase(make_pair(path, chnk_id));
+            size_ -= chunksize_;
+            ABT_mutex_unlock(mutex_);
+            delete args;
+            throw ChunkWriteOpException(
+                    fmt::format("WriteAggregator::{}() Failed to create ABT thread with abt_err '{}'", __func__,
+                                abt_err));
+        }
+    }
+    ABT_mutex_unlock(mutex_);
+    return true;
+}
+
+/**
+ * Waits for the aggregation window, closes the slot, and writes it. Runs as ULT in the chunk's I/O pool
+ */
+void WriteAggregator::flush_ult(void* _arg) {
+    unique_ptr<FlushArgs> args(static_cast<FlushArgs*>(_arg));
+    auto aggregator = args->aggregator;
+    margo_thread_sleep(aggregator->mid_, aggregator->window_);
+
+    ABT_mutex_lock(aggregator->mutex_);
+    aggregator->slots_.erase(make_pair(args->slot->path, args->slot->chnk_id));
+    ABT_mutex_unlock(aggregator->mutex_);
+    // the slot cannot receive writes anymore
+    aggregator->flush_(*args->slot);
+    args->slot.reset();
+
+    ABT_mutex_lock(aggregator->mutex_);
+    aggregator->size_ -= aggregator->chunksize_;
+    ABT_mutex_unlock(aggregator->mutex_);
+}
+
+void WriteAggregator::flush_(Slot& slot) {
+    // merge overlapping and adjacent ranges
+    auto extents = slot.extents;
+    sort(extents.begin(), extents.end());
+    vector<pair<size_t, size_t>> runs;
+    for (const auto& extent : extents) {
+        if (!runs.empty() && extent.first <= runs.back().second)
+            runs.back().second = max(runs.back().second, extent.second);
+        else
+            runs.push_back(extent);
+    }
+    GKFS_DATA->spdlogger()->trace("WriteAggregator::{}() path '{}' chunk '{}' writes '{}' pwrites '{}'", __func__,
+                                  slot.path, slot.chnk_id, slot.writers.size(), runs.size());
+
+    ssize_t err = 0;
+    auto& staging = GKFS_DATA->staging();
+    for (const auto& run : runs) {
+        try {
+            if (staging)
+                staging->write_chunk(slot.path, slot.chnk_id, slot.buf.data() + run.first, run.second - run.first,
+                                     run.first);
+            else
+                GKFS_DATA->storage()->write_chunk(slot.path, slot.chnk_id, slot.buf.data() + run.first,
+                                                  run.second - run.first, run.first);
+        } catch (const ChunkStorageException& e) {
+            GKFS_DATA->spdlogger()->error("WriteAggregator::{}() {}", __func__, e.what());
+            err = -(e.code().value());
+            break;
+        } catch (const ::exception& e) {
+            GKFS_DATA->spdlogger()->error("WriteAggregator::{}() Unexpected error writing chunk {} of file {}",
+                                          __func__, slot.chnk_id, slot.path);
+            err = -EIO;
+            break;
+        }
+    }
+    for (auto& writer : slot.writers) {
+        ssize_t wrote = err != 0 ? err : static_cast<ssize_t>(writer.size);
+        ABT_eventual_set(writer.eventual, &wrote, sizeof(wrote));
+    }
+}
+
+} // namespace data
+} // namespace gkfs
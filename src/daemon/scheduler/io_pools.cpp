@@ -0,0 +1,189 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/io_pools.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+namespace {
+
+// number of units run between checks whether the stream has to stop
+constexpr unsigned int event_freq = 50;
+
+/**
+ * Pools of a stealing scheduler, its own pool first
+ */
+struct StealingSched {
+    vector<ABT_pool> pools;
+};
+
+int stealing_sched_init(ABT_sched sched, ABT_sched_config config) {
+    int num_pools = 0;
+    auto ret = ABT_sched_get_num_pools(sched, &num_pools);
+    if (ret != ABT_SUCCESS)
+        return ret;
+    auto data = new StealingSched{vector<ABT_pool>(static_cast<size_t>(num_pools))};
+    ret = ABT_sched_get_pools(sched, num_pools, 0, data->pools.data());
+    if (ret == ABT_SUCCESS)
+        ret = ABT_sched_set_data(sched, data);
+    if (ret != ABT_SUCCESS)
+        delete data;
+    return ret;
+}
+
+/**
+ * Runs the units of the own pool and steals from the other pools when it is empty. Unlike Argobots' basic wait
+ * scheduler, which blocks on the first pool, an idle stream polls all pools again after a short backoff, so that tasks
+ * queued in the pool of a busy stream are stolen quickly. A push to the own pool wakes the stream immediately.
+ */
+void stealing_sched_run(ABT_sched sched) {
+    StealingSched* data = nullptr;
+    ABT_sched_get_data(sched, reinterpret_cast<void**>(&data));
+    const auto& pools = data->pools;
+    unsigned int runs = 0;
+    auto backoff = gkfs::config::io::steal_poll_min;
+    while (true) {
+        ABT_unit unit = ABT_UNIT_NULL;
+        for (auto pool : pools) {
+            ABT_pool_pop(pool, &unit);
+            if (unit != ABT_UNIT_NULL) {
+                ABT_xstream_run_unit(unit, pool);
+                break;
+            }
+        }
+        if (unit == ABT_UNIT_NULL) {
+            // all pools are empty
+            ABT_pool_pop_timedwait(pools[0], &unit, ABT_get_wtime() + backoff / 1e6);
+            if (unit != ABT_UNIT_NULL) {
+                ABT_xstream_run_unit(unit, pools[0]);
+            } else {
+                backoff = min(backoff * 2, gkfs::config::io::steal_poll_max);
+                runs = event_freq;
+            }
+        }
+        if (unit != ABT_UNIT_NULL)
+            backoff = gkfs::config::io::steal_poll_min;
+        if (++runs < event_freq)
+            continue;
+        runs = 0;
+        ABT_bool stop;
+        ABT_sched_has_to_stop(sched, &stop);
+        if (stop == ABT_TRUE)
+            break;
+        ABT_xstream_check_events(sched);
+    }
+}
+
+int stealing_sched_free(ABT_sched sched) {
+    StealingSched* data = nullptr;
+    ABT_sched_get_data(sched, reinterpret_cast<void**>(&data));
+    delete data;
+    return ABT_SUCCESS;
+}
+
+ABT_sched_def stealing_sched_def = {
+        ABT_SCHED_TYPE_ULT,
+        stealing_sched_init,
+        stealing_sched_run,
+        stealing_sched_free,
+        nullptr
+};
+
+} // namespace
+
+/**
+ * Creates a pool for each execution stream. A stream runs the tasks of its own pool and steals from the other pools,
+ * starting with the next one, when its pool is empty, see stealing_sched_run()
+ * @param xstreams_num
+ * @param pools filled with the created pools
+ * @param xstreams filled with the created execution streams
+ * @throws runtime_error
+ */
+void create_stealing_pools(unsigned int xstreams_num, vector<ABT_pool>& pools, vector<ABT_xstream>& xstreams) {
+    pools.resize(xstreams_num);
+    for (auto& pool : pools) {
+        auto ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &pool);
+        if (ret != ABT_SUCCESS) {
+            throw runtime_error("Failed to create pool");
+        }
+    }
+
+    // schedulers are freed with their streams
+    ABT_sched_config config;
+    auto ret = ABT_sched_config_create(&config, ABT_sched_config_automatic, ABT_TRUE, ABT_sched_config_var_end);
+    if (ret != ABT_SUCCESS) {
+        throw runtime_error("Failed to create scheduler config");
+    }
+    xstreams.resize(xstreams_num);
+    vector<ABT_pool> stream_pools(xstreams_num);
+    for (unsigned int i = 0; i < xstreams_num; ++i) {
+        // the scheduler pops from the pools in this order
+        for (unsigned int j = 0; j < xstreams_num; ++j)
+            stream_pools[j] = pools[(i + j) % xstreams_num];
+        ABT_sched sched;
+        ret = ABT_sched_create(&stealing_sched_def, static_cast<int>(xstreams_num), stream_pools.data(), config,
+                               &sched);
+        if (ret == ABT_SUCCESS)
+            ret = ABT_xstream_create(sched, &xstreams[i]);
+        if (ret != ABT_SUCCESS) {
+            ABT_sched_config_free(&config);
+            throw runtime_error("Failed to create execution streams");
+        }
+    }
+    ABT_sched_config_free(&config);
+}
+
+/**
+ * @param fn function called by the last barrier tasklet
+ * @param arg argument of fn
+ */
+PoolBarrier::PoolBarrier(void (* fn)(void*), void* arg) : fn_(fn), arg_(arg) {}
+
+void PoolBarrier::arrive_abt(void* _arg) {
+    auto barrier = static_cast<PoolBarrier*>(_arg);
+    // the barrier may be released once the function was called, it must not be touched afterwards
+    if (barrier->pending_.fetch_sub(1) == 1)
+        barrier->fn_(barrier->arg_);
+}
+
+/**
+ * Queues a barrier tasklet in each pool. The function is not called if a tasklet cannot be created
+ * @param pools
+ * @param tasks filled with the barrier tasklets, one per pool
+ * @return ABT_SUCCESS or the Argobots error of the first tasklet that could not be created
+ */
+int PoolBarrier::post(const vector<ABT_pool>& pools, vector<ABT_task>& tasks) {
+    tasks.assign(pools.size(), ABT_TASK_NULL);
+    // one more than the barriers so that tasklets running while others are created cannot call the function
+    pending_ = pools.size() + 1;
+    for (size_t i = 0; i < pools.size(); ++i) {
+        auto abt_err = ABT_task_create(pools[i], arrive_abt, this, &tasks[i]);
+        if (abt_err != ABT_SUCCESS) {
+            tasks[i] = ABT_TASK_NULL;
+            return abt_err;
+        }
+    }
+    if (pending_.fetch_sub(1) == 1)
+        fn_(arg_);
+    return ABT_SUCCESS;
+}
+
+} // namespace scheduler
+} // namespace gkfs
@@ -0,0 +1,160 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/io_tuner.hpp>
+#include <daemon/daemon.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+/**
+ * @param pools I/O pools, one per stream. All streams are active initially
+ * @param min_xstreams lowest number of active streams
+ * @param interval_ms time between samples
+ */
+IoTuner::IoTuner(vector<ABT_pool> pools, unsigned int min_xstreams, unsigned int interval_ms) :
+        pools_(std::move(pools)), max_xstreams_(static_cast<unsigned int>(pools_.size())),
+        interval_(interval_ms), active_(max_xstreams_) {
+    min_xstreams_ = max(min(min_xstreams, max_xstreams_), 1u);
+    thread_ = thread(&IoTuner::run_, this);
+}
+
+IoTuner::~IoTuner() {
+    shutdown();
+}
+
+/**
+ * Blocks the stream it runs on until the number of deactivated streams is lowered
+ */
+void IoTuner::park_ult(void* _arg) {
+    auto tuner = static_cast<IoTuner*>(_arg);
+    unique_lock<mutex> lock(tuner->mutex_);
+    tuner->parked_++;
+    tuner->park_cv_.wait(lock, [&]() { return tuner->parked_ > tuner->park_target_ || tuner->stop_; });
+    tuner->parked_--;
+}
+
+void IoTuner::run_() {
+    unique_lock<mutex> lock(mutex_);
+    while (!stop_) {
+        stop_cv_.wait_for(lock, interval_);
+        if (stop_)
+            break;
+        lock.unlock();
+        tune_();
+        lock.lock();
+    }
+}
+
+void IoTuner::tune_() {
+    size_t waiting = 0;
+    for (auto pool : pools_) {
+        size_t size = 0;
+        ABT_pool_get_size(pool, &size);
+        waiting += size;
+    }
+    uint64_t count = latency_count_.exchange(0);
+    uint64_t sum = latency_sum_us_.exchange(0);
+    auto saturated = false;
+    double latency = 0;
+    if (count > 0) {
+        latency = static_cast<double>(sum) / static_cast<double>(count);
+        // the lowest latency is forgotten slowly, e.g., after the workload changed
+        baseline_us_ = baseline_us_ == 0 ? latency : min(latency, baseline_us_ * gkfs::config::io::autotune_decay);
+        saturated = latency > baseline_us_ * gkfs::config::io::autotune_saturation;
+    }
+    idle_rounds_ = waiting == 0 ? idle_rounds_ + 1 : 0;
+
+    auto active = this->active();
+    if (waiting > active && !saturated && active < max_xstreams_) {
+        activate_();
+    } else if (saturated || idle_rounds_ >= gkfs::config::io::autotune_idle_rounds) {
+        if (deactivate_())
+            idle_rounds_ = 0;
+    } else {
+        return;
+    }
+    GKFS_DATA->spdlogger()->debug("IoTuner::{}() waiting '{}' latency '{}us' baseline '{}us' active streams '{}'",
+                                  __func__, waiting, static_cast<uint64_t>(latency),
+                                  static_cast<uint64_t>(baseline_us_), this->active());
+}
+
+/**
+ * @return false if the lowest number of active streams is reached
+ */
+bool IoTuner::deactivate_() {
+    ABT_pool pool;
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (active_ <= min_xstreams_ || stop_)
+            return false;
+        active_--;
+        park_target_++;
+        // streams are deactivated from the last one. Any stream may pick up the ULT, e.g., if the stream was parked
+        pool = pools_[active_];
+    }
+    if (ABT_thread_create(pool, park_ult, this, ABT_THREAD_ATTR_NULL, nullptr) != ABT_SUCCESS) {
+        GKFS_DATA->spdlogger()->warn("IoTuner::{}() Failed to create parking ULT", __func__);
+        lock_guard<mutex> lock(mutex_);
+        active_++;
+        park_target_--;
+        return false;
+    }
+    return true;
+}
+
+void IoTuner::activate_() {
+    lock_guard<mutex> lock(mutex_);
+    active_++;
+    park_target_--;
+    park_cv_.notify_all();
+}
+
+/**
+ * Records the latency of a finished chunk operation
+ * @param latency
+ */
+void IoTuner::record(chrono::steady_clock::duration latency) {
+    latency_sum_us_ += static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(latency).count());
+    latency_count_++;
+}
+
+/**
+ * @return number of streams that are not deactivated
+ */
+unsigned int IoTuner::active() {
+    lock_guard<mutex> lock(mutex_);
+    return active_;
+}
+
+/**
+ * Stops tuning and activates all streams, e.g., so that they can be joined
+ */
+void IoTuner::shutdown() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (stop_)
+            return;
+        stop_ = true;
+        stop_cv_.notify_all();
+        park_cv_.notify_all();
+    }
+    thread_.join();
+}
+
+} // namespace scheduler
+} // namespace gkfs
@@ -0,0 +1,156 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/qos.hpp>
+#include <daemon/daemon.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+namespace {
+
+struct PacerArgs {
+    shared_ptr<QosScheduler> qos;
+    margo_instance_id mid;
+    double wait_ms;
+};
+
+} // namespace
+
+/**
+ * @param classes per-job shares and limits
+ * @param max_inflight maximum number of requests processed at the same time
+ * @param mid Margo instance whose handler pool runs the ULT releasing throttled requests
+ * @throws runtime_error
+ */
+QosScheduler::QosScheduler(vector<QosClass> classes, unsigned int max_inflight, margo_instance_id mid) :
+        mid_(mid), policy_(std::move(classes), max_inflight) {
+    if (margo_get_handler_pool(mid_, &pacer_pool_) != 0) {
+        throw runtime_error("Failed to get Margo's handler pool");
+    }
+    if (ABT_mutex_create(&mutex_) != ABT_SUCCESS) {
+        throw runtime_error("Failed to create mutex for the QoS scheduler");
+    }
+}
+
+QosScheduler::~QosScheduler() {
+    ABT_mutex_free(&mutex_);
+}
+
+/**
+ * Waits until the job's buckets are likely refilled and releases throttled requests
+ */
+void QosScheduler::pacer_ult(void* _arg) {
+    unique_ptr<PacerArgs> args(static_cast<PacerArgs*>(_arg));
+    margo_thread_sleep(args->mid, args->wait_ms);
+    auto& qos = *args->qos;
+    ABT_mutex_lock(qos.mutex_);
+    qos.pacer_active_ = false;
+    qos.dispatch_();
+    ABT_mutex_unlock(qos.mutex_);
+}
+
+/**
+ * Wakes the requests the policy releases. If requests remain queued because their jobs are throttled, a ULT
+ * dispatches again once the first of these jobs may continue. Must be called with the mutex held
+ */
+void QosScheduler::dispatch_() {
+    double wait;
+    for (auto id : policy_.dispatch(QosPolicy::clock::now(), wait)) {
+        auto waiter = waiters_.find(id);
+        assert(waiter != waiters_.end());
+        GKFS_DATA->spdlogger()->trace("{}() Releasing request '{}'", __func__, id);
+        ABT_eventual_set(waiter->second, nullptr, 0);
+        waiters_.erase(waiter);
+    }
+    if (wait >= 0 && !pacer_active_) {
+        auto args = new PacerArgs{shared_from_this(), mid_, max(wait * 1000.0, 1.0)};
+        if (ABT_thread_create(pacer_pool_, pacer_ult, args, ABT_THREAD_ATTR_NULL, nullptr) == ABT_SUCCESS) {
+            pacer_active_ = true;
+        } else {
+            // throttled requests are released by the next request entering or leaving
+            GKFS_DATA->spdlogger()->error("{}() Failed to create ABT thread", __func__);
+            delete args;
+        }
+    }
+}
+
+/**
+ * Waits until the request may be processed. Must be followed by leave() when the request finished
+ * @param job job id
+ * @param size requested bytes
+ */
+void QosScheduler::enter(const string& job, uint64_t size) {
+    ABT_mutex_lock(mutex_);
+    auto now = QosPolicy::clock::now();
+    auto id = policy_.enter(job, size, now);
+    if (id == 0) {
+        ABT_mutex_unlock(mutex_);
+        return;
+    }
+    ABT_eventual eventual = ABT_EVENTUAL_NULL;
+    if (ABT_eventual_create(0, &eventual) != ABT_SUCCESS) {
+        // don't hold back the request if it cannot wait
+        GKFS_DATA->spdlogger()->error("{}() Failed to create eventual. Request is not scheduled", __func__);
+        policy_.release(job, id, now);
+        ABT_mutex_unlock(mutex_);
+        return;
+    }
+    waiters_.emplace(id, eventual);
+    dispatch_();
+    ABT_mutex_unlock(mutex_);
+
+    ABT_eventual_wait(eventual, nullptr);
+    ABT_eventual_free(&eventual);
+}
+
+/**
+ * Marks a request that passed enter() as finished and releases waiting requests
+ * @param job job id
+ */
+void QosScheduler::leave(const string& job) {
+    ABT_mutex_lock(mutex_);
+    policy_.leave(job);
+    dispatch_();
+    ABT_mutex_unlock(mutex_);
+}
+
+/**
+ * @return statistics per job, see QosPolicy::stats()
+ */
+string QosScheduler::stats() {
+    ABT_mutex_lock(mutex_);
+    auto out = policy_.stats();
+    ABT_mutex_unlock(mutex_);
+    return out;
+}
+
+QosRequest::QosRequest(shared_ptr<QosScheduler> qos, string job, uint64_t size) :
+        qos_(std::move(qos)), job_(std::move(job)) {
+    if (qos_)
+        qos_->enter(job_, size);
+}
+
+QosRequest::~QosRequest() {
+    if (qos_)
+        qos_->leave(job_);
+}
+
+} // namespace scheduler
+} // namespace gkfs
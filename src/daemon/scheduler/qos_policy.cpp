@@ -0,0 +1,349 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/qos_policy.hpp>
+#include <config.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+namespace {
+
+/**
+ * @param rate tokens per second
+ * @return maximum number of tokens in a bucket
+ */
+double bucket_size(uint64_t rate) {
+    return max(static_cast<double>(rate) * gkfs::config::scheduler::qos_burst / 1000.0, 1.0);
+}
+
+/**
+ * @param value number with an optional binary suffix K, M, or G
+ * @throws runtime_error
+ */
+uint64_t parse_rate(const string& value) {
+    size_t pos = 0;
+    uint64_t rate = 0;
+    try {
+        rate = stoull(value, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0)
+        throw runtime_error(fmt::format("Invalid rate '{}'", value));
+    if (pos + 1 == value.size()) {
+        switch (value[pos]) {
+            case 'G':
+                rate *= 1024;
+                // fallthrough
+            case 'M':
+                rate *= 1024;
+                // fallthrough
+            case 'K':
+                rate *= 1024;
+                ++pos;
+                break;
+            default:
+                break;
+        }
+    }
+    if (pos != value.size())
+        throw runtime_error(fmt::format("Invalid rate '{}'", value));
+    return rate;
+}
+
+} // namespace
+
+/**
+ * @param classes per-job shares and limits
+ * @param max_inflight maximum number of requests processed at the same time
+ */
+QosPolicy::QosPolicy(vector<QosClass> classes, unsigned int max_inflight) :
+        max_inflight_(max(max_inflight, 1u)), classes_(std::move(classes)) {
+    for (const auto& qos_class : classes_) {
+        if (qos_class.job == "*")
+            default_class_ = qos_class;
+    }
+}
+
+/**
+ * @param job job id
+ * @return state of the job, created with the job's class or the default class on first use
+ */
+QosPolicy::Job& QosPolicy::job_(const string& job, clock::time_point now) {
+    auto it = jobs_.find(job);
+    if (it != jobs_.end())
+        return it->second;
+    auto& state = jobs_[job];
+    state.config = default_class_;
+    for (const auto& qos_class : classes_) {
+        if (qos_class.job == job)
+            state.config = qos_class;
+    }
+    state.config.job = job;
+    state.byte_tokens = bucket_size(state.config.bandwidth);
+    state.request_tokens = bucket_size(state.config.iops);
+    state.refilled = now;
+    return state;
+}
+
+/**
+ * Refills the job's buckets
+ * @return true if the job's buckets are not empty
+ */
+bool QosPolicy::eligible_(Job& job, clock::time_point now) {
+    auto elapsed = chrono::duration<double>(now - job.refilled).count();
+    job.refilled = now;
+    if (job.config.bandwidth > 0) {
+        job.byte_tokens = min(job.byte_tokens + elapsed * static_cast<double>(job.config.bandwidth),
+                              bucket_size(job.config.bandwidth));
+    }
+    if (job.config.iops > 0) {
+        job.request_tokens = min(job.request_tokens + elapsed * static_cast<double>(job.config.iops),
+                                 bucket_size(job.config.iops));
+    }
+    return (job.config.bandwidth == 0 || job.byte_tokens >= 0) && (job.config.iops == 0 || job.request_tokens >= 0);
+}
+
+/**
+ * Accounts a released request. A request may take more tokens than the bucket holds, the job is throttled until
+ * the debt is paid
+ */
+void QosPolicy::release_(Job& job, uint64_t size, double start_tag) {
+    if (job.config.bandwidth > 0)
+        job.byte_tokens -= static_cast<double>(size);
+    if (job.config.iops > 0)
+        job.request_tokens -= 1;
+    job.inflight++;
+    inflight_++;
+    virtual_time_ = max(virtual_time_, start_tag);
+}
+
+/**
+ * Releases a queued request of the job
+ */
+void QosPolicy::dequeue_(Job& job, deque<Request>::iterator request, clock::time_point now) {
+    job.waited += now - request->arrival;
+    release_(job, request->size, request->start_tag);
+    job.queue.erase(request);
+    queued_--;
+    if (job.queue.empty()) {
+        auto it = find(backlogged_.begin(), backlogged_.end(), &job);
+        *it = backlogged_.back();
+        backlogged_.pop_back();
+    }
+}
+
+/**
+ * Forgets the jobs without requests that did not send a request for qos_job_timeout and whose buckets are full,
+ * i.e., that would be in the same state when created again. Scans the jobs at most every half of the timeout
+ */
+void QosPolicy::prune_(clock::time_point now) {
+    auto timeout = chrono::seconds(gkfs::config::scheduler::qos_job_timeout);
+    if (now - pruned_ < timeout / 2)
+        return;
+    pruned_ = now;
+    for (auto it = jobs_.begin(); it != jobs_.end();) {
+        auto& job = it->second;
+        if (job.queue.empty() && job.inflight == 0 && now - job.active >= timeout && eligible_(job, now) &&
+            (job.config.bandwidth == 0 || job.byte_tokens >= bucket_size(job.config.bandwidth)) &&
+            (job.config.iops == 0 || job.request_tokens >= bucket_size(job.config.iops))) {
+            it = jobs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * Accounts a new request. Must be followed by leave() when the request finished
+ * @param job job id
+ * @param size requested bytes
+ * @param now
+ * @return 0 if the request may be processed now. Otherwise, the request is queued and the returned id is released
+ * by dispatch()
+ */
+uint64_t QosPolicy::enter(const string& job, uint64_t size, clock::time_point now) {
+    prune_(now);
+    auto& state = job_(job, now);
+    state.active = now;
+    state.requests++;
+    state.bytes += size;
+    auto start_tag = max(virtual_time_, state.last_finish);
+    state.last_finish = start_tag + static_cast<double>(max(size, static_cast<uint64_t>(1))) / state.config.weight;
+    auto eligible = eligible_(state, now);
+    if (queued_ == 0 && inflight_ < max_inflight_ && eligible) {
+        release_(state, size, start_tag);
+        return 0;
+    }
+    if (!eligible)
+        state.throttled++;
+    if (state.queue.empty())
+        backlogged_.push_back(&state);
+    state.queue.push_back(Request{++last_id_, size, start_tag, now});
+    queued_++;
+    return last_id_;
+}
+
+/**
+ * Marks a request that was released as finished. Waiting requests may be released by the next dispatch()
+ * @param job job id
+ */
+void QosPolicy::leave(const string& job) {
+    auto it = jobs_.find(job);
+    if (it != jobs_.end())
+        it->second.inflight--;
+    inflight_--;
+}
+
+/**
+ * Releases a queued request regardless of its job's share and limits, e.g., if it cannot wait
+ * @param job job id
+ * @param id id returned by enter()
+ * @param now
+ */
+void QosPolicy::release(const string& job, uint64_t id, clock::time_point now) {
+    auto it = jobs_.find(job);
+    if (it == jobs_.end())
+        return;
+    auto& queue = it->second.queue;
+    auto request = find_if(queue.begin(), queue.end(), [id](const Request& r) { return r.id == id; });
+    if (request != queue.end())
+        dequeue_(it->second, request, now);
+}
+
+/**
+ * Releases the waiting requests with the lowest start tag among the jobs that are not throttled while fewer than
+ * max_inflight requests are processed
+ * @param now
+ * @param wait set to the time in seconds until the first throttled job may continue if requests remain queued only
+ * because their jobs are throttled, otherwise negative
+ * @return ids of the released requests in the order they were released
+ */
+vector<uint64_t> QosPolicy::dispatch(clock::time_point now, double& wait) {
+    vector<uint64_t> released;
+    wait = -1;
+    while (inflight_ < max_inflight_ && queued_ > 0) {
+        Job* next = nullptr;
+        wait = -1;
+        for (auto job_ptr : backlogged_) {
+            auto& job = *job_ptr;
+            if (!eligible_(job, now)) {
+                double job_wait = 0;
+                if (job.config.bandwidth > 0 && job.byte_tokens < 0)
+                    job_wait = -job.byte_tokens / static_cast<double>(job.config.bandwidth);
+                if (job.config.iops > 0 && job.request_tokens < 0)
+                    job_wait = max(job_wait, -job.request_tokens / static_cast<double>(job.config.iops));
+                if (wait < 0 || job_wait < wait)
+                    wait = job_wait;
+                continue;
+            }
+            if (next == nullptr || job.queue.front().start_tag < next->queue.front().start_tag)
+                next = &job;
+        }
+        if (next == nullptr)
+            break;
+        wait = -1;
+        released.push_back(next->queue.front().id);
+        dequeue_(*next, next->queue.begin(), now);
+    }
+    return released;
+}
+
+size_t QosPolicy::queued() const {
+    return queued_;
+}
+
+unsigned int QosPolicy::inflight() const {
+    return inflight_;
+}
+
+size_t QosPolicy::jobs() const {
+    return jobs_.size();
+}
+
+/**
+ * @return a line per job that sent requests and was not forgotten: job id, weight, bandwidth and iops limits, requests, bytes, throttled
+ * requests, waiting and processed requests, and total time requests waited in milliseconds
+ */
+string QosPolicy::stats() const {
+    string out = "job weight bandwidth iops requests bytes throttled queued inflight waited_ms\n";
+    for (const auto& entry : jobs_) {
+        const auto& job = entry.second;
+        out += fmt::format("{} {} {} {} {} {} {} {} {} {}\n", job.config.job.empty() ? "-" : job.config.job,
+                           job.config.weight, job.config.bandwidth, job.config.iops, job.requests, job.bytes,
+                           job.throttled, job.queue.size(), job.inflight,
+                           chrono::duration_cast<chrono::milliseconds>(job.waited).count());
+    }
+    return out;
+}
+
+/**
+ * Parses a comma-separated list of classes JOB:WEIGHT[:BANDWIDTH[:IOPS]], e.g., "ckpt:1:2G,viz:4". BANDWIDTH is
+ * given in bytes/s with an optional suffix K, M, or G. 0 or a missing limit is unlimited
+ * @param spec
+ * @return classes
+ * @throws runtime_error
+ */
+vector<QosClass> QosPolicy::parse_classes(const string& spec) {
+    vector<QosClass> classes;
+    size_t begin = 0;
+    while (begin < spec.size()) {
+        auto end = spec.find(',', begin);
+        if (end == string::npos)
+            end = spec.size();
+        auto entry = spec.substr(begin, end - begin);
+        begin = end + 1;
+        vector<string> fields;
+        size_t field_begin = 0;
+        while (true) {
+            auto field_end = entry.find(':', field_begin);
+            fields.push_back(entry.substr(field_begin, field_end - field_begin));
+            if (field_end == string::npos)
+                break;
+            field_begin = field_end + 1;
+        }
+        if (fields.size() < 2 || fields.size() > 4 || fields[0].empty())
+            throw runtime_error(fmt::format("Invalid QoS class '{}'", entry));
+        QosClass qos_class{};
+        qos_class.job = fields[0];
+        size_t pos = 0;
+        try {
+            qos_class.weight = stod(fields[1], &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos == 0 || pos != fields[1].size() || !(qos_class.weight > 0))
+            throw runtime_error(fmt::format("Invalid weight in QoS class '{}'", entry));
+        if (fields.size() > 2)
+            qos_class.bandwidth = parse_rate(fields[2]);
+        if (fields.size() > 3)
+            qos_class.iops = parse_rate(fields[3]);
+        for (const auto& other : classes) {
+            if (other.job == qos_class.job)
+                throw runtime_error(fmt::format("Duplicate QoS class for job '{}'", qos_class.job));
+        }
+        classes.push_back(qos_class);
+    }
+    return classes;
+}
+
+} // namespace scheduler
+} // namespace gkfs
@@ -0,0 +1,158 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/request_queue.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+RequestQueue::RequestQueue(Policy policy, unsigned int max_inflight, unsigned int deadline_ms) :
+        policy_(policy), max_inflight_(max(max_inflight, 1u)), deadline_(deadline_ms) {}
+
+Policy RequestQueue::policy() const {
+    return policy_;
+}
+
+/**
+ * Selects the queued requests to release next. Must be called with a non-empty queue
+ * @param now
+ * @return iterators to the selected requests
+ */
+vector<list<Request*>::iterator> RequestQueue::pick_(chrono::steady_clock::time_point now) {
+    auto oldest = queue_.begin();
+    switch (policy_) {
+        case Policy::aggregation: {
+            // requests of the same file and type as the oldest one, in offset order
+            vector<list<Request*>::iterator> candidates;
+            for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                if ((*it)->type == (*oldest)->type && (*it)->path == (*oldest)->path)
+                    candidates.push_back(it);
+            }
+            stable_sort(candidates.begin(), candidates.end(),
+                        [](const list<Request*>::iterator& a, const list<Request*>::iterator& b) {
+                            return (*a)->offset < (*b)->offset;
+                        });
+            auto pos = static_cast<size_t>(find(candidates.begin(), candidates.end(), oldest) - candidates.begin());
+            // grow a contiguous range around the oldest request
+            auto first = pos;
+            auto last = pos;
+            auto range_begin = (*oldest)->offset;
+            auto range_end = (*oldest)->offset + (*oldest)->size;
+            while (last + 1 < candidates.size() && (*candidates[last + 1])->offset <= range_end) {
+                ++last;
+                range_end = max(range_end, (*candidates[last])->offset + (*candidates[last])->size);
+            }
+            while (first > 0 && (*candidates[first - 1])->offset + (*candidates[first - 1])->size >= range_begin) {
+                --first;
+                range_begin = (*candidates[first])->offset;
+            }
+            return vector<list<Request*>::iterator>(candidates.begin() + first, candidates.begin() + last + 1);
+        }
+        case Policy::deadline: {
+            if (now - (*oldest)->arrival >= deadline_)
+                return {oldest};
+            // continue after the last released request in its file, otherwise start at the lowest offset of the
+            // file of the oldest request
+            auto next = queue_.end();
+            for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                if ((*it)->path == last_path_ && (*it)->offset >= last_end_ &&
+                    (next == queue_.end() || (*it)->offset < (*next)->offset))
+                    next = it;
+            }
+            if (next == queue_.end()) {
+                next = oldest;
+                for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                    if ((*it)->path == (*oldest)->path && (*it)->offset < (*next)->offset)
+                        next = it;
+                }
+            }
+            return {next};
+        }
+        default:
+            return {oldest};
+    }
+}
+
+/**
+ * Accounts a released request
+ */
+void RequestQueue::release_(const Request& request) {
+    inflight_++;
+    last_path_ = request.path;
+    last_end_ = request.offset + request.size;
+}
+
+/**
+ * Accounts a new request. Must be followed by leave() when the request finished
+ * @param request
+ * @return true if the request may be processed now. Otherwise, the request is queued until dispatch() releases it
+ */
+bool RequestQueue::enter(Request* request) {
+    if (queue_.empty() && inflight_ < max_inflight_) {
+        release_(*request);
+        return true;
+    }
+    queue_.push_back(request);
+    return false;
+}
+
+/**
+ * Marks a request that was released as finished. Queued requests may be released by the next dispatch()
+ */
+void RequestQueue::leave() {
+    inflight_--;
+}
+
+/**
+ * Releases a queued request regardless of the policy, e.g., if it cannot wait
+ * @param request
+ */
+void RequestQueue::release(Request* request) {
+    auto it = find(queue_.begin(), queue_.end(), request);
+    if (it == queue_.end())
+        return;
+    queue_.erase(it);
+    inflight_++;
+}
+
+/**
+ * Releases queued requests while fewer than max_inflight requests are processed
+ * @param now
+ * @return the released requests in the order they were released
+ */
+vector<Request*> RequestQueue::dispatch(chrono::steady_clock::time_point now) {
+    vector<Request*> released;
+    while (inflight_ < max_inflight_ && !queue_.empty()) {
+        for (auto& it : pick_(now)) {
+            release_(**it);
+            released.push_back(*it);
+            queue_.erase(it);
+        }
+    }
+    return released;
+}
+
+size_t RequestQueue::queued() const {
+    return queue_.size();
+}
+
+unsigned int RequestQueue::inflight() const {
+    return inflight_;
+}
+
+} // namespace scheduler
+} // namespace gkfs
@@ -0,0 +1,182 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/scheduler/scheduler.hpp>
+#include <daemon/daemon.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gkfs {
+namespace scheduler {
+
+RequestScheduler::RequestScheduler(Policy policy, unsigned int max_inflight, unsigned int deadline_ms) :
+        queue_(policy, max_inflight, deadline_ms) {
+    if (ABT_mutex_create(&mutex_) != ABT_SUCCESS) {
+        throw runtime_error("Failed to create mutex for the request scheduler");
+    }
+}
+
+RequestScheduler::~RequestScheduler() {
+    ABT_mutex_free(&mutex_);
+}
+
+Policy RequestScheduler::policy() const {
+    return queue_.policy();
+}
+
+/**
+ * Wakes the requests the queue releases. Must be called with the mutex held
+ */
+void RequestScheduler::dispatch_() {
+    for (auto request : queue_.dispatch(chrono::steady_clock::now())) {
+        GKFS_DATA->spdlogger()->trace("{}() Releasing request path '{}' offset '{}' size '{}'", __func__,
+                                      request->path, request->offset, request->size);
+        ABT_eventual_set(static_cast<Waiter*>(request)->eventual, nullptr, 0);
+    }
+}
+
+/**
+ * Waits until the request may be processed. Must be followed by leave() when the request finished
+ * @param path
+ * @param type
+ * @param offset file offset of the request
+ * @param size
+ */
+void RequestScheduler::enter(const string& path, RequestType type, uint64_t offset, uint64_t size) {
+    if (queue_.policy() == Policy::none)
+        return;
+    Waiter waiter{};
+    waiter.path = path;
+    waiter.type = type;
+    waiter.offset = offset;
+    waiter.size = size;
+    waiter.eventual = ABT_EVENTUAL_NULL;
+    ABT_mutex_lock(mutex_);
+    waiter.arrival = chrono::steady_clock::now();
+    if (queue_.enter(&waiter)) {
+        ABT_mutex_unlock(mutex_);
+        return;
+    }
+    if (ABT_eventual_create(0, &waiter.eventual) != ABT_SUCCESS) {
+        // don't hold back the request if it cannot wait
+        GKFS_DATA->spdlogger()->error("{}() Failed to create eventual. Request is not scheduled", __func__);
+        queue_.release(&waiter);
+        ABT_mutex_unlock(mutex_);
+        return;
+    }
+    dispatch_();
+    ABT_mutex_unlock(mutex_);
+
+    ABT_eventual_wait(waiter.eventual, nullptr);
+    ABT_eventual_free(&waiter.eventual);
+}
+
+/**
+ * Marks a request that passed enter() as finished and releases queued requests
+ */
+void RequestScheduler::leave() {
+    if (queue_.policy() == Policy::none)
+        return;
+    ABT_mutex_lock(mutex_);
+    queue_.leave();
+    dispatch_();
+    ABT_mutex_unlock(mutex_);
+}
+
+/**
+ * @param name
+ * @return policy for the name
+ * @throws runtime_error if the name is unknown
+ */
+Policy RequestScheduler::parse_policy(const string& name) {
+    if (name == "none")
+        return Policy::none;
+    if (name == "fifo")
+        return Policy::fifo;
+    if (name == "aggregation")
+        return Policy::aggregation;
+    if (name == "deadline")
+        return Policy::deadline;
+    throw runtime_error("Unknown I/O scheduling policy '"s + name + "'");
+}
+
+string RequestScheduler::policy_name(Policy policy) {
+    switch (policy) {
+        case Policy::fifo:
+            return "fifo";
+        case Policy::aggregation:
+            return "aggregation";
+        case Policy::deadline:
+            return "deadline";
+        default:
+            return "none";
+    }
+}
+
+/**
+ * Accounts a request that arrived at the data path
+ * @param size requested bytes
+ */
+void LoadStats::begin(uint64_t size) {
+    active_requests_++;
+    bytes_ += size;
+}
+
+void LoadStats::end() {
+    active_requests_--;
+}
+
+/**
+ * @return number of read and write requests that are queued or processed
+ */
+uint64_t LoadStats::queue_depth() const {
+    return active_requests_;
+}
+
+/**
+ * @return requested bytes per second over the last completed window
+ */
+uint64_t LoadStats::bytes_per_sec() {
+    lock_guard<mutex> lock(rate_mutex_);
+    auto now = chrono::steady_clock::now();
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(now - window_start_).count();
+    if (elapsed >= gkfs::config::scheduler::load_window) {
+        uint64_t bytes = bytes_;
+        bytes_per_sec_ = (bytes - window_bytes_) * 1000 / static_cast<uint64_t>(elapsed);
+        window_bytes_ = bytes;
+        window_start_ = now;
+    }
+    return bytes_per_sec_;
+}
+
+ScheduledRequest::ScheduledRequest(shared_ptr<RequestScheduler> scheduler, shared_ptr<LoadStats> load,
+                                   const string& path, RequestType type, uint64_t offset, uint64_t size) :
+        scheduler_(std::move(scheduler)), load_(std::move(load)) {
+    if (load_)
+        load_->begin(size);
+    if (scheduler_)
+        scheduler_->enter(path, type, offset, size);
+}
+
+ScheduledRequest::~ScheduledRequest() {
+    if (scheduler_)
+        scheduler_->leave();
+    if (load_)
+        load_->end();
+}
+
+} // namespace scheduler
+} // namespace gkfs
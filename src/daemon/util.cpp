@@ -17,6 +17,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -43,5 +44,44 @@ void destroy_hosts_file() {
     std::remove(GKFS_DATA->hosts_file().c_str());
 }
 
+/**
+ * Returns the address of another daemon. Host ids are the line numbers in the hosts file, as used by the clients.
+ * Addresses are looked up once and then cached.
+ * @param host_id
+ * @return address of the daemon
+ * @throws std::runtime_error if the host is not in the hosts file or its address cannot be looked up
+ */
+hg_addr_t lookup_peer_addr(uint64_t host_id) {
+    auto addr = RPC_DATA->peer_addr(host_id);
+    if (addr != HG_ADDR_NULL)
+        return addr;
+
+    const auto& hosts_file = GKFS_DATA->hosts_file();
+    if (hosts_file.empty())
+        throw runtime_error("Daemon was started without hosts file");
+    ifstream lf(hosts_file);
+    if (!lf)
+        throw runtime_error(fmt::format("Failed to open hosts file '{}': {}", hosts_file, strerror(errno)));
+    string line;
+    uint64_t line_nr = 0;
+    while (line_nr <= host_id && getline(lf, line))
+        ++line_nr;
+    if (line_nr <= host_id)
+        throw runtime_error(fmt::format("Host id '{}' not found in hosts file '{}'", host_id, hosts_file));
+
+    string hostname;
+    string uri;
+    istringstream iss(line);
+    if (!(iss >> hostname >> uri))
+        throw runtime_error(fmt::format("Unrecognized line format in hosts file: '{}'", line));
+
+    GKFS_DATA->spdlogger()->debug("{}() Looking up host id '{}' uri '{}'", __func__, host_id, uri);
+    auto ret = margo_addr_lookup(RPC_DATA->server_rpc_mid(), uri.c_str(), &addr);
+    if (ret != HG_SUCCESS)
+        throw runtime_error(fmt::format("Failed to lookup address '{}' with err '{}'", uri, ret));
+    RPC_DATA->peer_addr(host_id, addr);
+    return RPC_DATA->peer_addr(host_id);
+}
+
 } // namespace util
 } // namespace gkfs
@@ -23,6 +23,7 @@ extern "C" {
 
 #include <ctime>
 #include <cassert>
+#include <cctype>
 
 namespace gkfs {
 namespace metadata {
@@ -36,7 +37,10 @@ Metadata::Metadata(const mode_t mode) :
         mode_(mode),
         link_count_(0),
         size_(0),
-        blocks_(0) {
+        blocks_(0),
+        stripe_count_(0),
+        stripe_size_(0),
+        stripe_start_(0) {
     assert(S_ISDIR(mode_) || S_ISREG(mode_));
 }
 
@@ -50,6 +54,9 @@ Metadata::Metadata(const mode_t mode, const std::string& target_path) :
         link_count_(0),
         size_(0),
         blocks_(0),
+        stripe_count_(0),
+        stripe_size_(0),
+        stripe_start_(0),
         target_path_(target_path) {
     assert(S_ISLNK(mode_) || S_ISDIR(mode_) || S_ISREG(mode_));
     // target_path should be there only if this is a link
@@ -60,7 +67,10 @@ Metadata::Metadata(const mode_t mode, const std::string& target_path) :
 
 #endif
 
-Metadata::Metadata(const std::string& binary_str) {
+Metadata::Metadata(const std::string& binary_str) :
+        stripe_count_(0),
+        stripe_size_(0),
+        stripe_start_(0) {
     size_t read = 0;
 
     auto ptr = binary_str.data();
@@ -102,12 +112,30 @@ Metadata::Metadata(const std::string& binary_str) {
         assert(read > 0);
         ptr += read;
     }
-    if (gkfs::config::metadata::use_blocks) { // last one will not encounter a delimiter anymore
+    if (gkfs::config::metadata::use_blocks) {
         assert(*ptr == MSP);
         blocks_ = static_cast<blkcnt_t>(std::stoul(++ptr, &read));
         assert(read > 0);
         ptr += read;
     }
+    /*
+     * Entries written before stripe layouts were stored end here or continue with the symlink target, which is empty
+     * or absolute. They keep the default layout
+     */
+    auto has_stripe_layout = *ptr == MSP && std::isdigit(static_cast<unsigned char>(ptr[1]));
+    if (gkfs::config::metadata::use_stripe_layout && has_stripe_layout) {
+        stripe_count_ = static_cast<unsigned int>(std::stoul(++ptr, &read));
+        assert(read > 0);
+        ptr += read;
+        assert(*ptr == MSP);
+        stripe_size_ = static_cast<size_t>(std::stoul(++ptr, &read));
+        assert(read > 0);
+        ptr += read;
+        assert(*ptr == MSP);
+        stripe_start_ = static_cast<unsigned int>(std::stoul(++ptr, &read));
+        assert(read > 0);
+        ptr += read;
+    }
 
 #ifdef HAS_SYMLINKS
     // Read target_path
@@ -148,6 +176,14 @@ std::string Metadata::serialize() const {
         s += MSP;
         s += fmt::format_int(blocks_).c_str();
     }
+    if (gkfs::config::metadata::use_stripe_layout) {
+        s += MSP;
+        s += fmt::format_int(stripe_count_).c_str();
+        s += MSP;
+        s += fmt::format_int(stripe_size_).c_str();
+        s += MSP;
+        s += fmt::format_int(stripe_start_).c_str();
+    }
 
 #ifdef HAS_SYMLINKS
     s += MSP;
@@ -234,6 +270,30 @@ void Metadata::blocks(blkcnt_t blocks) {
     Metadata::blocks_ = blocks;
 }
 
+unsigned int Metadata::stripe_count() const {
+    return stripe_count_;
+}
+
+void Metadata::stripe_count(unsigned int stripe_count) {
+    Metadata::stripe_count_ = stripe_count;
+}
+
+size_t Metadata::stripe_size() const {
+    return stripe_size_;
+}
+
+void Metadata::stripe_size(size_t stripe_size) {
+    Metadata::stripe_size_ = stripe_size;
+}
+
+unsigned int Metadata::stripe_start() const {
+    return stripe_start_;
+}
+
+void Metadata::stripe_start(unsigned int stripe_start) {
+    Metadata::stripe_start_ = stripe_start;
+}
+
 #ifdef HAS_SYMLINKS
 
 std::string Metadata::target_path() const {
@@ -12,6 +12,9 @@
 */
 
 #include <global/rpc/distributor.hpp>
+#include <config.hpp>
+
+#include <algorithm>
 
 using namespace std;
 
@@ -36,6 +39,18 @@ locate_data(const string& path, const chunkid_t& chnk_id) const {
     return str_hash(path + ::to_string(chnk_id)) % hosts_size_;
 }
 
+host_t SimpleHashDistributor::
+locate_data(const string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const {
+    if (layout.is_default()) {
+        return locate_data(path, chnk_id);
+    }
+    // number of consecutive chunks that are placed on the same host
+    auto stripe_chunks = std::max<size_t>(1, layout.stripe_size / gkfs::config::rpc::chunksize);
+    auto stripe_count = std::min(layout.stripe_count, hosts_size_);
+    auto stripe_unit = chnk_id / stripe_chunks;
+    return (layout.start_host + stripe_unit % stripe_count) % hosts_size_;
+}
+
 host_t SimpleHashDistributor::
 locate_file_metadata(const string& path) const {
     return str_hash(path) % hosts_size_;
@@ -58,6 +73,11 @@ locate_data(const string& path, const chunkid_t& chnk_id) const {
     return localhost_;
 }
 
+host_t LocalOnlyDistributor::
+locate_data(const string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const {
+    return localhost_;
+}
+
 host_t LocalOnlyDistributor::
 locate_file_metadata(const string& path) const {
     return localhost_;
@@ -68,11 +88,53 @@ locate_directory_metadata(const string& path) const {
     return {localhost_};
 }
 
+/**
+ * Pins the path to the host unless it is pinned already
+ * @param path
+ * @param host
+ */
+void ForwarderPins::pin(const std::string& path, host_t host) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = pins_.find(path);
+    if (it == pins_.end()) {
+        pins_.emplace(path, make_pair(host, 1u));
+        size_ = pins_.size();
+    } else {
+        it->second.second++;
+    }
+}
+
+void ForwarderPins::unpin(const std::string& path) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = pins_.find(path);
+    if (it != pins_.end() && --it->second.second == 0) {
+        pins_.erase(it);
+        size_ = pins_.size();
+    }
+}
+
+/**
+ * @param path
+ * @param host set to the pinned forwarder
+ * @return true if the path is pinned
+ */
+bool ForwarderPins::lookup(const std::string& path, host_t& host) const {
+    if (size_ == 0)
+        return false;
+    lock_guard<mutex> lock(mutex_);
+    auto it = pins_.find(path);
+    if (it == pins_.end())
+        return false;
+    host = it->second.first;
+    return true;
+}
+
 ForwarderDistributor::
-ForwarderDistributor(host_t fwhost, unsigned int hosts_size) :
+ForwarderDistributor(host_t fwhost, unsigned int hosts_size, std::shared_ptr<ForwarderPins> pins) :
         fwd_host_(fwhost),
         hosts_size_(hosts_size),
-        all_hosts_(hosts_size) {
+        all_hosts_(hosts_size),
+        pins_(std::move(pins)) {
     ::iota(all_hosts_.begin(), all_hosts_.end(), 0);
 }
 
@@ -83,9 +145,17 @@ localhost() const {
 
 host_t ForwarderDistributor::
 locate_data(const std::string& path, const chunkid_t& chnk_id) const {
+    host_t host;
+    if (pins_ && pins_->lookup(path, host))
+        return host;
     return fwd_host_;
 }
 
+host_t ForwarderDistributor::
+locate_data(const std::string& path, const chunkid_t& chnk_id, const StripeLayout& layout) const {
+    return locate_data(path, chnk_id);
+}
+
 host_t ForwarderDistributor::
 locate_file_metadata(const std::string& path) const {
     return str_hash(path) % hosts_size_;
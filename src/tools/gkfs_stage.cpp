@@ -0,0 +1,522 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+/*
+ * gkfs_stage copies a directory tree into GekkoFS (stage-in) or out of it (stage-out) without going through the
+ * interception library. Metadata is created with batched RPCs, and file contents are split into chunk-aligned
+ * transfers that are processed by a pool of threads. Each transfer is sent directly to the daemons owning its chunks.
+ *
+ * Usage: gkfs_stage [-t threads] [-c chunks] in <local_path> <gkfs_path>
+ *        gkfs_stage [-t threads] [-c chunks] out <gkfs_path> <local_path>
+ * GekkoFS paths are given relative to the GekkoFS root, e.g., /dataset. The hosts file is taken from the
+ * environment as for the interception library.
+ */
+
+#include <config.hpp>
+#include <client/user_functions.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// Same layout as returned by gkfs_getdents64()
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+namespace {
+
+// upper bound of files with open descriptors at the same time
+constexpr size_t max_open_files = 512;
+constexpr size_t dirents_buf_size = 1024 * 1024;
+
+struct StageFile {
+    string src;
+    string dst;
+    size_t size;
+    mode_t mode;
+};
+
+struct Transfer {
+    size_t file;
+    off64_t offset;
+    size_t count;
+};
+
+struct Stats {
+    atomic<size_t> bytes{0};
+    size_t files{0};
+    size_t dirs{0};
+};
+
+string join(const string& dir, const string& name) {
+    if (!dir.empty() && dir.back() == '/')
+        return dir + name;
+    return dir + '/' + name;
+}
+
+string strip_trailing_slashes(string path) {
+    while (path.size() > 1 && path.back() == '/')
+        path.pop_back();
+    return path;
+}
+
+/**
+ * Runs fn(i) for all i in [0, n) on the given number of threads. Stops handing out work after the first error.
+ * @param n
+ * @param threads
+ * @param fn returns 0 on success or an errno
+ * @return first error, 0 on success
+ */
+int parallel_for(size_t n, unsigned int threads, const function<int(size_t)>& fn) {
+    atomic<size_t> next{0};
+    atomic<int> err{0};
+    auto worker = [&]() {
+        while (err.load() == 0) {
+            auto i = next.fetch_add(1);
+            if (i >= n)
+                return;
+            auto ret = fn(i);
+            if (ret != 0) {
+                int expected = 0;
+                err.compare_exchange_strong(expected, ret);
+            }
+        }
+    };
+    threads = static_cast<unsigned int>(min<size_t>(threads, n));
+    vector<thread> pool{};
+    for (unsigned int t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    return err.load();
+}
+
+/**
+ * Splits all files into transfers. Transfers start at chunk boundaries so that no chunk is written by two threads.
+ */
+vector<Transfer> make_transfers(const vector<StageFile>& files, size_t first, size_t last, size_t transfer_size) {
+    vector<Transfer> transfers{};
+    for (auto i = first; i < last; ++i) {
+        for (size_t off = 0; off < files[i].size; off += transfer_size) {
+            transfers.push_back({i, static_cast<off64_t>(off), min(transfer_size, files[i].size - off)});
+        }
+    }
+    return transfers;
+}
+
+/**
+ * Creates GekkoFS entries with one batched create per call. If the batch fails, e.g., because some entries already
+ * exist, the entries are created one by one and existing entries are accepted.
+ */
+int create_batch(const vector<string>& paths, mode_t mode) {
+    if (paths.empty() || gkfs::syscall::gkfs_create_batch(paths, mode) == 0)
+        return 0;
+    for (const auto& path : paths) {
+        if (gkfs::syscall::gkfs_create(path, mode) != 0 && errno != EEXIST) {
+            cerr << "Error creating '" << path << "': " << strerror(errno) << endl;
+            return errno;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Stage-in
+ */
+
+int walk_local(const string& src, const string& dst, unsigned int depth, vector<vector<string>>& dirs,
+               vector<StageFile>& files) {
+    struct stat st{};
+    if (lstat(src.c_str(), &st) != 0) {
+        cerr << "Error accessing '" << src << "': " << strerror(errno) << endl;
+        return errno;
+    }
+    if (S_ISREG(st.st_mode)) {
+        files.push_back({src, dst, static_cast<size_t>(st.st_size), st.st_mode & 0777});
+        return 0;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        cerr << "Skipping '" << src << "': not a regular file or directory" << endl;
+        return 0;
+    }
+    if (dirs.size() <= depth)
+        dirs.resize(depth + 1);
+    dirs[depth].push_back(dst);
+    auto dp = opendir(src.c_str());
+    if (dp == nullptr) {
+        cerr << "Error opening directory '" << src << "': " << strerror(errno) << endl;
+        return errno;
+    }
+    int err = 0;
+    struct dirent* de;
+    while (err == 0 && (de = readdir(dp)) != nullptr) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+            continue;
+        err = walk_local(join(src, de->d_name), join(dst, de->d_name), depth + 1, dirs, files);
+    }
+    closedir(dp);
+    return err;
+}
+
+int stage_in_data(const vector<StageFile>& files, unsigned int threads, size_t transfer_size, Stats& stats) {
+    // descriptors are opened for a window of files at a time to stay within the process' file limit
+    for (size_t first = 0; first < files.size(); first += max_open_files) {
+        auto last = min(files.size(), first + max_open_files);
+        vector<int> src_fds(last - first, -1);
+        vector<int> dst_fds(last - first, -1);
+        auto err = parallel_for(last - first, threads, [&](size_t i) {
+            const auto& f = files[first + i];
+            src_fds[i] = open(f.src.c_str(), O_RDONLY);
+            if (src_fds[i] < 0) {
+                cerr << "Error opening '" << f.src << "': " << strerror(errno) << endl;
+                return errno;
+            }
+            // a restaged file may have shrunk since it was staged before
+            dst_fds[i] = gkfs::syscall::gkfs_open(f.dst, 0, O_WRONLY | O_TRUNC);
+            if (dst_fds[i] < 0) {
+                cerr << "Error opening GekkoFS file '" << f.dst << "': " << strerror(errno) << endl;
+                return errno;
+            }
+            return 0;
+        });
+        if (err == 0) {
+            auto transfers = make_transfers(files, first, last, transfer_size);
+            err = parallel_for(transfers.size(), threads, [&](size_t i) {
+                thread_local vector<char> buf{};
+                buf.resize(transfer_size);
+                const auto& t = transfers[i];
+                const auto& f = files[t.file];
+                size_t done = 0;
+                while (done < t.count) {
+                    auto ret = pread(src_fds[t.file - first], buf.data() + done, t.count - done, t.offset + done);
+                    if (ret < 0 && errno == EINTR)
+                        continue;
+                    if (ret <= 0) {
+                        cerr << "Error reading '" << f.src << "': " << (ret < 0 ? strerror(errno) : "file shrunk")
+                             << endl;
+                        return ret < 0 ? errno : EIO;
+                    }
+                    done += ret;
+                }
+                auto ret = gkfs::syscall::gkfs_pwrite_ws(dst_fds[t.file - first], buf.data(), t.count, t.offset);
+                if (ret != static_cast<ssize_t>(t.count)) {
+                    cerr << "Error writing GekkoFS file '" << f.dst << "': "
+                         << (ret < 0 ? strerror(errno) : "short write") << endl;
+                    return ret < 0 ? errno : EIO;
+                }
+                stats.bytes += t.count;
+                return 0;
+            });
+        }
+        for (size_t i = 0; i < src_fds.size(); ++i) {
+            if (src_fds[i] >= 0)
+                close(src_fds[i]);
+            if (dst_fds[i] >= 0)
+                gkfs::syscall::gkfs_close(dst_fds[i]);
+        }
+        if (err != 0)
+            return err;
+    }
+    return 0;
+}
+
+int stage_in(const string& src, const string& dst, unsigned int threads, size_t transfer_size, Stats& stats) {
+    vector<vector<string>> dirs{};
+    vector<StageFile> files{};
+    auto err = walk_local(strip_trailing_slashes(src), strip_trailing_slashes(dst), 0, dirs, files);
+    if (err != 0)
+        return err;
+
+    // parents must exist before their children are created, thus directories are created level by level
+    for (const auto& level : dirs) {
+        err = create_batch(level, S_IFDIR | 0755);
+        if (err != 0)
+            return err;
+        stats.dirs += level.size();
+    }
+    map<mode_t, vector<string>> files_by_mode{};
+    for (const auto& f : files)
+        files_by_mode[f.mode].push_back(f.dst);
+    for (const auto& entry : files_by_mode) {
+        err = create_batch(entry.second, S_IFREG | entry.first);
+        if (err != 0)
+            return err;
+    }
+    stats.files = files.size();
+
+    return stage_in_data(files, threads, transfer_size, stats);
+}
+
+/*
+ * Stage-out
+ */
+
+int walk_gkfs(const string& src, const string& dst, vector<string>& dirs, vector<StageFile>& files) {
+    struct stat st{};
+    if (gkfs::syscall::gkfs_stat(src, &st) != 0) {
+        cerr << "Error accessing GekkoFS path '" << src << "': " << strerror(errno) << endl;
+        return errno;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        files.push_back({src, dst, static_cast<size_t>(st.st_size), st.st_mode & 0777});
+        return 0;
+    }
+    dirs.push_back(dst);
+    auto fd = gkfs::syscall::gkfs_opendir(src);
+    if (fd < 0) {
+        cerr << "Error opening GekkoFS directory '" << src << "': " << strerror(errno) << endl;
+        return errno;
+    }
+    vector<pair<string, bool>> entries{};
+    vector<char> buf(dirents_buf_size);
+    int nread;
+    while ((nread = gkfs::syscall::gkfs_getdents64(fd, reinterpret_cast<struct linux_dirent64*>(buf.data()),
+                                                   buf.size())) > 0) {
+        for (int pos = 0; pos < nread;) {
+            auto de = reinterpret_cast<struct linux_dirent64*>(buf.data() + pos);
+            entries.emplace_back(de->d_name, de->d_type == DT_DIR);
+            pos += de->d_reclen;
+        }
+    }
+    auto err = nread < 0 ? errno : 0;
+    gkfs::syscall::gkfs_close(fd);
+    if (err != 0) {
+        cerr << "Error reading GekkoFS directory '" << src << "': " << strerror(err) << endl;
+        return err;
+    }
+
+    // files of one directory are stat'ed with a single batched lookup
+    vector<string> file_paths{};
+    for (const auto& e : entries) {
+        if (e.second) {
+            err = walk_gkfs(join(src, e.first), join(dst, e.first), dirs, files);
+            if (err != 0)
+                return err;
+        } else {
+            file_paths.push_back(join(src, e.first));
+        }
+    }
+    if (file_paths.empty())
+        return 0;
+    vector<struct stat> bufs{};
+    vector<int> errs{};
+    if (gkfs::syscall::gkfs_stat_batch(file_paths, bufs, errs) != 0) {
+        cerr << "Error stat'ing files in GekkoFS directory '" << src << "': " << strerror(errno) << endl;
+        return errno;
+    }
+    for (size_t i = 0; i < file_paths.size(); ++i) {
+        if (errs[i] != 0) {
+            // removed in the meantime
+            cerr << "Skipping GekkoFS file '" << file_paths[i] << "': " << strerror(errs[i]) << endl;
+            continue;
+        }
+        auto name = file_paths[i].substr(file_paths[i].rfind('/') + 1);
+        files.push_back({file_paths[i], join(dst, name), static_cast<size_t>(bufs[i].st_size),
+                         bufs[i].st_mode & 0777});
+    }
+    return 0;
+}
+
+int stage_out_data(const vector<StageFile>& files, unsigned int threads, size_t transfer_size, Stats& stats) {
+    for (size_t first = 0; first < files.size(); first += max_open_files) {
+        auto last = min(files.size(), first + max_open_files);
+        vector<int> src_fds(last - first, -1);
+        vector<int> dst_fds(last - first, -1);
+        auto err = parallel_for(last - first, threads, [&](size_t i) {
+            const auto& f = files[first + i];
+            src_fds[i] = gkfs::syscall::gkfs_open(f.src, 0, O_RDONLY);
+            if (src_fds[i] < 0) {
+                cerr << "Error opening GekkoFS file '" << f.src << "': " << strerror(errno) << endl;
+                return errno;
+            }
+            dst_fds[i] = open(f.dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, f.mode);
+            // the file is sized up front so that transfers can be written in any order
+            if (dst_fds[i] < 0 || ftruncate(dst_fds[i], f.size) != 0) {
+                cerr << "Error creating '" << f.dst << "': " << strerror(errno) << endl;
+                return errno;
+            }
+            return 0;
+        });
+        if (err == 0) {
+            auto transfers = make_transfers(files, first, last, transfer_size);
+            err = parallel_for(transfers.size(), threads, [&](size_t i) {
+                thread_local vector<char> buf{};
+                buf.resize(transfer_size);
+                const auto& t = transfers[i];
+                const auto& f = files[t.file];
+                auto ret = gkfs::syscall::gkfs_pread_ws(src_fds[t.file - first], buf.data(), t.count, t.offset);
+                if (ret < 0) {
+                    cerr << "Error reading GekkoFS file '" << f.src << "': " << strerror(errno) << endl;
+                    return errno;
+                }
+                // a short read means the file was truncated in the meantime. The rest stays a hole
+                size_t done = 0;
+                while (done < static_cast<size_t>(ret)) {
+                    auto wrt = pwrite(dst_fds[t.file - first], buf.data() + done, ret - done, t.offset + done);
+                    if (wrt < 0 && errno == EINTR)
+                        continue;
+                    if (wrt < 0) {
+                        cerr << "Error writing '" << f.dst << "': " << strerror(errno) << endl;
+                        return errno;
+                    }
+                    done += wrt;
+                }
+                stats.bytes += done;
+                return 0;
+            });
+        }
+        for (size_t i = 0; i < src_fds.size(); ++i) {
+            if (src_fds[i] >= 0)
+                gkfs::syscall::gkfs_close(src_fds[i]);
+            if (dst_fds[i] >= 0 && close(dst_fds[i]) != 0 && err == 0) {
+                cerr << "Error closing '" << files[first + i].dst << "': " << strerror(errno) << endl;
+                err = errno;
+            }
+        }
+        if (err != 0)
+            return err;
+    }
+    return 0;
+}
+
+int stage_out(const string& src, const string& dst, unsigned int threads, size_t transfer_size, Stats& stats) {
+    vector<string> dirs{};
+    vector<StageFile> files{};
+    auto err = walk_gkfs(strip_trailing_slashes(src), strip_trailing_slashes(dst), dirs, files);
+    if (err != 0)
+        return err;
+    // directories were collected in pre-order, i.e., parents come first
+    for (const auto& dir : dirs) {
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            cerr << "Error creating directory '" << dir << "': " << strerror(errno) << endl;
+            return errno;
+        }
+    }
+    stats.dirs = dirs.size();
+    stats.files = files.size();
+    return stage_out_data(files, threads, transfer_size, stats);
+}
+
+/**
+ * @param arg
+ * @param value (return val) positive number
+ * @return false if arg is not a positive number
+ */
+bool parse_positive(const char* arg, unsigned long& value) {
+    size_t pos = 0;
+    try {
+        value = stoul(arg, &pos);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return arg[pos] == '\0' && arg[0] != '-' && value > 0;
+}
+
+void print_usage(const char* prog) {
+    cerr << "Usage: " << prog << " [-t threads] [-c chunks] in <local_path> <gkfs_path>" << endl
+         << "       " << prog << " [-t threads] [-c chunks] out <gkfs_path> <local_path>" << endl
+         << "  -t  number of transfer threads (default: number of cores)" << endl
+         << "  -c  chunks per transfer (default: 8)" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned int threads = max(1u, thread::hardware_concurrency());
+    size_t chunks_per_transfer = 8;
+    unsigned long value = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:c:h")) != -1) {
+        switch (opt) {
+            case 't':
+                if (!parse_positive(optarg, value) || value > numeric_limits<unsigned int>::max()) {
+                    cerr << "Invalid number of threads '" << optarg << "'" << endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                threads = static_cast<unsigned int>(value);
+                break;
+            case 'c':
+                if (!parse_positive(optarg, value) ||
+                    value > numeric_limits<size_t>::max() / gkfs::config::rpc::chunksize) {
+                    cerr << "Invalid number of chunks per transfer '" << optarg << "'" << endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                chunks_per_transfer = value;
+                break;
+            default:
+                print_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (argc - optind != 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    string direction = argv[optind];
+    string src = argv[optind + 1];
+    string dst = argv[optind + 2];
+    if (direction != "in" && direction != "out") {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const auto& gkfs_path = direction == "in" ? dst : src;
+    if (gkfs_path.empty() || gkfs_path.front() != '/') {
+        cerr << "GekkoFS path '" << gkfs_path << "' must be absolute to the GekkoFS root" << endl;
+        return 1;
+    }
+
+    if (gkfs::syscall::gkfs_init() != 0) {
+        cerr << "Error initializing GekkoFS client: " << strerror(errno) << endl;
+        return 1;
+    }
+    auto transfer_size = chunks_per_transfer * gkfs::config::rpc::chunksize;
+    Stats stats{};
+    auto start = chrono::steady_clock::now();
+    auto err = direction == "in" ? stage_in(src, dst, threads, transfer_size, stats)
+                                 : stage_out(src, dst, threads, transfer_size, stats);
+    auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    gkfs::syscall::gkfs_end();
+    if (err != 0) {
+        cerr << "Staging " << direction << " failed: " << strerror(err) << endl;
+        return 1;
+    }
+    auto mib = static_cast<double>(stats.bytes.load()) / (1024 * 1024);
+    cout << "Staged " << direction << " " << stats.files << " files, " << stats.dirs << " directories, " << mib
+         << " MiB in " << elapsed << " s (" << (elapsed > 0 ? mib / elapsed : 0) << " MiB/s)" << endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Multithreaded microbenchmark for file descriptor lookups in the client.
+ * Each thread opens its own file in GekkoFS and calls lseek(fd, 0, SEEK_CUR) in a loop. The call is served by the
+ * client library without contacting a daemon, so the measured rate is dominated by the open file table lookup.
+ *
+ * Usage: LD_PRELOAD=<libgkfs_intercept.so> gkfs_bench_fd_lookup [threads] [seconds] [mountdir]
+ */
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+    unsigned int thread_count = argc > 1 ? stoul(argv[1]) : thread::hardware_concurrency();
+    unsigned int seconds = argc > 2 ? stoul(argv[2]) : 5;
+    string mountdir = argc > 3 ? argv[3] : "/tmp/mountdir";
+
+    vector<int> fds(thread_count);
+    for (unsigned int i = 0; i < thread_count; ++i) {
+        auto f = mountdir + "/fd_lookup_bench_" + to_string(i);
+        fds[i] = open(f.c_str(), O_RDWR | O_CREAT, 0777);
+        if (fds[i] < 0) {
+            cerr << "Error opening file '" << f << "': " << strerror(errno) << endl;
+            return -1;
+        }
+    }
+
+    atomic<bool> stop{false};
+    atomic<bool> failed{false};
+    vector<unsigned long> ops(thread_count, 0);
+    vector<thread> threads;
+    for (unsigned int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i]() {
+            unsigned long count = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                if (lseek(fds[i], 0, SEEK_CUR) < 0) {
+                    failed = true;
+                    break;
+                }
+                ++count;
+            }
+            ops[i] = count;
+        });
+    }
+    this_thread::sleep_for(chrono::seconds(seconds));
+    stop = true;
+    for (auto& t : threads)
+        t.join();
+
+    if (failed) {
+        cerr << "Error seeking file: " << strerror(errno) << endl;
+        return -1;
+    }
+    unsigned long total = 0;
+    for (auto o : ops)
+        total += o;
+    cout << "threads: " << thread_count << ", ops: " << total << ", ops/s: " << total / seconds << endl;
+
+    for (unsigned int i = 0; i < thread_count; ++i) {
+        close(fds[i]);
+        auto f = mountdir + "/fd_lookup_bench_" + to_string(i);
+        if (remove(f.c_str()) != 0) {
+            cerr << "Error removing file: " << strerror(errno) << endl;
+            return -1;
+        }
+    }
+    return 0;
+}
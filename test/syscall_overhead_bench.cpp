@@ -0,0 +1,63 @@
+/*
+ * Microbenchmark for the per-syscall overhead of the interception library.
+ * It times a syscall that GekkoFS does not hook (getpid), a hooked syscall on a file outside of GekkoFS (fstat on
+ * /dev/null), and, if the file can be opened, a hooked syscall served by the client itself (lseek on a GekkoFS file).
+ * Comparing the results with and without LD_PRELOAD gives the interception overhead per syscall.
+ *
+ * Usage: [LD_PRELOAD=<libgkfs_intercept.so>] gkfs_bench_syscall_overhead [iterations] [mountdir]
+ */
+#include <iostream>
+#include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <cstring>
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+template<typename F>
+void bench(const string& name, unsigned long iterations, F&& op) {
+    auto start = chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; ++i) {
+        if (op() < 0) {
+            cerr << name << " failed: " << strerror(errno) << endl;
+            return;
+        }
+    }
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    cout << setw(28) << left << name << fixed << setprecision(1)
+         << static_cast<double>(elapsed.count()) / iterations << " ns/call" << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    unsigned long iterations = argc > 1 ? stoul(argv[1]) : 1000000;
+    string mountdir = argc > 2 ? argv[2] : "/tmp/mountdir";
+
+    // glibc may cache getpid(), so the raw syscall is used
+    bench("getpid (not hooked)", iterations, []() { return syscall(SYS_getpid); });
+
+    auto null_fd = open("/dev/null", O_RDONLY);
+    if (null_fd < 0) {
+        cerr << "Error opening '/dev/null': " << strerror(errno) << endl;
+        return -1;
+    }
+    struct stat st{};
+    bench("fstat (forwarded)", iterations, [&]() { return fstat(null_fd, &st); });
+    close(null_fd);
+
+    auto f = mountdir + "/syscall_overhead_bench";
+    auto gkfs_fd = open(f.c_str(), O_RDWR | O_CREAT, 0777);
+    if (gkfs_fd < 0) {
+        cerr << "Skipping lseek: error opening file '" << f << "': " << strerror(errno) << endl;
+        return 0;
+    }
+    bench("lseek (served by client)", iterations, [&]() { return lseek(gkfs_fd, 0, SEEK_CUR); });
+    close(gkfs_fd);
+    unlink(f.c_str());
+
+    return 0;
+}
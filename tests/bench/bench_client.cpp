@@ -0,0 +1,69 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include <client/preload.hpp>
+#include <client/preload_context.hpp>
+#include <client/path.hpp>
+#include <client/open_file_map.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+
+namespace {
+
+constexpr auto bench_mountdir = "/tmp/gkfs_bench_mountdir";
+
+} // namespace
+
+TEST_CASE("path resolution", "[path]") {
+    CTX->mountdir(bench_mountdir);
+    std::vector<std::string> paths{};
+    for (int i = 0; i < 64; ++i)
+        paths.push_back(fmt::format("{}/dataset/run_{}/./rank_{}//output.dat", bench_mountdir, i % 4, i));
+    std::string resolved{};
+
+    BENCHMARK_ADVANCED("resolve inside mountdir")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return gkfs::path::resolve(paths[i % paths.size()], resolved); });
+    };
+    BENCHMARK_ADVANCED("resolve with ..")(Catch::Benchmark::Chronometer meter) {
+        auto path = std::string{bench_mountdir} + "/dataset/run_0/../run_1/rank_1/output.dat";
+        meter.measure([&] { return gkfs::path::resolve(path, resolved); });
+    };
+}
+
+TEST_CASE("open file map", "[filemap]") {
+    gkfs::filemap::OpenFileMap ofm{};
+    auto file = std::make_shared<gkfs::filemap::OpenFile>("/dataset/file", O_RDWR);
+    std::vector<int> fds{};
+    for (int i = 0; i < 256; ++i)
+        fds.push_back(ofm.add(file));
+
+    BENCHMARK_ADVANCED("get")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return ofm.get(fds[i % fds.size()]); });
+    };
+    BENCHMARK_ADVANCED("exist")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return ofm.exist(fds[i % fds.size()]); });
+    };
+    BENCHMARK("add + remove") {
+        return ofm.remove(ofm.add(file));
+    };
+    BENCHMARK("advance_pos") {
+        return file->advance_pos(4096);
+    };
+}
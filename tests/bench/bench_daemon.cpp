@@ -0,0 +1,72 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include <client/user_functions.hpp>
+
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace gkfs::syscall;
+
+/*
+ * Round trips to a single daemon on the same node. Hidden by default since a running daemon is required, see
+ * run_loopback.sh, which starts one and selects this test case with the [daemon] tag.
+ */
+TEST_CASE("loopback daemon", "[.daemon]") {
+    REQUIRE(gkfs_init() == 0);
+    const std::string dir = "/gkfs_bench";
+    if (gkfs_create(dir, S_IFDIR | 0755) != 0)
+        REQUIRE(errno == EEXIST);
+
+    unsigned long n = 0;
+    BENCHMARK("create + remove") {
+        auto path = fmt::format("{}/file_{}", dir, n++);
+        gkfs_create(path, S_IFREG | 0644);
+        return gkfs_remove(path);
+    };
+
+    const auto file = dir + "/data";
+    REQUIRE(gkfs_create(file, S_IFREG | 0644) == 0);
+    auto fd = gkfs_open(file, 0, O_RDWR);
+    REQUIRE(fd >= 0);
+    std::vector<char> buf(1024 * 1024, 'x');
+    REQUIRE(gkfs_pwrite_ws(fd, buf.data(), buf.size(), 0) == static_cast<ssize_t>(buf.size()));
+
+    BENCHMARK("stat") {
+        struct stat st{};
+        return gkfs_stat(file, &st);
+    };
+    BENCHMARK("pwrite 4 KiB") {
+        return gkfs_pwrite_ws(fd, buf.data(), 4096, 0);
+    };
+    BENCHMARK("pread 4 KiB") {
+        return gkfs_pread_ws(fd, buf.data(), 4096, 0);
+    };
+    BENCHMARK("pwrite 1 MiB") {
+        return gkfs_pwrite_ws(fd, buf.data(), buf.size(), 0);
+    };
+    BENCHMARK("pread 1 MiB") {
+        return gkfs_pread_ws(fd, buf.data(), buf.size(), 0);
+    };
+
+    gkfs_close(fd);
+    gkfs_remove(file);
+    gkfs_rmdir(dir);
+    gkfs_end();
+}
@@ -0,0 +1,91 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <daemon/scheduler/io_pools.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int xstreams_num = 4;
+constexpr int tasks_num = 256;
+
+// a short chunk operation
+void operation_abt(void*) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(10);
+    while (std::chrono::steady_clock::now() < end);
+}
+
+/**
+ * Queues the operations, all of them into the first pool if skewed, and waits until they finished
+ */
+void run_operations(const std::vector<ABT_pool>& pools, bool skewed) {
+    std::vector<ABT_task> tasks(tasks_num);
+    for (int i = 0; i < tasks_num; ++i)
+        ABT_task_create(pools[skewed ? 0 : i % pools.size()], operation_abt, nullptr, &tasks[i]);
+    for (auto& task : tasks)
+        ABT_task_free(&task);
+}
+
+void free_xstreams(std::vector<ABT_xstream>& xstreams) {
+    for (auto& xstream : xstreams) {
+        ABT_xstream_join(xstream);
+        ABT_xstream_free(&xstream);
+    }
+}
+
+} // namespace
+
+/*
+ * Chunk operations hash to the pool of one stream. The other streams have to steal them, e.g., if a single chunk
+ * receives many small writes. Compares the daemon's stealing scheduler with Argobots' basic wait scheduler, which
+ * blocks on the stream's own pool.
+ */
+TEST_CASE("I/O pools", "[io_pools]") {
+    REQUIRE(ABT_init(0, nullptr) == ABT_SUCCESS);
+
+    std::vector<ABT_pool> pools;
+    std::vector<ABT_xstream> xstreams;
+    gkfs::scheduler::create_stealing_pools(xstreams_num, pools, xstreams);
+    BENCHMARK("stealing scheduler, spread") {
+        run_operations(pools, false);
+    };
+    BENCHMARK("stealing scheduler, skewed") {
+        run_operations(pools, true);
+    };
+    free_xstreams(xstreams);
+
+    pools.assign(xstreams_num, ABT_POOL_NULL);
+    for (auto& pool : pools)
+        REQUIRE(ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &pool) == ABT_SUCCESS);
+    xstreams.assign(xstreams_num, ABT_XSTREAM_NULL);
+    std::vector<ABT_pool> stream_pools(xstreams_num);
+    for (unsigned int i = 0; i < xstreams_num; ++i) {
+        for (unsigned int j = 0; j < xstreams_num; ++j)
+            stream_pools[j] = pools[(i + j) % xstreams_num];
+        REQUIRE(ABT_xstream_create_basic(ABT_SCHED_BASIC_WAIT, xstreams_num, stream_pools.data(),
+                                         ABT_SCHED_CONFIG_NULL, &xstreams[i]) == ABT_SUCCESS);
+    }
+    BENCHMARK("basic wait scheduler, spread") {
+        run_operations(pools, false);
+    };
+    BENCHMARK("basic wait scheduler, skewed") {
+        run_operations(pools, true);
+    };
+    free_xstreams(xstreams);
+
+    ABT_finalize();
+}
@@ -0,0 +1,78 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <global/metadata.hpp>
+#include <daemon/backend/metadata/merge.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace gkfs::metadata;
+
+TEST_CASE("metadata serialization", "[metadata]") {
+    Metadata md{S_IFREG | 0644};
+    md.size(123456789);
+    md.stripe_count(8);
+    md.stripe_size(2 * 1024 * 1024);
+    md.stripe_start(3);
+    auto serialized = md.serialize();
+
+    BENCHMARK("serialize") {
+        return md.serialize();
+    };
+    BENCHMARK("deserialize") {
+        return Metadata{serialized}.size();
+    };
+}
+
+TEST_CASE("metadata merge operators", "[metadata][merge]") {
+    MetadataMergeOperator merge_operator{};
+    Metadata md{S_IFREG | 0644};
+    auto existing = md.serialize();
+    rdb::Slice existing_slice{existing};
+    rdb::Slice key{"/dataset/file"};
+
+    // what concurrent writers to one file produce between two compactions
+    std::vector<std::string> serialized_ops{};
+    for (size_t i = 1; i <= 16; ++i)
+        serialized_ops.push_back(IncreaseSizeOperand(i * 4096, false).serialize());
+    std::vector<rdb::Slice> operands(serialized_ops.begin(), serialized_ops.end());
+
+    BENCHMARK("IncreaseSizeOperand serialize") {
+        return IncreaseSizeOperand(4096, false).serialize();
+    };
+    BENCHMARK("IncreaseSizeOperand deserialize") {
+        return IncreaseSizeOperand(MergeOperand::get_params(operands[7])).size;
+    };
+    BENCHMARK("FullMergeV2 with 16 size updates") {
+        std::string new_value{};
+        rdb::Slice existing_operand{};
+        rdb::MergeOperator::MergeOperationInput merge_in{key, &existing_slice, operands, nullptr};
+        rdb::MergeOperator::MergeOperationOutput merge_out{new_value, existing_operand};
+        merge_operator.FullMergeV2(merge_in, &merge_out);
+        return new_value;
+    };
+
+    auto create_op = CreateOperand(existing).serialize();
+    std::vector<rdb::Slice> create_operands{rdb::Slice{create_op}, operands[0]};
+    BENCHMARK("FullMergeV2 create") {
+        std::string new_value{};
+        rdb::Slice existing_operand{};
+        rdb::MergeOperator::MergeOperationInput merge_in{key, nullptr, create_operands, nullptr};
+        rdb::MergeOperator::MergeOperationOutput merge_out{new_value, existing_operand};
+        merge_operator.FullMergeV2(merge_in, &merge_out);
+        return new_value;
+    };
+}
@@ -0,0 +1,86 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include <config.hpp>
+#include <global/chunk_calc_util.hpp>
+#include <global/rpc/distributor.hpp>
+
+#include <vector>
+#include <string>
+
+using namespace gkfs::util;
+
+namespace {
+
+constexpr size_t chnk_size = gkfs::config::rpc::chunksize;
+constexpr int inputs = 1024;
+
+// inputs are varied per iteration so that the compiler cannot fold the calls
+std::vector<off64_t> make_offsets() {
+    std::vector<off64_t> offsets(inputs);
+    for (int i = 0; i < inputs; ++i)
+        offsets[i] = static_cast<off64_t>(i) * 7919 * 1021;
+    return offsets;
+}
+
+std::vector<std::string> make_paths() {
+    std::vector<std::string> paths(inputs);
+    for (int i = 0; i < inputs; ++i)
+        paths[i] = fmt::format("/dataset/run_{}/rank_{}/output.dat", i % 16, i);
+    return paths;
+}
+
+} // namespace
+
+TEST_CASE("chunk calculations", "[chunk]") {
+    auto offsets = make_offsets();
+
+    BENCHMARK_ADVANCED("chnk_id_for_offset")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return chnk_id_for_offset(offsets[i % inputs], chnk_size); });
+    };
+    BENCHMARK_ADVANCED("chnk_count_for_offset")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return chnk_count_for_offset(offsets[i % inputs], 3 * chnk_size + 17, chnk_size); });
+    };
+    BENCHMARK_ADVANCED("chnk_lpad + chnk_rpad")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return chnk_lpad(offsets[i % inputs], chnk_size) + chnk_rpad(offsets[i % inputs], chnk_size);
+        });
+    };
+    BENCHMARK_ADVANCED("chnk_lalign + chnk_ralign")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return chnk_lalign(offsets[i % inputs], chnk_size) + chnk_ralign(offsets[i % inputs], chnk_size);
+        });
+    };
+}
+
+TEST_CASE("distributor placement", "[distributor]") {
+    auto paths = make_paths();
+    gkfs::rpc::SimpleHashDistributor distributor{0, 64};
+    gkfs::rpc::StripeLayout layout{};
+    layout.stripe_count = 8;
+    layout.stripe_size = 4 * chnk_size;
+    layout.start_host = 3;
+
+    BENCHMARK_ADVANCED("locate_data")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return distributor.locate_data(paths[i % inputs], i); });
+    };
+    BENCHMARK_ADVANCED("locate_data striped")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return distributor.locate_data(paths[i % inputs], i, layout); });
+    };
+    BENCHMARK_ADVANCED("locate_file_metadata")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) { return distributor.locate_file_metadata(paths[i % inputs]); });
+    };
+}
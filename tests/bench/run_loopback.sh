@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+#
+# Starts a single GekkoFS daemon on the loopback interface, runs the test cases
+# tagged [daemon] of a Catch2 program, e.g., gkfs_bench, against it, and stops
+# the daemon again.
+#
+# usage: run_loopback.sh <gkfs_daemon> <program> [program args...]
+
+set -u
+
+if [[ $# -lt 2 ]]; then
+    echo "usage: $0 <gkfs_daemon> <program> [program args...]" >&2
+    exit 1
+fi
+
+DAEMON=$1
+PROGRAM=$2
+shift 2
+
+WORKDIR=$(mktemp -d -t gkfs_bench.XXXXXX)
+HOSTSFILE=${WORKDIR}/gkfs_hosts.txt
+LOGFILE=${WORKDIR}/gkfs_daemon.log
+
+cleanup() {
+    if [[ -n "${DAEMON_PID:-}" ]]; then
+        kill -TERM "${DAEMON_PID}" 2>/dev/null
+        wait "${DAEMON_PID}" 2>/dev/null
+    fi
+    rm -rf "${WORKDIR}"
+}
+trap cleanup EXIT
+
+GKFS_DAEMON_LOG_PATH=${LOGFILE} GKFS_LOG_LEVEL=info \
+    "${DAEMON}" --mountdir "${WORKDIR}/mnt" --rootdir "${WORKDIR}/root" \
+    --hosts-file "${HOSTSFILE}" -l 127.0.0.1 &
+DAEMON_PID=$!
+
+# wait up to 10 seconds for the daemon to become ready
+for _ in $(seq 100); do
+    if grep -q "Startup successful. Daemon is ready." "${LOGFILE}" 2>/dev/null; then
+        break
+    fi
+    if ! kill -0 "${DAEMON_PID}" 2>/dev/null; then
+        echo "Daemon exited during startup:" >&2
+        cat "${LOGFILE}" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+if ! grep -q "Startup successful. Daemon is ready." "${LOGFILE}" 2>/dev/null; then
+    echo "Daemon did not start within 10 seconds" >&2
+    exit 1
+fi
+
+LIBGKFS_HOSTS_FILE=${HOSTSFILE} "${PROGRAM}" "[daemon]" "$@"
@@ -0,0 +1,98 @@
+################################################################################
+#  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain           #
+#  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany         #
+#                                                                              #
+#  This software was partially supported by the                                #
+#  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).   #
+#                                                                              #
+#  This software was partially supported by the                                #
+#  ADA-FS project under the SPPEXA project funded by the DFG.                  #
+#                                                                              #
+#  SPDX-License-Identifier: MIT                                                #
+################################################################################
+
+
+import os
+import stat
+
+
+def create_random(gkfs_client, pathname, size):
+    ret = gkfs_client.open(pathname, os.O_CREAT | os.O_WRONLY, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    ret = gkfs_client.write_random(pathname, size)
+    assert ret.retval == size
+
+
+def test_copy_file_range(test_workspace, gkfs_daemon, gkfs_client):
+    """Testing copy_file_range:
+    1. copy a file over multiple chunks to a new GekkoFS file. The offsets share their position within a chunk, so
+       the daemons copy the chunks themselves
+    2. copy at offsets with different positions within a chunk, streamed through the client
+    3. copy from a GekkoFS file to a file outside GekkoFS
+    """
+    src = gkfs_daemon.mountdir / "copy_src"
+    # 16 MiB plus an incomplete chunk
+    size = 16777216 + 12345
+    create_random(gkfs_client, src, size)
+
+    dst = gkfs_daemon.mountdir / "copy_dst"
+    ret = gkfs_client.copy_file_range(src, 0, dst, 0, size)
+    assert ret.retval == size
+    ret = gkfs_client.stat(dst)
+    assert ret.statbuf.st_size == size
+    ret = gkfs_client.file_compare(src, dst, size)
+    assert ret.retval == 0
+
+    # the first 1000 bytes of the target are a hole
+    dst_unaligned = gkfs_daemon.mountdir / "copy_dst_unaligned"
+    ret = gkfs_client.copy_file_range(src, 0, dst_unaligned, 1000, size)
+    assert ret.retval == size
+    ret = gkfs_client.stat(dst_unaligned)
+    assert ret.statbuf.st_size == size + 1000
+    verify = gkfs_daemon.mountdir / "copy_verify"
+    ret = gkfs_client.copy_file_range(dst_unaligned, 1000, verify, 0, size)
+    assert ret.retval == size
+    ret = gkfs_client.file_compare(src, verify, size)
+    assert ret.retval == 0
+
+    external = test_workspace.tmpdir / "copy_external"
+    ret = gkfs_client.copy_file_range(src, 0, external, 0, size)
+    assert ret.retval == size
+    assert os.path.getsize(external) == size
+    ret = gkfs_client.file_compare(src, external, size)
+    assert ret.retval == 0
+
+
+def test_sendfile(test_workspace, gkfs_daemon, gkfs_client):
+    """Testing sendfile:
+    1. send a file over multiple chunks to a new GekkoFS file
+    2. send a part of it starting in the middle of a chunk
+    3. send a GekkoFS file to a file outside GekkoFS and back
+    """
+    src = gkfs_daemon.mountdir / "sendfile_src"
+    size = 16777216 + 12345
+    create_random(gkfs_client, src, size)
+
+    dst = gkfs_daemon.mountdir / "sendfile_dst"
+    ret = gkfs_client.sendfile(src, 0, dst, 0, size)
+    assert ret.retval == size
+    ret = gkfs_client.stat(dst)
+    assert ret.statbuf.st_size == size
+    ret = gkfs_client.file_compare(src, dst, size)
+    assert ret.retval == 0
+
+    part = gkfs_daemon.mountdir / "sendfile_part"
+    ret = gkfs_client.sendfile(src, 700000, part, 700000, size - 700000)
+    assert ret.retval == size - 700000
+    ret = gkfs_client.stat(part)
+    assert ret.statbuf.st_size == size
+
+    external = test_workspace.tmpdir / "sendfile_external"
+    ret = gkfs_client.sendfile(src, 0, external, 0, size)
+    assert ret.retval == size
+    assert os.path.getsize(external) == size
+    back = gkfs_daemon.mountdir / "sendfile_back"
+    ret = gkfs_client.sendfile(external, 0, back, 0, size)
+    assert ret.retval == size
+    ret = gkfs_client.file_compare(src, back, size)
+    assert ret.retval == 0
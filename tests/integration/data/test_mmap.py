@@ -0,0 +1,57 @@
+################################################################################
+#  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain           #
+#  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany         #
+#                                                                              #
+#  This software was partially supported by the                                #
+#  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).   #
+#                                                                              #
+#  This software was partially supported by the                                #
+#  ADA-FS project under the SPPEXA project funded by the DFG.                  #
+#                                                                              #
+#  SPDX-License-Identifier: MIT                                                #
+################################################################################
+
+
+import os
+import stat
+
+
+def test_mmap(gkfs_daemon, gkfs_client):
+    """Testing mmap:
+    1. write through a shared mapping and check that the data reaches the file
+    2. replace a shared mapping by an anonymous MAP_FIXED mapping and check that the written pages are kept, but the
+       contents of the replacing mapping are not written to the file
+    3. map a file at an offset
+    """
+    file = gkfs_daemon.mountdir / "file_mmap"
+
+    ret = gkfs_client.open(file, os.O_CREAT | os.O_WRONLY, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    buf = b'abcdefghij' * 10000
+    ret = gkfs_client.write(file, buf, len(buf))
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.mmap(file, 0, len(buf), 'XYZ')
+    assert ret.retval == 0
+    assert ret.buf == b'abc'
+
+    ret = gkfs_client.read(file, len(buf))
+    assert ret.retval == len(buf)
+    assert ret.buf == b'XYZ' + buf[3:]
+
+    ret = gkfs_client.mmap(file, 0, len(buf), '123', '--replace')
+    assert ret.retval == 0
+    assert ret.buf == b'XYZ'
+
+    ret = gkfs_client.read(file, len(buf))
+    assert ret.retval == len(buf)
+    assert ret.buf == b'123' + buf[3:]
+
+    ret = gkfs_client.mmap(file, 8192, 4096, 'uvw')
+    assert ret.retval == 0
+    assert ret.buf == buf[8192:8195]
+
+    ret = gkfs_client.read(file, len(buf))
+    assert ret.retval == len(buf)
+    assert ret.buf == b'123' + buf[3:8192] + b'uvw' + buf[8195:]
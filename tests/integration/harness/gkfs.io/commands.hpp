@@ -76,6 +76,15 @@ write_random_init(CLI::App& app);
 void
 truncate_init(CLI::App& app);
 
+void
+copy_file_range_init(CLI::App& app);
+
+void
+sendfile_init(CLI::App& app);
+
+void
+mmap_init(CLI::App& app);
+
 // UTIL
 void
 file_compare_init(CLI::App& app);
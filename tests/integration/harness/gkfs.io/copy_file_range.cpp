@@ -0,0 +1,158 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct copy_file_range_options {
+    bool verbose{};
+    std::string pathname_in{};
+    std::string pathname_out{};
+    ::off_t offset_in{};
+    ::off_t offset_out{};
+    ::size_t count{};
+
+    REFL_DECL_STRUCT(copy_file_range_options,
+                     REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname_in),
+                     REFL_DECL_MEMBER(std::string, pathname_out),
+                     REFL_DECL_MEMBER(::off_t, offset_in),
+                     REFL_DECL_MEMBER(::off_t, offset_out),
+                     REFL_DECL_MEMBER(::size_t, count)
+    );
+};
+
+struct copy_file_range_output {
+    ::ssize_t retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(copy_file_range_output,
+                     REFL_DECL_MEMBER(::ssize_t, retval),
+                     REFL_DECL_MEMBER(int, errnum)
+    );
+};
+
+void to_json(json& record,
+             const copy_file_range_output& out) {
+    record = serialize(out);
+}
+
+/**
+ * Copies `count` bytes from pathname_in at offset_in to pathname_out at offset_out. pathname_out is created if it
+ * does not exist
+ * @param opts
+ */
+void copy_file_range_exec(const copy_file_range_options& opts) {
+
+    int fd_in = ::open(opts.pathname_in.c_str(), O_RDONLY);
+    int fd_out = fd_in == -1 ? -1 : ::open(opts.pathname_out.c_str(), O_WRONLY | O_CREAT, 0644);
+
+    if (fd_in == -1 || fd_out == -1) {
+        if (opts.verbose) {
+            fmt::print("open(pathname_in=\"{}\", pathname_out=\"{}\") = {}, errno: {} [{}]\n",
+                       opts.pathname_in, opts.pathname_out, -1, errno, ::strerror(errno));
+            return;
+        }
+
+        json out = copy_file_range_output{-1, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    ::loff_t off_in = opts.offset_in;
+    ::loff_t off_out = opts.offset_out;
+    auto rv = ::copy_file_range(fd_in, &off_in, fd_out, &off_out, opts.count, 0);
+
+    if (opts.verbose) {
+        fmt::print("copy_file_range(pathname_in=\"{}\", offset_in={}, pathname_out=\"{}\", offset_out={}, count={}) = {}, "
+                   "errno: {} [{}]\n", opts.pathname_in, opts.offset_in, opts.pathname_out, opts.offset_out,
+                   opts.count, rv, errno, ::strerror(errno));
+        return;
+    }
+
+    json out = copy_file_range_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void copy_file_range_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<copy_file_range_options>();
+    auto* cmd = app.add_subcommand(
+            "copy_file_range",
+            "Execute the copy_file_range() system call between two files");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag(
+            "-v,--verbose",
+            opts->verbose,
+            "Produce human writeable output"
+    );
+
+    cmd->add_option(
+                    "pathname_in",
+                    opts->pathname_in,
+                    "File to copy from"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "offset_in",
+                    opts->offset_in,
+                    "Offset to copy from"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "pathname_out",
+                    opts->pathname_out,
+                    "File to copy to"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "offset_out",
+                    opts->offset_out,
+                    "Offset to copy to"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "count",
+                    opts->count,
+                    "Number of bytes to copy"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->callback([opts]() {
+        copy_file_range_exec(*opts);
+    });
+}
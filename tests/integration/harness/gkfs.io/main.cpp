@@ -41,6 +41,9 @@ init_commands(CLI::App& app) {
     write_validate_init(app);
     write_random_init(app);
     truncate_init(app);
+    copy_file_range_init(app);
+    sendfile_init(app);
+    mmap_init(app);
     // util
     file_compare_init(app);
 }
@@ -0,0 +1,194 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <cstring>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+#include <binary_buffer.hpp>
+
+/* C includes */
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct mmap_options {
+    bool verbose{};
+    bool replace{};
+    std::string pathname{};
+    ::off_t offset{};
+    ::size_t length{};
+    std::string data{};
+
+    REFL_DECL_STRUCT(mmap_options,
+                     REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(bool, replace),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(::off_t, offset),
+                     REFL_DECL_MEMBER(::size_t, length),
+                     REFL_DECL_MEMBER(std::string, data)
+    );
+};
+
+struct mmap_output {
+    int retval;
+    io::buffer buf;
+    int errnum;
+
+    REFL_DECL_STRUCT(mmap_output,
+                     REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(void*, buf),
+                     REFL_DECL_MEMBER(int, errnum)
+    );
+};
+
+void
+to_json(json& record,
+        const mmap_output& out) {
+    record = serialize(out);
+}
+
+/**
+ * Maps `length` bytes of a file at `offset` shared and writable, returns the first bytes of the mapping, and
+ * overwrites them with `data`. The mapping is then synced and unmapped or, with --replace, replaced by a fixed
+ * anonymous mapping whose contents must not reach the file
+ * @param opts
+ */
+void
+mmap_exec(const mmap_options& opts) {
+
+    auto fd = ::open(opts.pathname.c_str(), O_RDWR);
+    if (fd == -1) {
+        if (opts.verbose) {
+            fmt::print("open(pathname=\"{}\") = {}, errno: {} [{}]\n",
+                       opts.pathname, fd, errno, ::strerror(errno));
+            return;
+        }
+
+        json out = mmap_output{fd, nullptr, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    auto map = static_cast<char*>(::mmap(nullptr, opts.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                                         opts.offset));
+    // the mapping stays valid after the file is closed
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        if (opts.verbose) {
+            fmt::print("mmap(pathname=\"{}\", offset={}, length={}) = -1, errno: {} [{}]\n",
+                       opts.pathname, opts.offset, opts.length, errno, ::strerror(errno));
+            return;
+        }
+
+        json out = mmap_output{-1, nullptr, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    auto size = std::min(opts.data.size(), opts.length);
+    io::buffer buf(size);
+    std::memcpy(buf.data(), map, size);
+    std::memcpy(map, opts.data.data(), size);
+
+    int rv;
+    if (opts.replace) {
+        auto anon = ::mmap(map, opts.length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1,
+                           0);
+        rv = anon == MAP_FAILED ? -1 : 0;
+        if (rv == 0) {
+            std::memset(map, 'Q', opts.length);
+            rv = ::munmap(map, opts.length);
+        }
+    } else {
+        rv = ::msync(map, opts.length, MS_SYNC);
+        if (rv == 0)
+            rv = ::munmap(map, opts.length);
+    }
+
+    if (opts.verbose) {
+        fmt::print("mmap(pathname=\"{}\", offset={}, length={}, replace={}) = {}, errno: {} [{}]\n",
+                   opts.pathname, opts.offset, opts.length, opts.replace, rv, errno, ::strerror(errno));
+        return;
+    }
+
+    json out = mmap_output{rv, (rv != -1 ? buf : nullptr), errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+mmap_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<mmap_options>();
+    auto* cmd = app.add_subcommand(
+            "mmap",
+            "Execute the mmap() system call on a file and write through the mapping");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag(
+            "-v,--verbose",
+            opts->verbose,
+            "Produce human readable output"
+        );
+
+    cmd->add_flag(
+            "--replace",
+            opts->replace,
+            "Replace the mapping with an anonymous MAP_FIXED mapping instead of unmapping it"
+        );
+
+    cmd->add_option(
+            "pathname",
+            opts->pathname,
+            "File name"
+        )
+        ->required()
+        ->type_name("");
+
+    cmd->add_option(
+            "offset",
+            opts->offset,
+            "Offset of the mapping in the file, a multiple of the page size"
+        )
+        ->required()
+        ->type_name("");
+
+    cmd->add_option(
+            "length",
+            opts->length,
+            "Length of the mapping"
+        )
+        ->required()
+        ->type_name("");
+
+    cmd->add_option(
+            "data",
+            opts->data,
+            "Data written to the beginning of the mapping"
+        )
+        ->required()
+        ->type_name("");
+
+    cmd->callback([opts]() {
+        mmap_exec(*opts);
+    });
+}
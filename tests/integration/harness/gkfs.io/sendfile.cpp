@@ -0,0 +1,163 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+
+using json = nlohmann::json;
+
+struct sendfile_options {
+    bool verbose{};
+    std::string pathname_in{};
+    std::string pathname_out{};
+    ::off_t offset_in{};
+    ::off_t offset_out{};
+    ::size_t count{};
+
+    REFL_DECL_STRUCT(sendfile_options,
+                     REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname_in),
+                     REFL_DECL_MEMBER(std::string, pathname_out),
+                     REFL_DECL_MEMBER(::off_t, offset_in),
+                     REFL_DECL_MEMBER(::off_t, offset_out),
+                     REFL_DECL_MEMBER(::size_t, count)
+    );
+};
+
+struct sendfile_output {
+    ::ssize_t retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(sendfile_output,
+                     REFL_DECL_MEMBER(::ssize_t, retval),
+                     REFL_DECL_MEMBER(int, errnum)
+    );
+};
+
+void to_json(json& record,
+             const sendfile_output& out) {
+    record = serialize(out);
+}
+
+/**
+ * Copies `count` bytes from pathname_in at offset_in to pathname_out at offset_out. pathname_out is created if it
+ * does not exist
+ * @param opts
+ */
+void sendfile_exec(const sendfile_options& opts) {
+
+    int fd_in = ::open(opts.pathname_in.c_str(), O_RDONLY);
+    int fd_out = fd_in == -1 ? -1 : ::open(opts.pathname_out.c_str(), O_WRONLY | O_CREAT, 0644);
+
+    if (fd_in == -1 || fd_out == -1) {
+        if (opts.verbose) {
+            fmt::print("open(pathname_in=\"{}\", pathname_out=\"{}\") = {}, errno: {} [{}]\n",
+                       opts.pathname_in, opts.pathname_out, -1, errno, ::strerror(errno));
+            return;
+        }
+
+        json out = sendfile_output{-1, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    ::off_t off_in = opts.offset_in;
+    if (::lseek(fd_out, opts.offset_out, SEEK_SET) == -1) {
+        json out = sendfile_output{-1, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+    auto rv = ::sendfile(fd_out, fd_in, &off_in, opts.count);
+
+    if (opts.verbose) {
+        fmt::print("sendfile(pathname_in=\"{}\", offset_in={}, pathname_out=\"{}\", offset_out={}, count={}) = {}, "
+                   "errno: {} [{}]\n", opts.pathname_in, opts.offset_in, opts.pathname_out, opts.offset_out,
+                   opts.count, rv, errno, ::strerror(errno));
+        return;
+    }
+
+    json out = sendfile_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void sendfile_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<sendfile_options>();
+    auto* cmd = app.add_subcommand(
+            "sendfile",
+            "Execute the sendfile() system call between two files");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag(
+            "-v,--verbose",
+            opts->verbose,
+            "Produce human writeable output"
+    );
+
+    cmd->add_option(
+                    "pathname_in",
+                    opts->pathname_in,
+                    "File to copy from"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "offset_in",
+                    opts->offset_in,
+                    "Offset to copy from"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "pathname_out",
+                    opts->pathname_out,
+                    "File to copy to"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "offset_out",
+                    opts->offset_out,
+                    "Offset to copy to"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->add_option(
+                    "count",
+                    opts->count,
+                    "Number of bytes to copy"
+            )
+            ->required()
+            ->type_name("");
+
+    cmd->callback([opts]() {
+        sendfile_exec(*opts);
+    });
+}
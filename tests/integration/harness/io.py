@@ -326,6 +326,38 @@ class TruncateOutputSchema(Schema):
         return namedtuple('TruncateReturn', ['retval', 'errno'])(**data)
 
 
+class CopyFileRangeOutputSchema(Schema):
+    """Schema to deserialize the results of a copy_file_range() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('CopyFileRangeReturn', ['retval', 'errno'])(**data)
+
+
+class SendfileOutputSchema(Schema):
+    """Schema to deserialize the results of a sendfile() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('SendfileReturn', ['retval', 'errno'])(**data)
+
+
+class MmapOutputSchema(Schema):
+    """Schema to deserialize the results of a mmap() execution"""
+
+    buf = ByteList(allow_none=True)
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('MmapReturn', ['buf', 'retval', 'errno'])(**data)
+
+
 # UTIL
 class FileCompareOutputSchema(Schema):
     """Schema to deserialize the results of comparing two files execution"""
@@ -358,6 +390,9 @@ class IOParser:
         'write_random': WriteRandomOutputSchema(),
         'write_validate' : WriteValidateOutputSchema(),
         'truncate': TruncateOutputSchema(),
+        'copy_file_range': CopyFileRangeOutputSchema(),
+        'sendfile': SendfileOutputSchema(),
+        'mmap': MmapOutputSchema(),
         # UTIL
         'file_compare': FileCompareOutputSchema(),
     }
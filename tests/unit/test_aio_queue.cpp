@@ -0,0 +1,165 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <client/aio_queue.hpp>
+#include <config.hpp>
+
+#include <cerrno>
+#include <future>
+#include <thread>
+#include <vector>
+
+using gkfs::aio::AioQueue;
+using gkfs::aio::io_result;
+
+namespace {
+
+/**
+ * @return a function posting a request that completes with the value set on p
+ */
+std::function<std::shared_future<io_result>()> post(std::promise<io_result>& p) {
+    return [&p]() { return p.get_future().share(); };
+}
+
+} // namespace
+
+TEST_CASE("Requests are completed by worker threads and removed when waited for", "[aio]") {
+    AioQueue queue{};
+    std::promise<io_result> p;
+    auto id = queue.submit(post(p));
+    REQUIRE(id >= 0);
+    REQUIRE(queue.poll(id) == 0);
+
+    p.set_value(io_result{0, 42});
+    io_result ret{};
+    REQUIRE(queue.wait(id, ret) == 0);
+    REQUIRE(ret == io_result{0, 42});
+    // the id is released
+    REQUIRE(queue.poll(id) == -1);
+    REQUIRE(queue.wait(id, ret) == EINVAL);
+}
+
+TEST_CASE("Failed posts do not leave requests behind", "[aio]") {
+    AioQueue queue{};
+    errno = 0;
+    auto id = queue.submit([]() {
+        errno = EBADF;
+        return std::shared_future<io_result>{};
+    });
+    REQUIRE(id == -1);
+    REQUIRE(errno == EBADF);
+
+    std::promise<io_result> p;
+    p.set_value(io_result{0, 1});
+    id = queue.submit(post(p));
+    REQUIRE(id >= 0);
+    io_result ret{};
+    REQUIRE(queue.wait(id, ret) == 0);
+}
+
+TEST_CASE("Only one thread waits for a request", "[aio]") {
+    AioQueue queue{};
+    std::promise<io_result> p;
+    auto id = queue.submit(post(p));
+    REQUIRE(id >= 0);
+
+    // whichever waiter comes second is rejected. The request completes only afterwards, so the first one cannot
+    // have removed it yet
+    std::promise<void> rejected;
+    std::vector<int> errs(2, -1);
+    std::vector<io_result> rets(2);
+    std::vector<std::thread> waiters;
+    for (size_t i = 0; i < 2; i++) {
+        waiters.emplace_back([&, i]() {
+            errs[i] = queue.wait(id, rets[i]);
+            if (errs[i] == EBUSY)
+                rejected.set_value();
+        });
+    }
+    rejected.get_future().wait();
+    p.set_value(io_result{0, 7});
+    for (auto& waiter : waiters)
+        waiter.join();
+
+    REQUIRE(((errs[0] == 0 && errs[1] == EBUSY) || (errs[0] == EBUSY && errs[1] == 0)));
+    REQUIRE(rets[errs[0] == 0 ? 0 : 1] == io_result{0, 7});
+    REQUIRE(queue.poll(id) == -1);
+}
+
+TEST_CASE("Submissions fail while too many requests are not waited for", "[aio]") {
+    AioQueue queue{};
+    std::vector<std::promise<io_result>> promises(gkfs::config::io::aio_max_requests);
+    std::vector<int> ids;
+    for (auto& p : promises) {
+        ids.push_back(queue.submit(post(p)));
+        REQUIRE(ids.back() >= 0);
+    }
+
+    std::promise<io_result> extra;
+    auto posted = false;
+    errno = 0;
+    REQUIRE(queue.submit([&]() {
+        posted = true;
+        return extra.get_future().share();
+    }) == -1);
+    REQUIRE(errno == EAGAIN);
+    // the RPCs of a rejected request are never sent
+    REQUIRE_FALSE(posted);
+
+    // completed requests still count until they are waited for
+    for (auto& p : promises)
+        p.set_value(io_result{0, 1});
+    REQUIRE(queue.submit(post(extra)) == -1);
+
+    io_result ret{};
+    REQUIRE(queue.wait(ids.front(), ret) == 0);
+    auto id = queue.submit(post(extra));
+    REQUIRE(id >= 0);
+    extra.set_value(io_result{EIO, 0});
+    REQUIRE(queue.wait(id, ret) == 0);
+    REQUIRE(ret == io_result{EIO, 0});
+    for (size_t i = 1; i < ids.size(); i++)
+        REQUIRE(queue.wait(ids[i], ret) == 0);
+}
+
+TEST_CASE("Concurrent submitters and waiters", "[aio]") {
+    AioQueue queue{};
+    constexpr auto threads = 8;
+    constexpr auto requests = 500;
+    std::vector<std::thread> clients;
+    std::vector<int> failures(threads, 0);
+    for (int t = 0; t < threads; t++) {
+        clients.emplace_back([&, t]() {
+            for (int r = 0; r < requests; r++) {
+                std::promise<io_result> p;
+                auto id = queue.submit(post(p));
+                if (id < 0) {
+                    failures[t]++;
+                    continue;
+                }
+                // completed by another thread while the request may be in a worker's hands
+                std::thread completer([&p, r]() { p.set_value(io_result{0, r}); });
+                io_result ret{};
+                if (queue.wait(id, ret) != 0 || ret != io_result{0, r})
+                    failures[t]++;
+                completer.join();
+            }
+        });
+    }
+    for (auto& client : clients)
+        client.join();
+    REQUIRE(failures == std::vector<int>(threads, 0));
+    queue.shutdown();
+}
@@ -0,0 +1,62 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <daemon/cpu_set.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using gkfs::affinity::CpuSet;
+using gkfs::affinity::parse_cpu_set;
+
+TEST_CASE("CPU sets are parsed", "[affinity]") {
+
+    SECTION("ids and ranges are sorted and merged") {
+        REQUIRE(parse_cpu_set("") == CpuSet{});
+        REQUIRE(parse_cpu_set("3") == CpuSet{3});
+        REQUIRE(parse_cpu_set("0-3,8") == CpuSet{0, 1, 2, 3, 8});
+        REQUIRE(parse_cpu_set("8,2-4,3,0") == CpuSet{0, 2, 3, 4, 8});
+        REQUIRE(parse_cpu_set("5-5") == CpuSet{5});
+    }
+
+    SECTION("NUMA nodes add their CPUs") {
+        std::ifstream file("/sys/devices/system/node/node0/cpulist");
+        std::string node_list;
+        if (!file || !std::getline(file, node_list))
+            return;
+        auto node_cpus = parse_cpu_set(node_list);
+        REQUIRE_FALSE(node_cpus.empty());
+        REQUIRE(parse_cpu_set("node:0") == node_cpus);
+    }
+
+    SECTION("invalid sets") {
+        for (const auto& spec : {"x", "-1", "1-", "3-1", "1,,2", "1;2", "0-100000", "node:", "node:x",
+                                 "node:100000"}) {
+            CAPTURE(spec);
+            REQUIRE_THROWS_AS(parse_cpu_set(spec), std::runtime_error);
+        }
+    }
+}
+
+TEST_CASE("CPU sets are printed in the kernel's list format", "[affinity]") {
+    REQUIRE(gkfs::affinity::to_string({}).empty());
+    REQUIRE(gkfs::affinity::to_string({4}) == "4");
+    REQUIRE(gkfs::affinity::to_string({0, 1, 2, 3, 8}) == "0-3,8");
+    REQUIRE(gkfs::affinity::to_string({0, 2, 4, 5}) == "0,2,4-5");
+
+    for (const auto& spec : {"0-3,8", "1,3,5-7", "0-63"})
+        REQUIRE(gkfs::affinity::to_string(parse_cpu_set(spec)) == spec);
+}
@@ -0,0 +1,116 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <daemon/scheduler/io_pools.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Operation {
+    std::atomic<bool> started{false};
+};
+
+void operation_abt(void* _arg) {
+    static_cast<Operation*>(_arg)->started = true;
+    // long enough that the operations queue up in the pool
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+    while (std::chrono::steady_clock::now() < end);
+}
+
+struct Truncate {
+    std::vector<std::unique_ptr<Operation>>* operations;
+    // operations queued before the truncate
+    size_t before;
+    bool ordered{false};
+    std::atomic<bool> called{false};
+};
+
+void truncate_abt(void* _arg) {
+    auto truncate = static_cast<Truncate*>(_arg);
+    truncate->ordered = true;
+    for (size_t i = 0; i < truncate->before; ++i) {
+        if (!truncate->operations->at(i)->started)
+            truncate->ordered = false;
+    }
+    truncate->called = true;
+}
+
+} // namespace
+
+TEST_CASE("Truncate barrier is ordered after the operations of all I/O pools", "[io_pools]") {
+    REQUIRE(ABT_init(0, nullptr) == ABT_SUCCESS);
+    std::vector<ABT_pool> pools;
+    std::vector<ABT_xstream> xstreams;
+    gkfs::scheduler::create_stealing_pools(4, pools, xstreams);
+
+    std::vector<std::unique_ptr<Operation>> operations;
+    // the truncate reads the operations while further ones are queued
+    operations.reserve(1100);
+    std::vector<ABT_task> tasks;
+    auto queue = [&](ABT_pool pool) {
+        operations.emplace_back(new Operation);
+        ABT_task task;
+        REQUIRE(ABT_task_create(pool, operation_abt, operations.back().get(), &task) == ABT_SUCCESS);
+        tasks.push_back(task);
+    };
+
+    SECTION("Operations queued in one pool only") {
+        // the barriers of the other pools run immediately
+        for (int i = 0; i < 1000; ++i)
+            queue(pools[0]);
+    }
+    SECTION("Operations spread over all pools") {
+        for (int i = 0; i < 1000; ++i)
+            queue(pools[i % pools.size()]);
+    }
+
+    Truncate truncate{&operations, operations.size()};
+    gkfs::scheduler::PoolBarrier barrier(truncate_abt, &truncate);
+    std::vector<ABT_task> barrier_tasks;
+    REQUIRE(barrier.post(pools, barrier_tasks) == ABT_SUCCESS);
+    REQUIRE(barrier_tasks.size() == pools.size());
+    // operations queued after the truncate may start before it
+    for (int i = 0; i < 100; ++i)
+        queue(pools[i % pools.size()]);
+
+    while (!truncate.called)
+        std::this_thread::yield();
+    REQUIRE(truncate.ordered);
+
+    for (auto& task : tasks)
+        ABT_task_free(&task);
+    for (auto& task : barrier_tasks)
+        ABT_task_free(&task);
+    for (auto& xstream : xstreams) {
+        ABT_xstream_join(xstream);
+        ABT_xstream_free(&xstream);
+    }
+    ABT_finalize();
+}
+
+TEST_CASE("Truncate barrier without pools calls the function immediately", "[io_pools]") {
+    Truncate truncate{nullptr, 0};
+    gkfs::scheduler::PoolBarrier barrier(truncate_abt, &truncate);
+    std::vector<ABT_task> barrier_tasks;
+    REQUIRE(barrier.post({}, barrier_tasks) == ABT_SUCCESS);
+    REQUIRE(barrier_tasks.empty());
+    REQUIRE(truncate.called);
+    REQUIRE(truncate.ordered);
+}
@@ -0,0 +1,105 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <client/open_file_map.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+
+using gkfs::filemap::OpenFile;
+using gkfs::filemap::OpenFileMap;
+
+TEST_CASE("Files are found by their fd until they are removed", "[filemap]") {
+    OpenFileMap ofm{};
+    auto file = std::make_shared<OpenFile>("/file", O_RDWR);
+    auto fd = ofm.add(file);
+    REQUIRE(ofm.get(fd) == file);
+    REQUIRE(ofm.exist(fd));
+
+    auto dup = ofm.dup(fd);
+    REQUIRE(dup != fd);
+    REQUIRE(ofm.get(dup) == file);
+    // fds outside the fd table
+    REQUIRE(ofm.dup2(fd, 42) == 42);
+    REQUIRE(ofm.get(42) == file);
+
+    REQUIRE(ofm.remove(fd));
+    REQUIRE_FALSE(ofm.exist(fd));
+    REQUIRE(ofm.get(fd) == nullptr);
+    REQUIRE_FALSE(ofm.remove(fd));
+    REQUIRE(ofm.get(dup) == file);
+    REQUIRE(ofm.remove(dup));
+    REQUIRE(ofm.remove(42));
+}
+
+/*
+ * Lookups run concurrently with add(), dup(), dup2(), and remove(), so that slots are retired while they are read.
+ * Meant to be run under AddressSanitizer or ThreadSanitizer, which report a slot freed while a lookup uses it.
+ */
+TEST_CASE("Concurrent lookups while files are added and removed", "[filemap]") {
+    OpenFileMap ofm{};
+    constexpr auto writers = 4;
+    constexpr auto readers = 4;
+    constexpr auto iterations = 5000;
+    // fd of each writer's file that readers look up, -1 if none
+    std::vector<std::atomic<int>> published(writers);
+    for (auto& fd : published)
+        fd.store(-1);
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&]() {
+            while (!stop.load()) {
+                for (auto& fd : published) {
+                    // the fd may be removed and taken by another writer's file in the meantime
+                    auto file = ofm.get(fd.load());
+                    if (file != nullptr && file->path().compare(0, 8, "/stress/") != 0)
+                        errors++;
+                    ofm.exist(fd.load());
+                }
+            }
+        });
+    }
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w]() {
+            auto file = std::make_shared<OpenFile>("/stress/" + std::to_string(w), O_RDWR);
+            // fds of dup2() outside the fd table
+            auto target = 100 + w;
+            for (int i = 0; i < iterations; i++) {
+                auto fd = ofm.add(file);
+                published[w].store(fd);
+                auto dup = ofm.dup(fd);
+                if (ofm.get(fd) != file || ofm.get(dup) != file || ofm.dup2(dup, target) != target ||
+                    ofm.get(target) != file)
+                    errors++;
+                if (!ofm.remove(fd) || !ofm.remove(dup) || !ofm.remove(target))
+                    errors++;
+            }
+        });
+    }
+    for (int w = 0; w < writers; w++)
+        threads[readers + w].join();
+    stop.store(true);
+    for (int r = 0; r < readers; r++)
+        threads[r].join();
+    REQUIRE(errors.load() == 0);
+}
@@ -0,0 +1,189 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <daemon/scheduler/qos_policy.hpp>
+#include <config.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using gkfs::scheduler::QosPolicy;
+
+namespace {
+
+QosPolicy::clock::time_point after(QosPolicy::clock::time_point t, double seconds) {
+    return t + std::chrono::duration_cast<QosPolicy::clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+} // namespace
+
+TEST_CASE("QoS classes are parsed", "[qos]") {
+
+    SECTION("weights and limits") {
+        auto classes = QosPolicy::parse_classes("ckpt:1:2G,viz:4,*:0.5:512K:100");
+        REQUIRE(classes.size() == 3);
+        REQUIRE(classes[0].job == "ckpt");
+        REQUIRE(classes[0].weight == 1);
+        REQUIRE(classes[0].bandwidth == 2ull * 1024 * 1024 * 1024);
+        REQUIRE(classes[0].iops == 0);
+        REQUIRE(classes[1].job == "viz");
+        REQUIRE(classes[1].weight == 4);
+        REQUIRE(classes[1].bandwidth == 0);
+        REQUIRE(classes[2].job == "*");
+        REQUIRE(classes[2].weight == 0.5);
+        REQUIRE(classes[2].bandwidth == 512 * 1024);
+        REQUIRE(classes[2].iops == 100);
+    }
+
+    SECTION("empty specification") {
+        REQUIRE(QosPolicy::parse_classes("").empty());
+    }
+
+    SECTION("invalid classes") {
+        for (const auto& spec : {"ckpt", ":1", "ckpt:", "ckpt:0", "ckpt:-1", "ckpt:x", "ckpt:1x", "ckpt:1:2T",
+                                 "ckpt:1:K", "ckpt:1:2:3:4", "ckpt:1,ckpt:2", "ckpt:1,,viz:1"}) {
+            CAPTURE(spec);
+            REQUIRE_THROWS_AS(QosPolicy::parse_classes(spec), std::runtime_error);
+        }
+    }
+}
+
+TEST_CASE("QoS releases queued requests", "[qos]") {
+    auto now = QosPolicy::clock::now();
+    double wait;
+
+    SECTION("at most max_inflight requests are processed") {
+        QosPolicy policy{{}, 2};
+        REQUIRE(policy.enter("a", 1, now) == 0);
+        REQUIRE(policy.enter("b", 1, now) == 0);
+        auto id = policy.enter("a", 1, now);
+        REQUIRE(id != 0);
+        REQUIRE(policy.dispatch(now, wait).empty());
+        REQUIRE(wait < 0);
+        policy.leave("b");
+        REQUIRE(policy.dispatch(now, wait) == std::vector<uint64_t>{id});
+        REQUIRE(policy.queued() == 0);
+        REQUIRE(policy.inflight() == 2);
+    }
+
+    SECTION("requests of a job are released in order") {
+        QosPolicy policy{{}, 1};
+        REQUIRE(policy.enter("a", 1, now) == 0);
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < 4; ++i)
+            ids.push_back(policy.enter("a", 1, now));
+        std::vector<uint64_t> released;
+        for (int i = 0; i < 4; ++i) {
+            policy.leave("a");
+            auto next = policy.dispatch(now, wait);
+            REQUIRE(next.size() == 1);
+            released.push_back(next[0]);
+        }
+        REQUIRE(released == ids);
+    }
+
+    SECTION("jobs share requests by their weights") {
+        QosPolicy policy{QosPolicy::parse_classes("light:1,heavy:3"), 1};
+        REQUIRE(policy.enter("light", 1, now) == 0);
+        for (int i = 0; i < 8; ++i) {
+            policy.enter("light", 100, now);
+            policy.enter("heavy", 100, now);
+        }
+        std::vector<std::string> jobs{"light"};
+        size_t heavy = 0;
+        for (int i = 0; i < 8; ++i) {
+            policy.leave(jobs.back());
+            auto next = policy.dispatch(now, wait);
+            REQUIRE(next.size() == 1);
+            // ids alternate between the jobs, starting with light
+            jobs.emplace_back(next[0] % 2 == 1 ? "light" : "heavy");
+            if (jobs.back() == "heavy")
+                heavy++;
+        }
+        REQUIRE(heavy == 6);
+    }
+
+    SECTION("a queued request is released if it cannot wait") {
+        QosPolicy policy{{}, 1};
+        REQUIRE(policy.enter("a", 1, now) == 0);
+        auto id = policy.enter("a", 1, now);
+        policy.release("a", id, now);
+        REQUIRE(policy.queued() == 0);
+        REQUIRE(policy.inflight() == 2);
+        policy.leave("a");
+        policy.leave("a");
+        REQUIRE(policy.dispatch(now, wait).empty());
+    }
+}
+
+TEST_CASE("QoS throttles jobs by their limits", "[qos]") {
+    auto now = QosPolicy::clock::now();
+    double wait;
+    // unlisted jobs are limited to 1000 bytes/s
+    QosPolicy policy{QosPolicy::parse_classes("*:1:1000"), 4};
+
+    // the first request takes more than the bucket holds and leaves the job in debt
+    REQUIRE(policy.enter("slow", 1000, now) == 0);
+    policy.leave("slow");
+    auto slow = policy.enter("slow", 1000, now);
+    REQUIRE(slow != 0);
+    REQUIRE(policy.dispatch(now, wait).empty());
+    REQUIRE(wait > 0);
+    REQUIRE(wait < 1);
+
+    SECTION("other jobs are not held back") {
+        auto other = policy.enter("other", 1, now);
+        // requests queue while others wait, the next dispatch releases it
+        REQUIRE(other != 0);
+        REQUIRE(policy.dispatch(now, wait) == std::vector<uint64_t>{other});
+        REQUIRE(wait > 0);
+    }
+
+    SECTION("the job continues once its bucket is refilled") {
+        REQUIRE(policy.dispatch(after(now, wait / 2), wait).empty());
+        REQUIRE(wait > 0);
+        auto refilled = after(now, 1);
+        REQUIRE(policy.dispatch(refilled, wait) == std::vector<uint64_t>{slow});
+        REQUIRE(wait < 0);
+    }
+}
+
+TEST_CASE("QoS forgets idle jobs", "[qos]") {
+    auto now = QosPolicy::clock::now();
+    // a request of 1000 bytes leaves the slow job in debt for minutes
+    QosPolicy policy{QosPolicy::parse_classes("*:1:1000,slow:1:1"), 2};
+    REQUIRE(policy.enter("idle", 1000, now) == 0);
+    policy.leave("idle");
+    REQUIRE(policy.enter("slow", 1000, now) == 0);
+    policy.leave("slow");
+    REQUIRE(policy.enter("busy", 1, now) == 0);
+    REQUIRE(policy.jobs() == 3);
+
+    auto later = now + std::chrono::seconds(gkfs::config::scheduler::qos_job_timeout + 1);
+    REQUIRE(policy.enter("new", 1, later) == 0);
+    // the busy job still processes its request and the slow job did not pay its debt
+    REQUIRE(policy.jobs() == 3);
+    auto stats = policy.stats();
+    REQUIRE(stats.find("idle") == std::string::npos);
+    REQUIRE(stats.find("slow") != std::string::npos);
+    REQUIRE(stats.find("busy") != std::string::npos);
+    policy.leave("busy");
+    policy.leave("new");
+    double wait;
+    REQUIRE(policy.dispatch(later, wait).empty());
+    REQUIRE(policy.inflight() == 0);
+}
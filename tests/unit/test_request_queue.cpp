@@ -0,0 +1,199 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <daemon/scheduler/request_queue.hpp>
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+using gkfs::scheduler::Policy;
+using gkfs::scheduler::Request;
+using gkfs::scheduler::RequestQueue;
+using gkfs::scheduler::RequestType;
+
+namespace {
+
+/**
+ * Owns the requests of a test and queues them in arrival order
+ */
+struct Requests {
+    RequestQueue& queue;
+    std::chrono::steady_clock::time_point now;
+    std::deque<Request> requests{};
+
+    /**
+     * @return true if the request was released on arrival
+     */
+    bool enter(const std::string& path, uint64_t offset, uint64_t size, RequestType type = RequestType::write) {
+        requests.push_back(Request{path, type, offset, size, now});
+        return queue.enter(&requests.back());
+    }
+};
+
+/**
+ * @return path:offset of each released request
+ */
+std::vector<std::string> names(const std::vector<Request*>& released) {
+    std::vector<std::string> out;
+    for (auto request : released)
+        out.push_back(request->path + ":" + std::to_string(request->offset));
+    return out;
+}
+
+using names_t = std::vector<std::string>;
+
+} // namespace
+
+TEST_CASE("Requests are released while fewer than max_inflight are processed", "[scheduler]") {
+    auto now = std::chrono::steady_clock::now();
+    RequestQueue queue{Policy::fifo, 2, 50};
+    Requests requests{queue, now};
+
+    REQUIRE(requests.enter("/a", 0, 10));
+    REQUIRE(requests.enter("/b", 0, 10));
+    REQUIRE_FALSE(requests.enter("/c", 0, 10));
+    // a new request queues behind a waiting one even if a slot is free
+    queue.leave();
+    REQUIRE_FALSE(requests.enter("/d", 0, 10));
+    REQUIRE(names(queue.dispatch(now)) == names_t{"/c:0"});
+    REQUIRE(queue.dispatch(now).empty());
+    queue.leave();
+    queue.leave();
+    REQUIRE(names(queue.dispatch(now)) == names_t{"/d:0"});
+    REQUIRE(queue.queued() == 0);
+    REQUIRE(queue.inflight() == 1);
+}
+
+TEST_CASE("The fifo policy releases requests in arrival order", "[scheduler]") {
+    auto now = std::chrono::steady_clock::now();
+    RequestQueue queue{Policy::fifo, 1, 50};
+    Requests requests{queue, now};
+
+    REQUIRE(requests.enter("/a", 0, 10));
+    requests.enter("/b", 20, 10);
+    requests.enter("/a", 10, 10);
+    requests.enter("/b", 10, 10);
+    names_t released;
+    for (int i = 0; i < 3; ++i) {
+        queue.leave();
+        auto next = names(queue.dispatch(now));
+        REQUIRE(next.size() == 1);
+        released.push_back(next[0]);
+    }
+    REQUIRE(released == names_t{"/b:20", "/a:10", "/b:10"});
+}
+
+TEST_CASE("The aggregation policy releases contiguous requests together", "[scheduler]") {
+    auto now = std::chrono::steady_clock::now();
+    RequestQueue queue{Policy::aggregation, 1, 50};
+    Requests requests{queue, now};
+    REQUIRE(requests.enter("/busy", 0, 10));
+
+    SECTION("the window grows to both sides of the oldest request") {
+        requests.enter("/a", 10, 10);
+        requests.enter("/b", 20, 10);
+        requests.enter("/a", 20, 10);
+        requests.enter("/a", 0, 10);
+        // a gap ends the window
+        requests.enter("/a", 40, 10);
+        // overlapping requests are contiguous
+        requests.enter("/a", 25, 10);
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:0", "/a:10", "/a:20", "/a:25"});
+        REQUIRE(queue.inflight() == 4);
+        REQUIRE(queue.queued() == 2);
+        for (int i = 0; i < 4; ++i)
+            queue.leave();
+        // the oldest request is released next
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/b:20"});
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:40"});
+    }
+
+    SECTION("reads and writes are not aggregated") {
+        requests.enter("/a", 0, 10, RequestType::write);
+        requests.enter("/a", 10, 10, RequestType::read);
+        requests.enter("/a", 20, 10, RequestType::write);
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:0"});
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:10"});
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:20"});
+    }
+}
+
+TEST_CASE("The deadline policy releases requests in offset order", "[scheduler]") {
+    auto start = std::chrono::steady_clock::now();
+    RequestQueue queue{Policy::deadline, 1, 50};
+    Requests requests{queue, start};
+    // the last released request ends at offset 10 of /a
+    REQUIRE(requests.enter("/a", 0, 10));
+    requests.enter("/b", 0, 10);
+    requests.enter("/a", 30, 10);
+    requests.enter("/a", 10, 10);
+    requests.enter("/a", 20, 10);
+
+    SECTION("within the deadline") {
+        auto now = start + std::chrono::milliseconds(10);
+        names_t released;
+        for (int i = 0; i < 4; ++i) {
+            queue.leave();
+            auto next = names(queue.dispatch(now));
+            REQUIRE(next.size() == 1);
+            released.push_back(next[0]);
+        }
+        REQUIRE(released == names_t{"/a:10", "/a:20", "/a:30", "/b:0"});
+    }
+
+    SECTION("an expired request is released first") {
+        auto now = start + std::chrono::milliseconds(50);
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/b:0"});
+        // all requests expired, so they are released in arrival order
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/a:30"});
+    }
+
+    SECTION("without a request continuing the last one, the oldest request's file starts at its lowest offset") {
+        auto now = start + std::chrono::milliseconds(10);
+        requests.enter("/b", 40, 10);
+        requests.enter("/a", 40, 10);
+        // drain /a
+        for (int i = 0; i < 4; ++i) {
+            queue.leave();
+            auto next = names(queue.dispatch(now));
+            REQUIRE(next.size() == 1);
+            REQUIRE(next[0].compare(0, 3, "/a:") == 0);
+        }
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/b:0"});
+        queue.leave();
+        REQUIRE(names(queue.dispatch(now)) == names_t{"/b:40"});
+    }
+}
+
+TEST_CASE("A queued request is released if it cannot wait", "[scheduler]") {
+    auto now = std::chrono::steady_clock::now();
+    RequestQueue queue{Policy::fifo, 1, 50};
+    Requests requests{queue, now};
+    REQUIRE(requests.enter("/a", 0, 10));
+    REQUIRE_FALSE(requests.enter("/b", 0, 10));
+    queue.release(&requests.requests.back());
+    REQUIRE(queue.queued() == 0);
+    REQUIRE(queue.inflight() == 2);
+}
@@ -0,0 +1,138 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <global/metadata.hpp>
+#include <global/rpc/distributor.hpp>
+#include <config.hpp>
+
+#include <string>
+
+extern "C" {
+#include <sys/stat.h>
+}
+
+using gkfs::metadata::Metadata;
+
+TEST_CASE("Stripe layouts are serialized in the metadentry", "[stripe_layout]") {
+    REQUIRE(gkfs::config::metadata::use_stripe_layout);
+
+    SECTION("a file with a layout") {
+        Metadata md{S_IFREG | 0644};
+        md.size(12345);
+        md.stripe_count(4);
+        md.stripe_size(2 * gkfs::config::rpc::chunksize);
+        md.stripe_start(3);
+
+        Metadata parsed{md.serialize()};
+        REQUIRE(parsed.mode() == (S_IFREG | 0644));
+        REQUIRE(parsed.size() == 12345);
+        REQUIRE(parsed.stripe_count() == 4);
+        REQUIRE(parsed.stripe_size() == 2 * gkfs::config::rpc::chunksize);
+        REQUIRE(parsed.stripe_start() == 3);
+        REQUIRE(parsed.serialize() == md.serialize());
+    }
+
+    SECTION("a directory with the default layout") {
+        Metadata md{S_IFDIR | 0755};
+        Metadata parsed{md.serialize()};
+        REQUIRE(S_ISDIR(parsed.mode()));
+        REQUIRE(parsed.stripe_count() == 0);
+        REQUIRE(parsed.stripe_size() == 0);
+        REQUIRE(parsed.stripe_start() == 0);
+    }
+
+#ifdef HAS_SYMLINKS
+    SECTION("the layout is followed by a symlink's target") {
+        Metadata md{S_IFLNK | 0777, "/target"};
+        md.stripe_count(2);
+        md.stripe_size(gkfs::config::rpc::chunksize);
+        md.stripe_start(1);
+        Metadata parsed{md.serialize()};
+        REQUIRE(parsed.target_path() == "/target");
+        REQUIRE(parsed.stripe_count() == 2);
+        REQUIRE(parsed.stripe_start() == 1);
+    }
+#endif
+}
+
+TEST_CASE("Metadentries stored without a stripe layout get the default layout", "[stripe_layout]") {
+    // format before stripe layouts were stored: mode|size, the enabled optional fields, and the symlink target
+    auto serialize_without_layout = [](mode_t mode, const std::string& target_path) {
+        std::string s = std::to_string(mode) + "|12345";
+        if (gkfs::config::metadata::use_atime)
+            s += "|1";
+        if (gkfs::config::metadata::use_mtime)
+            s += "|2";
+        if (gkfs::config::metadata::use_ctime)
+            s += "|3";
+        if (gkfs::config::metadata::use_link_cnt)
+            s += "|1";
+        if (gkfs::config::metadata::use_blocks)
+            s += "|4";
+#ifdef HAS_SYMLINKS
+        s += "|" + target_path;
+#else
+        (void) target_path;
+#endif
+        return s;
+    };
+
+    SECTION("a file") {
+        Metadata parsed{serialize_without_layout(S_IFREG | 0644, "")};
+        REQUIRE(parsed.mode() == (S_IFREG | 0644));
+        REQUIRE(parsed.size() == 12345);
+        REQUIRE(parsed.stripe_count() == 0);
+        REQUIRE(parsed.stripe_size() == 0);
+        REQUIRE(parsed.stripe_start() == 0);
+        // written back with a layout
+        Metadata reparsed{parsed.serialize()};
+        REQUIRE(reparsed.size() == 12345);
+        REQUIRE(reparsed.stripe_count() == 0);
+    }
+
+#ifdef HAS_SYMLINKS
+    SECTION("a symlink") {
+        Metadata parsed{serialize_without_layout(S_IFLNK | 0777, "/target")};
+        REQUIRE(parsed.target_path() == "/target");
+        REQUIRE(parsed.stripe_count() == 0);
+    }
+#endif
+}
+
+TEST_CASE("Chunks are placed by the stripe layout", "[stripe_layout]") {
+    gkfs::rpc::SimpleHashDistributor distributor{0, 8};
+
+    SECTION("stripe units are placed round-robin beginning with the start host") {
+        gkfs::rpc::StripeLayout layout{4, 2 * gkfs::config::rpc::chunksize, 6};
+        const gkfs::rpc::host_t expected[] = {6, 6, 7, 7, 0, 0, 1, 1, 6, 6};
+        for (gkfs::rpc::chunkid_t chunk = 0; chunk < 10; ++chunk) {
+            CAPTURE(chunk);
+            REQUIRE(distributor.locate_data("/file", chunk, layout) == expected[chunk]);
+        }
+    }
+
+    SECTION("a stripe count larger than the number of hosts uses all hosts") {
+        gkfs::rpc::StripeLayout layout{16, gkfs::config::rpc::chunksize, 0};
+        for (gkfs::rpc::chunkid_t chunk = 0; chunk < 16; ++chunk)
+            REQUIRE(distributor.locate_data("/file", chunk, layout) == chunk % 8);
+    }
+
+    SECTION("the default layout hashes every chunk") {
+        gkfs::rpc::StripeLayout layout{};
+        REQUIRE(layout.is_default());
+        for (gkfs::rpc::chunkid_t chunk = 0; chunk < 16; ++chunk)
+            REQUIRE(distributor.locate_data("/file", chunk, layout) == distributor.locate_data("/file", chunk));
+    }
+}
@@ -0,0 +1,101 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+
+#include <client/user_functions.hpp>
+
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace gkfs::syscall;
+
+/*
+ * The user library against a single daemon on the same node. Hidden by default since a running daemon is required,
+ * see tests/bench/run_loopback.sh, which starts one and selects these test cases with the [daemon] tag.
+ */
+TEST_CASE("The user library connects to the daemons", "[.daemon]") {
+    REQUIRE(gkfs_init() == 0);
+    // subsequent calls return immediately
+    REQUIRE(gkfs_init() == 0);
+
+    REQUIRE(gkfs_end() == 0);
+    errno = 0;
+    REQUIRE(gkfs_end() == -1);
+    REQUIRE(errno == EINVAL);
+}
+
+TEST_CASE("The user library reads and writes files", "[.daemon]") {
+    REQUIRE(gkfs_init() == 0);
+    const std::string dir = "/gkfs_user_lib";
+    const auto file = dir + "/data";
+    REQUIRE(gkfs_create(dir, S_IFDIR | 0755) == 0);
+    REQUIRE(gkfs_create(file, S_IFREG | 0644) == 0);
+
+    SECTION("synchronous I/O") {
+        auto fd = gkfs_open(file, 0, O_RDWR);
+        REQUIRE(fd >= 0);
+        std::vector<char> buf(1024 * 1024);
+        for (size_t i = 0; i < buf.size(); ++i)
+            buf[i] = static_cast<char>(i % 251);
+        REQUIRE(gkfs_pwrite_ws(fd, buf.data(), buf.size(), 4096) == static_cast<ssize_t>(buf.size()));
+
+        struct stat st{};
+        REQUIRE(gkfs_stat(file, &st) == 0);
+        REQUIRE(S_ISREG(st.st_mode));
+        REQUIRE(st.st_size == static_cast<off_t>(buf.size() + 4096));
+
+        std::vector<char> out(buf.size());
+        REQUIRE(gkfs_pread_ws(fd, out.data(), out.size(), 4096) == static_cast<ssize_t>(out.size()));
+        REQUIRE(out == buf);
+        // the hole before the data reads as zeros
+        std::vector<char> hole(4096, 'x');
+        REQUIRE(gkfs_pread_ws(fd, hole.data(), hole.size(), 0) == static_cast<ssize_t>(hole.size()));
+        REQUIRE(hole == std::vector<char>(4096, 0));
+        REQUIRE(gkfs_close(fd) == 0);
+    }
+
+    SECTION("asynchronous I/O") {
+        auto fd = gkfs_open(file, 0, O_RDWR);
+        REQUIRE(fd >= 0);
+        std::vector<char> buf(64 * 1024, 'a');
+        auto req = gkfs_aio_pwrite(fd, buf.data(), buf.size(), 0);
+        REQUIRE(req >= 0);
+        REQUIRE(gkfs_aio_wait(req) == static_cast<ssize_t>(buf.size()));
+
+        std::vector<char> out(buf.size());
+        req = gkfs_aio_pread(fd, out.data(), out.size(), 0);
+        REQUIRE(req >= 0);
+        REQUIRE(gkfs_aio_wait(req) == static_cast<ssize_t>(out.size()));
+        REQUIRE(out == buf);
+        REQUIRE(gkfs_close(fd) == 0);
+    }
+
+    SECTION("missing files") {
+        errno = 0;
+        REQUIRE(gkfs_open(dir + "/missing", 0, O_RDONLY) == -1);
+        REQUIRE(errno == ENOENT);
+        struct stat st{};
+        errno = 0;
+        REQUIRE(gkfs_stat(dir + "/missing", &st) == -1);
+        REQUIRE(errno == ENOENT);
+    }
+
+    REQUIRE(gkfs_remove(file) == 0);
+    REQUIRE(gkfs_rmdir(dir) == 0);
+    REQUIRE(gkfs_end() == 0);
+}